@@ -41,6 +41,7 @@
 
 #include <opentxs/core/Contract.hpp>
 #include <map>
+#include <vector>
 #include <cstdint>
 #include <ctime>
 
@@ -58,6 +59,10 @@ class Mint : public Contract
 private: // Private prevents erroneous use by other classes.
     typedef Contract ot_super;
 
+    static int32_t __token_thread_count; // Number of threads signing or
+                                         // verifying the tokens of one
+                                         // purse at once.
+
 protected:
     virtual int32_t ProcessXMLNode(irr::io::IrrXMLReader*& xml);
 
@@ -142,6 +147,15 @@ public:
         return m_pReserveAcct;
     }
 
+    static int32_t GetTokenThreadCount()
+    {
+        return __token_thread_count;
+    }
+    static void SetTokenThreadCount(int32_t nCount)
+    {
+        __token_thread_count = nCount;
+    }
+
 public:
     // Caller is responsible to delete.
     //
@@ -225,6 +239,20 @@ public:
     // Lucre step 5: mint verifies token when it is redeemed by merchant.
     EXPORT virtual bool VerifyToken(Nym& theNotary, String& theCleartextToken,
                                     int64_t lDenomination) = 0;
+
+    // The same, for every token of a purse. theOutputs[i] receives the
+    // signature for theTokens[i]. Each denomination's private key is only
+    // opened once, and the tokens are split over GetTokenThreadCount()
+    // threads. Fails if any one of them fails.
+    EXPORT virtual bool SignTokens(Nym& theNotary,
+                                   const std::vector<Token*>& theTokens,
+                                   std::vector<String>& theOutputs,
+                                   int32_t nTokenIndex);
+    // Succeeds only if every one of theCleartextTokens verifies against
+    // theDenominations[i].
+    EXPORT virtual bool VerifyTokens(
+        Nym& theNotary, std::vector<String>& theCleartextTokens,
+        const std::vector<int64_t>& theDenominations);
 };
 
 } // namespace opentxs
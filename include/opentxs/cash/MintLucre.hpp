@@ -74,6 +74,13 @@ public:
                                   String& theOutput, int32_t nTokenIndex);
     EXPORT virtual bool VerifyToken(Nym& theNotary, String& theCleartextToken,
                                     int64_t lDenomination);
+    EXPORT virtual bool SignTokens(Nym& theNotary,
+                                   const std::vector<Token*>& theTokens,
+                                   std::vector<String>& theOutputs,
+                                   int32_t nTokenIndex);
+    EXPORT virtual bool VerifyTokens(
+        Nym& theNotary, std::vector<String>& theCleartextTokens,
+        const std::vector<int64_t>& theDenominations);
 
     EXPORT virtual ~MintLucre();
 };
@@ -0,0 +1,135 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CASH_SPENTTOKENINDEX_HPP
+#define OPENTXS_CASH_SPENTTOKENINDEX_HPP
+
+#include <opentxs/core/util/Common.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace opentxs
+{
+
+class String;
+
+// The spent token database for one mint series.
+//
+// Each spent token is recorded as the hash of its cleartext, appended to
+// <instrumentDefinitionID>.<series>.log in the spent folder. Once the log
+// holds COMPACT_THRESHOLD hashes they are merged into the .idx file next to
+// it, a sorted array of fixed-size hashes. Both are loaded when the series is
+// first used, with a Bloom filter in front, so a token that was never spent
+// is normally answered without a search and without touching the disk.
+//
+// Spent tokens recorded one file per token (the old layout) are copied into
+// the log the first time a series is opened from filesystem storage. With
+// key/value storage they are looked up in the store instead.
+//
+// Once a series has expired none of its tokens can be deposited, so
+// DropExpired() forgets it and deletes its files.
+class SpentTokenIndex
+{
+public:
+    typedef std::vector<std::string> Hashes;
+
+    static const size_t HASH_SIZE = 20;
+    static const size_t COMPACT_THRESHOLD = 8192;
+
+    // Loads the series on first use. Never returns nullptr. tExpires is the
+    // valid-to date of the server's mint for the series.
+    EXPORT static std::shared_ptr<SpentTokenIndex> Get(
+        const String& strInstrumentDefinitionID, int32_t nSeries,
+        time64_t tExpires);
+    EXPORT static void DropExpired();
+
+    // The hash a token is recorded under.
+    EXPORT static bool HashToken(const String& strCleartextToken,
+                                 std::string& strHash);
+
+    // Sets theResults[i] if theHashes[i] was spent. Returns false on error,
+    // in which case every token must be treated as spent.
+    EXPORT bool IsSpent(const Hashes& theHashes, std::vector<bool>& theResults);
+    // Records all of theHashes with a single write. Fails if any of them was
+    // already spent, or appears twice.
+    EXPORT bool Record(const Hashes& theHashes);
+
+    ~SpentTokenIndex();
+
+private:
+    SpentTokenIndex(const std::string& strName, time64_t tExpires);
+    SpentTokenIndex(const SpentTokenIndex&);
+    SpentTokenIndex& operator=(const SpentTokenIndex&);
+
+    bool open();
+    bool load(const std::string& strPath, std::string& strOutput) const;
+    bool importLegacy();
+    bool append(const std::string& strRecords);
+    bool compact();
+    void close();
+    void remove();
+
+    bool contains(const std::string& strHash) const;
+    void addToBloom(const std::string& strHash);
+    void setBloomBits(const char* pHash);
+    bool mayContain(const std::string& strHash) const;
+    void rebuildBloom();
+
+    std::mutex mutex_;
+    std::string name_; // <instrumentDefinitionID>.<series>
+    time64_t expires_;
+    bool open_;
+    bool legacy_; // Also check the old one-file-per-token layout.
+    std::string logPath_;
+    std::string indexPath_;
+    std::FILE* log_;
+    std::string index_;            // Sorted, HASH_SIZE bytes each.
+    std::set<std::string> recent_; // In the log, not yet in index_.
+    std::vector<uint64_t> bloom_;
+    uint64_t bloomMask_;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CASH_SPENTTOKENINDEX_HPP
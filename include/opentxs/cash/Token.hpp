@@ -42,6 +42,8 @@
 #include <opentxs/core/crypto/OTASCIIArmor.hpp>
 #include <opentxs/core/Instrument.hpp>
 
+#include <vector>
+
 namespace opentxs
 {
 
@@ -291,10 +293,25 @@ public:
     // Lucre step 5: token verifies when it is redeemed by merchant.
     //                 Now including spent token database!
     EXPORT bool VerifyToken(Nym& theNotary, Mint& theMint);
-    EXPORT bool IsTokenAlreadySpent(String& theCleartextToken); // Spent Token
-                                                                // Database
-    EXPORT bool RecordTokenAsSpent(String& theCleartextToken);  // Spent Token
-                                                                // Database
+    // The series and date checks from VerifyToken, without the coin itself.
+    EXPORT bool VerifySeries(const Mint& theMint);
+    // theMint is the server's mint for this token's series. The series is
+    // kept in the spent token database until the mint's valid-to date.
+    EXPORT bool IsTokenAlreadySpent(const Mint& theMint,
+                                    String& theCleartextToken);
+    EXPORT bool RecordTokenAsSpent(const Mint& theMint,
+                                   String& theCleartextToken);
+    // The same, for every token in a purse at once. theMints[i] and
+    // theCleartextTokens[i] belong to theTokens[i]. Each mint series is
+    // checked or written once.
+    EXPORT static bool AreTokensAlreadySpent(
+        const std::vector<Token*>& theTokens,
+        const std::vector<const Mint*>& theMints,
+        const std::vector<String>& theCleartextTokens);
+    EXPORT static bool RecordTokensAsSpent(
+        const std::vector<Token*>& theTokens,
+        const std::vector<const Mint*>& theMints,
+        const std::vector<String>& theCleartextTokens);
     EXPORT void SetSignature(const OTASCIIArmor& theSignature,
                              int32_t nTokenIndex);
     EXPORT bool GetSignature(OTASCIIArmor& theSignature) const;
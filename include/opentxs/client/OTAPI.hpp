@@ -2645,6 +2645,14 @@ public:
                                        const std::string& NYM_ID_CHECK,
                                        const int64_t& ADJUSTMENT);
 
+    /** Asks the server for its per-command request counts and latencies.
+    The reply payload (see Message_GetPayload) holds them as XML. Only the
+    server's override Nym may do this, unless the server operator sets
+    cmd_get_server_stats=true in ~/.ot/server.cfg
+    */
+    EXPORT static int32_t getServerStats(const std::string& NOTARY_ID,
+                                         const std::string& NYM_ID);
+
     /** IF THE_MESSAGE is of command type usageCreditsResponse, and IF it was a
     SUCCESS,
     // then this function returns the usage credits BALANCE (it's a int64_t, but
@@ -3240,6 +3248,15 @@ public:
         const int32_t& nBoxType,       // 0/nymbox, 1/inbox, 2/outbox
         const int64_t& TRANSACTION_NUMBER);
 
+    // Same as getBoxReceipt, for several receipts from the same box at once.
+    // TRANSACTION_NUMBERS is a comma-separated list, such as "5,6,9". The
+    // server's reply may hold only some of them, so check DoesBoxReceiptExist
+    // after.
+    EXPORT static int32_t getBoxReceipts(
+        const std::string& NOTARY_ID, const std::string& NYM_ID,
+        const std::string& ACCOUNT_ID, const int32_t& nBoxType,
+        const std::string& TRANSACTION_NUMBERS);
+
     //
     EXPORT static bool DoesBoxReceiptExist(
         const std::string& NOTARY_ID,
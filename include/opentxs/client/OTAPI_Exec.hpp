@@ -2694,6 +2694,21 @@ public:
                                 const std::string& NYM_ID_CHECK,
                                 const int64_t& ADJUSTMENT) const;
 
+    /** Asks the server for its per-command request counts and latencies.
+    The reply payload (see Message_GetPayload) holds them as XML. Only the
+    server's override Nym may do this, unless the server operator sets
+    cmd_get_server_stats=true in ~/.ot/server.cfg
+    */
+    // Returns int32_t:
+    // -1 means error; no message was sent.
+    // 0 means NO error, but also: no message was sent.
+    // >0 means NO error, and the message was sent, and the request number fits
+    // into an integer...
+    // ...and in fact the requestNum IS the return value!
+    //
+    EXPORT int32_t getServerStats(const std::string& NOTARY_ID,
+                                  const std::string& NYM_ID) const;
+
     /** IF THE_MESSAGE is of command type usageCreditsResponse, and IF it was a
     SUCCESS,
     // then this function returns the usage credits BALANCE (it's a int64_t, but
@@ -3291,6 +3306,16 @@ public:
         const int32_t& nBoxType,       // 0/nymbox, 1/inbox, 2/outbox
         const int64_t& TRANSACTION_NUMBER) const;
 
+    // Same as getBoxReceipt, for several receipts from the same box at once.
+    // TRANSACTION_NUMBERS is a comma-separated list, such as "5,6,9". The
+    // server's reply may hold only some of them (see
+    // Utility::insureHaveAllBoxReceipts), so check DoesBoxReceiptExist after.
+    EXPORT int32_t getBoxReceipts(const std::string& NOTARY_ID,
+                                  const std::string& NYM_ID,
+                                  const std::string& ACCOUNT_ID,
+                                  const int32_t& nBoxType,
+                                  const std::string& TRANSACTION_NUMBERS) const;
+
     EXPORT bool DoesBoxReceiptExist(
         const std::string& NOTARY_ID,
         const std::string& NYM_ID,     // Unused here for now, but still
@@ -51,6 +51,7 @@ namespace opentxs
 class Account;
 class AssetContract;
 class Ledger;
+class OTASCIIArmor;
 class OTServerContract;
 class OTWallet;
 
@@ -193,6 +194,11 @@ private:
     bool processServerReplyGetBoxReceipt(const Message& theReply,
                                          Ledger* pNymbox,
                                          ProcessServerReplyArgs& args);
+    bool processServerReplyGetBoxReceipts(const Message& theReply,
+                                          ProcessServerReplyArgs& args);
+    void processBoxReceipt(int64_t lBoxType, int64_t lTransactionNum,
+                           const OTASCIIArmor& ascReceipt,
+                           ProcessServerReplyArgs& args);
     bool processServerReplyProcessInbox(const Message& theReply,
                                         Ledger* pNymbox,
                                         ProcessServerReplyArgs& args);
@@ -205,6 +211,7 @@ private:
     bool processServerReplyGetMarketList(const Message& theReply);
     bool processServerReplyGetMarketOffers(const Message& theReply);
     bool processServerReplyGetMarketRecentTrades(const Message& theReply);
+    bool processServerReplyGetMarketCandles(const Message& theReply);
     bool processServerReplyGetNymMarketOffers(const Message& theReply);
     bool processServerReplyUnregisterNym(const Message& theReply,
                                          ProcessServerReplyArgs& args);
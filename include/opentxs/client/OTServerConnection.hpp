@@ -81,7 +81,9 @@ public:
               const Message& theMessage);
 
 private:
-    bool send(const String&);
+    bool send(const Message& theMessage);
+    bool send(const std::string& request, std::string& reply);
+    bool processReply(const std::string& rawServerReply);
     bool receive(std::string& reply);
 
 private:
@@ -89,6 +91,7 @@ private:
     Nym* m_pNym;
     OTServerContract* m_pServerContract;
     OTClient* m_pClient;
+    bool m_bBinary; // Until the server turns down a binary message.
 };
 
 } // namespace opentxs
@@ -671,6 +671,9 @@ public:
                                 const Identifier& NYM_ID_CHECK,
                                 int64_t lAdjustment = 0) const;
 
+    EXPORT int32_t getServerStats(const Identifier& NOTARY_ID,
+                                  const Identifier& NYM_ID) const;
+
     EXPORT int32_t getRequestNumber(const Identifier& NOTARY_ID,
                                     const Identifier& NYM_ID) const;
 
@@ -707,6 +710,12 @@ public:
                       int32_t nBoxType, // 0/nymbox, 1/inbox, 2/outbox
                       const int64_t& lTransactionNum) const;
 
+    // Same, for several receipts from the same box in one request.
+    EXPORT int32_t
+        getBoxReceipts(const Identifier& NOTARY_ID, const Identifier& NYM_ID,
+                       const Identifier& ACCOUNT_ID, int32_t nBoxType,
+                       const NumList& theTransactionNums) const;
+
     EXPORT int32_t
         queryInstrumentDefinitions(const Identifier& NOTARY_ID,
                                    const Identifier& NYM_ID,
@@ -1004,13 +1013,24 @@ public:
                                              // threshold price here.
     EXPORT int32_t getMarketList(const Identifier& NOTARY_ID,
                                  const Identifier& NYM_ID) const;
+    // If lSinceVersion is set (from the marketVersion of an earlier reply)
+    // and lDepth is 0, the server may send only the offers that changed
+    // since then.
     EXPORT int32_t getMarketOffers(const Identifier& NOTARY_ID,
                                    const Identifier& NYM_ID,
                                    const Identifier& MARKET_ID,
-                                   const int64_t& lDepth) const;
+                                   const int64_t& lDepth,
+                                   const int64_t& lSinceVersion = 0) const;
     EXPORT int32_t getMarketRecentTrades(const Identifier& NOTARY_ID,
                                          const Identifier& NYM_ID,
                                          const Identifier& MARKET_ID) const;
+    // strResolution is "1m", "1h" or "1d". lDepth of 0 means all the candles
+    // the server keeps.
+    EXPORT int32_t getMarketCandles(const Identifier& NOTARY_ID,
+                                    const Identifier& NYM_ID,
+                                    const Identifier& MARKET_ID,
+                                    const String& strResolution,
+                                    const int64_t& lDepth) const;
     EXPORT int32_t getNymMarketOffers(const Identifier& NOTARY_ID,
                                       const Identifier& NYM_ID) const;
     // For cancelling market offers and payment plans.
@@ -300,6 +300,8 @@ public:
                                                               // have a
                                                               // contract in
     // string form, pass it in here to import it.
+    // Same, but takes over theStr's buffer instead of copying it.
+    EXPORT bool LoadContractFromString(String&& theStr);
     bool LoadContractRawFile(); // fopens m_strFilename and reads it off the
                                 // disk into m_strRawFile
     EXPORT bool ParseRawFile(); // parses m_strRawFile into the various member
@@ -41,6 +41,8 @@
 
 #include "OTData.hpp"
 
+#include <cstddef>
+#include <functional>
 #include <string>
 
 // An Identifier is basically a 256 bit hash value.
@@ -85,6 +87,9 @@ public:
     EXPORT bool operator<(const Identifier& s2) const;
     EXPORT bool operator<=(const Identifier& s2) const;
     EXPORT bool operator>=(const Identifier& s2) const;
+    // Returns <0, 0 or >0, comparing the binary digests.
+    EXPORT int32_t Compare(const Identifier& s2) const;
+    EXPORT size_t Hash() const;
     EXPORT bool CalculateDigest(const OTData& dataInput);
     EXPORT bool CalculateDigest(const String& strInput);
 
@@ -98,4 +103,16 @@ public:
 
 } // namespace opentxs
 
+namespace std
+{
+template <>
+struct hash<opentxs::Identifier>
+{
+    size_t operator()(const opentxs::Identifier& id) const
+    {
+        return id.Hash();
+    }
+};
+} // namespace std
+
 #endif // OPENTXS_CORE_OTIDENTIFIER_HPP
@@ -41,6 +41,8 @@
 
 #include "OTTransactionType.hpp"
 
+#include <map>
+
 namespace opentxs
 {
 
@@ -51,6 +53,7 @@ class Nym;
 class OTTransaction;
 
 typedef std::list<Item*> listOfItems;
+typedef std::map<int64_t, Item*> mapOfItems;
 
 // Item as in "Transaction Item"
 // An OTLedger contains a list of transactions (pending transactions, inbox or
@@ -281,6 +284,16 @@ protected:
 
     int64_t m_lClosingTransactionNo; // Used in balance agreement (to represent
                                      // an inbox item)
+    // Sub-items indexed by transaction number, and final receipts by "in
+    // reference to" number, so that verifying a balance statement doesn't
+    // rescan m_listItems for every inbox and outbox entry. Built on first
+    // lookup and dropped whenever the list changes.
+    mapOfItems m_mapItemsByTransNum;
+    mapOfItems m_mapFinalReceiptsByRefNum;
+    bool m_bItemsIndexed;
+
+    void IndexItems();
+
 public:
     // For "OTItem::acceptTransaction" -- the blank contains a list of blank
     // numbers,
@@ -75,6 +75,10 @@ private:
     mapOfTransactions m_mapTransactions; // a ledger contains a map of
                                          // transactions.
 
+    static int32_t __box_receipt_thread_count; // Number of threads verifying
+                                               // the box receipts of one
+                                               // ledger at once.
+
 protected:
     // return -1 if error, 0 if nothing, and 1 if the node was processed.
     virtual int32_t ProcessXMLNode(irr::io::IrrXMLReader*& xml);
@@ -120,6 +124,15 @@ public:
         return m_Type;
     }
 
+    static int32_t GetBoxReceiptThreadCount()
+    {
+        return __box_receipt_thread_count;
+    }
+    static void SetBoxReceiptThreadCount(int32_t nCount)
+    {
+        __box_receipt_thread_count = nCount;
+    }
+
     EXPORT bool LoadedLegacyData() const
     {
         return m_bLoadedLegacyData;
@@ -61,6 +61,7 @@ namespace opentxs
 
 typedef std::deque<String*> dequeOfStrings;
 
+class LogWriter;
 class OTLogStream;
 
 #ifdef _WIN32
@@ -84,12 +85,11 @@ OTLOG_IMPORT extern OTLogStream otLog3; // logs using OTLog::vOutput(3)
 OTLOG_IMPORT extern OTLogStream otLog4; // logs using OTLog::vOutput(4)
 OTLOG_IMPORT extern OTLogStream otLog5; // logs using OTLog::vOutput(5)
 
+// Each thread assembles its own line; see OTLogStream::overflow.
 class OTLogStream : public std::ostream, std::streambuf
 {
 private:
     int logLevel;
-    int next;
-    char* pBuffer;
 
 public:
     OTLogStream(int _logLevel);
@@ -119,6 +119,10 @@ private:
 
     bool m_bInitialized;
 
+    // Owns the log file once Init has found its path. Output lines are handed
+    // to it instead of being written on the calling thread.
+    LogWriter* m_pWriter;
+
     // For things that represent internal inconsistency in the code.
     // Normally should NEVER happen even with bad input from user.
     // (Don't call this directly. Use the above #defined macro instead.)
@@ -163,6 +167,15 @@ public:
 
     EXPORT static bool LogToFile(const String& strOutput);
 
+    // Blocks until everything logged so far has reached the log file.
+    // Asserts and Cleanup() do this themselves.
+    EXPORT static void Flush();
+
+    // Rotates the log file once it exceeds lMaxFileSize bytes, keeping
+    // nFileCount old files. A size of 0 (the default) disables rotation.
+    EXPORT static bool SetLogRotation(const int64_t& lMaxFileSize,
+                                      const int32_t& nFileCount);
+
     // We keep 1024 logs in memory, to make them available via the API.
     EXPORT static int32_t GetMemlogSize();
     EXPORT static String GetMemlogAtIndex(int32_t nIndex);
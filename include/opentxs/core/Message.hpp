@@ -43,6 +43,7 @@
 #include "Contract.hpp"
 #include "NumList.hpp"
 
+#include <map>
 #include <unordered_map>
 #include <memory>
 
@@ -135,6 +136,17 @@ public:
     EXPORT static void registerStrategy(std::string name,
                                         OTMessageStrategy* strategy);
 
+    // Compact wire form of a signed message: the signed text, with its
+    // base64 blocks carried as raw bytes. (See Wire.proto.) The client and
+    // server send this instead of the armored text when both speak it.
+    EXPORT bool SaveBinary(std::string& strOutput) const;
+    // Loads exactly what LoadContractFromString would have loaded from the
+    // signed text SaveBinary was given.
+    // (Both read straight from the caller's buffer, such as a network frame.)
+    EXPORT bool LoadBinary(const char* data, size_t size);
+    // True if data was made by SaveBinary, rather than being armored.
+    EXPORT static bool IsBinary(const char* data, size_t size);
+
     String m_strCommand;  // perhaps @register is the string for "reply to
                           // register" a-ha
     String m_strNotaryID; // This is sent with every message for security
@@ -190,6 +202,13 @@ public:
     int64_t m_lTransactionNum; // For Market-related messages... Also used by
                                // getBoxReceipt
 
+    // getBoxReceipts: the transaction numbers whose box receipts are wanted.
+    NumList m_TransactionNums;
+    // getBoxReceiptsResponse: the box receipts the server sent back, by
+    // transaction number. (A reply may hold only some of the receipts asked
+    // for, if they don't all fit; the client asks again for the rest.)
+    std::map<int64_t, OTASCIIArmor> m_mapBoxReceipts;
+
     bool m_bSuccess; // When the server replies to the client, this may be true
                      // or false
     bool m_bBool;    // Some commands need to send a bool. This variable is for
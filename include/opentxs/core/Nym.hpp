@@ -43,8 +43,10 @@
 #include "Identifier.hpp"
 
 #include <deque>
+#include <functional>
 #include <map>
 #include <list>
+#include <mutex>
 #include <set>
 
 namespace opentxs
@@ -206,6 +208,18 @@ private:
     String::List m_listRevokedIDs; // std::string list, any revoked Credential
                                    // IDs. (Mainly for subcredentials /
                                    // subkeys.)
+    // (SERVER side.) Set while this Nym is checked out of the server's Nym
+    // cache. SaveSignedNymfile() then keeps the serialized nymfile here, and
+    // if saves are deferred, leaves signing and writing it to the cache.
+    String* m_pstrCachedNymfile;
+    bool m_bDeferSave;
+    bool m_bNymfileDirty; // Saved to m_pstrCachedNymfile, but not to disk.
+    // Held while one of this Nym's private keys signs. (The server Nym signs
+    // replies from several threads at once.)
+    mutable std::mutex m_signingLock;
+
+    static std::function<void(const String&)> s_NymfileSaved;
+
 public:
     EXPORT void GetPrivateCredentials(String& strCredList,
                                       String::Map* pmapCredFiles = nullptr);
@@ -465,6 +479,10 @@ public:
     const OTAsymmetricKey& GetPrivateEncrKey() const;
     EXPORT const OTAsymmetricKey& GetPublicSignKey() const; // Signing
     const OTAsymmetricKey& GetPrivateSignKey() const;
+    std::mutex& GetSigningLock() const
+    {
+        return m_signingLock;
+    }
     // OT uses the signature's metadata to narrow down its search for the
     // correct public key.
     EXPORT int32_t GetPublicKeysBySignature(
@@ -495,6 +513,24 @@ public:
     // used as signer.
     EXPORT bool LoadSignedNymfile(Nym& SIGNER_NYM);
     EXPORT bool SaveSignedNymfile(Nym& SIGNER_NYM);
+    EXPORT static bool WriteSignedNymfile(const String& strNymID,
+                                          const String& strPayload,
+                                          const Nym& SIGNER_NYM,
+                                          String* pstrFilename = nullptr);
+    // (Server side.) Nym cache support. See NymCache in the server.
+    EXPORT void SetCachedNymfile(String* pstrNymfile, bool bDeferSave);
+    EXPORT bool IsNymfileDirty() const
+    {
+        return m_bNymfileDirty;
+    }
+    EXPORT void ClearNymfileDirty()
+    {
+        m_bNymfileDirty = false;
+    }
+    // Called with the NymID whenever a Nym that is NOT checked out of the
+    // cache writes its nymfile, so the cache can drop its stale copy.
+    EXPORT static void SetNymfileSavedCallback(
+        std::function<void(const String&)> callback);
     EXPORT bool LoadFromString(const String& strNym,
                                String::Map* pMapCredentials =
                                    nullptr, // pMapCredentials can be passed, if
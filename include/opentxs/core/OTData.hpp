@@ -97,9 +97,22 @@ protected:
     }
 
 private:
+    // Buffers up to this size are stored inside the object instead of on the
+    // heap. Big enough for any digest we use, so Identifiers never allocate.
+    static const uint32_t INLINE_SIZE = 32;
+
+    void* allocate(uint32_t size);
+    void deallocate();
+
+    inline bool isInline() const
+    {
+        return data_ == inline_;
+    }
+
     void* data_;
     uint32_t position_;
     uint32_t size_; // TODO: MAX_SIZE ?? security.
+    uint8_t inline_[INLINE_SIZE];
 };
 
 } // namespace opentxs
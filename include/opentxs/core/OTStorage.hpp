@@ -48,8 +48,12 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <cstdint>
+#include <cstdio>
 
 #define OTDB_PROTOCOL_BUFFERS 1
 
@@ -74,10 +78,12 @@ enum PackType            // PACKING TYPE
   PACK_TYPE_ERROR        // (Should never be.)
 };
 
-// Currently supporting filesystem, with subclasses possible via API.
+// Currently supporting filesystem and a single-file key/value store, with
+// subclasses possible via API.
 //
 enum StorageType        // STORAGE TYPE
 { STORE_FILESYSTEM = 0, // Filesystem
+  STORE_KEY_VALUE,      // Single-file key/value store in the data folder.
   STORE_TYPE_SUBCLASS   // (Subclass provided by API client via SWIG.)
 };
 
@@ -411,9 +417,55 @@ public:
 //
 class Storage
 {
+#ifndef SWIG
+protected:
+    // One staged store or erase. (See BeginBatch.)
+    struct BatchEntry
+    {
+        std::string strFolder;
+        std::string oneStr;
+        std::string twoStr;
+        std::string threeStr;
+        std::string value; // Plain string, or the bytes of a PackedBuffer.
+        bool packed;
+        bool erase;
+    };
+#endif // (not) SWIG
+
 private:
     OTPacker* m_pPacker;
 
+#ifndef SWIG
+    struct Batch
+    {
+        Batch()
+            : depth(0)
+        {
+        }
+
+        std::vector<BatchEntry> entries;
+        std::map<std::string, size_t> index; // key -> position in entries
+        int32_t depth;
+    };
+
+    // Each thread has its own batch.
+    std::map<std::thread::id, Batch> m_mapBatches;
+    std::mutex m_batchLock;
+
+    Batch* GetBatch();
+    // Returns false if the calling thread has no open batch.
+    bool Stage(const std::string& strValue, bool bPacked, bool bErase,
+               const std::string& strFolder, const std::string& oneStr,
+               const std::string& twoStr, const std::string& threeStr);
+    bool StageBuffer(PackedBuffer& theBuffer, const std::string& strFolder,
+                     const std::string& oneStr, const std::string& twoStr,
+                     const std::string& threeStr);
+    // Returns false if the calling thread hasn't staged anything at this key.
+    bool FindStaged(const BatchEntry*& pEntry, const std::string& strFolder,
+                    const std::string& oneStr, const std::string& twoStr,
+                    const std::string& threeStr);
+#endif // (not) SWIG
+
 protected:
     Storage()
         : m_pPacker(nullptr)
@@ -478,6 +530,12 @@ protected:
                                    std::string twoStr = "",
                                    std::string threeStr = "") = 0;
 
+#ifndef SWIG
+    // Writes a committed batch. The default just replays the entries one by
+    // one, so override it if your storage can write them atomically.
+    virtual bool onCommitBatch(std::vector<BatchEntry>& theEntries);
+#endif // (not) SWIG
+
 public:
     // Use GetPacker() to access the Packer, throughout duration of this Storage
     // object.
@@ -560,6 +618,24 @@ public:
                                 std::string twoStr = "",
                                 std::string threeStr = "");
 
+    // WRITE BATCHES
+    //
+    // Between BeginBatch() and CommitBatch(), every store and erase made by
+    // the calling thread is staged in memory, and that thread's queries see
+    // the staged values. CommitBatch() writes them all at once, which is
+    // atomic for storage that supports it (StorageKV.) Other threads don't
+    // see the changes until then. Batches nest; only the outermost
+    // CommitBatch() writes.
+    EXPORT void BeginBatch();
+    EXPORT bool CommitBatch();
+    EXPORT void AbortBatch();
+
+    // Returns false if the calling thread's batch has nothing at this key.
+    // Otherwise bExists says whether it was stored (vs. erased.)
+    EXPORT bool ExistsInBatch(bool& bExists, std::string strFolder,
+                              std::string oneStr = "", std::string twoStr = "",
+                              std::string threeStr = "");
+
     // Note:
     // Make sure to use: %newobject Factory::createObj();  IN OTAPI.i file!
     //
@@ -654,6 +730,34 @@ EXPORT Storable* DecodeObject(StoredObjectType theObjectType,
 EXPORT bool EraseValueByKey(std::string strFolder, std::string oneStr = "",
                             std::string twoStr = "", std::string threeStr = "");
 
+// Write batches on the default storage. (See Storage::BeginBatch.)
+
+EXPORT void BeginBatch();
+EXPORT bool CommitBatch();
+EXPORT void AbortBatch();
+
+#ifndef SWIG
+// Opens a batch on the default storage for the life of this object. Call
+// Commit() to write it and learn whether that worked. Otherwise it is
+// committed when destroyed. (Everything staged gets written, even on an
+// early return, just as it would have been without the batch.)
+class ScopedBatch
+{
+public:
+    EXPORT ScopedBatch();
+    EXPORT ~ScopedBatch();
+
+    // Only the first call writes anything.
+    EXPORT bool Commit();
+
+private:
+    bool m_bOpen;
+
+    ScopedBatch(const ScopedBatch&);
+    ScopedBatch& operator=(const ScopedBatch&);
+};
+#endif // (not) SWIG
+
 #ifdef SWIG
 #define DECLARE_GET_ADD_REMOVE(name)                                           \
                                                                                \
@@ -1588,9 +1692,20 @@ namespace OTDB
 //
 class StorageFS : public Storage
 {
-private:
+protected:
     std::string m_strDataPath;
 
+private:
+    // A batch is written to temporary files, which a journal lists before
+    // they're renamed into place. A commit that was cut off after the
+    // journal was written is finished when the storage is next created.
+    std::string m_strJournal;
+    std::mutex m_commitLock;
+
+    void RecoverBatch();
+    bool ReplayJournal(const std::string& strJournal);
+    bool RemoveJournal();
+
 protected:
     StorageFS(); // You have to use the factory to instantiate (so it can create
                  // the Packer also.)
@@ -1651,6 +1766,8 @@ protected:
                                    std::string twoStr = "",
                                    std::string threeStr = "");
 
+    virtual bool onCommitBatch(std::vector<BatchEntry>& theEntries);
+
 public:
     virtual bool Exists(std::string strFolder, std::string oneStr = "",
                         std::string twoStr = "", std::string threeStr = "");
@@ -1677,6 +1794,150 @@ public:
                      struct stat* pst = nullptr); // local to data_folder
 };
 
+// StorageKV means "Storage in a Key/Value file."
+//
+// Every value lives in ONE file in the data folder, keyed by the path
+// StorageFS would have used (relative to the data folder.) The file is an
+// append-only log of checksummed commit records, so a commit either lands
+// completely or (after a crash) not at all, and each commit is fsync'd.
+// A write batch (see Storage::BeginBatch) is a single commit, and commits
+// arriving from several threads at once share one fsync.
+// Only the index (key -> location of the latest value) is kept in memory.
+// Space taken by overwritten values is reclaimed when the file is opened,
+// or once commits have left too much of it.
+//
+// FormPathString still returns (and creates the folders for) a filesystem
+// path, for the few callers that need a real file. (zcert, for example.)
+//
+class StorageKV : public StorageFS
+{
+private:
+    struct Location
+    {
+        int64_t offset;
+        uint32_t size;
+    };
+
+    typedef std::map<std::string, Location> mapOfLocations;
+
+    // One change inside a commit record.
+    struct Change
+    {
+        std::string key;
+        std::string value;
+        bool erase;
+    };
+
+    // A commit waiting for its record to be written and synced.
+    struct PendingCommit
+    {
+        explicit PendingCommit(const std::vector<Change>& theChanges)
+            : changes(theChanges)
+            , done(false)
+            , success(false)
+        {
+        }
+
+        const std::vector<Change>& changes;
+        bool done;
+        bool success;
+    };
+
+    std::string m_strFilename;
+    std::FILE* m_pFile;
+    mapOfLocations m_mapIndex;
+    int64_t m_lFileSize;
+    int64_t m_lLiveBytes;
+    std::mutex m_lock;
+    // Group commit: whoever finds nobody syncing writes every queued commit.
+    std::vector<PendingCommit*> m_queue;
+    std::condition_variable m_commitDone;
+    bool m_bCommitting;
+
+protected:
+    StorageKV(); // Use the factory.
+
+    bool Open(bool bCompact = true);
+    void Close();
+    bool HasTooMuchGarbage() const;
+    bool Compact();
+    // Serializes theChanges into a record, and sets the offset of each value
+    // relative to the start of the record.
+    static void SerializeRecord(const std::vector<Change>& theChanges,
+                                std::string& strRecord,
+                                std::vector<int64_t>& theOffsets);
+    // Appends one commit record and syncs it to disk. Commits from other
+    // threads that arrive meanwhile are written and synced together. lock
+    // holds m_lock, and is released while syncing.
+    bool Commit(std::unique_lock<std::mutex>& lock,
+                const std::vector<Change>& theChanges);
+    bool ReadValue(const Location& theLocation, std::string& strOutput);
+
+    bool FormKey(std::string& strOutput, std::string strFolder,
+                 std::string oneStr, std::string twoStr, std::string threeStr);
+    bool StoreValue(const std::string& strValue, std::string strFolder,
+                    std::string oneStr, std::string twoStr,
+                    std::string threeStr);
+    bool QueryValue(std::string& strValue, std::string strFolder,
+                    std::string oneStr, std::string twoStr,
+                    std::string threeStr);
+
+    bool ImportFolder(std::unique_lock<std::mutex>& lock,
+                      const std::string& strPath, const std::string& strKey,
+                      int64_t& lCount);
+
+    virtual bool onCommitBatch(std::vector<BatchEntry>& theEntries);
+
+    virtual bool onStorePackedBuffer(PackedBuffer& theBuffer,
+                                     std::string strFolder,
+                                     std::string oneStr = "",
+                                     std::string twoStr = "",
+                                     std::string threeStr = "");
+
+    virtual bool onQueryPackedBuffer(PackedBuffer& theBuffer,
+                                     std::string strFolder,
+                                     std::string oneStr = "",
+                                     std::string twoStr = "",
+                                     std::string threeStr = "");
+
+    virtual bool onStorePlainString(std::string& theBuffer,
+                                    std::string strFolder,
+                                    std::string oneStr = "",
+                                    std::string twoStr = "",
+                                    std::string threeStr = "");
+
+    virtual bool onQueryPlainString(std::string& theBuffer,
+                                    std::string strFolder,
+                                    std::string oneStr = "",
+                                    std::string twoStr = "",
+                                    std::string threeStr = "");
+
+    virtual bool onEraseValueByKey(std::string strFolder,
+                                   std::string oneStr = "",
+                                   std::string twoStr = "",
+                                   std::string threeStr = "");
+
+public:
+    virtual bool Exists(std::string strFolder, std::string oneStr = "",
+                        std::string twoStr = "", std::string threeStr = "");
+
+    virtual int64_t FormPathString(std::string& strOutput,
+                                   std::string strFolder,
+                                   std::string oneStr = "",
+                                   std::string twoStr = "",
+                                   std::string threeStr = "");
+
+    // Returns nullptr if the file can't be opened.
+    static StorageKV* Instantiate();
+
+    virtual ~StorageKV();
+
+    // One-shot migration from the folder layout used by StorageFS. Copies
+    // every file under the data folder into a new store. Does nothing once
+    // that has finished, or if the store was already in use without it.
+    EXPORT bool ImportDataFolder();
+};
+
 } // namespace OTDB
 
 // IStorable-derived types...
@@ -342,7 +342,7 @@ same time that it is first being
  */
 
 class Ledger;
-class Tag;
+class XMLWriter;
 
 class OTTransaction : public OTTransactionType
 {
@@ -597,7 +597,7 @@ public:
     EXPORT bool DeleteBoxReceipt(Ledger& theLedger);
 
     // Call on abbreviated version, and pass in the purported full version.
-    bool VerifyBoxReceipt(OTTransaction& theFullVersion);
+    bool VerifyBoxReceipt(OTTransaction& theFullVersion) const;
 
     EXPORT bool VerifyBalanceReceipt(Nym& SERVER_NYM, Nym& THE_NYM);
 
@@ -637,12 +637,12 @@ public:
     // Because all of the actual receipts cannot fit into the single inbox
     // file, you must put their hash, and then store the receipt itself
     // separately...
-    void SaveAbbreviatedNymboxRecord(Tag& parent);
-    void SaveAbbreviatedOutboxRecord(Tag& parent);
-    void SaveAbbreviatedInboxRecord(Tag& parent);
-    void SaveAbbrevPaymentInboxRecord(Tag& parent);
-    void SaveAbbrevRecordBoxRecord(Tag& parent);
-    void SaveAbbrevExpiredBoxRecord(Tag& parent);
+    void SaveAbbreviatedNymboxRecord(XMLWriter& parent);
+    void SaveAbbreviatedOutboxRecord(XMLWriter& parent);
+    void SaveAbbreviatedInboxRecord(XMLWriter& parent);
+    void SaveAbbrevPaymentInboxRecord(XMLWriter& parent);
+    void SaveAbbrevRecordBoxRecord(XMLWriter& parent);
+    void SaveAbbrevExpiredBoxRecord(XMLWriter& parent);
     void ProduceInboxReportItem(Item& theBalanceItem);
     void ProduceOutboxReportItem(Item& theBalanceItem);
 
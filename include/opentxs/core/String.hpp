@@ -112,6 +112,8 @@ public:
     EXPORT bool operator==(const String& rhs) const;
 
     EXPORT static std::string& trim(std::string& str);
+    // Same as trim, in place. Doesn't copy if there's nothing to trim.
+    EXPORT void Trim();
     EXPORT static std::string replace_chars(const std::string& str,
                                             const std::string& charsFrom,
                                             const char& charTo);
@@ -43,10 +43,16 @@
 #define OPENTXS_CORE_CRON_OTCRON_HPP
 
 #include <opentxs/core/Contract.hpp>
+#include <opentxs/core/crypto/OTASCIIArmor.hpp>
 #include <opentxs/core/util/StringUtils.hpp>
 #include <opentxs/core/util/Assert.hpp>
 #include <opentxs/core/util/Timer.hpp>
 
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <vector>
+
 namespace opentxs
 {
 
@@ -61,6 +67,12 @@ class Nym;
 typedef std::map<int64_t, OTCronItem*> mapOfCronItems;
 typedef std::multimap<time64_t, OTCronItem*> multimapOfCronItems;
 
+// setOfCronDueDates: Transaction numbers, ordered by the date each cron item
+//                    is next due to process. (See OTCronItem::GetCronDueDate.)
+// mapOfCronDueDates: The same dates, mapped to transaction number.
+typedef std::set<std::pair<time64_t, int64_t>> setOfCronDueDates;
+typedef std::map<int64_t, time64_t> mapOfCronDueDates;
+
 // Mapped (uniquely) to market ID.
 typedef std::map<std::string, OTMarket*> mapOfMarkets;
 
@@ -77,12 +89,37 @@ private:
     mapOfMarkets m_mapMarkets;     // A list of all valid markets.
     mapOfCronItems m_mapCronItems; // Cron Items are found on both lists.
     multimapOfCronItems m_multimapCronItems;
+    setOfCronDueDates m_setDueDates; // Only due items are processed.
+    mapOfCronDueDates m_mapDueDates;
     Identifier m_NOTARY_ID; // Always store this in any object that's
                             // associated with a specific server.
 
     listOfLongNumbers m_listTransactionNumbers; // I can't put receipts in
                                                 // people's inboxes without a
                                                 // supply of these.
+    mutable std::mutex m_transactionLock; // Cron items processing in
+                                          // parallel all draw on the list.
+    std::mutex m_scheduleLock; // Items may be flagged (and rescheduled)
+                               // from any of those threads.
+    std::mutex m_saveLock;
+
+    // While a cron pass is running, items ask for Cron to be saved instead
+    // of saving it themselves. The pass saves it once, at the end.
+    std::atomic<bool> m_bProcessing;
+    std::atomic<bool> m_bNeedToSave;
+
+    // The encoded market list, as last returned, and the sum of the market
+    // versions (plus the number of markets) it was made from. Market queries
+    // may run at the same time, so they take m_marketListLock.
+    std::mutex m_marketListLock;
+    OTASCIIArmor m_ascMarketList;
+    int32_t m_nMarketListCount;
+    int64_t m_lMarketListVersion;
+
+    // A pass over the due items may be split over several calls to
+    // ProcessCronItems(). All of them use the time the pass started.
+    bool m_bInPass;
+    time64_t m_tPassTime;
 
     bool m_bIsActivated; // I don't want to start Cron processing until
                          // everything else is all loaded up and ready to go.
@@ -99,8 +136,21 @@ private:
                                              // items any given Nym can have
                                              // active at the same time.
 
+    static int32_t __cron_thread_count; // Number of threads processing
+                                        // independent cron items at once.
+
     static Timer tCron;
 
+    void UnscheduleCronItem(int64_t lTransactionNum);
+    void EraseDueDate(int64_t lTransactionNum);
+    void TakeDueItems(time64_t tNow, std::vector<OTCronItem*>& theItems,
+                      std::size_t nMaxItems);
+    void ProcessDueItems(const std::vector<OTCronItem*>& theItems,
+                         std::vector<int32_t>& theResults);
+    bool ProcessDueItem(OTCronItem& theItem, int32_t& nResult);
+    bool encodeMarketList(OTASCIIArmor& ascOutput, int32_t& nMarketCount);
+    int64_t getMarketListVersion() const;
+
 public:
     static int32_t GetCronMsBetweenProcess()
     {
@@ -127,6 +177,14 @@ public:
     {
         __cron_max_items_per_nym = nMax;
     }
+    static int32_t GetCronThreadCount()
+    {
+        return __cron_thread_count;
+    }
+    static void SetCronThreadCount(int32_t nCount)
+    {
+        __cron_thread_count = nCount;
+    }
     inline bool IsActivated() const
     {
         return m_bIsActivated;
@@ -152,6 +210,10 @@ public:
     EXPORT mapOfCronItems::iterator FindItemOnMap(int64_t lTransactionNum);
     EXPORT multimapOfCronItems::iterator FindItemOnMultimap(
         int64_t lTransactionNum);
+    // Works out when the item is next due to process, but no earlier than
+    // tNotBefore. (Called again whenever that might have changed.)
+    void ScheduleCronItem(OTCronItem& theItem,
+                          time64_t tNotBefore = OT_TIME_ZERO);
     // MARKETS
     //
     bool AddMarket(OTMarket& theMarket, bool bSaveMarketFile = true);
@@ -193,7 +255,9 @@ public:
     // within, since it will not
     // be replenished again at least until the call has finished.)
     //
-    EXPORT void ProcessCronItems();
+    // Processes at most nMaxItems (0 for no limit) and returns false if that
+    // left due items for the next call, which continues the same pass.
+    EXPORT bool ProcessCronItems(int32_t nMaxItems = 0);
 
     int64_t computeTimeout();
 
@@ -218,6 +282,9 @@ public:
 
     EXPORT bool LoadCron();
     EXPORT bool SaveCron();
+    // Cron items call this when they change. Saves Cron right away, or, in
+    // the middle of a cron pass, once the pass is done.
+    EXPORT void SaveCronLater();
 
     EXPORT OTCron();
     OTCron(const Identifier& NOTARY_ID);
@@ -45,6 +45,8 @@
 #include <opentxs/core/OTTrackable.hpp>
 
 #include <deque>
+#include <set>
+#include <string>
 
 namespace opentxs
 {
@@ -149,10 +151,8 @@ public:
     {
         return m_bRemovalFlag;
     }
-    inline void FlagForRemoval()
-    {
-        m_bRemovalFlag = true;
-    }
+    // Also tells Cron to process this item on its next round.
+    void FlagForRemoval();
     inline void SetCronPointer(OTCron& theCron)
     {
         m_pCron = &theCron;
@@ -224,6 +224,14 @@ public:
     virtual bool ProcessCron(); // OTCron calls this regularly, which is my
                                 // chance to expire, etc.
                                 // From OTTrackable (parent class of this)
+    // The earliest time ProcessCron() might have anything to do. OTCron won't
+    // call ProcessCron() before then. OT_TIME_ZERO means "right away."
+    virtual time64_t GetCronDueDate() const;
+    // Adds the IDs of the accounts, Nyms and markets that ProcessCron() may
+    // touch, so OTCron can process items that share none of them in
+    // parallel. Returns false if the item can't tell, in which case OTCron
+    // only processes it on its own.
+    virtual bool GetCronKeys(std::set<std::string>& keys) const;
     virtual ~OTCronItem();
 
     void InitCronItem();
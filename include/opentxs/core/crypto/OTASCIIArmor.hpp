@@ -153,10 +153,18 @@ public:
     // compress and Base64-encode
     EXPORT bool SetString(const String& theData, bool bLineBreaks = true);
 
+    // The same two, for data that isn't in an OTASCIIArmor (or a String) to
+    // begin with, such as a network frame.
+    EXPORT static bool DecodeString(const char* szArmored, size_t size,
+                                    std::string& strOutput);
+    EXPORT static bool EncodeString(const char* szData, size_t size,
+                                    std::string& strOutput,
+                                    bool bLineBreaks = true);
+
 private:
-    std::string compress_string(const std::string& str,
-                                int32_t compressionlevel) const;
-    std::string decompress_string(const std::string& str) const;
+    static std::string compress_string(const char* data, size_t size,
+                                       int32_t compressionlevel);
+    static std::string decompress_string(const char* data, size_t size);
 
     static std::unique_ptr<OTDB::OTPacker> s_pPacker;
 };
@@ -87,6 +87,11 @@ public:
                                     const OTPasswordData* pPWData = nullptr,
                                     const OTPassword* pImportPassword =
                                         nullptr); // CALLER must EVP_pkey_free!
+    // Public keys parsed by InstantiatePublicKey are shared, process-wide,
+    // between all the key objects with the same armored key. This drops the
+    // cache's references, before OpenSSL is cleaned up.
+    static void ReleasePublicKeyCache();
+
 private:
     // INSTANCES...
     // PRIVATE MEMBER DATA
@@ -0,0 +1,78 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_CRYPTO_OTBASE64_HPP
+#define OPENTXS_CORE_CRYPTO_OTBASE64_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace opentxs
+{
+
+// Table-driven base64 codec working on caller-provided buffers.
+//
+// Encoding matches OpenSSL's base64 BIO byte for byte: with line breaks, a
+// '\n' follows every 64 characters and the final (possibly short) line;
+// without them the output is a single run. Decoding accepts either form:
+// whitespace is skipped anywhere, '=' padding is optional, and any other
+// character outside the alphabet fails the decode.
+class OTBase64
+{
+public:
+    EXPORT static size_t EncodedSize(size_t inputSize, bool bLineBreaks);
+    // Returns the number of characters written. output must have room for
+    // EncodedSize() characters; no terminator is added.
+    EXPORT static size_t Encode(const uint8_t* input, size_t inputSize,
+                                char* output, bool bLineBreaks);
+
+    // Upper bound on the decoded size of inputSize characters.
+    EXPORT static size_t DecodedSizeMax(size_t inputSize);
+    // outputSize is the capacity of output on the way in, which must be at
+    // least DecodedSizeMax(inputSize), and the number of bytes written on the
+    // way out. Fails if the input isn't base64.
+    EXPORT static bool Decode(const char* input, size_t inputSize,
+                              uint8_t* output, size_t& outputSize);
+
+private:
+    OTBase64();
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_CRYPTO_OTBASE64_HPP
@@ -80,6 +80,8 @@ private:
     static const int32_t* sp_nSymmetricBufferSize;
     static const int32_t* sp_nPublicKeysize;
     static const int32_t* sp_nPublicKeysizeMax;
+    static const int32_t* sp_nSignatureCacheSize;
+    static const int32_t* sp_nPublicKeyCacheSize;
 
 public:
     EXPORT static uint32_t IterationCount();
@@ -90,6 +92,8 @@ public:
     EXPORT static uint32_t SymmetricBufferSize();
     EXPORT static uint32_t PublicKeysize();
     EXPORT static uint32_t PublicKeysizeMax();
+    EXPORT static uint32_t SignatureCacheSize();
+    EXPORT static uint32_t PublicKeyCacheSize();
 };
 
 // Sometimes I want to decrypt into an OTPassword (for encrypted symmetric
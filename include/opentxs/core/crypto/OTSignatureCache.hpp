@@ -0,0 +1,97 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_CRYPTO_OTSIGNATURECACHE_HPP
+#define OPENTXS_CORE_CRYPTO_OTSIGNATURECACHE_HPP
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace opentxs
+{
+
+// Bounded, thread-safe LRU set of signatures that already verified.
+//
+// Each entry is a digest that binds the signed contents, the public key, the
+// signature and the hash type together (see OTCrypto_OpenSSL). A contract
+// that is loaded and verified again with the same key and signature is then
+// accepted without another public key operation. Only successes are cached.
+// The process-wide instance holds OTCryptoConfig::SignatureCacheSize()
+// entries; a size of 0 disables it.
+class OTSignatureCache
+{
+public:
+    EXPORT static OTSignatureCache& It();
+
+    explicit OTSignatureCache(size_t capacity);
+
+    // Returns true if the digest is cached, and counts the hit or miss.
+    bool Check(const std::string& digest);
+    void Add(const std::string& digest);
+    void Clear();
+
+    size_t GetCapacity() const
+    {
+        return capacity_;
+    }
+    EXPORT size_t GetSize() const;
+    EXPORT int64_t GetHits() const;
+    EXPORT int64_t GetMisses() const;
+
+private:
+    OTSignatureCache(const OTSignatureCache&);
+    OTSignatureCache& operator=(const OTSignatureCache&);
+
+    typedef std::list<std::string> listOfDigests;
+    typedef std::unordered_map<std::string, listOfDigests::iterator>
+        mapOfDigests;
+
+    const size_t capacity_;
+    mutable std::mutex lock_;
+    listOfDigests lru_; // Most recently used at the front.
+    mapOfDigests entries_;
+    int64_t hits_;
+    int64_t misses_;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_CRYPTO_OTSIGNATURECACHE_HPP
@@ -305,6 +305,7 @@ public:
     // Return False if expired or otherwise should be removed.
     virtual bool ProcessCron(); // OTCron calls this regularly, which is my
                                 // chance to expire, etc.
+    virtual bool GetCronKeys(std::set<std::string>& keys) const;
 
     // From OTTrackable (parent class of OTCronItem, parent class of this)
     /*
@@ -44,9 +44,15 @@
 #ifndef OPENTXS_CORE_TRADE_OTMARKET_HPP
 #define OPENTXS_CORE_TRADE_OTMARKET_HPP
 
+#include "OTMarketCandles.hpp"
+#include "OTMarketJournal.hpp"
 #include "OTOffer.hpp"
+#include "OTOrderBook.hpp"
 #include <opentxs/core/cron/OTCron.hpp>
+#include <opentxs/core/crypto/OTASCIIArmor.hpp>
 #include <opentxs/core/OTStorage.hpp>
+#include <deque>
+#include <mutex>
 
 namespace opentxs
 {
@@ -56,13 +62,8 @@ class OTTrade;
 #define MAX_MARKET_QUERY_DEPTH                                                 \
     50 // todo add this to the ini file. (Now that we actually have one.)
 
-// Multiple offers, mapped by price limit.
-// Using multi-map since there will be more than one offer for each single
-// price.
-// (Map would only allow a single item on the map for each price.)
-typedef std::multimap<int64_t, OTOffer*> mapOfOffers;
-
-// The same offers are also mapped (uniquely) to transaction number.
+// The offers are mapped (uniquely) to transaction number, and also kept on
+// an order book for each side of the market, grouped by price.
 typedef std::map<int64_t, OTOffer*> mapOfOffersTrnsNum;
 
 class OTMarket : public Contract
@@ -75,8 +76,8 @@ private:
 
     OTDB::TradeListMarket* m_pTradeList;
 
-    mapOfOffers m_mapBids; // The buyers, ordered by price limit
-    mapOfOffers m_mapAsks; // The sellers, ordered by price limit
+    OTOrderBook m_bookBids; // The buyers, ordered by price limit
+    OTOrderBook m_bookAsks; // The sellers, ordered by price limit
 
     mapOfOffersTrnsNum m_mapOffers; // All of the offers on a single list,
                                     // ordered by transaction number.
@@ -102,6 +103,48 @@ private:
     int64_t m_lLastSalePrice;
     std::string m_strLastSaleDate;
 
+    // Changes since the market file was last saved. Every entry is numbered,
+    // and the market file remembers the last number it already includes.
+    OTMarketJournal m_journal;
+    int64_t m_lJournalSequence;
+
+    // An offer that changed, and the market version it changed in. The side
+    // and price are kept so a removed offer can still be reported.
+    struct OfferChange
+    {
+        int64_t lVersion;
+        int64_t lTransactionNum;
+        bool bBid;
+        int64_t lPriceLimit;
+    };
+
+    // The most recent changes, oldest first, and the version they start
+    // after. (So a delta can be given since any version from there on.)
+    std::deque<OfferChange> m_dequeChanges;
+    int64_t m_lChangesSince;
+    // The full-depth offer list has held the whole market at every version
+    // from this one on, so the changes can be applied to it.
+    int64_t m_lWholeListSince;
+
+    // Encoded replies to market-data queries, valid for m_lCacheVersion.
+    // Queries on the market may run at the same time (changes never do), so
+    // they take m_cacheLock to fill these in.
+    struct OfferListCache
+    {
+        OTASCIIArmor ascOffers;
+        int32_t nOfferCount;
+    };
+
+    std::mutex m_cacheLock;
+    int64_t m_lCacheVersion;
+    std::map<int64_t, OfferListCache> m_mapOfferLists; // By depth.
+    bool m_bRecentTradesCached;
+    OTASCIIArmor m_ascRecentTrades;
+    int32_t m_nRecentTradeCount;
+
+    // Candles for charting, updated as trades happen.
+    OTMarketCandles m_candles;
+
     // The server stores a map of markets, one for each unique combination of
     // instrument definitions.
     // That's what this market class represents: one instrument definition being
@@ -129,6 +172,31 @@ private:
                                 Account& p3, bool b3, const int64_t& a3,
                                 Account& p4, bool b4, const int64_t& a4);
 
+    bool loadOffer(const String& strOffer, time64_t tDateAdded);
+    bool removeOffer(const int64_t& lTransactionNum);
+    bool updateOffer(const int64_t& lTransactionNum, const String& strOffer);
+    void addRecentTrade(const int64_t& lTransactionNum, time64_t tDate,
+                        const int64_t& lPrice, const int64_t& lAmountSold);
+
+    bool encodeOfferList(OTASCIIArmor& ascOutput, int64_t lDepth,
+                         int32_t& nOfferCount);
+    bool encodeRecentTradeList(OTASCIIArmor& ascOutput, int32_t& nTradeCount);
+    void noteChange(const int64_t& lTransactionNum, bool bBid,
+                    const int64_t& lPriceLimit);
+    bool isWholeList() const;
+    void checkCache();
+
+    bool getFilePath(const char* szSubFolder, std::string& strPath) const;
+    bool openJournal(std::vector<std::string>& theEntries);
+    bool appendJournal(const std::string& strEntry);
+    bool signJournalEntry(const std::string& strEntry,
+                          std::string& strSignature);
+    bool verifyJournalEntry(const std::string& strEntry,
+                            const std::string& strSignature);
+    bool replayJournal(const std::vector<std::string>& theEntries);
+    bool openCandles();
+    bool replayEntry(const std::string& strEntry);
+
 public:
     bool ValidateOfferForMarket(OTOffer& theOffer, String* pReason = nullptr);
 
@@ -136,12 +204,37 @@ public:
     bool AddOffer(OTTrade* pTrade, OTOffer& theOffer, bool bSaveFile = true,
                   time64_t tDateAddedToMarket = OT_TIME_ZERO);
     bool RemoveOffer(const int64_t& lTransactionNum);
+    // Records an offer's new contents, such as after the server signs it.
+    bool SaveOffer(const OTOffer& theOffer);
     // returns general information about offers on the market
     EXPORT bool GetOfferList(OTASCIIArmor& ascOutput, int64_t lDepth,
                              int32_t& nOfferCount);
     EXPORT bool GetRecentTradeList(OTASCIIArmor& ascOutput,
                                    int32_t& nTradeCount);
 
+    // Goes up by at least one whenever the offers or recent trades change.
+    // It's saved with the market, so it keeps counting across restarts.
+    int64_t GetVersion() const
+    {
+        return m_lJournalSequence;
+    }
+    // True if applying the changes since lVersion to the offer list a client
+    // got then at lDepth gives the list it would get now. That's only so for
+    // a full-depth list (lDepth 0) that has held the whole market since then,
+    // and while those changes are still on hand.
+    bool HasChangesSince(int64_t lVersion, int64_t lDepth) const;
+    // The offers that changed since lVersion, packed like GetOfferList().
+    // A removed offer is listed with no assets available. This covers the
+    // whole market, so it fails unless HasChangesSince(lVersion, 0).
+    EXPORT bool GetOfferChanges(OTASCIIArmor& ascOutput, int64_t lVersion,
+                                int32_t& nOfferCount);
+    // The latest lDepth candles at strResolution ("1m", "1h" or "1d"), oldest
+    // first, one per line: "<start> <open> <high> <low> <close> <volume>".
+    // Prices are per scale, like the offers.
+    EXPORT bool GetCandles(const std::string& strResolution, int64_t lDepth,
+                           OTASCIIArmor& ascOutput,
+                           int32_t& nCandleCount) const;
+
     // Returns more detailed information about offers for a specific Nym.
     bool GetNym_OfferList(const Identifier& NYM_ID,
                           OTDB::OfferListNym& theOutputList,
@@ -160,13 +253,13 @@ public:
     int64_t GetHighestBidPrice();
     int64_t GetLowestAskPrice();
 
-    mapOfOffers::size_type GetBidCount()
+    OTOrderBook::size_type GetBidCount()
     {
-        return m_mapBids.size();
+        return m_bookBids.size();
     }
-    mapOfOffers::size_type GetAskCount()
+    OTOrderBook::size_type GetAskCount()
     {
-        return m_mapAsks.size();
+        return m_bookAsks.size();
     }
     void SetInstrumentDefinitionID(const Identifier& INSTRUMENT_DEFINITION_ID)
     {
@@ -220,6 +313,8 @@ public:
         return m_strLastSaleDate;
     }
     int64_t GetTotalAvailableAssets();
+    // Adds the account and Nym IDs of every trader with an offer here.
+    void GetTraderKeys(std::set<std::string>& keys) const;
     OTMarket();
     OTMarket(const char* szFilename);
     OTMarket(const Identifier& NOTARY_ID,
@@ -239,8 +334,14 @@ public:
     {
         return m_pCron;
     }
+    // Loads the market file, then replays the journal on top of it.
     bool LoadMarket();
+    // Saves the whole market to its file, and empties the journal.
     bool SaveMarket();
+    // Calls SaveMarket() once the journal holds more entries than the market
+    // has offers (and at least a few hundred), so the cost of saving the
+    // market is spread over the changes that led to it.
+    bool CompactJournal();
 
     void InitMarket();
 
@@ -0,0 +1,108 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+// Open/high/low/close/volume candles for a market's trades, at a few fixed
+// resolutions.
+
+#ifndef OPENTXS_CORE_TRADE_OTMARKETCANDLES_HPP
+#define OPENTXS_CORE_TRADE_OTMARKETCANDLES_HPP
+
+#include <opentxs/core/util/Common.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace opentxs
+{
+
+// Each resolution ("1m", "1h" and "1d") keeps a fixed number of candles in a
+// ring, where a candle's place is decided by its start time. The file holds
+// the rings one after another in fixed-size records, so recording a trade
+// rewrites only the records for the candles it falls in.
+//
+// Candles are informational, like the market's list of recent trades, so
+// they're flushed but not synced after every trade.
+class OTMarketCandles
+{
+public:
+    struct Candle
+    {
+        time64_t tStart;
+        int64_t lOpen;
+        int64_t lHigh;
+        int64_t lLow;
+        int64_t lClose;
+        int64_t lVolume; // Assets sold.
+    };
+
+    EXPORT OTMarketCandles();
+    EXPORT ~OTMarketCandles();
+
+    // Opens (or creates) the candles file at strPath and reads it in.
+    EXPORT bool Open(const std::string& strPath);
+    EXPORT void Close();
+
+    bool IsOpen() const
+    {
+        return nullptr != m_pFile;
+    }
+
+    // Adds a trade to its candle at every resolution. A trade older than the
+    // candles kept at some resolution is left out of that one.
+    EXPORT bool AddTrade(time64_t tDate, int64_t lPrice, int64_t lAmount);
+    // The latest lDepth candles at strResolution (all of them if lDepth is
+    // 0), oldest first. Fails if strResolution isn't one of those kept.
+    EXPORT bool GetCandles(const std::string& strResolution, int64_t lDepth,
+                           std::vector<Candle>& theCandles) const;
+
+private:
+    OTMarketCandles(const OTMarketCandles&);
+    OTMarketCandles& operator=(const OTMarketCandles&);
+
+    bool writeCandle(size_t nIndex);
+
+    std::string m_strPath;
+    std::FILE* m_pFile;
+    std::vector<Candle> m_vecCandles; // Every ring, in file order.
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_TRADE_OTMARKETCANDLES_HPP
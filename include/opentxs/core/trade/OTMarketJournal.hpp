@@ -0,0 +1,98 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+// An append-only log of the changes made to a market since its last snapshot.
+
+#ifndef OPENTXS_CORE_TRADE_OTMARKETJOURNAL_HPP
+#define OPENTXS_CORE_TRADE_OTMARKETJOURNAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace opentxs
+{
+
+// Each entry is a single line, written and synced to disk on its own, so
+// recording a change costs one small write no matter how large the market is.
+// If a write fails, the file is cut back to where the entry started. A line
+// that was only partly written when the server stopped is dropped (and cut
+// off the file) the next time the journal is opened.
+//
+// The market folds the journal back into its signed file from time to time,
+// and then calls Clear().
+class OTMarketJournal
+{
+public:
+    EXPORT OTMarketJournal();
+    EXPORT ~OTMarketJournal();
+
+    // Opens (or creates) the journal at strPath and reads back its entries.
+    EXPORT bool Open(const std::string& strPath,
+                     std::vector<std::string>& theEntries);
+    EXPORT void Close();
+
+    // strEntry must not contain a newline.
+    EXPORT bool Append(const std::string& strEntry);
+    // Empties the journal.
+    EXPORT bool Clear();
+
+    bool IsOpen() const
+    {
+        return m_nFile >= 0;
+    }
+    // Entries written since the journal was last cleared.
+    std::size_t GetCount() const
+    {
+        return m_nCount;
+    }
+
+private:
+    OTMarketJournal(const OTMarketJournal&);
+    OTMarketJournal& operator=(const OTMarketJournal&);
+
+    std::string m_strPath;
+    int m_nFile;
+    int64_t m_lSize; // Where the next entry goes.
+    std::size_t m_nCount;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_TRADE_OTMARKETJOURNAL_HPP
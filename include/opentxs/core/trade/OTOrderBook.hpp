@@ -0,0 +1,232 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+// One side of a market (the bids or the asks), grouped into price levels.
+
+#ifndef OPENTXS_CORE_TRADE_OTORDERBOOK_HPP
+#define OPENTXS_CORE_TRADE_OTORDERBOOK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace opentxs
+{
+
+class OTOffer;
+
+// Offers resting on one side of an OTMarket.
+//
+// Offers are grouped into price levels, ordered best price first (highest
+// for bids, lowest for asks.) Each level keeps its offers in the order they
+// arrived, along with the total amount they have available, so iterating the
+// book visits offers in price/time priority and the best price is always at
+// the front. The book doesn't own the offers; OTMarket does.
+//
+// Offers are linked into their level through nodes drawn from a pool owned by
+// the book, and indexed by transaction number, so adding and removing an offer
+// only costs the price level lookup.
+class OTOrderBook
+{
+private:
+    struct Level;
+
+    struct Node
+    {
+        OTOffer* offer;
+        int64_t amount; // What this offer contributes to the level quantity.
+        Level* level;
+        Node* prev;
+        Node* next;
+    };
+
+    struct Level
+    {
+        Level()
+            : price(0)
+            , quantity(0)
+            , count(0)
+            , head(nullptr)
+            , tail(nullptr)
+        {
+        }
+
+        int64_t price;
+        int64_t quantity; // Total amount available at this price.
+        std::size_t count;
+        Node* head; // First in line.
+        Node* tail; // Last in line.
+    };
+
+    struct PriceOrder
+    {
+        explicit PriceOrder(bool bBids)
+            : bids(bBids)
+        {
+        }
+
+        bool operator()(int64_t lhs, int64_t rhs) const
+        {
+            return bids ? (lhs > rhs) : (lhs < rhs);
+        }
+
+        bool bids;
+    };
+
+    typedef std::map<int64_t, Level, PriceOrder> mapOfLevels;
+    typedef std::unordered_map<int64_t, Node*> mapOfNodes;
+
+public:
+    typedef std::size_t size_type;
+
+    // Visits offers best price first, in arrival order within each price.
+    class const_iterator
+    {
+    public:
+        const_iterator(mapOfLevels::const_iterator level,
+                       mapOfLevels::const_iterator end)
+            : level_(level)
+            , end_(end)
+            , node_(level == end ? nullptr : level->second.head)
+        {
+        }
+
+        OTOffer* operator*() const
+        {
+            return node_->offer;
+        }
+
+        const_iterator& operator++();
+
+        bool operator==(const const_iterator& rhs) const
+        {
+            return node_ == rhs.node_;
+        }
+
+        bool operator!=(const const_iterator& rhs) const
+        {
+            return node_ != rhs.node_;
+        }
+
+        // Price and total available amount of the current offer's level.
+        int64_t GetLevelPrice() const
+        {
+            return level_->first;
+        }
+
+        int64_t GetLevelQuantity() const
+        {
+            return level_->second.quantity;
+        }
+
+        // Skips the rest of the current level.
+        void NextLevel();
+
+    private:
+        mapOfLevels::const_iterator level_;
+        mapOfLevels::const_iterator end_;
+        const Node* node_;
+    };
+
+    EXPORT explicit OTOrderBook(bool bBids);
+    EXPORT ~OTOrderBook();
+
+    // Puts the offer last in line at its price. Returns false if an offer
+    // with the same transaction number is already on the book.
+    EXPORT bool Add(OTOffer& theOffer);
+    // Returns the removed offer, or nullptr if it wasn't on the book.
+    EXPORT OTOffer* Remove(const int64_t& lTransactionNum);
+    // Call after an offer's available amount changes (after a trade.)
+    EXPORT void Update(const OTOffer& theOffer);
+    // Forgets every offer. (Doesn't delete them.)
+    EXPORT void Clear();
+
+    // Best price on the book, skipping market orders (which have a 0 price.)
+    // Returns 0 if there isn't one.
+    EXPORT int64_t GetBestPrice() const;
+    EXPORT int64_t GetQuantityAtPrice(const int64_t& lPrice) const;
+    int64_t GetTotalQuantity() const
+    {
+        return m_lTotalQuantity;
+    }
+    size_type GetLevelCount() const
+    {
+        return m_mapLevels.size();
+    }
+
+    size_type size() const
+    {
+        return m_mapNodes.size();
+    }
+
+    bool empty() const
+    {
+        return m_mapNodes.empty();
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(m_mapLevels.begin(), m_mapLevels.end());
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(m_mapLevels.end(), m_mapLevels.end());
+    }
+
+private:
+    OTOrderBook(const OTOrderBook&);
+    OTOrderBook& operator=(const OTOrderBook&);
+
+    Node* allocateNode();
+    void releaseNode(Node* pNode);
+
+private:
+    mapOfLevels m_mapLevels;
+    mapOfNodes m_mapNodes; // By transaction number.
+    int64_t m_lTotalQuantity;
+    std::vector<std::unique_ptr<Node[]>> m_vecPool;
+    Node* m_pFreeNodes;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_TRADE_OTORDERBOOK_HPP
@@ -195,6 +195,8 @@ public:
     EXPORT int64_t GetAssetAcctClosingNum() const;
     EXPORT int64_t GetCurrencyAcctClosingNum() const;
 
+    // The market the offer is on, which OTCron expands to every trader on it.
+    virtual bool GetCronKeys(std::set<std::string>& keys) const;
     // Return True if should stay on OTCron's list for more processing.
     // Return False if expired or otherwise should be removed.
     virtual bool ProcessCron(); // OTCron calls this regularly, which is my
@@ -75,6 +75,13 @@ OTTransaction* LoadBoxReceipt(OTTransaction& theAbbrev, Ledger& theLedger);
 EXPORT OTTransaction* LoadBoxReceipt(OTTransaction& theAbbrev,
                                      int64_t lLedgerType);
 
+// LoadBoxReceipt in two steps: read the raw receipt from storage, then
+// instantiate it and verify it against the abbreviated version.
+bool LoadBoxReceiptString(OTTransaction& theAbbrev, int64_t lLedgerType,
+                          String& strRawFile);
+OTTransaction* LoadBoxReceiptFromString(const OTTransaction& theAbbrev,
+                                        const String& strRawFile);
+
 bool SetupBoxReceiptFilename(int64_t lLedgerType, OTTransaction& theTransaction,
                              const char* szCaller, String& strFolder1name,
                              String& strFolder2name, String& strFolder3name,
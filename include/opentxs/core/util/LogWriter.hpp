@@ -0,0 +1,121 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_UTIL_LOGWRITER_HPP
+#define OPENTXS_CORE_UTIL_LOGWRITER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace opentxs
+{
+
+// Background writer for the log file.
+//
+// Any number of threads Push() lines into a bounded lock-free ring; a single
+// writer thread drains it in batches, echoes each batch to stderr, and
+// appends it to the log file, which stays open between batches. When the
+// file grows past the rotation size it is renamed to "<path>.1" (shifting
+// older files up to the rotation count) and a new one is started.
+//
+// Flush() drains the ring on the calling thread and flushes both outputs. Log
+// calls it before an assert reports, and the destructor calls it on shutdown.
+class LogWriter
+{
+public:
+    // capacity is rounded up to a power of two.
+    LogWriter(const std::string& strPath, size_t capacity);
+    ~LogWriter();
+
+    // Never blocks on I/O. If the ring is full, waits for the writer to
+    // make room.
+    void Push(std::string strLine);
+    void Flush();
+
+    // A size of 0 disables rotation.
+    void SetRotation(int64_t lMaxFileSize, int32_t nFileCount);
+
+    const std::string& GetPath() const
+    {
+        return m_strPath;
+    }
+
+private:
+    LogWriter(const LogWriter&);
+    LogWriter& operator=(const LogWriter&);
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        std::string line;
+    };
+
+    bool Pop(std::string& strLine);
+    // Caller must hold m_drainLock. Returns false if the ring was empty.
+    bool Drain();
+    void Write(const std::string& strBatch);
+    void Rotate();
+    void Run();
+
+    const std::string m_strPath;
+    const size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<size_t> m_enqueuePos;
+    size_t m_dequeuePos; // Only touched by whoever holds m_drainLock.
+
+    std::mutex m_drainLock; // Serializes the consumer side and the file.
+    std::ofstream m_file;
+    int64_t m_lFileSize;
+    std::atomic<int64_t> m_lMaxFileSize;
+    std::atomic<int32_t> m_nFileCount;
+
+    std::mutex m_wakeLock;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_bStopping;
+    std::thread m_thread;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_UTIL_LOGWRITER_HPP
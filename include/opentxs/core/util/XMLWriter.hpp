@@ -0,0 +1,110 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_UTIL_XMLWRITER_HPP
+#define OPENTXS_CORE_UTIL_XMLWRITER_HPP
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace opentxs
+{
+
+// Writes XML straight into a caller-owned buffer, in the same layout that
+// Tag::output() produces, without first building a tree of Tags.
+//
+// Elements are written as they are opened. Attributes are held only until
+// the element's start tag is written (by its first child, its text, or its
+// close()), and are then written sorted by name, like Tag does. An element
+// has either text or child elements, not both. Every open() must be matched
+// by a close().
+//
+//  std::string str_result;
+//  XMLWriter writer(str_result);
+//  writer.open("market");
+//  writer.add_attribute("version", "1.0");
+//  writer.add_tag("offer", ascOffer.Get());
+//  writer.close();
+//
+class XMLWriter
+{
+public:
+    // Appends to str_output, so a buffer can be reserved and reused.
+    explicit XMLWriter(std::string& str_output);
+
+    void open(const std::string& str_name);
+    void add_attribute(const std::string& str_att_name,
+                       const std::string& str_att_value);
+    void add_attribute(const std::string& str_att_name,
+                       const char* sz_att_value);
+    void set_text(const std::string& str_text);
+    void set_text(const char* sz_text);
+    // Writes a complete element that only contains text.
+    void add_tag(const std::string& str_tag_name,
+                 const std::string& str_tag_value);
+    void close();
+
+    size_t depth() const
+    {
+        return elements_.size();
+    }
+
+private:
+    XMLWriter(const XMLWriter&);
+    XMLWriter& operator=(const XMLWriter&);
+
+    struct Element
+    {
+        std::string name;
+        bool has_text;
+        bool has_content;
+    };
+
+    void start_content();
+    void write_start_tag();
+
+    std::string& output_;
+    std::vector<Element> elements_;
+    std::vector<std::pair<std::string, std::string>> attributes_;
+    bool pending_; // The innermost start tag hasn't been written yet.
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_UTIL_XMLWRITER_HPP
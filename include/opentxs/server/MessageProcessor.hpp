@@ -39,21 +39,41 @@
 #ifndef OPENTXS_SERVER_MESSAGEPROCESSOR_HPP
 #define OPENTXS_SERVER_MESSAGEPROCESSOR_HPP
 
+#include "ServerLocks.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
 #include <string>
 #include <memory>
+#include <thread>
+#include <vector>
 #include <czmq.h>
 
 // forward declare czmq types
 typedef struct _zsock_t zsock_t;
 typedef struct _zactor_t zactor_t;
 typedef struct _zpoller_t zpoller_t;
+typedef struct _zmsg_t zmsg_t;
+typedef struct _zframe_t zframe_t;
 
 namespace opentxs
 {
 
 class ServerLoader;
 class OTServer;
+class Message;
 
+// Client requests arrive on a ROUTER socket and are handed to a pool of
+// worker threads. Replies come back to the polling thread over an inproc
+// PULL socket, since only that thread may touch the ROUTER.
+//
+// Requests from the same Nym are handled one at a time, in the order they
+// arrived, through nymLocks_. The notary's shared state is guarded by
+// notaryLock_, which is taken after the Nym's turn (see ServerLocks.hpp.)
+// Cron runs on its own thread and takes the exclusive side of the lock, one
+// slice of its pass at a time.
 class MessageProcessor
 {
 public:
@@ -62,15 +82,45 @@ public:
     EXPORT void run();
 
 private:
+    // The routing envelope (identity and delimiter frames) of a request,
+    // plus the frame holding the request body. The body is read straight out
+    // of its frame, and the reply goes back out on the envelope.
+    struct Request
+    {
+        zmsg_t* envelope;
+        zframe_t* body;
+        uint64_t ticket; // (See NymLockTable.)
+    };
+
     void init(int port, zcert_t* transportKey);
-    bool processMessage(const std::string& messageString, std::string& reply);
+    void startThreads();
+    void stopThreads();
+    bool processMessage(const char* data, size_t size, uint64_t ticket,
+                        std::string& reply);
+    bool processCommand(Message& message, Message& reply, uint64_t ticket);
     void processSocket();
+    void processReply();
+    void workerLoop();
+    void cronLoop();
 
 private:
     OTServer* server_;
     zsock_t* zmqSocket_;
+    zsock_t* replySocket_;
     zactor_t* zmqAuth_;
     zpoller_t* zmqPoller_;
+
+    NotaryLock notaryLock_;
+    NymLockTable nymLocks_;
+
+    std::mutex queueMutex_;
+    std::condition_variable queueCondition_;
+    std::condition_variable cronCondition_;
+    std::deque<Request> queue_;
+    bool shutdown_;
+
+    std::vector<std::thread> workers_;
+    std::thread cronThread_;
 };
 
 } // namespace opentxs
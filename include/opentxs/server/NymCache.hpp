@@ -0,0 +1,183 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_SERVER_NYMCACHE_HPP
+#define OPENTXS_SERVER_NYMCACHE_HPP
+
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/String.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace opentxs
+{
+
+class OTServer;
+
+// Bounded LRU cache of verified server-side Nyms.
+//
+// A Nym whose credentials, signature and nymfile verified on an earlier
+// request is kept in memory, so later requests skip loading and verifying it.
+// Every request still starts from the last SAVED state of the nymfile, so
+// changes a command made without saving them are discarded, as before.
+//
+// For Nym-local commands (see UserCommandProcessor::IsNymLocalCommand)
+// nymfile saves are deferred: they only mark the entry dirty, and the cache
+// signs and writes it according to the flush policy. Other commands write
+// through, since they may load the same Nym from disk through other code
+// paths. All dirty entries are flushed before any exclusive command and
+// before cron runs. (See MessageProcessor.)
+class NymCache
+{
+public:
+    enum FlushPolicy {
+        FLUSH_SYNC,     // Write the nymfile when the request finishes.
+        FLUSH_GROUP,    // Write all dirty nymfiles once enough accumulate.
+        FLUSH_PERIODIC, // Write all dirty nymfiles every so often.
+    };
+
+    // Checks a Nym out of the cache for the duration of one request.
+    //
+    // On a hit, GetNym() returns the cached Nym and IsVerified() is true. On
+    // a miss, GetNym() returns a fresh Nym for the caller to load and verify,
+    // followed by SetVerified(). Unverified Nyms are discarded when the lease
+    // ends. With the cache disabled, GetNym() returns nullptr.
+    class Lease
+    {
+    public:
+        Lease(NymCache& cache, const String& nymID, bool bDeferSave);
+        ~Lease();
+
+        Nym* GetNym() const
+        {
+            return nym_;
+        }
+
+        bool IsVerified() const
+        {
+            return verified_;
+        }
+
+        void SetVerified();
+
+    private:
+        Lease(const Lease&);
+        Lease& operator=(const Lease&);
+
+        NymCache& cache_;
+        std::string nymID_;
+        Nym* nym_;
+        String* nymfile_;
+        bool verified_;
+    };
+
+    explicit NymCache(OTServer* server);
+    ~NymCache();
+
+    // Writes every dirty Nym that isn't checked out.
+    void Flush();
+    // Flushes if the periodic flush policy says it's time.
+    void FlushIfDue();
+    void Invalidate(const String& nymID);
+
+    int64_t GetHits() const;
+    int64_t GetMisses() const;
+
+private:
+    NymCache(const NymCache&);
+    NymCache& operator=(const NymCache&);
+
+    struct Entry
+    {
+        Entry()
+            : version(0)
+            , dirty(false)
+            , leased(false)
+            , stale(false)
+            , verified(false)
+        {
+        }
+
+        std::unique_ptr<Nym> nym;
+        String nymfile;  // Last saved state of the nymfile.
+        int64_t version; // Counts the changes to nymfile.
+        bool dirty;      // nymfile hasn't been written to disk yet.
+        bool leased;
+        bool stale; // Written by somebody else while checked out.
+        bool verified;
+        std::list<std::string>::iterator lru;
+    };
+
+    typedef std::map<std::string, Entry> mapOfEntries;
+
+    Nym* checkout(const std::string& nymID, bool bDeferSave,
+                  String*& nymfile, bool& bVerified);
+    void checkin(const std::string& nymID, bool bVerified);
+    void onNymfileSaved(const String& nymID);
+
+    // Signing and writing happen without mutex_, so other requests can check
+    // Nyms in and out meanwhile.
+    bool write(const std::string& nymID, const String& nymfile);
+    void write(const std::vector<std::string>& nymIDs);
+    void getDirty(std::vector<std::string>& nymIDs) const;
+    void evict(std::vector<std::string>& nymIDs);
+
+private:
+    OTServer* server_;
+    mutable std::mutex mutex_;
+    // Taken before mutex_. Writers take turns, so an older copy of a
+    // nymfile never lands on top of a newer one.
+    std::mutex writeMutex_;
+    mapOfEntries entries_;
+    std::list<std::string> lru_; // Most recently used at the front.
+    int32_t dirtyCount_;
+    std::chrono::steady_clock::time_point lastFlush_;
+    int64_t hits_;
+    int64_t misses_;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_SERVER_NYMCACHE_HPP
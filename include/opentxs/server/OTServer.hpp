@@ -43,6 +43,8 @@
 #include "Notary.hpp"
 #include "MainFile.hpp"
 #include "UserCommandProcessor.hpp"
+#include "NymCache.hpp"
+#include "ServerStats.hpp"
 #include <opentxs/core/util/Common.hpp>
 #include <opentxs/core/cron/OTCron.hpp>
 #include <opentxs/core/Nym.hpp>
@@ -82,7 +84,9 @@ public:
     const Nym& GetServerNym() const;
 
     EXPORT void ActivateCron();
-    void ProcessCron();
+    // Processes at most nMaxItems of the due cron items (0 for all of them.)
+    // Returns false if some are still due; the next call continues the pass.
+    bool ProcessCron(int32_t nMaxItems = 0);
     int64_t computeTimeout()
     {
         return m_Cron.computeTimeout();
@@ -130,6 +134,11 @@ private:
     Nym m_nymServer;
 
     OTCron m_Cron; // This is where re-occurring and expiring tasks go.
+
+    ServerStats stats_;
+
+    // Declared last so it's destroyed (and flushed) before the server Nym.
+    NymCache nymCache_;
 };
 
 } // namespace opentxs
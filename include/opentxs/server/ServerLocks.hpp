@@ -0,0 +1,191 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_SERVER_SERVERLOCKS_HPP
+#define OPENTXS_SERVER_SERVERLOCKS_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace opentxs
+{
+
+// Readers/writer lock guarding the notary's shared state (accounts, boxes,
+// cron, markets, the transaction number counter.)
+//
+// Commands that only touch the sending Nym's own files run under the shared
+// side, everything else (including cron) takes the exclusive side. The lock
+// prefers writers: once an exclusive locker is waiting, no new shared lockers
+// get in.
+//
+// Cron takes the exclusive side one slice of its pass at a time, as a
+// priority locker: it goes ahead of the other exclusive lockers, so client
+// traffic can't starve it. In return, whoever was waiting when it unlocked
+// gets in before it locks again, so a long pass can't starve the clients.
+class NotaryLock
+{
+public:
+    NotaryLock();
+
+    void lockShared();
+    void unlockShared();
+    void lockExclusive(bool bPriority = false);
+    void unlockExclusive();
+
+private:
+    NotaryLock(const NotaryLock&);
+    NotaryLock& operator=(const NotaryLock&);
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    int32_t readers_;
+    int32_t readersWaiting_;
+    int32_t writersWaiting_;
+    int32_t priorityWaiting_;
+    bool writer_;
+    bool priority_; // The writer is a priority locker.
+    bool yielding_; // A priority locker is letting the others in first.
+};
+
+// Serializes requests from the same NymID, in the order they arrived, so the
+// request number and nymfile stay consistent, while unrelated Nyms proceed
+// in parallel.
+//
+// Each request takes a ticket when it is queued. The NymID is only known
+// once a worker has parsed the request, so requests join their Nym's line in
+// ticket order (waiting until the ones ahead of them have joined theirs),
+// and then wait for their turn. A request that never gets as far as its
+// NymID must still skip() its ticket.
+class NymLockTable
+{
+public:
+    NymLockTable();
+
+    uint64_t takeTicket();
+    void lock(uint64_t ticket, const std::string& nymID);
+    void unlock(const std::string& nymID);
+    void skip(uint64_t ticket);
+
+private:
+    NymLockTable(const NymLockTable&);
+    NymLockTable& operator=(const NymLockTable&);
+
+    void waitToJoin(std::unique_lock<std::mutex>& lock, uint64_t ticket);
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    uint64_t nextTicket_;
+    uint64_t nextToJoin_;
+    // The tickets waiting for each Nym. The first one holds the lock.
+    std::map<std::string, std::deque<uint64_t>> lines_;
+};
+
+// Scoped helpers, in the style of std::lock_guard.
+
+class SharedNotaryLock
+{
+public:
+    explicit SharedNotaryLock(NotaryLock& lock)
+        : lock_(lock)
+    {
+        lock_.lockShared();
+    }
+
+    ~SharedNotaryLock()
+    {
+        lock_.unlockShared();
+    }
+
+private:
+    SharedNotaryLock(const SharedNotaryLock&);
+    SharedNotaryLock& operator=(const SharedNotaryLock&);
+
+    NotaryLock& lock_;
+};
+
+class ExclusiveNotaryLock
+{
+public:
+    explicit ExclusiveNotaryLock(NotaryLock& lock, bool bPriority = false)
+        : lock_(lock)
+    {
+        lock_.lockExclusive(bPriority);
+    }
+
+    ~ExclusiveNotaryLock()
+    {
+        lock_.unlockExclusive();
+    }
+
+private:
+    ExclusiveNotaryLock(const ExclusiveNotaryLock&);
+    ExclusiveNotaryLock& operator=(const ExclusiveNotaryLock&);
+
+    NotaryLock& lock_;
+};
+
+class NymGuard
+{
+public:
+    NymGuard(NymLockTable& table, uint64_t ticket, const std::string& nymID)
+        : table_(table)
+        , nymID_(nymID)
+    {
+        table_.lock(ticket, nymID_);
+    }
+
+    ~NymGuard()
+    {
+        table_.unlock(nymID_);
+    }
+
+private:
+    NymGuard(const NymGuard&);
+    NymGuard& operator=(const NymGuard&);
+
+    NymLockTable& table_;
+    const std::string nymID_;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_SERVER_SERVERLOCKS_HPP
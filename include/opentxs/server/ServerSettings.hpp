@@ -77,6 +77,86 @@ struct ServerSettings
         __heartbeat_ms_between_beats = value;
     }
 
+    static int32_t GetWorkerThreads()
+    {
+        return __worker_threads;
+    }
+
+    static void SetWorkerThreads(int32_t value)
+    {
+        __worker_threads = value;
+    }
+
+    static int32_t GetNymCacheSize()
+    {
+        return __nym_cache_size;
+    }
+
+    static void SetNymCacheSize(int32_t value)
+    {
+        __nym_cache_size = value;
+    }
+
+    static int32_t GetNymCacheFlushPolicy()
+    {
+        return __nym_cache_flush_policy;
+    }
+
+    static void SetNymCacheFlushPolicy(int32_t value)
+    {
+        __nym_cache_flush_policy = value;
+    }
+
+    static int32_t GetNymCacheGroupSize()
+    {
+        return __nym_cache_group_size;
+    }
+
+    static void SetNymCacheGroupSize(int32_t value)
+    {
+        __nym_cache_group_size = value;
+    }
+
+    static int32_t GetNymCacheFlushMs()
+    {
+        return __nym_cache_flush_ms;
+    }
+
+    static void SetNymCacheFlushMs(int32_t value)
+    {
+        __nym_cache_flush_ms = value;
+    }
+
+    static int32_t GetStatsSnapshotSeconds()
+    {
+        return __stats_snapshot_seconds;
+    }
+
+    static void SetStatsSnapshotSeconds(int32_t value)
+    {
+        __stats_snapshot_seconds = value;
+    }
+
+    static int32_t GetStorageType()
+    {
+        return __storage_type;
+    }
+
+    static void SetStorageType(int32_t value)
+    {
+        __storage_type = value;
+    }
+
+    static bool GetStorageImport()
+    {
+        return __storage_import;
+    }
+
+    static void SetStorageImport(bool value)
+    {
+        __storage_import = value;
+    }
+
     static const std::string& GetOverrideNymID()
     {
         return __override_nym_id;
@@ -92,6 +172,26 @@ struct ServerSettings
     static int32_t __heartbeat_no_requests;
     static int32_t __heartbeat_ms_between_beats;
 
+    // Number of threads processing client requests. (0 means one per core.)
+    static int32_t __worker_threads;
+
+    // Max number of verified Nyms kept in memory. (0 disables the cache.)
+    static int32_t __nym_cache_size;
+    // When deferred nymfile saves are written. (See NymCache::FlushPolicy.)
+    static int32_t __nym_cache_flush_policy;
+    // FLUSH_GROUP: number of dirty nymfiles written together.
+    static int32_t __nym_cache_group_size;
+    // FLUSH_PERIODIC: number of ms between flushes.
+    static int32_t __nym_cache_flush_ms;
+
+    // Seconds between writes of stats.xml. (0 disables it.)
+    static int32_t __stats_snapshot_seconds;
+
+    // Where the server keeps its data. (See OTDB::StorageType.)
+    static int32_t __storage_type;
+    // Copy the data folder into an empty key/value store at startup.
+    static bool __storage_import;
+
     // The Nym who's allowed to do certain commands even if they are turned off.
     static std::string __override_nym_id;
     // Are usage credits REQUIRED in order to use this server?
@@ -139,6 +239,7 @@ struct ServerSettings
     static bool __cmd_get_market_list;
     static bool __cmd_get_market_offers;
     static bool __cmd_get_market_recent_trades;
+    static bool __cmd_get_market_candles;
     static bool __cmd_get_nym_market_offers;
 
     static bool __transact_market_offer;
@@ -146,6 +247,8 @@ struct ServerSettings
     static bool __transact_cancel_cron_item;
     static bool __transact_smart_contract;
     static bool __cmd_trigger_clause;
+    // Off by default. (The override Nym can still use it.)
+    static bool __cmd_get_server_stats;
 };
 
 } // namespace opentxs
@@ -0,0 +1,179 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_SERVER_SERVERSTATS_HPP
+#define OPENTXS_SERVER_SERVERSTATS_HPP
+
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/util/Common.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace opentxs
+{
+
+// Request counts, error counts and latency histograms per server command.
+//
+// A Request times one client request on the worker thread handling it. A
+// Timer further down the call chain charges its time to the phase it names
+// instead of to the phase that was running, so every phase gets its own
+// time and the phases add up to the total. Timers outside of a Request
+// (cron, startup) do nothing.
+//
+// The override Nym can fetch the numbers with getServerStats, and they are
+// written to stats.xml in the data folder every
+// ServerSettings::GetStatsSnapshotSeconds() seconds.
+class ServerStats
+{
+public:
+    enum Phase {
+        PHASE_PARSE,    // De-armoring and parsing the request.
+        PHASE_NYM_LOAD, // Loading and verifying the Nym.
+        PHASE_VERIFY,   // Verifying the signature on the request.
+        PHASE_PROCESS,  // The command itself.
+        PHASE_SAVE,     // Writing nymfiles.
+        PHASE_SIGN,     // Signing and encoding the reply.
+        PHASE_COUNT
+    };
+
+    // Latencies in microseconds. Bucket 0 counts those under 2us and bucket
+    // n those from 2^n up to 2^(n+1). The last bucket counts everything
+    // longer.
+    class Histogram
+    {
+    public:
+        static const int32_t BUCKETS = 26;
+
+        Histogram();
+
+        void Add(int64_t lMicroseconds);
+
+        int64_t count_;
+        int64_t total_;
+        int64_t max_;
+        int64_t buckets_[BUCKETS];
+    };
+
+    class Request
+    {
+    public:
+        explicit Request(ServerStats& stats);
+        ~Request();
+
+        // Requests that never get a command are counted as "unknown".
+        void SetCommand(const String& strCommand);
+        void SetFailed();
+
+    private:
+        friend class ServerStats;
+
+        Request(const Request&);
+        Request& operator=(const Request&);
+
+        // Charges the time since the last switch to the running phase.
+        void switchTo(Phase phase);
+
+        ServerStats& stats_;
+        Request* previous_;
+        std::string command_;
+        bool failed_;
+        Phase phase_;
+        std::chrono::steady_clock::time_point start_;
+        std::chrono::steady_clock::time_point mark_;
+        std::chrono::steady_clock::duration phases_[PHASE_COUNT];
+    };
+
+    class Timer
+    {
+    public:
+        explicit Timer(Phase phase);
+        ~Timer();
+
+    private:
+        Timer(const Timer&);
+        Timer& operator=(const Timer&);
+
+        Request* request_;
+        Phase previous_;
+    };
+
+    ServerStats();
+
+    static const char* PhaseName(Phase phase);
+
+    // The numbers so far, as XML.
+    void Snapshot(String& strOutput) const;
+    // Writes the snapshot file if it's due. (Called from the cron thread.)
+    void SaveIfDue();
+
+private:
+    ServerStats(const ServerStats&);
+    ServerStats& operator=(const ServerStats&);
+
+    struct Command
+    {
+        Command()
+            : requests(0)
+            , errors(0)
+        {
+        }
+
+        int64_t requests;
+        int64_t errors;
+        Histogram total;
+        Histogram phases[PHASE_COUNT];
+    };
+
+    typedef std::map<std::string, Command> mapOfCommands;
+
+    void record(const Request& request);
+
+private:
+    mutable std::mutex mutex_;
+    mapOfCommands commands_;
+    time64_t started_;
+    std::chrono::steady_clock::time_point lastSave_;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_SERVER_SERVERSTATS_HPP
@@ -49,6 +49,7 @@ class Nym;
 class OTServer;
 class Identifier;
 class ClientConnection;
+class Ledger;
 
 class UserCommandProcessor
 {
@@ -58,6 +59,8 @@ public:
     bool ProcessUserCommand(Message& msgIn, Message& msgOut,
                             ClientConnection* connection, Nym* nym);
 
+    static bool IsNymLocalCommand(const String& command);
+
 private:
     bool SendMessageToNym(const Identifier& notaryID,
                           const Identifier& senderNymID,
@@ -82,11 +85,14 @@ private:
     void UserCmdRegisterInstrumentDefinition(Nym& nym, Message& msgIn,
                                              Message& msgOut);
     void UserCmdIssueBasket(Nym& nym, Message& msgIn, Message& msgOut);
+    bool LoadBoxForReceipts(const Message& msgIn, Ledger& box);
     void UserCmdGetBoxReceipt(Message& msgIn, Message& msgOut);
+    void UserCmdGetBoxReceipts(Message& msgIn, Message& msgOut);
     void UserCmdDeleteUser(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdDeleteAssetAcct(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdRegisterAccount(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdNotarizeTransaction(Nym& nym, Message& msgIn, Message& msgOut);
+    void RejectTransactionReplies(Ledger& responseLedger);
     void UserCmdGetNymbox(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdGetAccountData(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdGetInstrumentDefinition(Message& msgIn, Message& msgOut);
@@ -95,6 +101,7 @@ private:
     void UserCmdProcessNymbox(Nym& nym, Message& msgIn, Message& msgOut);
 
     void UserCmdUsageCredits(Nym& nym, Message& msgIn, Message& msgOut);
+    void UserCmdGetServerStats(Message& msgIn, Message& msgOut);
     void UserCmdTriggerClause(Nym& nym, Message& msgIn, Message& msgOut);
 
     void UserCmdQueryInstrumentDefinitions(Nym& nym, Message& msgIn,
@@ -110,6 +117,9 @@ private:
     void UserCmdGetMarketRecentTrades(Nym& nym, Message& msgIn,
                                       Message& msgOut);
 
+    // Get price candles (for charts) for a specific market.
+    void UserCmdGetMarketCandles(Nym& nym, Message& msgIn, Message& msgOut);
+
     // Get the offers that a specific Nym has placed on a specific market.
     void UserCmdGetNymMarketOffers(Nym& nym, Message& msgIn, Message& msgOut);
 
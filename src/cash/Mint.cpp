@@ -56,6 +56,9 @@
 namespace opentxs
 {
 
+int32_t Mint::__token_thread_count = 1; // Threads signing or verifying tokens
+                                        // at the same time.
+
 // static
 Mint* Mint::MintFactory()
 {
@@ -873,4 +876,32 @@ void Mint::GenerateNewMint(int32_t nSeries, time64_t VALID_FROM,
     }
 }
 
+// Cash algorithms that can't do better just sign them one at a time.
+bool Mint::SignTokens(Nym& theNotary, const std::vector<Token*>& theTokens,
+                      std::vector<String>& theOutputs, int32_t nTokenIndex)
+{
+    theOutputs.assign(theTokens.size(), String());
+
+    for (size_t i = 0; i < theTokens.size(); ++i) {
+        if (!SignToken(theNotary, *theTokens[i], theOutputs[i], nTokenIndex))
+            return false;
+    }
+
+    return true;
+}
+
+bool Mint::VerifyTokens(Nym& theNotary, std::vector<String>& theCleartextTokens,
+                        const std::vector<int64_t>& theDenominations)
+{
+    OT_ASSERT(theCleartextTokens.size() == theDenominations.size());
+
+    for (size_t i = 0; i < theCleartextTokens.size(); ++i) {
+        if (!VerifyToken(theNotary, theCleartextTokens[i],
+                         theDenominations[i]))
+            return false;
+    }
+
+    return true;
+}
+
 } // namespace opentxs
@@ -52,6 +52,13 @@
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Nym.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread>
+
 #ifdef __APPLE__
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #endif
@@ -192,107 +199,217 @@ bool MintLucre::AddDenomination(Nym& theNotary, int64_t lDenomination,
 
 #if defined(OT_CRYPTO_USING_OPENSSL)
 
-// Lucre step 3: the mint signs the token
-//
-bool MintLucre::SignToken(Nym& theNotary, Token& theToken, String& theOutput,
-                          int32_t nTokenIndex)
+namespace
 {
-    bool bReturnValue = false;
 
-    LucreDumper setDumper;
-
-    OpenSSL_BIO bioBank = BIO_new(BIO_s_mem());      // input
-    OpenSSL_BIO bioRequest = BIO_new(BIO_s_mem());   // input
-    OpenSSL_BIO bioSignature = BIO_new(BIO_s_mem()); // output
+typedef std::map<int64_t, String> mapOfPrivateBanks;
 
+// The Mint private info is encrypted in m_mapPrivate[lDenomination].
+// So I need to extract that first before I can use it.
+bool OpenPrivateBank(Mint& theMint, Nym& theNotary, int64_t lDenomination,
+                     String& strContents)
+{
     OTASCIIArmor thePrivate;
-    GetPrivate(thePrivate, theToken.GetDenomination());
-
-    // The Mint private info is encrypted in
-    // m_mapPrivates[theToken.GetDenomination()].
-    // So I need to extract that first before I can use it.
+    theMint.GetPrivate(thePrivate, lDenomination);
     OTEnvelope theEnvelope(thePrivate);
 
-    String strContents; // output from opening the envelope.
     // Decrypt the Envelope into strContents
-    if (!theEnvelope.Open(theNotary, strContents)) return false;
+    return theEnvelope.Open(theNotary, strContents);
+}
+
+// Instantiate the Bank with its private key
+Bank* LoadBank(const String& strContents)
+{
+    OpenSSL_BIO bioBank = BIO_new(BIO_s_mem()); // input
 
     // copy strContents to a BIO
     BIO_puts(bioBank, strContents.Get());
 
-    // Instantiate the Bank with its private key
-    Bank bank(bioBank);
+    return new Bank(bioBank);
+}
+
+// Signs the prototoken with a bank that's already loaded. The signature goes
+// into theOutput; the caller still has to set the series on the token.
+bool SignPrototoken(Bank& bank, Token& theToken, String& theOutput,
+                    int32_t nTokenIndex)
+{
+    OpenSSL_BIO bioRequest = BIO_new(BIO_s_mem());   // input
+    OpenSSL_BIO bioSignature = BIO_new(BIO_s_mem()); // output
 
     // I need the request. the prototoken.
     OTASCIIArmor ascPrototoken;
-    bool bFoundToken = theToken.GetPrototoken(ascPrototoken, nTokenIndex);
+    if (!theToken.GetPrototoken(ascPrototoken, nTokenIndex)) return false;
 
-    if (bFoundToken) {
-        // base64-Decode the prototoken
-        String strPrototoken(ascPrototoken);
+    // base64-Decode the prototoken
+    String strPrototoken(ascPrototoken);
 
-        // copy strPrototoken to a BIO
-        BIO_puts(bioRequest, strPrototoken.Get());
+    // copy strPrototoken to a BIO
+    BIO_puts(bioRequest, strPrototoken.Get());
 
-        // Load up the coin request from the bio (the prototoken)
-        PublicCoinRequest req(bioRequest);
+    // Load up the coin request from the bio (the prototoken)
+    PublicCoinRequest req(bioRequest);
 
-        // Sign it with the bank we previously instantiated.
-        // results will be in bnSignature (BIGNUM)
-        BIGNUM* bnSignature = bank.SignRequest(req);
+    // Sign it with the bank we previously instantiated.
+    // results will be in bnSignature (BIGNUM)
+    BIGNUM* bnSignature = bank.SignRequest(req);
 
-        if (nullptr == bnSignature) {
-            otErr << "MAJOR ERROR!: Bank.SignRequest failed in "
-                     "MintLucre::SignToken\n";
-        }
-        else {
-
-            // Write the request contents, followed by the signature contents,
-            // to the Signature bio. Then free the BIGNUM.
-            req.WriteBIO(bioSignature); // the original request contents
-            DumpNumber(bioSignature, "signature=",
-                       bnSignature); // the new signature contents
-            BN_free(bnSignature);
-
-            // Read the signature bio into a C-style buffer...
-            char sig_buf[1024]; // todo stop hardcoding these string lengths
-
-            int32_t sig_len = BIO_read(bioSignature, sig_buf,
-                                       1000); // cutting it a little short on
-                                              // purpose, with the buffer. Just
-                                              // makes me feel more comfortable
-                                              // for some reason.
-
-            // Add the null terminator by hand (just in case.)
-            sig_buf[sig_len] = '\0';
-
-            if (sig_len) {
-                // Copy the original coin request into the spendable field of
-                // the token object.
-                // (It won't actually be spendable until the client processes
-                // it, though.)
-                theToken.SetSpendable(ascPrototoken);
-
-                // Base64-encode the signature contents into
-                // theToken.m_Signature.
-                String strSignature(sig_buf);
-
-                // Here we pass the signature back to the caller.
-                // He will probably set it onto the token.
-                theOutput.Set(sig_buf, sig_len);
-                bReturnValue = true;
-
-                // This is also where we set the expiration date on the token.
-                // The client should have already done this, but we are
-                // explicitly
-                // setting the values here to prevent any funny business.
-                theToken.SetSeriesAndExpiration(m_nSeries, m_VALID_FROM,
-                                                m_VALID_TO);
+    if (nullptr == bnSignature) {
+        otErr << "MAJOR ERROR!: Bank.SignRequest failed in "
+                 "MintLucre::SignToken\n";
+        return false;
+    }
+
+    // Write the request contents, followed by the signature contents,
+    // to the Signature bio. Then free the BIGNUM.
+    req.WriteBIO(bioSignature); // the original request contents
+    DumpNumber(bioSignature, "signature=",
+               bnSignature); // the new signature contents
+    BN_free(bnSignature);
+
+    // Read the signature bio into a C-style buffer...
+    char sig_buf[1024]; // todo stop hardcoding these string lengths
+
+    int32_t sig_len =
+        BIO_read(bioSignature, sig_buf, 1000); // cutting it a little short on
+                                               // purpose, with the buffer.
+
+    if (sig_len <= 0) return false;
+
+    // Add the null terminator by hand (just in case.)
+    sig_buf[sig_len] = '\0';
+
+    // Copy the original coin request into the spendable field of the token
+    // object. (It won't actually be spendable until the client processes it,
+    // though.)
+    theToken.SetSpendable(ascPrototoken);
+
+    // Here we pass the signature back to the caller.
+    // He will probably set it onto the token.
+    theOutput.Set(sig_buf, sig_len);
+
+    return true;
+}
+
+bool VerifyCoin(Bank& bank, const String& theCleartextToken)
+{
+    OpenSSL_BIO bioCoin = BIO_new(BIO_s_mem()); // input
+
+    // --- copy theCleartextToken to bioCoin so lucre can load it
+    BIO_puts(bioCoin, theCleartextToken.Get());
+
+    Coin coin(bioCoin);
+
+    // Here's the boolean output: coin is verified!
+    return bank.Verify(coin);
+}
+
+// Calls fnToken(bank, i) for each i below nCount, spread over up to
+// Mint::GetTokenThreadCount() threads. Every thread loads its own Bank for
+// each denomination it meets, so no Lucre object is shared between threads.
+// Stops at the first failure.
+bool ForEachToken(size_t nCount, const mapOfPrivateBanks& thePrivateBanks,
+                  const std::function<int64_t(size_t)>& fnDenomination,
+                  const std::function<bool(Bank&, size_t)>& fnToken)
+{
+    std::atomic<size_t> nNext(0);
+    std::atomic<bool> bFailed(false);
+
+    auto processTokens = [&]() {
+        std::map<int64_t, std::unique_ptr<Bank>> theBanks;
+
+        for (size_t i = nNext++; (i < nCount) && !bFailed; i = nNext++) {
+            const int64_t lDenomination = fnDenomination(i);
+            std::unique_ptr<Bank>& pBank = theBanks[lDenomination];
+
+            if (!pBank) {
+                auto it = thePrivateBanks.find(lDenomination);
+                OT_ASSERT(thePrivateBanks.end() != it);
+                pBank.reset(LoadBank(it->second));
             }
+
+            if (!fnToken(*pBank, i)) bFailed = true;
         }
+    };
+
+    const size_t nThreads = std::min(
+        static_cast<size_t>(std::max(Mint::GetTokenThreadCount(), 1)), nCount);
+
+    if (nThreads > 1) {
+        std::vector<std::thread> vecThreads;
+
+        for (size_t i = 1; i < nThreads; ++i)
+            vecThreads.push_back(std::thread(processTokens));
+
+        processTokens();
+
+        for (auto& theThread : vecThreads) theThread.join();
     }
+    else
+        processTokens();
 
-    return bReturnValue;
+    return !bFailed;
+}
+
+} // namespace
+
+// Lucre step 3: the mint signs the token
+//
+bool MintLucre::SignToken(Nym& theNotary, Token& theToken, String& theOutput,
+                          int32_t nTokenIndex)
+{
+    LucreDumper setDumper;
+
+    String strContents; // output from opening the envelope.
+    if (!OpenPrivateBank(*this, theNotary, theToken.GetDenomination(),
+                         strContents))
+        return false;
+
+    std::unique_ptr<Bank> pBank(LoadBank(strContents));
+
+    if (!SignPrototoken(*pBank, theToken, theOutput, nTokenIndex))
+        return false;
+
+    // This is also where we set the expiration date on the token.
+    // The client should have already done this, but we are explicitly
+    // setting the values here to prevent any funny business.
+    theToken.SetSeriesAndExpiration(m_nSeries, m_VALID_FROM, m_VALID_TO);
+
+    return true;
+}
+
+// Each denomination's private key is opened once, on this thread, rather
+// than once per token.
+bool MintLucre::SignTokens(Nym& theNotary, const std::vector<Token*>& theTokens,
+                           std::vector<String>& theOutputs, int32_t nTokenIndex)
+{
+    LucreDumper setDumper;
+
+    theOutputs.assign(theTokens.size(), String());
+
+    mapOfPrivateBanks thePrivateBanks;
+
+    for (auto& pToken : theTokens) {
+        const int64_t lDenomination = pToken->GetDenomination();
+
+        if ((0 == thePrivateBanks.count(lDenomination)) &&
+            !OpenPrivateBank(*this, theNotary, lDenomination,
+                             thePrivateBanks[lDenomination]))
+            return false;
+    }
+
+    return ForEachToken(
+        theTokens.size(), thePrivateBanks,
+        [&](size_t i) { return theTokens[i]->GetDenomination(); },
+        [&](Bank& bank, size_t i) {
+            Token& theToken = *theTokens[i];
+
+            if (!SignPrototoken(bank, theToken, theOutputs[i], nTokenIndex))
+                return false;
+
+            theToken.SetSeriesAndExpiration(m_nSeries, m_VALID_FROM,
+                                            m_VALID_TO);
+            return true;
+        });
 }
 
 // Lucre step 5: mint verifies token when it is redeemed by merchant.
@@ -301,63 +418,63 @@ bool MintLucre::SignToken(Nym& theNotary, Token& theToken, String& theOutput,
 bool MintLucre::VerifyToken(Nym& theNotary, String& theCleartextToken,
                             int64_t lDenomination)
 {
-    bool bReturnValue = false;
     LucreDumper setDumper;
 
-    OpenSSL_BIO bioBank = BIO_new(BIO_s_mem()); // input
-    OpenSSL_BIO bioCoin = BIO_new(BIO_s_mem()); // input
+    String strContents; // will contain output from opening the envelope.
+    if (!OpenPrivateBank(*this, theNotary, lDenomination, strContents))
+        return false;
 
-    // --- copy theCleartextToken to bioCoin so lucre can load it
-    BIO_puts(bioCoin, theCleartextToken.Get());
+    std::unique_ptr<Bank> pBank(LoadBank(strContents));
+
+    // (Done): When a token is redeemed, need to store it in the spent
+    // token database.
+    // Right now I can verify the token, but unless I check it against a
+    // database, then
+    // even though the signature verifies, it doesn't stop people from
+    // redeeming the same
+    // token again and again and again.
+    //
+    // (done): also need to make sure issuer has double-entries for
+    // total amount outstanding.
+    //
+    // UPDATE: These are both done now.  The Spent Token database is
+    // implemented in the transaction server,
+    // (not OTLib proper) and the same server also now keeps a cash
+    // account to match all cash withdrawals.
+    // (Meaning, if 10,000 clams total have been withdrawn by various
+    // users, then the server actually has
+    // a clam account containing 10,000 clams. As the cash comes in for
+    // redemption, the server debits it from
+    // this account again before sending it to its final destination.
+    // This way the server tracks total outstanding
+    // amount, as an additional level of security after the blind
+    // signature itself.)
+    return VerifyCoin(*pBank, theCleartextToken);
+}
 
-    // --- The Mint private info is encrypted in m_mapPrivate[lDenomination].
-    // So I need to extract that first before I can use it.
-    OTASCIIArmor theArmor;
-    GetPrivate(theArmor, lDenomination);
-    OTEnvelope theEnvelope(theArmor);
+bool MintLucre::VerifyTokens(Nym& theNotary,
+                             std::vector<String>& theCleartextTokens,
+                             const std::vector<int64_t>& theDenominations)
+{
+    OT_ASSERT(theCleartextTokens.size() == theDenominations.size());
 
-    String strContents; // will contain output from opening the envelope.
-    // Decrypt the Envelope into strContents
-    if (theEnvelope.Open(theNotary, strContents)) {
-        // copy strContents to a BIO
-        BIO_puts(bioBank, strContents.Get());
-
-        // ---- Now the bank and coin bios are both ready to go...
-
-        Bank bank(bioBank);
-        Coin coin(bioCoin);
-
-        if (bank.Verify(coin)) // Here's the boolean output: coin is verified!
-        {
-            bReturnValue = true;
-
-            // (Done): When a token is redeemed, need to store it in the spent
-            // token database.
-            // Right now I can verify the token, but unless I check it against a
-            // database, then
-            // even though the signature verifies, it doesn't stop people from
-            // redeeming the same
-            // token again and again and again.
-            //
-            // (done): also need to make sure issuer has double-entries for
-            // total amount outstanding.
-            //
-            // UPDATE: These are both done now.  The Spent Token database is
-            // implemented in the transaction server,
-            // (not OTLib proper) and the same server also now keeps a cash
-            // account to match all cash withdrawals.
-            // (Meaning, if 10,000 clams total have been withdrawn by various
-            // users, then the server actually has
-            // a clam account containing 10,000 clams. As the cash comes in for
-            // redemption, the server debits it from
-            // this account again before sending it to its final destination.
-            // This way the server tracks total outstanding
-            // amount, as an additional level of security after the blind
-            // signature itself.)
-        }
+    LucreDumper setDumper;
+
+    mapOfPrivateBanks thePrivateBanks;
+
+    for (auto& lDenomination : theDenominations) {
+        if ((0 == thePrivateBanks.count(lDenomination)) &&
+            !OpenPrivateBank(*this, theNotary, lDenomination,
+                             thePrivateBanks[lDenomination]))
+            return false;
     }
 
-    return bReturnValue;
+    return ForEachToken(
+        theCleartextTokens.size(), thePrivateBanks,
+        [&](size_t i) { return theDenominations[i]; },
+        [&](Bank& bank, size_t i) {
+            return VerifyCoin(bank, theCleartextTokens[i]);
+        });
 }
 
 #endif // defined(OT_CRYPTO_USING_OPENSSL)
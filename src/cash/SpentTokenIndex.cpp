@@ -0,0 +1,655 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+#include <opentxs/cash/SpentTokenIndex.hpp>
+
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+#include <opentxs/core/util/OTPaths.hpp>
+
+#include <cstring>
+#include <map>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+namespace opentxs
+{
+
+namespace
+{
+
+typedef std::map<std::string, std::shared_ptr<SpentTokenIndex>> mapOfIndexes;
+
+std::mutex registryLock;
+
+mapOfIndexes& registry()
+{
+    static mapOfIndexes theIndexes;
+    return theIndexes;
+}
+
+// The hashes are already uniformly distributed, so the filter takes its bit
+// positions straight from their bytes.
+const int32_t BLOOM_PROBES = 8;
+const uint64_t BLOOM_BITS_PER_HASH = 16;
+const uint64_t BLOOM_MIN_BITS = 1 << 16;
+
+uint64_t getWord(const char* pData)
+{
+    uint64_t lValue = 0;
+
+    for (size_t i = 0; i < 8; ++i) {
+        lValue |= static_cast<uint64_t>(static_cast<uint8_t>(pData[i]))
+                  << (8 * i);
+    }
+
+    return lValue;
+}
+
+bool syncFile(std::FILE* pFile)
+{
+    if (0 != std::fflush(pFile)) return false;
+#ifdef _WIN32
+    return 0 == _commit(_fileno(pFile));
+#else
+    return 0 == fsync(fileno(pFile));
+#endif
+}
+
+// Unbuffered, so each append reaches the file in one write and a failed one
+// leaves nothing behind in the buffer.
+std::FILE* openLog(const std::string& strPath)
+{
+    std::FILE* pFile = std::fopen(strPath.c_str(), "ab");
+
+    if (nullptr != pFile) std::setvbuf(pFile, nullptr, _IONBF, 0);
+
+    return pFile;
+}
+
+// Cuts off whatever a failed append managed to write.
+bool truncateFile(std::FILE* pFile, long lSize)
+{
+#ifdef _WIN32
+    return 0 == _chsize(_fileno(pFile), lSize);
+#else
+    return 0 == ftruncate(fileno(pFile), lSize);
+#endif
+}
+
+bool writeFile(const std::string& strPath, const std::string& strContents)
+{
+    std::FILE* pFile = std::fopen(strPath.c_str(), "wb");
+    if (nullptr == pFile) return false;
+
+    const bool bWritten =
+        (strContents.empty() ||
+         (1 == std::fwrite(strContents.data(), strContents.size(), 1, pFile))) &&
+        syncFile(pFile);
+
+    return (0 == std::fclose(pFile)) && bWritten;
+}
+
+void listFolder(const std::string& strPath, std::vector<std::string>& theNames)
+{
+#ifdef _WIN32
+    struct _finddata_t theEntry;
+    const std::string strPattern = strPath + "/*";
+    intptr_t hFind = _findfirst(strPattern.c_str(), &theEntry);
+
+    if (-1 != hFind) {
+        do {
+            theNames.push_back(theEntry.name);
+        } while (0 == _findnext(hFind, &theEntry));
+        _findclose(hFind);
+    }
+#else
+    DIR* pDir = opendir(strPath.c_str());
+    if (nullptr == pDir) return;
+
+    for (struct dirent* pEntry = readdir(pDir); nullptr != pEntry;
+         pEntry = readdir(pDir)) {
+        theNames.push_back(pEntry->d_name);
+    }
+
+    closedir(pDir);
+#endif
+}
+
+// The name of a token's spent file in the old layout.
+String legacyName(const std::string& strHash)
+{
+    Identifier theHash;
+    theHash.Assign(strHash.data(), static_cast<uint32_t>(strHash.size()));
+
+    return String(theHash);
+}
+
+} // namespace
+
+std::shared_ptr<SpentTokenIndex> SpentTokenIndex::Get(
+    const String& strInstrumentDefinitionID, int32_t nSeries,
+    time64_t tExpires)
+{
+    String strName;
+    strName.Format("%s.%d", strInstrumentDefinitionID.Get(), nSeries);
+
+    std::lock_guard<std::mutex> lock(registryLock);
+
+    std::shared_ptr<SpentTokenIndex>& pIndex = registry()[strName.Get()];
+    if (!pIndex) pIndex.reset(new SpentTokenIndex(strName.Get(), tExpires));
+
+    return pIndex;
+}
+
+void SpentTokenIndex::DropExpired()
+{
+    const time64_t tNow = OTTimeGetCurrentTime();
+
+    std::lock_guard<std::mutex> lock(registryLock);
+
+    mapOfIndexes& theIndexes = registry();
+
+    for (auto it = theIndexes.begin(); it != theIndexes.end();) {
+        SpentTokenIndex& theIndex = *it->second;
+
+        // Token::VerifySeries still accepts deposits at the valid-to date
+        // itself, so the series is only dropped after it.
+        if ((OT_TIME_ZERO == theIndex.expires_) ||
+            (tNow <= theIndex.expires_)) {
+            ++it;
+            continue;
+        }
+
+        otOut << "SpentTokenIndex::" << __FUNCTION__ << ": Series "
+              << theIndex.name_ << " has expired. Removing its spent tokens.\n";
+        {
+            std::lock_guard<std::mutex> indexLock(theIndex.mutex_);
+            theIndex.remove();
+        }
+        it = theIndexes.erase(it);
+    }
+}
+
+bool SpentTokenIndex::HashToken(const String& strCleartextToken,
+                                std::string& strHash)
+{
+    Identifier theHash;
+
+    if (!theHash.CalculateDigest(strCleartextToken) ||
+        (HASH_SIZE != theHash.GetSize()))
+        return false;
+
+    strHash.assign(static_cast<const char*>(theHash.GetPointer()),
+                   theHash.GetSize());
+
+    return true;
+}
+
+SpentTokenIndex::SpentTokenIndex(const std::string& strName, time64_t tExpires)
+    : name_(strName)
+    , expires_(tExpires)
+    , open_(false)
+    , legacy_(false)
+    , log_(nullptr)
+    , bloomMask_(0)
+{
+}
+
+SpentTokenIndex::~SpentTokenIndex()
+{
+    if (nullptr != log_) std::fclose(log_);
+}
+
+bool SpentTokenIndex::IsSpent(const Hashes& theHashes,
+                              std::vector<bool>& theResults)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!open()) return false;
+
+    std::set<std::string> theBatch;
+    theResults.assign(theHashes.size(), true);
+
+    for (size_t i = 0; i < theHashes.size(); ++i) {
+        const std::string& strHash = theHashes[i];
+
+        if (HASH_SIZE != strHash.size()) return false;
+
+        theResults[i] =
+            contains(strHash) || !theBatch.insert(strHash).second ||
+            (legacy_ && OTDB::Exists(OTFolders::Spent().Get(), name_,
+                                     legacyName(strHash).Get()));
+    }
+
+    return true;
+}
+
+bool SpentTokenIndex::Record(const Hashes& theHashes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!open()) return false;
+
+    std::set<std::string> theBatch;
+    std::string strRecords;
+
+    for (auto& strHash : theHashes) {
+        if ((HASH_SIZE != strHash.size()) || contains(strHash) ||
+            !theBatch.insert(strHash).second) {
+            otErr << "SpentTokenIndex::" << __FUNCTION__
+                  << ": Token is already recorded as spent in series " << name_
+                  << "\n";
+            return false;
+        }
+
+        strRecords += strHash;
+    }
+
+    if (!append(strRecords)) return false;
+
+    for (auto& strHash : theHashes) {
+        recent_.insert(strHash);
+        addToBloom(strHash);
+    }
+
+    // The hashes are safely in the log either way. If compact() had to close
+    // the series, the next call opens it again.
+    if ((recent_.size() >= COMPACT_THRESHOLD) && !compact()) {
+        otErr << "SpentTokenIndex::" << __FUNCTION__
+              << ": Failed merging the log into the index for series " << name_
+              << ". (Will retry.)\n";
+    }
+
+    return true;
+}
+
+bool SpentTokenIndex::open()
+{
+    if (open_) return true;
+
+    const std::string strFolder = OTFolders::Spent().Get();
+
+    if ((0 > OTDB::FormPathString(logPath_, strFolder, name_ + ".log")) ||
+        (0 > OTDB::FormPathString(indexPath_, strFolder, name_ + ".idx"))) {
+        otErr << "SpentTokenIndex::" << __FUNCTION__
+              << ": Failed forming paths for series " << name_ << "\n";
+        return false;
+    }
+
+    bool bFolderCreated = false;
+    if (!OTPaths::BuildFilePath(String(logPath_), bFolderCreated)) {
+        otErr << "SpentTokenIndex::" << __FUNCTION__
+              << ": Failed creating folder for " << logPath_ << "\n";
+        return false;
+    }
+
+    std::string strLog;
+    index_.clear();
+    recent_.clear();
+
+    const bool bHaveIndex = load(indexPath_, index_);
+    const bool bHaveLog = load(logPath_, strLog);
+
+    const size_t nIndexCount = index_.size() / HASH_SIZE;
+
+    if (0 != index_.size() % HASH_SIZE) {
+        otErr << "SpentTokenIndex::" << __FUNCTION__
+              << ": Damaged index file: " << indexPath_ << "\n";
+        return false;
+    }
+
+    for (size_t i = 1; i < nIndexCount; ++i) {
+        if (0 <= std::memcmp(index_.data() + (i - 1) * HASH_SIZE,
+                             index_.data() + i * HASH_SIZE, HASH_SIZE)) {
+            otErr << "SpentTokenIndex::" << __FUNCTION__
+                  << ": Index file is out of order: " << indexPath_ << "\n";
+            return false;
+        }
+    }
+
+    // A partial hash at the end is from a write that never finished.
+    const bool bTorn = (0 != strLog.size() % HASH_SIZE);
+
+    for (size_t i = 0; i + HASH_SIZE <= strLog.size(); i += HASH_SIZE) {
+        recent_.insert(strLog.substr(i, HASH_SIZE));
+    }
+
+    OTDB::Storage* pStorage = OTDB::GetDefaultStorage();
+    legacy_ = (nullptr != pStorage) &&
+              (OTDB::STORE_FILESYSTEM != pStorage->GetType());
+
+    // Runs before the log exists, so it is tried again until it succeeds.
+    if (!bHaveIndex && !bHaveLog && !legacy_ && !importLegacy()) {
+        otErr << "SpentTokenIndex::" << __FUNCTION__
+              << ": Failed importing the old spent tokens of series " << name_
+              << "\n";
+        recent_.clear();
+        return false;
+    }
+
+    log_ = openLog(logPath_);
+
+    if (nullptr == log_) {
+        otErr << "SpentTokenIndex::" << __FUNCTION__ << ": Failed opening "
+              << logPath_ << "\n";
+        return false;
+    }
+
+    rebuildBloom();
+    open_ = true;
+
+    // Rewriting the index also empties the log, dropping the partial hash.
+    if ((bTorn || (recent_.size() >= COMPACT_THRESHOLD)) && !compact() &&
+        (bTorn || !open_)) {
+        otErr << "SpentTokenIndex::" << __FUNCTION__
+              << ": Failed repairing " << logPath_ << "\n";
+        close();
+        return false;
+    }
+
+    otWarn << "SpentTokenIndex::" << __FUNCTION__ << ": Loaded "
+           << (index_.size() / HASH_SIZE + recent_.size())
+           << " spent tokens for series " << name_ << "\n";
+
+    return true;
+}
+
+// False if the file doesn't exist.
+bool SpentTokenIndex::load(const std::string& strPath,
+                           std::string& strOutput) const
+{
+    std::FILE* pFile = std::fopen(strPath.c_str(), "rb");
+    if (nullptr == pFile) return false;
+
+    char buffer[64 * 1024];
+    size_t nRead = 0;
+
+    while (0 < (nRead = std::fread(buffer, 1, sizeof(buffer), pFile))) {
+        strOutput.append(buffer, nRead);
+    }
+
+    std::fclose(pFile);
+
+    return true;
+}
+
+// Copies the spent tokens of this series from the old layout, where each one
+// was a file named after its hash. They are written to a temporary file which
+// is then renamed to the log, so a crash part way through leaves no log and
+// the import runs again.
+bool SpentTokenIndex::importLegacy()
+{
+    std::string strPath;
+    OTDB::FormPathString(strPath, OTFolders::Spent().Get(), name_);
+
+    std::vector<std::string> theNames;
+    listFolder(strPath, theNames);
+
+    std::string strRecords;
+
+    for (auto& strName : theNames) {
+        if ((0 == strName.compare(".")) || (0 == strName.compare(".."))) {
+            continue;
+        }
+
+        const Identifier theHash{String(strName)};
+        if (HASH_SIZE != theHash.GetSize()) continue;
+
+        const std::string strHash(
+            static_cast<const char*>(theHash.GetPointer()), HASH_SIZE);
+
+        if (!recent_.insert(strHash).second) continue;
+
+        strRecords += strHash;
+    }
+
+    const std::string strTemp = logPath_ + ".tmp";
+
+    if (!writeFile(strTemp, strRecords) ||
+        (0 != std::rename(strTemp.c_str(), logPath_.c_str()))) {
+        std::remove(strTemp.c_str());
+        return false;
+    }
+
+    if (!recent_.empty()) {
+        otOut << "SpentTokenIndex::" << __FUNCTION__ << ": Imported "
+              << recent_.size() << " spent tokens for series " << name_
+              << "\n";
+    }
+
+    return true;
+}
+
+bool SpentTokenIndex::append(const std::string& strRecords)
+{
+    if (strRecords.empty()) return true;
+
+    const long lSize =
+        (0 == std::fseek(log_, 0, SEEK_END)) ? std::ftell(log_) : -1;
+
+    if ((0 > lSize) ||
+        (1 != std::fwrite(strRecords.data(), strRecords.size(), 1, log_)) ||
+        !syncFile(log_)) {
+        otErr << "SpentTokenIndex::" << __FUNCTION__ << ": Failed writing "
+              << logPath_ << "\n";
+
+        // If the log can't be cut back, open() drops a partial hash at its
+        // end. Whole hashes left behind only mean those tokens are refused.
+        if ((0 <= lSize) && !truncateFile(log_, lSize)) {
+            otErr << "SpentTokenIndex::" << __FUNCTION__
+                  << ": Failed truncating " << logPath_ << "\n";
+        }
+
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+// Merges the log into a new index file, then empties the log. If we stop
+// in between, the hashes are in both, which is harmless. If the log can't be
+// emptied and reopened, the series is closed so the next use loads it again.
+bool SpentTokenIndex::compact()
+{
+    std::string strMerged;
+    strMerged.reserve(index_.size() + recent_.size() * HASH_SIZE);
+
+    size_t nOffset = 0;
+    auto it = recent_.begin();
+
+    while ((nOffset < index_.size()) || (recent_.end() != it)) {
+        const int nCompare =
+            (nOffset >= index_.size())
+                ? 1
+                : (recent_.end() == it)
+                      ? -1
+                      : std::memcmp(index_.data() + nOffset, it->data(),
+                                    HASH_SIZE);
+
+        if (nCompare <= 0) {
+            strMerged.append(index_, nOffset, HASH_SIZE);
+            nOffset += HASH_SIZE;
+            if (0 == nCompare) ++it;
+        }
+        else {
+            strMerged += *it;
+            ++it;
+        }
+    }
+
+    const std::string strTemp = indexPath_ + ".tmp";
+
+    if (!writeFile(strTemp, strMerged)) {
+        std::remove(strTemp.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    std::remove(indexPath_.c_str());
+#endif
+    if (0 != std::rename(strTemp.c_str(), indexPath_.c_str())) {
+        std::remove(strTemp.c_str());
+        return false;
+    }
+
+    index_.swap(strMerged);
+    recent_.clear();
+
+    std::fclose(log_);
+    log_ = nullptr;
+
+    if (!writeFile(logPath_, "") || (nullptr == (log_ = openLog(logPath_)))) {
+        otErr << "SpentTokenIndex::" << __FUNCTION__ << ": Failed emptying "
+              << logPath_ << "\n";
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void SpentTokenIndex::close()
+{
+    if (nullptr != log_) std::fclose(log_);
+    log_ = nullptr;
+
+    open_ = false;
+    index_.clear();
+    recent_.clear();
+    bloom_.clear();
+    bloomMask_ = 0;
+}
+
+void SpentTokenIndex::remove()
+{
+    close();
+
+    if (!logPath_.empty()) std::remove(logPath_.c_str());
+    if (!indexPath_.empty()) std::remove(indexPath_.c_str());
+}
+
+bool SpentTokenIndex::contains(const std::string& strHash) const
+{
+    if (!mayContain(strHash)) return false;
+
+    size_t nLow = 0;
+    size_t nHigh = index_.size() / HASH_SIZE;
+
+    while (nLow < nHigh) {
+        const size_t nMiddle = nLow + (nHigh - nLow) / 2;
+        const int nCompare = std::memcmp(index_.data() + nMiddle * HASH_SIZE,
+                                         strHash.data(), HASH_SIZE);
+
+        if (0 == nCompare) return true;
+        if (nCompare < 0)
+            nLow = nMiddle + 1;
+        else
+            nHigh = nMiddle;
+    }
+
+    return recent_.end() != recent_.find(strHash);
+}
+
+void SpentTokenIndex::addToBloom(const std::string& strHash)
+{
+    const uint64_t lCount = index_.size() / HASH_SIZE + recent_.size();
+
+    if (lCount * BLOOM_BITS_PER_HASH > bloomMask_ + 1) {
+        rebuildBloom();
+        return;
+    }
+
+    setBloomBits(strHash.data());
+}
+
+void SpentTokenIndex::setBloomBits(const char* pHash)
+{
+    const uint64_t lFirst = getWord(pHash);
+    const uint64_t lStep = getWord(pHash + 8) | 1;
+
+    for (int32_t i = 0; i < BLOOM_PROBES; ++i) {
+        const uint64_t lBit = (lFirst + i * lStep) & bloomMask_;
+        bloom_[lBit / 64] |= uint64_t(1) << (lBit % 64);
+    }
+}
+
+bool SpentTokenIndex::mayContain(const std::string& strHash) const
+{
+    if (bloom_.empty()) return false;
+
+    const uint64_t lFirst = getWord(strHash.data());
+    const uint64_t lStep = getWord(strHash.data() + 8) | 1;
+
+    for (int32_t i = 0; i < BLOOM_PROBES; ++i) {
+        const uint64_t lBit = (lFirst + i * lStep) & bloomMask_;
+        if (0 == (bloom_[lBit / 64] & (uint64_t(1) << (lBit % 64))))
+            return false;
+    }
+
+    return true;
+}
+
+// Sized for twice the current number of hashes.
+void SpentTokenIndex::rebuildBloom()
+{
+    const uint64_t lCount = index_.size() / HASH_SIZE + recent_.size();
+
+    uint64_t lBits = BLOOM_MIN_BITS;
+    while (lBits < 2 * lCount * BLOOM_BITS_PER_HASH) lBits <<= 1;
+
+    bloom_.assign(lBits / 64, 0);
+    bloomMask_ = lBits - 1;
+
+    for (size_t i = 0; i < index_.size(); i += HASH_SIZE) {
+        setBloomBits(index_.data() + i);
+    }
+    for (auto& strHash : recent_) setBloomBits(strHash.data());
+}
+
+} // namespace opentxs
@@ -40,6 +40,7 @@
 #include <opentxs/cash/Token.hpp>
 #include <opentxs/cash/Mint.hpp>
 #include <opentxs/cash/Purse.hpp>
+#include <opentxs/cash/SpentTokenIndex.hpp>
 
 #if defined(OT_CASH_USING_LUCRE)
 #include <opentxs/cash/TokenLucre.hpp>
@@ -47,9 +48,7 @@
 
 #include <opentxs/core/crypto/OTEnvelope.hpp>
 #include <opentxs/core/crypto/OTNymOrSymmetricKey.hpp>
-#include <opentxs/core/util/OTFolders.hpp>
 #include <opentxs/core/Log.hpp>
-#include <opentxs/core/OTStorage.hpp>
 
 #include <opentxs/core/util/Tag.hpp>
 
@@ -439,6 +438,64 @@ Token* Token::TokenFactory(String strInput)
     return nullptr;
 }
 
+namespace
+{
+
+typedef std::map<std::string, std::pair<std::shared_ptr<SpentTokenIndex>,
+                                        SpentTokenIndex::Hashes>> mapOfSeries;
+
+// Hashes the tokens and sorts them by mint series, so each series in the
+// spent token database is only visited once.
+// The expiry comes from the server's mint, never from the token, since the
+// client chose the token's dates.
+bool GroupBySeries(const std::vector<Token*>& theTokens,
+                   const std::vector<const Mint*>& theMints,
+                   const std::vector<String>& theCleartextTokens,
+                   mapOfSeries& theSeries)
+{
+    OT_ASSERT(theTokens.size() == theCleartextTokens.size());
+    OT_ASSERT(theTokens.size() == theMints.size());
+
+    for (size_t i = 0; i < theTokens.size(); ++i) {
+        const Token& theToken = *theTokens[i];
+        const Mint& theMint = *theMints[i];
+        const String strInstrumentDefinitionID(
+            theToken.GetInstrumentDefinitionID());
+
+        String strSeries;
+        strSeries.Format("%s.%d", strInstrumentDefinitionID.Get(),
+                         theToken.GetSeries());
+
+        if (theMint.GetSeries() != theToken.GetSeries()) {
+            otErr << "Token::" << __FUNCTION__
+                  << ": Wrong mint for token in series " << strSeries << "\n";
+            return false;
+        }
+
+        std::string strHash;
+
+        if (!SpentTokenIndex::HashToken(theCleartextTokens[i], strHash)) {
+            otErr << "Token::" << __FUNCTION__
+                  << ": Failed hashing token in series " << strSeries
+                  << "\n";
+            return false;
+        }
+
+        auto& theEntry = theSeries[strSeries.Get()];
+
+        if (!theEntry.first)
+            theEntry.first = SpentTokenIndex::Get(strInstrumentDefinitionID,
+                                                  theMint.GetSeries(),
+                                                  theMint.GetValidTo());
+
+        theEntry.second.push_back(strHash);
+    }
+
+    return true;
+}
+
+} // namespace
+
 // Note: ALL failures will return true, even if the token has NOT already been
 // spent, and the failure was actually due to a directory creation error. Why,
 // you might ask? Because no matter WHAT is causing the failure, any return of
@@ -454,96 +511,79 @@ Token* Token::TokenFactory(String strInput)
 // submit
 // it again later and it will work.
 //
-bool Token::IsTokenAlreadySpent(String& theCleartextToken)
+bool Token::IsTokenAlreadySpent(const Mint& theMint,
+                                String& theCleartextToken)
 {
-    String strInstrumentDefinitionID(GetInstrumentDefinitionID());
-
-    // Calculate the filename (a hash of the Lucre cleartext token ID)
-    Identifier theTokenHash;
-    theTokenHash.CalculateDigest(theCleartextToken);
-
-    // Grab the new hash into a string (for use as a filename)
-    String strTokenHash(theTokenHash);
-
-    String strAssetFolder;
-    strAssetFolder.Format("%s.%d", strInstrumentDefinitionID.Get(),
-                          GetSeries());
-
-    bool bTokenIsPresent = OTDB::Exists(
-        OTFolders::Spent().Get(), strAssetFolder.Get(), strTokenHash.Get());
-
-    if (bTokenIsPresent) {
-        otOut << "\nToken::IsTokenAlreadySpent: Token was already spent: "
-              << OTFolders::Spent() << Log::PathSeparator() << strAssetFolder
-              << Log::PathSeparator() << strTokenHash << "\n";
-        return true; // all errors must return true in this function.
-                     // But this is not an error. Token really WAS already
-    }                // spent, and this true is for real. The others are just
-                     // for security reasons because of this one.
-
-    // This is the ideal case: the token was NOT already spent, it was good,
-    // so we can return false and the depositor can be credited appropriately.
-    // IsTokenAlreadySpent?  NO-it was NOT already spent. You can only POSSIBLY
-    // get a false out of this method if you actually reached the bottom (here.)
-    return false;
+    return AreTokensAlreadySpent(
+        std::vector<Token*>(1, this),
+        std::vector<const Mint*>(1, &theMint),
+        std::vector<String>(1, theCleartextToken));
 }
 
-bool Token::RecordTokenAsSpent(String& theCleartextToken)
+// Same rule as above: any error means "spent".
+bool Token::AreTokensAlreadySpent(const std::vector<Token*>& theTokens,
+                                  const std::vector<const Mint*>& theMints,
+                                  const std::vector<String>& theCleartextTokens)
 {
-    String strInstrumentDefinitionID(GetInstrumentDefinitionID());
+    mapOfSeries theSeries;
 
-    // Calculate the filename (a hash of the Lucre cleartext token ID)
-    Identifier theTokenHash;
-    theTokenHash.CalculateDigest(theCleartextToken);
+    if (!GroupBySeries(theTokens, theMints, theCleartextTokens, theSeries))
+        return true;
 
-    // Grab the new hash into a string (for use as a filename)
-    String strTokenHash(theTokenHash);
+    for (auto& it : theSeries) {
+        std::vector<bool> theResults;
 
-    String strAssetFolder;
-    strAssetFolder.Format("%s.%d", strInstrumentDefinitionID.Get(),
-                          GetSeries());
+        if (!it.second.first->IsSpent(it.second.second, theResults)) {
+            otErr << "Token::AreTokensAlreadySpent: Error reading the spent "
+                     "token database for series " << it.first << "\n";
+            return true;
+        }
 
-    // See if the spent token file ALREADY EXISTS...
-    bool bTokenIsPresent = OTDB::Exists(
-        OTFolders::Spent().Get(), strAssetFolder.Get(), strTokenHash.Get());
+        for (size_t i = 0; i < theResults.size(); ++i) {
+            if (theResults[i]) {
+                otOut << "\nToken::AreTokensAlreadySpent: Token was already "
+                         "spent in series " << it.first << "\n";
+                return true; // all errors must return true in this function.
+                             // But this is not an error. Token really WAS
+            }                // already spent, and this true is for real. The
+        }                    // others are just for security reasons because
+    }                        // of this one.
+
+    // This is the ideal case: the tokens were NOT already spent, they were
+    // good, so we can return false and the depositor can be credited.
+    // You can only POSSIBLY get a false out of this method if you actually
+    // reached the bottom (here.)
+    return false;
+}
 
-    // If so, we're trying to record a token that was already recorded...
-    if (bTokenIsPresent) {
-        otErr << "Token::RecordTokenAsSpent: Trying to record token as spent,"
-                 " but it was already recorded: " << OTFolders::Spent()
-              << Log::PathSeparator() << strAssetFolder << Log::PathSeparator()
-              << strTokenHash << "\n";
-        return false;
-    }
+bool Token::RecordTokenAsSpent(const Mint& theMint, String& theCleartextToken)
+{
+    return RecordTokensAsSpent(
+        std::vector<Token*>(1, this),
+        std::vector<const Mint*>(1, &theMint),
+        std::vector<String>(1, theCleartextToken));
+}
 
-    // FINISHED:
-    //
-    // We actually save the token itself into the file, which is named based
-    // on a hash of the Lucre data.
-    // The success of that operation is also now the success of this one.
-
-    String strFinal;
-    OTASCIIArmor ascTemp(m_strRawFile);
-
-    if (false ==
-        ascTemp.WriteArmoredString(strFinal, m_strContractType.Get())) {
-        otErr << "Token::RecordTokenAsSpent: Error recording token as "
-                 "spent (failed writing armored string):\n"
-              << OTFolders::Spent() << Log::PathSeparator() << strAssetFolder
-              << Log::PathSeparator() << strTokenHash << "\n";
+// Only the hash of each token is kept now, not the token itself. Fails if any
+// token was already recorded.
+bool Token::RecordTokensAsSpent(const std::vector<Token*>& theTokens,
+                                const std::vector<const Mint*>& theMints,
+                                const std::vector<String>& theCleartextTokens)
+{
+    mapOfSeries theSeries;
+
+    if (!GroupBySeries(theTokens, theMints, theCleartextTokens, theSeries))
         return false;
-    }
 
-    const bool bSaved =
-        OTDB::StorePlainString(strFinal.Get(), OTFolders::Spent().Get(),
-                               strAssetFolder.Get(), strTokenHash.Get());
-    if (!bSaved) {
-        otErr << "Token::RecordTokenAsSpent: Error saving file: "
-              << OTFolders::Spent() << Log::PathSeparator() << strAssetFolder
-              << Log::PathSeparator() << strTokenHash << "\n";
+    for (auto& it : theSeries) {
+        if (!it.second.first->Record(it.second.second)) {
+            otErr << "Token::RecordTokensAsSpent: Error recording tokens as "
+                     "spent in series " << it.first << "\n";
+            return false;
+        }
     }
 
-    return bSaved;
+    return true;
 }
 
 // OTSymmetricKey:
@@ -1079,6 +1119,24 @@ bool Token::VerifyToken(Nym& theNotary, Mint& theMint)
     if (!theEnvelope.Open(theNotary, strContents))
         return false; // todo log error, etc.
 
+    if (!VerifySeries(theMint)) return false;
+
+    // pass the cleartext Lucre spendable coin data to the Mint to be verified.
+    if (theMint.VerifyToken(theNotary, strContents,
+                            GetDenomination())) // Here's the boolean output:
+                                                // coin is verified!
+    {
+        otOut << "Token verified!\n";
+        return true;
+    }
+    else {
+        otOut << "Bad coin!\n";
+        return false;
+    }
+}
+
+bool Token::VerifySeries(const Mint& theMint)
+{
     // Verify that the series is correct...
     // (Otherwise, someone passed us the wrong Mint and the
     // thing won't verify anyway, since we'd have the wrong keys.)
@@ -1107,18 +1165,7 @@ bool Token::VerifyToken(Nym& theNotary, Mint& theMint)
         return false;
     }
 
-    // pass the cleartext Lucre spendable coin data to the Mint to be verified.
-    if (theMint.VerifyToken(theNotary, strContents,
-                            GetDenomination())) // Here's the boolean output:
-                                                // coin is verified!
-    {
-        otOut << "Token verified!\n";
-        return true;
-    }
-    else {
-        otOut << "Bad coin!\n";
-        return false;
-    }
+    return true;
 }
 
 // SUBCLASSES OF OTTOKEN FOR EACH DIGITAL CASH ALGORITHM.
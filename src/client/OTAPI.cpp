@@ -547,6 +547,16 @@ int32_t OTAPI_Wrap::getBoxReceipt(const std::string& NOTARY_ID,
                                  TRANSACTION_NUMBER);
 }
 
+int32_t OTAPI_Wrap::getBoxReceipts(const std::string& NOTARY_ID,
+                                   const std::string& NYM_ID,
+                                   const std::string& ACCOUNT_ID,
+                                   const int32_t& nBoxType,
+                                   const std::string& TRANSACTION_NUMBERS)
+{
+    return Exec()->getBoxReceipts(NOTARY_ID, NYM_ID, ACCOUNT_ID, nBoxType,
+                                  TRANSACTION_NUMBERS);
+}
+
 int32_t OTAPI_Wrap::deleteAssetAccount(const std::string& NOTARY_ID,
                                        const std::string& NYM_ID,
                                        const std::string& ACCOUNT_ID)
@@ -2019,6 +2029,12 @@ int32_t OTAPI_Wrap::usageCredits(const std::string& NOTARY_ID,
     return Exec()->usageCredits(NOTARY_ID, NYM_ID, NYM_ID_CHECK, ADJUSTMENT);
 }
 
+int32_t OTAPI_Wrap::getServerStats(const std::string& NOTARY_ID,
+                                   const std::string& NYM_ID)
+{
+    return Exec()->getServerStats(NOTARY_ID, NYM_ID);
+}
+
 int32_t OTAPI_Wrap::checkNym(const std::string& NOTARY_ID,
                              const std::string& NYM_ID,
                              const std::string& NYM_ID_CHECK)
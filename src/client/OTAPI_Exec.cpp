@@ -2108,6 +2108,52 @@ int32_t OTAPI_Exec::getBoxReceipt(
                                   static_cast<int64_t>(lTransactionNum));
 }
 
+// Returns int32_t, the same as getBoxReceipt.
+//
+int32_t OTAPI_Exec::getBoxReceipts(
+    const std::string& NOTARY_ID, const std::string& NYM_ID,
+    const std::string& ACCOUNT_ID, // If for Nymbox (vs inbox/outbox) then pass
+                                   // NYM_ID in this field also.
+    const int32_t& nBoxType,       // 0/nymbox, 1/inbox, 2/outbox
+    const std::string& TRANSACTION_NUMBERS) const
+{
+    if (NOTARY_ID.empty()) {
+        otErr << __FUNCTION__ << ": Null: NOTARY_ID passed in!\n";
+        return OT_ERROR;
+    }
+    if (NYM_ID.empty()) {
+        otErr << __FUNCTION__ << ": Null: NYM_ID passed in!\n";
+        return OT_ERROR;
+    }
+    if (ACCOUNT_ID.empty()) {
+        otErr << __FUNCTION__ << ": Null: ACCOUNT_ID passed in!\n";
+        return OT_ERROR;
+    }
+    if (!((0 == nBoxType) || (1 == nBoxType) || (2 == nBoxType))) {
+        otErr << __FUNCTION__
+              << ": nBoxType is of wrong type: value: " << nBoxType << "\n";
+        return OT_ERROR;
+    }
+    if (TRANSACTION_NUMBERS.empty()) {
+        otErr << __FUNCTION__ << ": Null: TRANSACTION_NUMBERS passed in!\n";
+        return OT_ERROR;
+    }
+
+    const NumList theTransactionNums(TRANSACTION_NUMBERS);
+
+    if (theTransactionNums.Count() < 1) {
+        otErr << __FUNCTION__ << ": No transaction numbers in: "
+              << TRANSACTION_NUMBERS << "\n";
+        return OT_ERROR;
+    }
+
+    const Identifier theNotaryID(NOTARY_ID), theNymID(NYM_ID),
+        theAccountID(ACCOUNT_ID);
+
+    return OTAPI()->getBoxReceipts(theNotaryID, theNymID, theAccountID,
+                                   nBoxType, theTransactionNums);
+}
+
 // Returns int32_t:
 // -1 means error; no message was sent.
 //  0 means NO error, but also: no message was sent.
@@ -13350,6 +13396,23 @@ int32_t OTAPI_Exec::usageCredits(const std::string& NOTARY_ID,
                                  static_cast<int64_t>(lAdjustment));
 }
 
+int32_t OTAPI_Exec::getServerStats(const std::string& NOTARY_ID,
+                                   const std::string& NYM_ID) const
+{
+    if (NOTARY_ID.empty()) {
+        otErr << __FUNCTION__ << ": Null: NOTARY_ID passed in!\n";
+        return OT_ERROR;
+    }
+    if (NYM_ID.empty()) {
+        otErr << __FUNCTION__ << ": Null: NYM_ID passed in!\n";
+        return OT_ERROR;
+    }
+
+    const Identifier theNotaryID(NOTARY_ID), theNymID(NYM_ID);
+
+    return OTAPI()->getServerStats(theNotaryID, theNymID);
+}
+
 // Returns int32_t:
 // -1 means error; no message was sent.
 //  0 means NO error, but also: no message was sent.
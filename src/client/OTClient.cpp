@@ -68,7 +68,10 @@
 #include <opentxs/core/trade/OTTrade.hpp>
 #include <opentxs/core/util/StringUtils.hpp>
 
+#include <algorithm>
 #include <memory>
+#include <set>
+#include <vector>
 #include <cstdio>
 #include <cinttypes>
 
@@ -3089,13 +3092,6 @@ bool OTClient::processServerReplyGetBoxReceipt(const Message& theReply,
                                                Ledger* pNymbox,
                                                ProcessServerReplyArgs& args)
 {
-    const auto& pNym = args.pNym;
-    const auto& NOTARY_ID = args.NOTARY_ID;
-    const auto& NYM_ID = args.NYM_ID;
-    const auto& pServerNym = args.pServerNym;
-    const auto& strNymID = args.strNymID;
-    const auto& strNotaryID = args.strNotaryID;
-
     otOut << "Received server response to getBoxReceipt request ("
           << (theReply.m_bSuccess ? "success" : "failure") << ")\n";
 
@@ -3138,220 +3134,9 @@ bool OTClient::processServerReplyGetBoxReceipt(const Message& theReply,
         // wanted: To save the Box Receipt!
         // Update: not loading ledger -- it would slow things down. Added a
         // method that allowed me to circumvent loading it.
-
-        // base64-Decode the server reply's payload into strTransaction
-        //
-        const String strTransType(theReply.m_ascPayload);
-        std::unique_ptr<OTTransactionType> pTransType;
-
-        if (strTransType.Exists())
-            pTransType.reset(
-                OTTransactionType::TransactionFactory(strTransType));
-
-        if (nullptr == pTransType)
-            otErr << __FUNCTION__
-                  << ": getBoxReceiptResponse: Error instantiating transaction "
-                     "type based on decoded theReply.m_ascPayload:\n\n"
-                  << strTransType << "\n";
-        else {
-            OTTransaction* pBoxReceipt =
-                dynamic_cast<OTTransaction*>(pTransType.get());
-
-            if (nullptr == pBoxReceipt)
-                otErr << __FUNCTION__
-                      << ": getBoxReceiptResponse: Error dynamic_cast from "
-                         "transaction type to transaction, based on "
-                         "decoded theReply.m_ascPayload:\n\n" << strTransType
-                      << "\n\n";
-            else if (!pBoxReceipt->VerifyAccount(*pServerNym))
-                otErr << __FUNCTION__
-                      << ": getBoxReceiptResponse: Error: Box Receipt "
-                      << pBoxReceipt->GetTransactionNum() << " in "
-                      << ((theReply.m_lDepth == 0)
-                              ? "nymbox"
-                              : ((theReply.m_lDepth == 1) ? "inbox" : "outbox"))
-                      << " fails VerifyAccount().\n"; // outbox is 2.);
-            else if (pBoxReceipt->GetTransactionNum() !=
-                     theReply.m_lTransactionNum)
-                otErr << __FUNCTION__
-                      << ": getBoxReceiptResponse: Error: Transaction Number "
-                         "doesn't match on the box receipt itself ("
-                      << pBoxReceipt->GetTransactionNum()
-                      << "), versus the one listed in the reply message ("
-                      << theReply.m_lTransactionNum << ").\n";
-            // Note: Account ID and Notary ID were already verified, in
-            // VerifyAccount().
-            else if (pBoxReceipt->GetNymID() != NYM_ID) {
-                const String strPurportedNymID(pBoxReceipt->GetNymID());
-                otErr
-                    << __FUNCTION__
-                    << ": getBoxReceiptResponse: Error: NymID doesn't match on "
-                       "the box receipt itself (" << strPurportedNymID
-                    << "), versus the one listed in the reply message ("
-                    << theReply.m_strNymID << ").\n";
-            }
-            else // FINALLY we have the Ledger AND the Box Receipt both
-                   // loaded at the same time.
-            {      // UPDATE: Not loading the ledger at this point. Not
-                   // necessary. Faster without it.
-
-                // UPDATE: We will ASSUME the abbreviated receipt is in the
-                // NYMBOX, which is WHY
-                // we are now downloading the FULL BOX RECEIPT. We will SAVE
-                // it for the Nymbox,
-                // which finishes the Nymbox (already in box as abbreviated,
-                // and already saved in full
-                // in box receipts folder). Next we will also add it to the
-                // PAYMENT INBOX and RECORD BOX,
-                // if it's the right sort of receipt. We will also save
-                // THEIR versions of the FULL BOX RECEIPT,
-                // just as we did for the Nymbox here.
-
-                if ((OTTransaction::instrumentNotice ==
-                     pBoxReceipt->GetType()) ||
-                    (OTTransaction::instrumentRejection ==
-                     pBoxReceipt->GetType())) {
-                    // Just make sure not to add it if it's already there...
-                    if (!strNotaryID.Exists()) {
-                        otErr << __FUNCTION__
-                              << ": strNotaryID doesn't Exist!\n";
-                        OT_FAIL;
-                    }
-                    if (!strNymID.Exists()) {
-                        otErr << __FUNCTION__ << ": strNymID dosn't Exist!\n";
-                        OT_FAIL;
-                    }
-                    const bool bExists =
-                        OTDB::Exists(OTFolders::PaymentInbox().Get(),
-                                     strNotaryID.Get(), strNymID.Get());
-                    Ledger thePmntInbox(NYM_ID, NYM_ID,
-                                        NOTARY_ID); // payment inbox
-                    bool bSuccessLoading =
-                        (bExists && thePmntInbox.LoadPaymentInbox());
-                    if (bExists && bSuccessLoading)
-                        bSuccessLoading = (thePmntInbox.VerifyContractID() &&
-                                           thePmntInbox.VerifySignature(*pNym));
-                    //                          bSuccessLoading    =
-                    // (thePmntInbox.VerifyAccount(*pNym)); // (No need here
-                    // to load all the Box Receipts by using VerifyAccount)
-                    else if (!bExists)
-                        bSuccessLoading = thePmntInbox.GenerateLedger(
-                            NYM_ID, NOTARY_ID, Ledger::paymentInbox,
-                            true); // bGenerateFile=true
-                    // by this point, the nymbox DEFINITELY exists -- or
-                    // not. (generation might have failed, or verification.)
-
-                    if (!bSuccessLoading) {
-                        String strNymID(NYM_ID), strAcctID(NYM_ID);
-                        otOut << __FUNCTION__
-                              << ": getBoxReceiptResponse: WARNING: Unable to "
-                                 "load, verify, or generate paymentInbox, "
-                                 "with IDs: " << strNymID << " / " << strAcctID
-                              << "\n";
-                    }
-                    else // --- ELSE --- Success loading the payment inbox
-                           // and recordBox and verifying their contractID
-                           // and signature, (OR success generating the
-                           // ledger.)
-                    {
-                        // The transaction (which we are putting into the
-                        // payment inbox) will not
-                        // be removed from the nymbox until we receive the
-                        // server's success reply to
-                        // this "process Nymbox" message. That's why you see
-                        // me adding it here to
-                        // the payment inbox, while not removing it from the
-                        // Nymbox (because that
-                        // will happen once the reply is received.) NOTE:
-                        // Need to make sure the
-                        // associated box receipt doesn't get MARKED FOR
-                        // DELETION when being removed
-                        // at that time.
-                        //
-                        //                          void
-                        // load_str_trans_add_to_ledger(const OTIdentifier&
-                        // the_nym_id, const OTString& str_trans, const
-                        // OTString str_box_type, const int64_t& lTransNum,
-                        // OTPseudonym& the_nym, OTLedger& ledger);
-
-                        // Basically we are taking this receipt from the
-                        // Nymbox, and also adding copies of it
-                        // to the paymentInbox and the recordBox.
-                        //
-                        // QUESTION: what if I ERASE it out of my recordBox.
-                        // Won't it pop back up again?
-                        // ANSWER: YES, but not if I do this instead at
-                        // getBoxReceiptResponse which will only happen once.
-                        //         UPDATE: which I now AM (see our location
-                        // here...)
-                        // HOWEVER: Most likely not, because this notice
-                        // will no longer BE in my Nymbox...
-                        //
-                        // QUESTION: What if I ERASE it out of my
-                        // paymentInbox? Won't this pop back there again?
-                        // ANSWER: I can't erase it out of there. I can
-                        // either accept it or reject it. Either way,
-                        // it is removed from my paymentInbox at that time
-                        // by OT. Like above, if a copy were still
-                        // in the Nymbox, I would get a duplicate here when
-                        // processing Nymbox again. But MOST TIMES,
-                        // there will be no duplicate, because it will
-                        // already be cleaned out of my Nymbox anyway.
-                        //
-                        //
-                        const int64_t lTransNum =
-                            pBoxReceipt->GetTransactionNum();
-
-                        // If pBoxReceipt->GetType() is instrument notice,
-                        // add to the payments inbox.
-                        // (It will be moved to record box after the
-                        // incoming payment is deposited or discarded.)
-                        //
-                        load_str_trans_add_to_ledger(NYM_ID, strTransType,
-                                                     "paymentInbox", lTransNum,
-                                                     *pNym, thePmntInbox);
-                        //                          load_str_trans_add_to_ledger(NYM_ID,
-                        // strTransType, "recordBox",    lTransNum, *pNym,
-                        // theRecordBox); // No longer here. Moved to
-                        // processDepositResponse
-
-                    } // --- ELSE --- Success loading the payment inbox and
-                      // verifying its contractID and signature, OR success
-                      // generating the ledger.
-                }     // if pBoxReceipt is instrumentNotice or
-                      // instrumentRejection...
-
-                //                    pBoxReceipt->ReleaseSignatures();
-
-                // I don't release the server's signature, so later on I can
-                // verify either
-                // signature -- the server's or pNym's. Both should be on
-                // the receipt.
-                // UPDATE: We're not changing the content of the Box Receipt
-                // AT ALL
-                // because we don't want to already its message digest,
-                // which will be
-                // compared to the hash stored in the abbreviated version of
-                // the same receipt.
-                //
-                //                    pBoxReceipt->SignContract(*pNym);
-                //                    pBoxReceipt->SaveContract();
-
-                //                    if
-                // (!pBoxReceipt->SaveBoxReceipt(*pLedger))
-                // // <===================
-                if (!pBoxReceipt->SaveBoxReceipt(
-                        theReply.m_lDepth)) // <===================
-                    otErr << __FUNCTION__
-                          << ": getBoxReceiptResponse(): Failed trying to "
-                             "SaveBoxReceipt. Contents:\n\n" << strTransType
-                          << "\n\n";
-                /* theReply.m_lDepth in this context stores boxType. Value
-                 * can be: 0/nymbox,1/inbox,2/outbox*/
-
-            } // We can save the box receipt.
-        }     // Success loading the boxReceipt from the server reply
-    }         // No error condition.
+        processBoxReceipt(theReply.m_lDepth, theReply.m_lTransactionNum,
+                          theReply.m_ascPayload, args);
+    } // No error condition.
     else {
         otErr
             << __FUNCTION__
@@ -3363,6 +3148,254 @@ bool OTClient::processServerReplyGetBoxReceipt(const Message& theReply,
     return true;
 }
 
+bool OTClient::processServerReplyGetBoxReceipts(const Message& theReply,
+                                                ProcessServerReplyArgs& args)
+{
+    otOut << "Received server response to getBoxReceipts request ("
+          << (theReply.m_bSuccess ? "success" : "failure") << ", "
+          << theReply.m_mapBoxReceipts.size() << " receipts)\n";
+
+    if ((theReply.m_lDepth < 0) || (theReply.m_lDepth > 2)) {
+        otErr << __FUNCTION__ << ": getBoxReceiptsResponse: Unknown box type: "
+              << theReply.m_lDepth << "\n";
+        return true;
+    }
+
+    // Any receipts that were asked for, but aren't here, are still missing
+    // afterwards. The caller (see Utility::insureHaveAllBoxReceipts) asks
+    // again for those.
+    for (auto& it : theReply.m_mapBoxReceipts) {
+        processBoxReceipt(theReply.m_lDepth, it.first, it.second, args);
+    }
+
+    return true;
+}
+
+// Verifies a box receipt that came from the server in a getBoxReceipt or
+// getBoxReceipts reply, and saves it. lBoxType is 0/nymbox, 1/inbox, or
+// 2/outbox.
+void OTClient::processBoxReceipt(int64_t lBoxType, int64_t lTransactionNum,
+                                 const OTASCIIArmor& ascReceipt,
+                                 ProcessServerReplyArgs& args)
+{
+    const auto& pNym = args.pNym;
+    const auto& NOTARY_ID = args.NOTARY_ID;
+    const auto& NYM_ID = args.NYM_ID;
+    const auto& pServerNym = args.pServerNym;
+    const auto& strNymID = args.strNymID;
+    const auto& strNotaryID = args.strNotaryID;
+
+    // base64-Decode the server reply's payload into strTransaction
+    //
+    const String strTransType(ascReceipt);
+    std::unique_ptr<OTTransactionType> pTransType;
+
+    if (strTransType.Exists())
+        pTransType.reset(OTTransactionType::TransactionFactory(strTransType));
+
+    if (nullptr == pTransType)
+        otErr << __FUNCTION__
+              << ": getBoxReceiptResponse: Error instantiating transaction "
+                 "type based on decoded ascReceipt:\n\n"
+              << strTransType << "\n";
+    else {
+        OTTransaction* pBoxReceipt =
+            dynamic_cast<OTTransaction*>(pTransType.get());
+
+        if (nullptr == pBoxReceipt)
+            otErr << __FUNCTION__
+                  << ": getBoxReceiptResponse: Error dynamic_cast from "
+                     "transaction type to transaction, based on "
+                     "decoded ascReceipt:\n\n" << strTransType
+                  << "\n\n";
+        else if (!pBoxReceipt->VerifyAccount(*pServerNym))
+            otErr << __FUNCTION__
+                  << ": getBoxReceiptResponse: Error: Box Receipt "
+                  << pBoxReceipt->GetTransactionNum() << " in "
+                  << ((lBoxType == 0) ? "nymbox"
+                                      : ((lBoxType == 1) ? "inbox" : "outbox"))
+                  << " fails VerifyAccount().\n"; // outbox is 2.);
+        else if (pBoxReceipt->GetTransactionNum() != lTransactionNum)
+            otErr << __FUNCTION__
+                  << ": getBoxReceiptResponse: Error: Transaction Number "
+                     "doesn't match on the box receipt itself ("
+                  << pBoxReceipt->GetTransactionNum()
+                  << "), versus the one listed in the reply message ("
+                  << lTransactionNum << ").\n";
+        // Note: Account ID and Notary ID were already verified, in
+        // VerifyAccount().
+        else if (pBoxReceipt->GetNymID() != NYM_ID) {
+            const String strPurportedNymID(pBoxReceipt->GetNymID());
+            otErr
+                << __FUNCTION__
+                << ": getBoxReceiptResponse: Error: NymID doesn't match on "
+                   "the box receipt itself (" << strPurportedNymID
+                << "), versus the one listed in the reply message ("
+                << strNymID << ").\n";
+        }
+        else // FINALLY we have the Ledger AND the Box Receipt both
+               // loaded at the same time.
+        {      // UPDATE: Not loading the ledger at this point. Not
+               // necessary. Faster without it.
+
+            // UPDATE: We will ASSUME the abbreviated receipt is in the
+            // NYMBOX, which is WHY
+            // we are now downloading the FULL BOX RECEIPT. We will SAVE
+            // it for the Nymbox,
+            // which finishes the Nymbox (already in box as abbreviated,
+            // and already saved in full
+            // in box receipts folder). Next we will also add it to the
+            // PAYMENT INBOX and RECORD BOX,
+            // if it's the right sort of receipt. We will also save
+            // THEIR versions of the FULL BOX RECEIPT,
+            // just as we did for the Nymbox here.
+
+            if ((OTTransaction::instrumentNotice ==
+                 pBoxReceipt->GetType()) ||
+                (OTTransaction::instrumentRejection ==
+                 pBoxReceipt->GetType())) {
+                // Just make sure not to add it if it's already there...
+                if (!strNotaryID.Exists()) {
+                    otErr << __FUNCTION__
+                          << ": strNotaryID doesn't Exist!\n";
+                    OT_FAIL;
+                }
+                if (!strNymID.Exists()) {
+                    otErr << __FUNCTION__ << ": strNymID dosn't Exist!\n";
+                    OT_FAIL;
+                }
+                const bool bExists =
+                    OTDB::Exists(OTFolders::PaymentInbox().Get(),
+                                 strNotaryID.Get(), strNymID.Get());
+                Ledger thePmntInbox(NYM_ID, NYM_ID,
+                                    NOTARY_ID); // payment inbox
+                bool bSuccessLoading =
+                    (bExists && thePmntInbox.LoadPaymentInbox());
+                if (bExists && bSuccessLoading)
+                    bSuccessLoading = (thePmntInbox.VerifyContractID() &&
+                                       thePmntInbox.VerifySignature(*pNym));
+                //                          bSuccessLoading    =
+                // (thePmntInbox.VerifyAccount(*pNym)); // (No need here
+                // to load all the Box Receipts by using VerifyAccount)
+                else if (!bExists)
+                    bSuccessLoading = thePmntInbox.GenerateLedger(
+                        NYM_ID, NOTARY_ID, Ledger::paymentInbox,
+                        true); // bGenerateFile=true
+                // by this point, the nymbox DEFINITELY exists -- or
+                // not. (generation might have failed, or verification.)
+
+                if (!bSuccessLoading) {
+                    String strNymID(NYM_ID), strAcctID(NYM_ID);
+                    otOut << __FUNCTION__
+                          << ": getBoxReceiptResponse: WARNING: Unable to "
+                             "load, verify, or generate paymentInbox, "
+                             "with IDs: " << strNymID << " / " << strAcctID
+                          << "\n";
+                }
+                else // --- ELSE --- Success loading the payment inbox
+                       // and recordBox and verifying their contractID
+                       // and signature, (OR success generating the
+                       // ledger.)
+                {
+                    // The transaction (which we are putting into the
+                    // payment inbox) will not
+                    // be removed from the nymbox until we receive the
+                    // server's success reply to
+                    // this "process Nymbox" message. That's why you see
+                    // me adding it here to
+                    // the payment inbox, while not removing it from the
+                    // Nymbox (because that
+                    // will happen once the reply is received.) NOTE:
+                    // Need to make sure the
+                    // associated box receipt doesn't get MARKED FOR
+                    // DELETION when being removed
+                    // at that time.
+                    //
+                    //                          void
+                    // load_str_trans_add_to_ledger(const OTIdentifier&
+                    // the_nym_id, const OTString& str_trans, const
+                    // OTString str_box_type, const int64_t& lTransNum,
+                    // OTPseudonym& the_nym, OTLedger& ledger);
+
+                    // Basically we are taking this receipt from the
+                    // Nymbox, and also adding copies of it
+                    // to the paymentInbox and the recordBox.
+                    //
+                    // QUESTION: what if I ERASE it out of my recordBox.
+                    // Won't it pop back up again?
+                    // ANSWER: YES, but not if I do this instead at
+                    // getBoxReceiptResponse which will only happen once.
+                    //         UPDATE: which I now AM (see our location
+                    // here...)
+                    // HOWEVER: Most likely not, because this notice
+                    // will no longer BE in my Nymbox...
+                    //
+                    // QUESTION: What if I ERASE it out of my
+                    // paymentInbox? Won't this pop back there again?
+                    // ANSWER: I can't erase it out of there. I can
+                    // either accept it or reject it. Either way,
+                    // it is removed from my paymentInbox at that time
+                    // by OT. Like above, if a copy were still
+                    // in the Nymbox, I would get a duplicate here when
+                    // processing Nymbox again. But MOST TIMES,
+                    // there will be no duplicate, because it will
+                    // already be cleaned out of my Nymbox anyway.
+                    //
+                    //
+                    const int64_t lTransNum =
+                        pBoxReceipt->GetTransactionNum();
+
+                    // If pBoxReceipt->GetType() is instrument notice,
+                    // add to the payments inbox.
+                    // (It will be moved to record box after the
+                    // incoming payment is deposited or discarded.)
+                    //
+                    load_str_trans_add_to_ledger(NYM_ID, strTransType,
+                                                 "paymentInbox", lTransNum,
+                                                 *pNym, thePmntInbox);
+                    //                          load_str_trans_add_to_ledger(NYM_ID,
+                    // strTransType, "recordBox",    lTransNum, *pNym,
+                    // theRecordBox); // No longer here. Moved to
+                    // processDepositResponse
+
+                } // --- ELSE --- Success loading the payment inbox and
+                  // verifying its contractID and signature, OR success
+                  // generating the ledger.
+            }     // if pBoxReceipt is instrumentNotice or
+                  // instrumentRejection...
+
+            //                    pBoxReceipt->ReleaseSignatures();
+
+            // I don't release the server's signature, so later on I can
+            // verify either
+            // signature -- the server's or pNym's. Both should be on
+            // the receipt.
+            // UPDATE: We're not changing the content of the Box Receipt
+            // AT ALL
+            // because we don't want to already its message digest,
+            // which will be
+            // compared to the hash stored in the abbreviated version of
+            // the same receipt.
+            //
+            //                    pBoxReceipt->SignContract(*pNym);
+            //                    pBoxReceipt->SaveContract();
+
+            //                    if
+            // (!pBoxReceipt->SaveBoxReceipt(*pLedger))
+            // // <===================
+            if (!pBoxReceipt->SaveBoxReceipt(
+                    lBoxType)) // <===================
+                otErr << __FUNCTION__
+                      << ": getBoxReceiptResponse(): Failed trying to "
+                         "SaveBoxReceipt. Contents:\n\n" << strTransType
+                      << "\n\n";
+            /* lBoxType in this context stores boxType. Value
+             * can be: 0/nymbox,1/inbox,2/outbox*/
+
+        } // We can save the box receipt.
+    }     // Success loading the boxReceipt from the server reply
+}
+
 bool OTClient::processServerReplyProcessInbox(const Message& theReply,
                                               Ledger* pNymbox,
                                               ProcessServerReplyArgs& args)
@@ -6951,6 +6984,57 @@ bool OTClient::processServerReplyGetMarketList(const Message& theReply)
     return true;
 }
 
+namespace
+{
+
+// Applies a getMarketOffersResponse delta to one side of the stored offers.
+// Changed offers replace their old entries, removed ones (with no assets
+// available) are dropped, and the result is put back in price order, the way
+// the server sends the whole list.
+template <class T>
+void mergeOffers(OTDB::OfferListMarket& theStored,
+                 OTDB::OfferListMarket& theChanges,
+                 OTDB::OfferListMarket& theMerged,
+                 size_t (OTDB::OfferListMarket::*pCount)(),
+                 T* (OTDB::OfferListMarket::*pGet)(size_t),
+                 bool (OTDB::OfferListMarket::*pAdd)(T&), bool bBids)
+{
+    std::set<std::string> setChanged;
+    std::vector<T*> theOffers;
+
+    for (size_t i = 0; i < (theChanges.*pCount)(); ++i) {
+        T* pOffer = (theChanges.*pGet)(i);
+
+        setChanged.insert(pOffer->transaction_id);
+
+        if (0 != String::StringToLong(pOffer->available_assets))
+            theOffers.push_back(pOffer);
+    }
+
+    for (size_t i = 0; i < (theStored.*pCount)(); ++i) {
+        T* pOffer = (theStored.*pGet)(i);
+
+        if (setChanged.end() == setChanged.find(pOffer->transaction_id))
+            theOffers.push_back(pOffer);
+    }
+
+    // Best price first, then oldest first.
+    std::stable_sort(theOffers.begin(), theOffers.end(),
+                     [bBids](const T* pLeft, const T* pRight) {
+        const int64_t lLeft = String::StringToLong(pLeft->price_per_scale);
+        const int64_t lRight = String::StringToLong(pRight->price_per_scale);
+
+        if (lLeft != lRight) return bBids ? (lLeft > lRight) : (lLeft < lRight);
+
+        return String::StringToLong(pLeft->date) <
+               String::StringToLong(pRight->date);
+    });
+
+    for (T* pOffer : theOffers) (theMerged.*pAdd)(*pOffer);
+}
+
+} // namespace
+
 bool OTClient::processServerReplyGetMarketOffers(const Message& theReply)
 {
 
@@ -6962,6 +7046,9 @@ bool OTClient::processServerReplyGetMarketOffers(const Message& theReply)
     OTDB::Storage* pStorage = OTDB::GetDefaultStorage();
     OT_ASSERT(nullptr != pStorage);
 
+    // A delta with nothing in it means nothing changed.
+    if (theReply.m_bBool && (theReply.m_lDepth == 0)) return true;
+
     // The reply is a SUCCESS, and the COUNT is 0 (empty list was returned.)
     // Since it was a success, but the list was empty, then we need to erase
     // the data file. (So when the file is loaded from storage, it will
@@ -7019,6 +7106,43 @@ bool OTClient::processServerReplyGetMarketOffers(const Message& theReply)
         return true;
     }
 
+    // Only the changes were sent, so apply them to the offers stored already.
+    if (theReply.m_bBool) {
+        std::unique_ptr<OTDB::OfferListMarket> pStored(
+            dynamic_cast<OTDB::OfferListMarket*>(OTDB::QueryObject(
+                OTDB::STORED_OBJ_OFFER_LIST_MARKET, OTFolders::Market().Get(),
+                theReply.m_strNotaryID.Get(), strOfferDatafile.Get())));
+
+        // Nothing stored yet (or it was erased once the market emptied), so
+        // the changes are applied to an empty list.
+        if (nullptr == pStored) {
+            otWarn << "getMarketOffersResponse: Received changes to the offers "
+                      "on market " << strMarketID
+                   << ", with no offers stored. Applying them to an empty "
+                      "list.\n";
+            pStored.reset(dynamic_cast<OTDB::OfferListMarket*>(
+                OTDB::CreateObject(OTDB::STORED_OBJ_OFFER_LIST_MARKET)));
+            OT_ASSERT(nullptr != pStored);
+        }
+
+        std::unique_ptr<OTDB::OfferListMarket> pMerged(
+            dynamic_cast<OTDB::OfferListMarket*>(
+                OTDB::CreateObject(OTDB::STORED_OBJ_OFFER_LIST_MARKET)));
+
+        mergeOffers<OTDB::BidData>(
+            *pStored, *pOfferList, *pMerged,
+            &OTDB::OfferListMarket::GetBidDataCount,
+            &OTDB::OfferListMarket::GetBidData,
+            &OTDB::OfferListMarket::AddBidData, true);
+        mergeOffers<OTDB::AskData>(
+            *pStored, *pOfferList, *pMerged,
+            &OTDB::OfferListMarket::GetAskDataCount,
+            &OTDB::OfferListMarket::GetAskData,
+            &OTDB::OfferListMarket::AddAskData, false);
+
+        pOfferList.reset(pMerged.release());
+    }
+
     bool bSuccessStore = pStorage->StoreObject(
         *pOfferList, OTFolders::Market().Get(), // "markets"
         theReply.m_strNotaryID.Get(), // "markets/<notaryID>offers", //
@@ -7110,6 +7234,47 @@ bool OTClient::processServerReplyGetMarketRecentTrades(const Message& theReply)
     return true;
 }
 
+// The candles are stored as the server sent them, one per line, in
+// "markets/<notaryID>/candles/<marketID>.<resolution>".
+bool OTClient::processServerReplyGetMarketCandles(const Message& theReply)
+{
+    String strCandleDatafile;
+    strCandleDatafile.Format("%s.%s", theReply.m_strNymID2.Get(),
+                             theReply.m_strType.Get());
+
+    // An empty list was returned, so erase the data file rather than leave
+    // outdated candles in it.
+    if (theReply.m_lDepth == 0) {
+        if (OTDB::Exists(OTFolders::Market().Get(),
+                         theReply.m_strNotaryID.Get(), "candles",
+                         strCandleDatafile.Get()) &&
+            !OTDB::EraseValueByKey(OTFolders::Market().Get(),
+                                   theReply.m_strNotaryID.Get(), "candles",
+                                   strCandleDatafile.Get()))
+            otErr << "Error erasing candles from market folder: "
+                  << strCandleDatafile << " \n";
+
+        return true;
+    }
+
+    String strCandles;
+
+    if ((theReply.m_ascPayload.GetLength() <= 2) ||
+        !theReply.m_ascPayload.GetString(strCandles)) {
+        otErr << "ProcessServerReply: unable to decode ascii-armored "
+                 "payload in getMarketCandlesResponse reply.\n";
+        return true;
+    }
+
+    if (!OTDB::StorePlainString(strCandles.Get(), OTFolders::Market().Get(),
+                                theReply.m_strNotaryID.Get(), "candles",
+                                strCandleDatafile.Get()))
+        otErr << "Error storing " << strCandleDatafile
+              << " to market folder.\n";
+
+    return true;
+}
+
 bool OTClient::processServerReplyGetNymMarketOffers(const Message& theReply)
 {
     String strOfferDatafile;
@@ -7609,6 +7774,9 @@ bool OTClient::processServerReply(std::shared_ptr<Message> reply,
     if (theReply.m_strCommand.Compare("getBoxReceiptResponse")) {
         return processServerReplyGetBoxReceipt(theReply, pNymbox, args);
     }
+    if (theReply.m_strCommand.Compare("getBoxReceiptsResponse")) {
+        return processServerReplyGetBoxReceipts(theReply, args);
+    }
     if ((theReply.m_strCommand.Compare("processInboxResponse") ||
          theReply.m_strCommand.Compare("processNymboxResponse"))) {
         return processServerReplyProcessInbox(theReply, pNymbox, args);
@@ -7636,6 +7804,9 @@ bool OTClient::processServerReply(std::shared_ptr<Message> reply,
     if (theReply.m_strCommand.Compare("getMarketRecentTradesResponse")) {
         return processServerReplyGetMarketRecentTrades(theReply);
     }
+    if (theReply.m_strCommand.Compare("getMarketCandlesResponse")) {
+        return processServerReplyGetMarketCandles(theReply);
+    }
     if (theReply.m_strCommand.Compare("getNymMarketOffersResponse")) {
         return processServerReplyGetNymMarketOffers(theReply);
     }
@@ -66,6 +66,7 @@ OTServerConnection::OTServerConnection(OTClient* theClient,
     , m_pNym(nullptr)
     , m_pServerContract(nullptr)
     , m_pClient(theClient)
+    , m_bBinary(true)
 {
     if (!zsys_has_curve()) {
         Log::vError("Error: libzmq has no libsodium support");
@@ -128,16 +129,13 @@ void OTServerConnection::send(OTServerContract* pServerContract, Nym* pNym,
     const Nym* pServerNym = pServerContract->GetContractPublicNym();
     OT_ASSERT(nullptr != pServerNym);
 
-    String strContents;
-    theMessage.SaveContractRaw(strContents);
-
     otOut << "\n=====>BEGIN Sending " << theMessage.m_strCommand
           << " message via ZMQ... Request number: "
           << theMessage.m_strRequestNum << "\n";
 
     m_pServerContract = pServerContract;
     m_pNym = pNym;
-    send(strContents);
+    send(theMessage);
 
     otWarn << "<=====END Finished sending " << theMessage.m_strCommand
            << " message (and hopefully receiving "
@@ -145,63 +143,99 @@ void OTServerConnection::send(OTServerContract* pServerContract, Nym* pNym,
            << "\n\n";
 }
 
-bool OTServerConnection::send(const String& theString)
+bool OTServerConnection::send(const Message& theMessage)
 {
-    OTASCIIArmor ascEnvelope(theString);
+    std::string request, reply;
+
+    // Servers that predate the binary form answer it with an empty reply.
+    // From then on, this connection sticks to armored text.
+    if (m_bBinary && theMessage.SaveBinary(request)) {
+        if (!send(request, reply)) return false;
+        if (!reply.empty()) return processReply(reply);
+
+        otWarn << __FUNCTION__ << ": Server didn't accept a binary message. "
+                                  "Resending it armored.\n";
+        m_bBinary = false;
+    }
 
-    if (!ascEnvelope.Exists()) {
+    String strContents;
+    theMessage.SaveContractRaw(strContents);
+
+    if (!strContents.Exists() ||
+        !OTASCIIArmor::EncodeString(strContents.Get(), strContents.GetLength(),
+                                    request)) {
         return false;
     }
 
-    int rc = zstr_send(socket_zmq, ascEnvelope.Get());
+    if (!send(request, reply)) return false;
+
+    return processReply(reply);
+}
+
+bool OTServerConnection::send(const std::string& request, std::string& reply)
+{
+    zframe_t* frame = zframe_new(request.data(), request.size());
 
-    if (rc != 0) {
+    if (zframe_send(&frame, socket_zmq, 0) != 0) {
+        zframe_destroy(&frame);
         otErr << __FUNCTION__
               << ": Failed, even with error correction and retries, "
                  "while trying to send message to server.";
         return false;
     }
 
-    std::string rawServerReply;
-    bool bSuccessReceiving = receive(rawServerReply);
-
-    if (!bSuccessReceiving) {
+    if (!receive(reply)) {
         otErr << __FUNCTION__ << ": Failed trying to receive expected reply "
                                  "from server.\n";
         return false;
     }
-    OTASCIIArmor ascServerReply;
-    ascServerReply.Set(rawServerReply.c_str());
 
-    String strServerReply;
-    bool bRetrievedReply = ascServerReply.GetString(strServerReply);
+    return true;
+}
 
+bool OTServerConnection::processReply(const std::string& rawServerReply)
+{
     // todo: use a unique_ptr  soon as feasible.
     std::shared_ptr<Message> pServerReply(new Message());
     OT_ASSERT(nullptr != pServerReply);
 
-    if (bRetrievedReply && strServerReply.Exists() &&
-        pServerReply->LoadContractFromString(strServerReply)) {
-        // Now the fully-loaded message object (from the server,
-        // this time) can be processed by the OT library...
-        // Client takes ownership and will
-        m_pClient->processServerReply(pServerReply);
+    bool bLoaded = false;
+
+    if (Message::IsBinary(rawServerReply.data(), rawServerReply.size())) {
+        bLoaded = pServerReply->LoadBinary(rawServerReply.data(),
+                                           rawServerReply.size());
     }
     else {
+        // Decoded straight out of the reply, with no armored copy in between.
+        std::string strServerReply;
+        bool bRetrievedReply = OTASCIIArmor::DecodeString(
+            rawServerReply.data(), rawServerReply.size(), strServerReply);
+
+        bLoaded = bRetrievedReply && !strServerReply.empty() &&
+                  pServerReply->LoadContractFromString(String(strServerReply));
+    }
+
+    if (!bLoaded) {
         otErr << __FUNCTION__ << ": Error loading server reply from string:\n\n"
               << rawServerReply << "\n\n";
         return false;
     }
 
+    // Now the fully-loaded message object (from the server,
+    // this time) can be processed by the OT library...
+    // Client takes ownership and will
+    m_pClient->processServerReply(pServerReply);
+
     return true;
 }
 
 bool OTServerConnection::receive(std::string& serverReply)
 {
-    char* msg = zstr_recv(socket_zmq);
-    if (msg == nullptr) return false;
-    serverReply.assign(msg);
-    zstr_free(&msg);
+    zframe_t* frame = zframe_recv(socket_zmq);
+    if (frame == nullptr) return false;
+    serverReply.assign(reinterpret_cast<const char*>(zframe_data(frame)),
+                       zframe_size(frame));
+    zframe_destroy(&frame);
     return true;
 }
 
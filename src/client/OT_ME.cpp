@@ -2223,6 +2223,8 @@ bool OT_ME::Register_API_With_Script_Chai(const OTScriptChai& theScript) const
         theScript.chai->add(fun(&OTAPI_Wrap::checkNym), "OT_API_checkNym");
         theScript.chai->add(fun(&OTAPI_Wrap::usageCredits),
                             "OT_API_usageCredits");
+        theScript.chai->add(fun(&OTAPI_Wrap::getServerStats),
+                            "OT_API_getServerStats");
         theScript.chai->add(fun(&OTAPI_Wrap::sendNymMessage),
                             "OT_API_sendNymMessage");
         theScript.chai->add(fun(&OTAPI_Wrap::sendNymInstrument),
@@ -2269,6 +2271,8 @@ bool OT_ME::Register_API_With_Script_Chai(const OTScriptChai& theScript) const
 
         theScript.chai->add(fun(&OTAPI_Wrap::getBoxReceipt),
                             "OT_API_getBoxReceipt");
+        theScript.chai->add(fun(&OTAPI_Wrap::getBoxReceipts),
+                            "OT_API_getBoxReceipts");
         theScript.chai->add(fun(&OTAPI_Wrap::DoesBoxReceiptExist),
                             "OT_API_DoesBoxReceiptExist");
 
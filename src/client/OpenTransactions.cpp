@@ -11835,7 +11835,8 @@ int32_t OT_API::getMarketList(const Identifier& NOTARY_ID,
 int32_t OT_API::getMarketOffers(const Identifier& NOTARY_ID,
                                 const Identifier& NYM_ID,
                                 const Identifier& MARKET_ID,
-                                const int64_t& lDepth) const
+                                const int64_t& lDepth,
+                                const int64_t& lSinceVersion) const
 {
     Nym* pNym = GetOrLoadPrivateNym(
         NYM_ID, false, __FUNCTION__); // This ASSERTs and logs already.
@@ -11870,6 +11871,7 @@ int32_t OT_API::getMarketOffers(const Identifier& NOTARY_ID,
 
     theMessage.m_strNymID2 = strMarketID;
     theMessage.m_lDepth = lDepth;
+    theMessage.m_lTransactionNum = lSinceVersion;
 
     // (2) Sign the Message
     theMessage.SignContract(*pNym);
@@ -11942,6 +11944,63 @@ int32_t OT_API::getMarketRecentTrades(const Identifier& NOTARY_ID,
     return SendMessage(pServer, pNym, theMessage, lRequestNumber);
 }
 
+///-------------------------------------------------------
+/// GET PRICE CANDLES FOR A SPECIFIC MARKET ID
+///
+/// Open, high, low, close and volume, per minute, hour or day, so charts
+/// don't have to be built from the recent trades.
+///
+int32_t OT_API::getMarketCandles(const Identifier& NOTARY_ID,
+                                 const Identifier& NYM_ID,
+                                 const Identifier& MARKET_ID,
+                                 const String& strResolution,
+                                 const int64_t& lDepth) const
+{
+    Nym* pNym = GetOrLoadPrivateNym(
+        NYM_ID, false, __FUNCTION__); // This ASSERTs and logs already.
+    if (nullptr == pNym) return (-1);
+    // By this point, pNym is a good pointer, and is on the wallet.
+    //  (No need to cleanup.)
+    OTServerContract* pServer =
+        GetServer(NOTARY_ID, __FUNCTION__); // This ASSERTs and logs already.
+    if (nullptr == pServer) return (-1);
+    // By this point, pServer is a good pointer.  (No need to cleanup.)
+    Message theMessage;
+
+    String strNotaryID(NOTARY_ID), strMarketID(MARKET_ID);
+    // (0) Set up the REQUEST NUMBER and then INCREMENT IT
+    int64_t lRequestNumber = 0;
+    pNym->GetCurrentRequestNum(strNotaryID, lRequestNumber);
+    theMessage.m_strRequestNum.Format(
+        "%" PRId64, lRequestNumber);               // Always have to send this.
+    pNym->IncrementRequestNum(*pNym, strNotaryID); // since I used it for a
+                                                   // server request, I have to
+                                                   // increment it
+
+    String strNymID(NYM_ID);
+    // (1) Set up member variables
+    theMessage.m_strCommand = "getMarketCandles";
+    theMessage.m_strNymID = strNymID;
+    theMessage.m_strNotaryID = strNotaryID;
+    theMessage.SetAcknowledgments(*pNym); // Must be called AFTER
+                                          // theMessage.m_strNotaryID is already
+                                          // set. (It uses it.)
+
+    theMessage.m_strNymID2 = strMarketID;
+    theMessage.m_strType = strResolution;
+    theMessage.m_lDepth = lDepth;
+
+    // (2) Sign the Message
+    theMessage.SignContract(*pNym);
+
+    // (3) Save the Message (with signatures and all, back to its internal
+    // member m_strRawFile.)
+    theMessage.SaveContract();
+
+    // (Send it)
+    return SendMessage(pServer, pNym, theMessage, lRequestNumber);
+}
+
 ///-------------------------------------------------------
 /// GET ALL THE ACTIVE (in Cron) MARKET OFFERS FOR A SPECIFIC NYM.
 /// (ON A SPECIFIC SERVER, OBVIOUSLY.) Remember to use Flush/Call/Wait/Pop
@@ -12996,6 +13055,65 @@ int32_t OT_API::getBoxReceipt(
     return SendMessage(pServer, pNym, theMessage, lRequestNumber);
 }
 
+int32_t OT_API::getBoxReceipts(
+    const Identifier& NOTARY_ID, const Identifier& NYM_ID,
+    const Identifier& ACCOUNT_ID, // If for Nymbox (vs inbox/outbox) then pass
+                                  // NYM_ID in this field also.
+    int32_t nBoxType,             // 0/nymbox, 1/inbox, 2/outbox
+    const NumList& theTransactionNums) const
+{
+    Nym* pNym = GetOrLoadPrivateNym(NYM_ID, false, __FUNCTION__);
+    if (nullptr == pNym) return (-1);
+    // By this point, pNym is a good pointer, and is on the wallet.
+    //  (No need to cleanup.)
+    OTServerContract* pServer =
+        GetServer(NOTARY_ID, __FUNCTION__); // This ASSERTs and logs already.
+    if (nullptr == pServer) return (-1);
+    // By this point, pServer is a good pointer.  (No need to cleanup.)
+    if (NYM_ID != ACCOUNT_ID) // inbox/outbox (if it were nymbox, the NYM_ID
+                              // and ACCOUNT_ID would match)
+    {
+        Account* pAccount =
+            GetOrLoadAccount(*pNym, ACCOUNT_ID, NOTARY_ID, __FUNCTION__);
+        if (nullptr == pAccount) return (-1);
+    }
+    Message theMessage;
+    int64_t lRequestNumber = 0;
+
+    const String strNotaryID(NOTARY_ID), strNymID(NYM_ID),
+        strAcctID(ACCOUNT_ID);
+
+    // (0) Set up the REQUEST NUMBER and then INCREMENT IT
+    pNym->GetCurrentRequestNum(strNotaryID, lRequestNumber);
+    theMessage.m_strRequestNum.Format(
+        "%" PRId64, lRequestNumber);               // Always have to send this.
+    pNym->IncrementRequestNum(*pNym, strNotaryID); // since I used it for a
+                                                   // server request, I have to
+                                                   // increment it
+
+    // (1) set up member variables
+    theMessage.m_strCommand = "getBoxReceipts";
+    theMessage.m_strNymID = strNymID;
+    theMessage.m_strNotaryID = strNotaryID;
+    theMessage.SetAcknowledgments(*pNym); // Must be called AFTER
+                                          // theMessage.m_strNotaryID is already
+                                          // set. (It uses it.)
+
+    theMessage.m_strAcctID = strAcctID;
+    theMessage.m_lDepth = static_cast<int64_t>(nBoxType);
+    theMessage.m_TransactionNums.Add(theTransactionNums);
+
+    // (2) Sign the Message
+    theMessage.SignContract(*pNym);
+
+    // (3) Save the Message (with signatures and all, back to its internal
+    // member m_strRawFile.)
+    theMessage.SaveContract();
+
+    // (Send it)
+    return SendMessage(pServer, pNym, theMessage, lRequestNumber);
+}
+
 int32_t OT_API::getAccountData(const Identifier& NOTARY_ID,
                                const Identifier& NYM_ID,
                                const Identifier& ACCT_ID) const
@@ -13127,6 +13245,52 @@ int32_t OT_API::usageCredits(const Identifier& NOTARY_ID,
     return SendMessage(pServer, pNym, theMessage, lRequestNumber);
 }
 
+// Only the server's override Nym may do this, unless the server is
+// configured with cmd_get_server_stats=true.
+int32_t OT_API::getServerStats(const Identifier& NOTARY_ID,
+                               const Identifier& NYM_ID) const
+{
+    Nym* pNym = GetOrLoadPrivateNym(
+        NYM_ID, false, __FUNCTION__); // This ASSERTs and logs already.
+    if (nullptr == pNym) return (-1);
+    // By this point, pNym is a good pointer, and is on the wallet.
+    //  (No need to cleanup.)
+    OTServerContract* pServer =
+        GetServer(NOTARY_ID, __FUNCTION__); // This ASSERTs and logs already.
+    if (nullptr == pServer) return (-1);
+    // By this point, pServer is a good pointer.  (No need to cleanup.)
+    Message theMessage;
+    int64_t lRequestNumber = 0;
+
+    String strNotaryID(NOTARY_ID), strNymID(NYM_ID);
+
+    // (0) Set up the REQUEST NUMBER and then INCREMENT IT
+    pNym->GetCurrentRequestNum(strNotaryID, lRequestNumber);
+    theMessage.m_strRequestNum.Format(
+        "%" PRId64, lRequestNumber);               // Always have to send this.
+    pNym->IncrementRequestNum(*pNym, strNotaryID); // since I used it for a
+                                                   // server request, I have to
+                                                   // increment it
+
+    // (1) set up member variables
+    theMessage.m_strCommand = "getServerStats";
+    theMessage.m_strNymID = strNymID;
+    theMessage.m_strNotaryID = strNotaryID;
+    theMessage.SetAcknowledgments(*pNym); // Must be called AFTER
+                                          // theMessage.m_strNotaryID is already
+                                          // set. (It uses it.)
+
+    // (2) Sign the Message
+    theMessage.SignContract(*pNym);
+
+    // (3) Save the Message (with signatures and all, back to its internal
+    // member m_strRawFile.)
+    theMessage.SaveContract();
+
+    // (Send it)
+    return SendMessage(pServer, pNym, theMessage, lRequestNumber);
+}
+
 int32_t OT_API::checkNym(const Identifier& NOTARY_ID, const Identifier& NYM_ID,
                          const Identifier& NYM_ID_CHECK) const
 {
@@ -40,7 +40,9 @@
 #include <opentxs/client/ot_otapi_ot.hpp>
 #include <opentxs/core/Log.hpp>
 
+#include <algorithm>
 #include <locale>
+#include <vector>
 
 namespace opentxs
 {
@@ -1853,6 +1855,58 @@ OT_UTILITY_OT bool Utility::getBoxReceiptLowLevel(
     return false;
 }
 
+// called by insureHaveAllBoxReceipts
+//
+// Asks for all the receipts in strTransactionNums (comma-separated) in one
+// request. A successful reply may still hold only some of them, if they
+// didn't all fit.
+OT_UTILITY_OT bool Utility::getBoxReceiptsLowLevel(
+    const string& notaryID, const string& nymID, const string& accountID,
+    int32_t nBoxType, const string& strTransactionNums, bool& bWasSent)
+{
+    string strLocation = "Utility::getBoxReceiptsLowLevel";
+
+    bWasSent = false;
+
+    OTAPI_Wrap::FlushMessageBuffer();
+
+    int32_t nRequestNum = OTAPI_Wrap::getBoxReceipts(
+        notaryID, nymID, accountID, nBoxType,
+        strTransactionNums); // <===== ATTEMPT TO SEND THE MESSAGE HERE...;
+    if (-1 == nRequestNum) {
+        otOut << strLocation
+              << ": Failed to send getBoxReceipts message due to error.\n";
+        return false;
+    }
+    if (0 == nRequestNum) {
+        otOut << strLocation << ": Didn't send getBoxReceipts message, but NO "
+                                "error occurred, either. (In this case, SHOULD "
+                                "NEVER HAPPEN. Treating as Error.)\n";
+        return false;
+    }
+    if (nRequestNum < 0) {
+        otOut << strLocation << ": Unexpected request number: " << nRequestNum
+              << "\n";
+        return false;
+    }
+
+    bWasSent = true;
+
+    int32_t nReturn =
+        receiveReplySuccessLowLevel(notaryID, nymID, nRequestNum, strLocation);
+    otWarn << strLocation << ": nRequestNum: " << nRequestNum
+           << " /  nReturn: " << nReturn << "\n";
+
+    if (nReturn > 0) {
+        return true;
+    }
+
+    otOut << strLocation << ": Failure: Response from server:\n"
+          << getLastReplyReceived() << "\n";
+
+    return false;
+}
+
 // called by insureHaveAllBoxReceipts     DONE
 OT_UTILITY_OT bool Utility::getBoxReceiptWithErrorCorrection(
     const string& notaryID, const string& nymID, const string& accountID,
@@ -1953,11 +2007,10 @@ OT_UTILITY_OT bool Utility::insureHaveAllBoxReceipts(
     // At this point, the box is definitely loaded.
     // Next we'll iterate the receipts
     // within, and for each, verify that the Box Receipt already exists. If not,
-    // then we'll download it using getBoxReceiptLowLevel(). If any download
-    // fails,
-    // then we break out of the loop (without continuing on to try the rest.)
+    // then we'll add it to the list to download. (See below.)
     //
     bool bReturnValue = true; // Assuming an empty box, we return success;
+    vector<int64_t> vecMissing;
 
     int32_t nReceiptCount =
         OTAPI_Wrap::Ledger_GetCount(notaryID, nymID, accountID, ledger);
@@ -2028,36 +2081,8 @@ OT_UTILITY_OT bool Utility::insureHaveAllBoxReceipts(
                                     notaryID, nymID, accountID, nBoxType,
                                     lTransactionNum);
                             if (!bHaveBoxReceipt) {
-                                otWarn << strLocation << ": Downloading box "
-                                                         "receipt to add to my "
-                                                         "collection...\n";
-
-                                bool bDownloaded =
-                                    getBoxReceiptWithErrorCorrection(
-                                        notaryID, nymID, accountID, nBoxType,
-                                        lTransactionNum);
-                                if (!bDownloaded) {
-                                    otOut
-                                        << strLocation
-                                        << ": Failed downloading box receipt. "
-                                           "(Skipping any others.) Transaction "
-                                           "number: " << lTransactionNum
-                                        << "\n";
-
-                                    bReturnValue = false;
-                                    break;
-                                    // No point continuing to loop and fail 500
-                                    // times, when
-                                    // getBoxReceiptWithErrorCorrection()
-                                    // already failed
-                                    // even doing the getRequestNumber() trick
-                                    // and
-                                    // everything, and whatever retries are
-                                    // inside OT, before it finally
-                                    // gave up.
-                                }
-                                // else (Download success.)
-                            } // if (!bHaveBoxReceipt)
+                                vecMissing.push_back(lTransactionNum);
+                            }
                         }
 
                         // else we already have the box receipt, no need to
@@ -2078,6 +2103,62 @@ OT_UTILITY_OT bool Utility::insureHaveAllBoxReceipts(
         } // ************* FOR LOOP ******************
     }     // if (nReceiptCount > 0)
 
+    // Download the missing receipts with getBoxReceipts, which takes as many
+    // round trips as the server needs to fit them all in its replies (usually
+    // one.) Servers that don't know getBoxReceipts fail the first request, and
+    // whatever is still missing after that is downloaded one at a time.
+    //
+    while (!vecMissing.empty()) {
+        otWarn << strLocation << ": Downloading " << vecMissing.size()
+               << " box receipts to add to my collection...\n";
+
+        string strTransactionNums;
+        for (const int64_t& lTransactionNum : vecMissing) {
+            if (!strTransactionNums.empty()) strTransactionNums += ",";
+            strTransactionNums += to_string(lTransactionNum);
+        }
+
+        bool bWasSent = false;
+        if (!getBoxReceiptsLowLevel(notaryID, nymID, accountID, nBoxType,
+                                    strTransactionNums, bWasSent)) {
+            break;
+        }
+
+        const size_t nMissingBefore = vecMissing.size();
+        vecMissing.erase(
+            remove_if(vecMissing.begin(), vecMissing.end(),
+                      [&](const int64_t& lTransactionNum) {
+                          return OTAPI_Wrap::DoesBoxReceiptExist(
+                              notaryID, nymID, accountID, nBoxType,
+                              lTransactionNum);
+                      }),
+            vecMissing.end());
+
+        if (vecMissing.size() == nMissingBefore) break; // No progress.
+    }
+
+    for (const int64_t& lTransactionNum : vecMissing) {
+        otWarn << strLocation << ": Downloading box "
+                                 "receipt to add to my "
+                                 "collection...\n";
+
+        bool bDownloaded = getBoxReceiptWithErrorCorrection(
+            notaryID, nymID, accountID, nBoxType, lTransactionNum);
+        if (!bDownloaded) {
+            otOut << strLocation << ": Failed downloading box receipt. "
+                                    "(Skipping any others.) Transaction "
+                                    "number: " << lTransactionNum << "\n";
+
+            bReturnValue = false;
+            break;
+            // No point continuing to loop and fail 500 times, when
+            // getBoxReceiptWithErrorCorrection() already failed even doing
+            // the getRequestNumber() trick and everything, and whatever
+            // retries are inside OT, before it finally gave up.
+        }
+        // else (Download success.)
+    }
+
     //
     // if nRequestSeeking is >0, that means the caller wants to know if there is
     // a receipt present for that request number.
@@ -198,6 +198,10 @@ public:
         const std::string& notaryID, const std::string& nymID,
         const std::string& accountID, int32_t nBoxType,
         int64_t strTransactionNum, bool& bWasSent);
+    EXPORT OT_UTILITY_OT bool getBoxReceiptsLowLevel(
+        const std::string& notaryID, const std::string& nymID,
+        const std::string& accountID, int32_t nBoxType,
+        const std::string& strTransactionNums, bool& bWasSent);
     EXPORT OT_UTILITY_OT bool getBoxReceiptWithErrorCorrection(
         const std::string& notaryID, const std::string& nymID,
         const std::string& accountID, int32_t nBoxType,
@@ -54,6 +54,8 @@
 
 #include <fstream>
 #include <memory>
+#include <utility>
+#include <vector>
 
 using namespace irr;
 using namespace io;
@@ -402,6 +404,8 @@ bool Contract::SignContractAuthent(const Nym& theNym,
 bool Contract::SignContract(const Nym& theNym, OTSignature& theSignature,
                             const OTPasswordData* pPWData)
 {
+    std::lock_guard<std::mutex> lock(theNym.GetSigningLock());
+
     return SignContract(theNym.GetPrivateSignKey(), theSignature,
                         m_strSigHashType, pPWData);
 }
@@ -410,6 +414,8 @@ bool Contract::SignContract(const Nym& theNym, OTSignature& theSignature,
 bool Contract::SignContractAuthent(const Nym& theNym, OTSignature& theSignature,
                                    const OTPasswordData* pPWData)
 {
+    std::lock_guard<std::mutex> lock(theNym.GetSigningLock());
+
     return SignContract(theNym.GetPrivateAuthKey(), theSignature,
                         m_strSigHashType, pPWData);
 }
@@ -981,12 +987,18 @@ bool Contract::SignFlatText(String& strFlatText, const String& strContractType,
 
     OTSignature theSignature;
     OTPasswordData thePWData("Signing flat text (need private key)");
+    bool bSigned = false;
 
-    if (false ==
-        OTCrypto::It()->SignContract(
+    {
+        std::lock_guard<std::mutex> lock(theSigner.GetSigningLock());
+
+        bSigned = OTCrypto::It()->SignContract(
             trim(strInput), theSigner.GetPrivateSignKey(),
             theSignature, // the output
-            Identifier::DefaultHashAlgorithm, &thePWData)) {
+            Identifier::DefaultHashAlgorithm, &thePWData);
+    }
+
+    if (!bSigned) {
         otErr << szFunc << ": SignContract failed. Contents:\n\n" << strInput
               << "\n\n\n";
         return false;
@@ -1006,7 +1018,11 @@ bool Contract::SignFlatText(String& strFlatText, const String& strContractType,
 // Saves the raw (pre-existing) contract text to any string you want to pass in.
 bool Contract::SaveContractRaw(String& strOutput) const
 {
-    strOutput.Concatenate("%s", m_strRawFile.Get());
+    // Usually strOutput is empty, and this is a single copy.
+    if (strOutput.Exists())
+        strOutput.Concatenate(m_strRawFile);
+    else
+        strOutput.Set(m_strRawFile);
 
     return true;
 }
@@ -1194,6 +1210,13 @@ bool Contract::LoadContract(const char* szFoldername, const char* szFilename)
 // Just like it says. If you have a contract in string form, pass it in
 // here to import it.
 bool Contract::LoadContractFromString(const String& theStr)
+{
+    String strContract(theStr);
+
+    return LoadContractFromString(std::move(strContract));
+}
+
+bool Contract::LoadContractFromString(String&& theStr)
 {
     Release();
 
@@ -1202,19 +1225,21 @@ bool Contract::LoadContractFromString(const String& theStr)
         return false;
     }
 
-    String strContract(theStr);
+    // Decoded (or just trimmed) in place, rather than in a copy that then
+    // gets copied again.
+    m_strRawFile.swap(theStr);
 
     if (false ==
-        strContract.DecodeIfArmored()) // bEscapedIsAllowed=true by default.
+        m_strRawFile.DecodeIfArmored()) // bEscapedIsAllowed=true by default.
     {
+        // (Left as it was passed in, when decoding fails.)
         otErr << __FUNCTION__ << ": ERROR: Input string apparently was encoded "
                                  "and then failed decoding. "
-                                 "Contents: \n" << theStr << "\n";
+                                 "Contents: \n" << m_strRawFile << "\n";
+        m_strRawFile.Release();
         return false;
     }
 
-    m_strRawFile.Set(strContract);
-
     // This populates m_xmlUnsigned with the contents of m_strRawFile (minus
     // bookends, signatures, etc. JUST the XML.)
     bool bSuccess =
@@ -1239,12 +1264,131 @@ bool Contract::LoadContractFromString(const String& theStr)
     return bSuccess;
 }
 
+namespace
+{
+
+// Walks a contract's raw text one line at a time, in place. A line is
+// [begin, begin + length), without its '\n'.
+//
+// next() returns false once the last line has been read, the same as
+// String::sgets, which this replaces. (Except that a long line comes back
+// whole, rather than in 2047-byte pieces.)
+class LineScanner
+{
+public:
+    LineScanner(const char* data, size_t size)
+        : pos_(data)
+        , end_(data + size)
+    {
+    }
+
+    bool next(const char*& begin, size_t& length)
+    {
+        begin = pos_;
+
+        const char* newline = static_cast<const char*>(
+            memchr(pos_, '\n', static_cast<size_t>(end_ - pos_)));
+
+        if (nullptr == newline) {
+            length = static_cast<size_t>(end_ - pos_);
+            pos_ = end_;
+            return false;
+        }
+
+        length = static_cast<size_t>(newline - pos_);
+        pos_ = newline + 1;
+
+        return pos_ < end_;
+    }
+
+private:
+    const char* pos_;
+    const char* end_;
+};
+
+// The lines making up one block of the contract (the signed content, or a
+// signature), as slices of the raw text. A line is recorded together with
+// its '\n', so consecutive lines merge into a single slice, and a block
+// with nothing skipped in the middle is copied out in one go.
+class SliceList
+{
+public:
+    void add(const char* begin, size_t length)
+    {
+        if (0 == length) return;
+
+        if (!slices_.empty() &&
+            (slices_.back().first + slices_.back().second == begin)) {
+            slices_.back().second += length;
+        }
+        else {
+            slices_.push_back(std::make_pair(begin, length));
+        }
+
+        size_ += length;
+    }
+
+    bool empty() const
+    {
+        return 0 == size_;
+    }
+
+    void clear()
+    {
+        slices_.clear();
+        size_ = 0;
+    }
+
+    void copyTo(String& strOutput) const
+    {
+        if (1 == slices_.size()) {
+            strOutput.Set(slices_.front().first,
+                          static_cast<uint32_t>(slices_.front().second));
+            return;
+        }
+
+        std::string str;
+        str.reserve(size_);
+        for (const auto& slice : slices_) {
+            str.append(slice.first, slice.second);
+        }
+        strOutput.Set(str.c_str());
+    }
+
+private:
+    std::vector<std::pair<const char*, size_t>> slices_;
+    size_t size_ = 0;
+};
+
+bool LineStartsWith(const char* line, size_t length, const char* prefix)
+{
+    const size_t prefixLength = strlen(prefix);
+
+    return (length >= prefixLength) &&
+           (0 == memcmp(line, prefix, prefixLength));
+}
+
+bool LineContains(const char* line, size_t length, const char* word)
+{
+    const size_t wordLength = strlen(word);
+
+    for (size_t i = 0; i + wordLength <= length; ++i) {
+        if (0 == memcmp(line + i, word, wordLength)) return true;
+    }
+
+    return false;
+}
+
+} // namespace
+
+// One pass over m_strRawFile. The content and the signatures are recorded as
+// slices of it, and each is copied out once, when it's complete, into
+// m_xmlUnsigned (for LoadContractXML and VerifySignature) or its OTSignature.
 bool Contract::ParseRawFile()
 {
-    char buffer1[2100]; // a bit bigger than 2048, just for safety reasons.
     OTSignature* pSig = nullptr;
 
-    std::string line;
+    SliceList xmlSlices, sigSlices;
 
     bool bSignatureMode = false;          // "currently in signature mode"
     bool bContentMode = false;            // "currently in content mode"
@@ -1259,35 +1403,38 @@ bool Contract::ParseRawFile()
 
     // This is redundant (I thought) but the problem hasn't cleared up yet.. so
     // trying to really nail it now.
-    std::string str_Trim(m_strRawFile.Get());
-    std::string str_Trim2 = String::trim(str_Trim);
-    m_strRawFile.Set(str_Trim2.c_str());
+    m_strRawFile.Trim();
+
+    LineScanner scanner(m_strRawFile.Get(), m_strRawFile.GetLength());
+    const char* line = nullptr;
+    size_t length = 0;
+
+    // Skips the line after a header such as "Version:", which is also
+    // expected not to be the last one.
+    auto skipLine = [&](bool bIsEOF) {
+        const char* skipped = nullptr;
+        size_t skippedLength = 0;
+
+        return !bIsEOF && scanner.next(skipped, skippedLength);
+    };
 
     bool bIsEOF = false;
-    m_strRawFile.reset();
 
     do {
-        // Just a fresh start at the top of the loop block... probably
-        // unnecessary.
-        memset(buffer1, 0, 2100); // todo remove this in optimization. (might be
-                                  // removed already...)
-
         // the call returns true if there's more to read, and false if there
         // isn't.
-        bIsEOF = !(m_strRawFile.sgets(buffer1, 2048));
+        bIsEOF = !scanner.next(line, length);
 
-        line = buffer1;
-        const char* pBuf = line.c_str();
-
-        if (line.length() < 2) {
+        if (length < 2) {
             if (bSignatureMode) continue;
         }
 
         // if we're on a dashed line...
-        else if (line.at(0) == '-') {
+        else if (line[0] == '-') {
             if (bSignatureMode) {
                 // we just reached the end of a signature
-                //    otErr << "%s\n", pSig->Get());
+                sigSlices.copyTo(*pSig);
+                sigSlices.clear();
                 pSig = nullptr;
                 bSignatureMode = false;
                 continue;
@@ -1300,33 +1447,18 @@ bool Contract::ParseRawFile()
             // a. I have not yet even entered content mode, and just now
             // entering it for the first time.
             if (!bHaveEnteredContentMode) {
-                if ((line.length() > 3) &&
-                    (line.find("BEGIN") != std::string::npos) &&
-                    line.at(1) == '-' && line.at(2) == '-' &&
-                    line.at(3) == '-') {
-                    //                    otErr << "\nProcessing contract...
-                    // \n";
+                if ((length > 3) && LineContains(line, length, "BEGIN") &&
+                    line[1] == '-' && line[2] == '-' && line[3] == '-') {
                     bHaveEnteredContentMode = true;
                     bContentMode = true;
-                    continue;
-                }
-                else {
-                    continue;
                 }
 
+                continue;
             }
 
             // b. I am now entering signature mode!
-            else if (line.length() > 3 &&
-                     line.find("SIGNATURE") != std::string::npos &&
-                     line.at(1) == '-' && line.at(2) == '-' &&
-                     line.at(3) == '-') {
-                // if (bContentMode)
-                //    otLog3 << "Finished reading contract.\n\nReading a
-                // signature at the bottom of the contract...\n");
-                // else
-                //    otLog3 << "Reading another signature...\n");
-
+            else if (length > 3 && LineContains(line, length, "SIGNATURE") &&
+                     line[1] == '-' && line[2] == '-' && line[3] == '-') {
                 bSignatureMode = true;
                 bContentMode = false;
 
@@ -1341,8 +1473,7 @@ bool Contract::ParseRawFile()
                 continue;
             }
             // c. There is an error in the file!
-            else if (line.length() < 3 || line.at(1) != ' ' ||
-                     line.at(2) != '-') {
+            else if (length < 3 || line[1] != ' ' || line[2] != '-') {
                 otOut
                     << "Error in contract " << m_strFilename
                     << ": a dash at the beginning of the "
@@ -1350,127 +1481,124 @@ bool Contract::ParseRawFile()
                     << m_strRawFile << "\n";
                 return false;
             }
-            // d. It is an escaped dash, and therefore kosher, so I merely
-            // remove the escape and add it.
-            // I've decided not to remove the dashes but to keep them as part of
-            // the signed content.
-            // It's just much easier to deal with that way. The input code will
-            // insert the extra dashes.
-            // pBuf += 2;
+            // d. It is an escaped dash, and therefore kosher. I've decided
+            // not to remove the dashes but to keep them as part of the signed
+            // content. It's just much easier to deal with that way. The input
+            // code will insert the extra dashes.
         }
 
         // Else we're on a normal line, not a dashed line.
-        else {
-            if (bHaveEnteredContentMode) {
-                if (bSignatureMode) {
-                    if (line.length() < 2) {
-                        otLog3 << "Skipping short line...\n";
-
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename
-                                  << ": Unexpected EOF after short line.\n";
-                            return false;
-                        }
-
-                        continue;
+        else if (bHaveEnteredContentMode) {
+            if (bSignatureMode) {
+                if (LineStartsWith(line, length, "Version:")) {
+                    otLog3 << "Skipping version section...\n";
+
+                    if (!skipLine(bIsEOF)) {
+                        otOut << "Error in signature for contract "
+                              << m_strFilename
+                              << ": Unexpected EOF after \"Version:\"\n";
+                        return false;
                     }
-                    else if (line.compare(0, 8, "Version:") == 0) {
-                        otLog3 << "Skipping version section...\n";
-
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename
-                                  << ": Unexpected EOF after \"Version:\"\n";
-                            return false;
-                        }
 
-                        continue;
+                    continue;
+                }
+                else if (LineStartsWith(line, length, "Comment:")) {
+                    otLog3 << "Skipping comment section...\n";
+
+                    if (!skipLine(bIsEOF)) {
+                        otOut << "Error in signature for contract "
+                              << m_strFilename
+                              << ": Unexpected EOF after \"Comment:\"\n";
+                        return false;
                     }
-                    else if (line.compare(0, 8, "Comment:") == 0) {
-                        otLog3 << "Skipping comment section...\n";
 
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename
-                                  << ": Unexpected EOF after \"Comment:\"\n";
-                            return false;
-                        }
+                    continue;
+                }
+                if (LineStartsWith(line, length, "Meta:")) {
+                    otLog3 << "Collecting signature metadata...\n";
+
+                    if (length != 13) // "Meta:    knms" (It will always be
+                                      // exactly 13 characters int64_t.) knms
+                                      // represents the first characters of
+                                      // the Key type, NymID, Master Cred ID,
+                                      // and Subcred ID. Key type is (A|E|S)
+                                      // and the others are base62.
+                    {
+                        otOut << "Error in signature for contract "
+                              << m_strFilename << ": Unexpected length for "
+                                                  "\"Meta:\" comment.\n";
+                        return false;
+                    }
 
-                        continue;
+                    OT_ASSERT(nullptr != pSig);
+                    if (false ==
+                        pSig->getMetaData().SetMetadata(
+                            line[9], line[10], line[11],
+                            line[12])) // "knms" from "Meta:    knms"
+                    {
+                        otOut << "Error in signature for contract "
+                              << m_strFilename
+                              << ": Unexpected metadata in the \"Meta:\" "
+                                 "comment.\nLine: "
+                              << std::string(line, length) << "\n";
+                        return false;
                     }
-                    if (line.compare(0, 5, "Meta:") == 0) {
-                        otLog3 << "Collecting signature metadata...\n";
-
-                        if (line.length() !=
-                            13) // "Meta:    knms" (It will always be exactly 13
-                                // characters int64_t.) knms represents the
-                                // first characters of the Key type, NymID,
-                                // Master Cred ID, and Subcred ID. Key type is
-                                // (A|E|S) and the others are base62.
-                        {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename << ": Unexpected length for "
-                                                      "\"Meta:\" comment.\n";
-                            return false;
-                        }
-
-                        OT_ASSERT(nullptr != pSig);
-                        if (false ==
-                            pSig->getMetaData().SetMetadata(
-                                line.at(9), line.at(10), line.at(11),
-                                line.at(12))) // "knms" from "Meta:    knms"
-                        {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename
-                                  << ": Unexpected metadata in the \"Meta:\" "
-                                     "comment.\nLine: " << line << "\n";
-                            return false;
-                        }
-
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename
-                                  << ": Unexpected EOF after \"Meta:\"\n";
-                            return false;
-                        }
-
-                        continue;
+
+                    if (!skipLine(bIsEOF)) {
+                        otOut << "Error in signature for contract "
+                              << m_strFilename
+                              << ": Unexpected EOF after \"Meta:\"\n";
+                        return false;
                     }
+
+                    continue;
                 }
-                if (bContentMode) {
-                    if (line.compare(0, 6, "Hash: ") == 0) {
-                        otLog3 << "Collecting message digest algorithm from "
-                                  "contract header...\n";
-
-                        std::string strTemp = line.substr(6);
-                        m_strSigHashType = strTemp.c_str();
-                        m_strSigHashType.ConvertToUpperCase();
-
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
-                            otOut << "Error in contract " << m_strFilename
-                                  << ": Unexpected EOF after \"Hash:\"\n";
-                            return false;
-                        }
-                        continue;
+            }
+            if (bContentMode) {
+                if (LineStartsWith(line, length, "Hash: ")) {
+                    otLog3 << "Collecting message digest algorithm from "
+                              "contract header...\n";
+
+                    std::string strTemp(line + 6, length - 6);
+                    m_strSigHashType = strTemp.c_str();
+                    m_strSigHashType.ConvertToUpperCase();
+
+                    if (!skipLine(bIsEOF)) {
+                        otOut << "Error in contract " << m_strFilename
+                              << ": Unexpected EOF after \"Hash:\"\n";
+                        return false;
                     }
+                    continue;
                 }
             }
         }
 
+        // Each line is kept with its '\n'. Only the last line of the file has
+        // none, and that one is never content or signature (it's an error
+        // below if it is, since the block never ended.)
+        const size_t lineLength = bIsEOF ? length : length + 1;
+
         if (bSignatureMode) {
             OT_ASSERT_MSG(nullptr != pSig,
                           "Error: Null Signature pointer WHILE "
                           "processing signature, in "
                           "OTContract::ParseRawFile");
 
-            pSig->Concatenate("%s\n", pBuf);
+            sigSlices.add(line, lineLength);
         }
         else if (bContentMode)
-            m_xmlUnsigned.Concatenate("%s\n", pBuf);
+            xmlSlices.add(line, lineLength);
     } while (!bIsEOF);
-    //    while(!bIsEOF && (!bHaveEnteredContentMode || bContentMode ||
-    // bSignatureMode));
+
+    if (!xmlSlices.empty()) {
+        if (m_xmlUnsigned.Exists()) {
+            String strXml;
+            xmlSlices.copyTo(strXml);
+            m_xmlUnsigned.Concatenate(strXml);
+        }
+        else
+            xmlSlices.copyTo(m_xmlUnsigned);
+    }
 
     if (!bHaveEnteredContentMode) {
         otErr << "Error in OTContract::ParseRawFile: Found no BEGIN for signed "
@@ -123,40 +123,68 @@ void Identifier::SetString(const char* szString)
     SetString(theStr);
 }
 
+// Identifiers compare by their raw digest bytes. (Shorter sorts first when
+// one is a prefix of the other.) This is much cheaper than comparing the
+// encoded strings, which matters since Identifiers are map keys all over.
+int32_t Identifier::Compare(const Identifier& s2) const
+{
+    const uint32_t size1 = GetSize();
+    const uint32_t size2 = s2.GetSize();
+    const uint32_t common = (size1 < size2) ? size1 : size2;
+
+    if (common > 0) {
+        const int32_t result =
+            std::memcmp(GetPointer(), s2.GetPointer(), common);
+
+        if (0 != result) return result;
+    }
+
+    if (size1 == size2) return 0;
+
+    return (size1 < size2) ? -1 : 1;
+}
+
 bool Identifier::operator==(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return ots1.Compare(ots2);
+    return 0 == Compare(s2);
 }
 
 bool Identifier::operator!=(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return !(ots1.Compare(ots2));
+    return 0 != Compare(s2);
 }
 
 bool Identifier::operator>(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return ots1.operator>(ots2);
+    return Compare(s2) > 0;
 }
 
 bool Identifier::operator<(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return ots1.operator<(ots2);
+    return Compare(s2) < 0;
 }
 
 bool Identifier::operator<=(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return ots1.operator<=(ots2);
+    return Compare(s2) <= 0;
 }
 
 bool Identifier::operator>=(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return ots1.operator>=(ots2);
+    return Compare(s2) >= 0;
+}
+
+// The digest bytes are already uniformly distributed, so the leading bytes
+// make a perfectly good hash.
+size_t Identifier::Hash() const
+{
+    size_t hash = GetSize();
+    const uint32_t size =
+        (GetSize() < sizeof(hash)) ? GetSize() : sizeof(hash);
+
+    if (size > 0) std::memcpy(&hash, GetPointer(), size);
+
+    return hash;
 }
 
 Identifier::~Identifier()
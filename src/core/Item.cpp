@@ -962,6 +962,7 @@ bool Item::VerifyBalanceStatement(int64_t lActualAdjustment, Nym& THE_NYM,
 void Item::AddItem(Item& theItem)
 {
     m_listItems.push_back(&theItem);
+    m_bItemsIndexed = false;
 }
 
 // While processing a transaction, you may wish to query it for items of a
@@ -985,14 +986,38 @@ Item* Item::GetItem(int32_t nIndex)
 // While processing an item, you may wish to query it for sub-items
 Item* Item::GetItemByTransactionNum(int64_t lTransactionNumber)
 {
+    IndexItems();
+
+    auto it = m_mapItemsByTransNum.find(lTransactionNumber);
+
+    if (m_mapItemsByTransNum.end() == it) return nullptr;
+
+    return it->second;
+}
+
+// Builds the sub-item lookup maps, unless they're already current. When two
+// sub-items share a number, the first one in the list wins, same as the
+// linear search these maps replace.
+void Item::IndexItems()
+{
+    if (m_bItemsIndexed) return;
+
+    m_mapItemsByTransNum.clear();
+    m_mapFinalReceiptsByRefNum.clear();
+
     for (auto& it : m_listItems) {
         Item* pItem = it;
         OT_ASSERT(nullptr != pItem);
 
-        if (pItem->GetTransactionNum() == lTransactionNumber) return pItem;
+        m_mapItemsByTransNum.insert(
+            std::make_pair(pItem->GetTransactionNum(), pItem));
+
+        if (Item::finalReceipt == pItem->GetType())
+            m_mapFinalReceiptsByRefNum.insert(
+                std::make_pair(pItem->GetReferenceToNum(), pItem));
     }
 
-    return nullptr;
+    m_bItemsIndexed = true;
 }
 
 // Count the number of items that are IN REFERENCE TO some transaction#.
@@ -1019,15 +1044,13 @@ int32_t Item::GetItemCountInRefTo(int64_t lReference)
 //
 Item* Item::GetFinalReceiptItemByReferenceNum(int64_t lReferenceNumber)
 {
-    for (auto& it : m_listItems) {
-        Item* pItem = it;
-        OT_ASSERT(nullptr != pItem);
+    IndexItems();
 
-        if (Item::finalReceipt != pItem->GetType()) continue;
-        if (pItem->GetReferenceToNum() == lReferenceNumber) return pItem;
-    }
+    auto it = m_mapFinalReceiptsByRefNum.find(lReferenceNumber);
 
-    return nullptr;
+    if (m_mapFinalReceiptsByRefNum.end() == it) return nullptr;
+
+    return it->second;
 }
 
 // For "OTItem::acceptTransaction"
@@ -1439,6 +1462,7 @@ Item::Item()
     , m_Status(Item::request)
     , m_lNewOutboxTransNum(0)
     , m_lClosingTransactionNo(0)
+    , m_bItemsIndexed(false)
 {
     InitItem();
 }
@@ -1453,6 +1477,7 @@ Item::Item(const Identifier& theNymID, const OTTransaction& theOwner)
     , m_Status(Item::request)
     , m_lNewOutboxTransNum(0)
     , m_lClosingTransactionNo(0)
+    , m_bItemsIndexed(false)
 {
     InitItem();
 }
@@ -1467,6 +1492,7 @@ Item::Item(const Identifier& theNymID, const Item& theOwner)
     , m_Status(Item::request)
     , m_lNewOutboxTransNum(0)
     , m_lClosingTransactionNo(0)
+    , m_bItemsIndexed(false)
 {
     InitItem();
 }
@@ -1481,6 +1507,7 @@ Item::Item(const Identifier& theNymID, const OTTransaction& theOwner,
     , m_Status(Item::request)
     , m_lNewOutboxTransNum(0)
     , m_lClosingTransactionNo(0)
+    , m_bItemsIndexed(false)
 {
     InitItem();
 
@@ -1522,6 +1549,10 @@ void Item::Release_Item()
 void Item::ReleaseItems()
 {
 
+    m_mapItemsByTransNum.clear();
+    m_mapFinalReceiptsByRefNum.clear();
+    m_bItemsIndexed = false;
+
     while (!m_listItems.empty()) {
         Item* pItem = m_listItems.front();
         m_listItems.pop_front();
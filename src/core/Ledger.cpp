@@ -43,7 +43,7 @@
 #include <opentxs/core/Cheque.hpp>
 #include <opentxs/core/crypto/OTEnvelope.hpp>
 #include <opentxs/core/util/OTFolders.hpp>
-#include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/XMLWriter.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Message.hpp>
 #include <opentxs/core/Nym.hpp>
@@ -52,11 +52,18 @@
 
 #include <irrxml/irrXML.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <vector>
 
 namespace opentxs
 {
 
+int32_t Ledger::__box_receipt_thread_count = 1; // Threads verifying box
+                                                // receipts at the same time.
+
 char const* const __TypeStringsLedger[] = {
     "nymbox", // the nymbox is per user account (versus per asset account) and
               // is used to receive new transaction numbers (and messages.)
@@ -228,64 +235,118 @@ bool Ledger::DeleteBoxReceipt(const int64_t& lTransactionNum)
 // if psetUnloaded passed in, then use it to return the #s that weren't there.
 bool Ledger::LoadBoxReceipts(std::set<int64_t>* psetUnloaded)
 {
-    // Grab a copy of all the transaction #s stored inside this ledger.
+    struct BoxReceipt
+    {
+        int64_t lTransactionNum;
+        const OTTransaction* pAbbrev;
+        String strRawFile;
+        OTTransaction* pFullVersion;
+    };
+
+    // Read the box receipt of every abbreviated transaction, in transaction
+    // number order. This stays on the calling thread, since storage batches
+    // are only visible to the thread that opened them.
     //
-    std::set<int64_t> the_set;
+    std::vector<BoxReceipt> vecReceipts;
+    vecReceipts.reserve(m_mapTransactions.size());
 
     for (auto& it : m_mapTransactions) {
         OTTransaction* pTransaction = it.second;
         OT_ASSERT(nullptr != pTransaction);
-        the_set.insert(pTransaction->GetTransactionNum());
+
+        if (!pTransaction->IsAbbreviated()) continue;
+
+        BoxReceipt theReceipt;
+        theReceipt.lTransactionNum = pTransaction->GetTransactionNum();
+        theReceipt.pAbbrev = pTransaction;
+        theReceipt.pFullVersion = nullptr;
+
+        const bool bRead = LoadBoxReceiptString(
+            *pTransaction, static_cast<int64_t>(GetType()),
+            theReceipt.strRawFile);
+
+        vecReceipts.push_back(theReceipt);
+
+        // Without psetUnloaded, nothing past the first failure is needed.
+        if (!bRead && (nullptr == psetUnloaded)) break;
     }
 
-    // Now iterate through those numbers and for each, load the box receipt.
+    // Instantiate and verify them, on several threads if configured. Without
+    // psetUnloaded, receipts after the first failure are skipped, since they
+    // won't be used anyway.
     //
-    bool bRetVal = true;
+    const size_t nReceipts = vecReceipts.size();
+    std::atomic<size_t> nNext(0);
+    std::atomic<size_t> nFirstFailure(nReceipts);
 
-    for (auto& it : the_set) {
-        int64_t lSetNum = it;
+    auto verifyReceipts = [&]() {
+        for (size_t i = nNext++; i < nReceipts; i = nNext++) {
+            if ((nullptr == psetUnloaded) && (i > nFirstFailure)) continue;
 
-        OTTransaction* pTransaction = GetTransaction(lSetNum);
-        OT_ASSERT(nullptr != pTransaction);
+            BoxReceipt& theReceipt = vecReceipts[i];
 
-        // Failed loading the boxReceipt
-        //
-        if ((true == pTransaction->IsAbbreviated()) &&
-            (false == LoadBoxReceipt(lSetNum))) {
-            // WARNING: pTransaction must be re-Get'd below this point if
-            // needed, since pointer
-            // is bad if success on LoadBoxReceipt() call.
-            //
-            pTransaction = nullptr;
-            bRetVal = false;
-            OTLogStream* pLog = &otOut;
+            if (theReceipt.strRawFile.Exists())
+                theReceipt.pFullVersion = LoadBoxReceiptFromString(
+                    *theReceipt.pAbbrev, theReceipt.strRawFile);
 
-            if (nullptr != psetUnloaded) {
-                psetUnloaded->insert(lSetNum);
-                pLog = &otLog3;
+            if (nullptr != theReceipt.pFullVersion) continue;
+
+            size_t nFailure = nFirstFailure;
+            while ((i < nFailure) &&
+                   !nFirstFailure.compare_exchange_weak(nFailure, i)) {
             }
-            *pLog << "OTLedger::LoadBoxReceipts: Failed calling LoadBoxReceipt "
-                     "on "
-                     "abbreviated transaction number:" << lSetNum << ".\n";
-            // If psetUnloaded is passed in, then we don't want to break,
-            // because we want to
-            // populate it with the conmplete list of IDs that wouldn't load as
-            // a Box Receipt.
-            // Thus, we only break if psetUnloaded is nullptr, which is better
-            // optimization in that case.
-            // (If not building a list of all failures, then we can return at
-            // first sign of failure.)
-            //
-            if (nullptr == psetUnloaded) break;
         }
-        // else (success), no need for a block in that case.
+    };
+
+    const size_t nThreads =
+        std::min(static_cast<size_t>(std::max(GetBoxReceiptThreadCount(), 1)),
+                 nReceipts);
+
+    if (nThreads > 1) {
+        std::vector<std::thread> vecThreads;
+
+        for (size_t i = 1; i < nThreads; ++i)
+            vecThreads.push_back(std::thread(verifyReceipts));
+
+        verifyReceipts();
+
+        for (auto& theThread : vecThreads) theThread.join();
     }
+    else
+        verifyReceipts();
 
-    // You might ask, why didn't I just iterate through the transactions
-    // directly and just call
-    // LoadBoxReceipt on each one? Answer: Because that function actually
-    // deletes the transaction
-    // and replaces it with a different object, if successful.
+    // Finally, in order, replace each abbreviated receipt with its full
+    // version. (That's also why this doesn't iterate the transactions
+    // directly: replacing one deletes it.)
+    //
+    bool bRetVal = true;
+
+    for (auto& theReceipt : vecReceipts) {
+        // Without psetUnloaded, stop at the first failure, like a serial load.
+        if (!bRetVal && (nullptr == psetUnloaded)) {
+            delete theReceipt.pFullVersion;
+            continue;
+        }
+
+        if (nullptr != theReceipt.pFullVersion) {
+            RemoveTransaction(theReceipt.lTransactionNum); // deletes pAbbrev
+            AddTransaction(*theReceipt.pFullVersion);      // takes ownership.
+            continue;
+        }
+
+        bRetVal = false;
+
+        OTLogStream* pLog = &otOut;
+
+        if (nullptr != psetUnloaded) {
+            psetUnloaded->insert(theReceipt.lTransactionNum);
+            pLog = &otLog3;
+        }
+        *pLog << "OTLedger::LoadBoxReceipts: Failed calling LoadBoxReceipt "
+                 "on "
+                 "abbreviated transaction number:"
+              << theReceipt.lTransactionNum << ".\n";
+    }
 
     return bRetVal;
 }
@@ -1154,17 +1215,16 @@ int32_t Ledger::GetTransactionIndex(int64_t lTransactionNum)
 // If it is, return a pointer to it, otherwise return nullptr.
 OTTransaction* Ledger::GetTransaction(int64_t lTransactionNum) const
 {
-    // loop through the transactions inside this ledger
+    // The map is keyed by transaction number, so look it up directly instead
+    // of looping through the transactions inside this ledger.
+    auto it = m_mapTransactions.find(lTransactionNum);
 
-    for (auto& it : m_mapTransactions) {
-        OTTransaction* pTransaction = it.second;
-        OT_ASSERT(nullptr != pTransaction);
+    if (m_mapTransactions.end() == it) return nullptr;
 
-        if (pTransaction->GetTransactionNum() == lTransactionNum) {
-            return pTransaction;
-        }
-    }
-    return nullptr;
+    OTTransaction* pTransaction = it->second;
+    OT_ASSERT(nullptr != pTransaction);
+
+    return pTransaction;
 }
 
 // Return a count of all the transactions in this ledger that are IN REFERENCE
@@ -1723,10 +1783,15 @@ void Ledger::UpdateContents() // Before transmission or serialization, this is
     String strType(GetTypeString()), strLedgerAcctID(GetPurportedAccountID()),
         strLedgerAcctNotaryID(GetPurportedNotaryID()), strNymID(GetNymID());
 
+    // Reuse the previous size as a guess for the new one.
+    std::string str_result;
+    str_result.reserve(m_xmlUnsigned.GetLength());
+
     // I release this because I'm about to repopulate it.
     m_xmlUnsigned.Release();
 
-    Tag tag("accountLedger");
+    XMLWriter tag(str_result);
+    tag.open("accountLedger");
 
     tag.add_attribute("version", m_strVersion.Get());
     tag.add_attribute("type", strType.Get());
@@ -1791,10 +1856,9 @@ void Ledger::UpdateContents() // Before transmission or serialization, this is
         }
     }
 
-    std::string str_result;
-    tag.output(str_result);
+    tag.close();
 
-    m_xmlUnsigned.Concatenate("%s", str_result.c_str());
+    m_xmlUnsigned.Set(str_result.c_str());
 }
 
 // LoadContract will call this function at the right time.
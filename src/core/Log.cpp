@@ -39,12 +39,16 @@
 #include <opentxs/core/stdafx.hpp>
 
 #include <opentxs/core/Log.hpp>
+#include <opentxs/core/util/LogWriter.hpp>
 #include <opentxs/core/util/OTPaths.hpp>
 #include <opentxs/core/util/stacktrace.h>
 #include <opentxs/core/Version.hpp>
 
+#include <cstdlib>
 #include <cstring>
+#include <map>
 #include <mutex>
+#include <string>
 
 #ifndef _WIN32
 #include <cerrno>
@@ -70,6 +74,11 @@
 #endif
 
 #define LOG_DEQUE_SIZE 1024
+// Lines that can be waiting for the log writer thread before loggers have to
+// wait for it.
+#define LOG_RING_SIZE 4096
+// Longest line an OTLogStream builds before handing it off anyway.
+#define LOG_STREAM_LINE_SIZE 1000
 
 extern "C" {
 
@@ -134,6 +143,22 @@ namespace opentxs
 
 Log* Log::pLogger = nullptr;
 
+namespace
+{
+// Guards the memlog, since the server logs from several threads at once.
+// (Recursive, since a failed assert while logging logs too.) The log file
+// itself is fed through the LogWriter, which needs no lock here.
+std::recursive_mutex s_logMutex;
+
+int64_t s_lMaxLogFileSize = 0;
+int32_t s_nLogFileCount = 5;
+
+void FlushLogAtExit()
+{
+    Log::Flush();
+}
+} // namespace
+
 const String Log::m_strVersion = OPENTXS_VERSION_STRING;
 const String Log::m_strPathSeparator = "/";
 
@@ -148,33 +173,36 @@ OTLOG_IMPORT OTLogStream otLog5(5); // logs using OTLog::vOutput(5)
 OTLogStream::OTLogStream(int _logLevel)
     : std::ostream(this)
     , logLevel(_logLevel)
-    , next(0)
-    , pBuffer(new char[1024])
 {
 }
 
 OTLogStream::~OTLogStream()
 {
-    delete[] pBuffer;
-    pBuffer = nullptr;
 }
 
+// The streams are globals shared by every thread, so the line being built
+// can't live in the stream: two threads logging at once would splice their
+// characters into each other's lines. Each thread keeps its own instead.
 int OTLogStream::overflow(int c)
 {
-    pBuffer[next++] = c;
-    if (c != '\n' && next < 1000) {
+    thread_local std::map<const OTLogStream*, std::string> lines;
+
+    std::string& line = lines[this];
+    line += static_cast<char>(c);
+
+    if (c != '\n' && line.size() < LOG_STREAM_LINE_SIZE) {
         return 0;
     }
 
-    pBuffer[next++] = '\0';
-    next = 0;
+    std::string output;
+    output.swap(line);
 
     if (logLevel < 0) {
-        Log::Error(pBuffer);
+        Log::Error(output.c_str());
         return 0;
     }
 
-    Log::Output(logLevel, pBuffer);
+    Log::Output(logLevel, output.c_str());
     return 0;
 }
 
@@ -186,6 +214,7 @@ bool Log::Init(const String& strThreadContext, const int32_t& nLogLevel)
     if (nullptr == pLogger) {
         pLogger = new Log();
         pLogger->m_bInitialized = false;
+        pLogger->m_pWriter = nullptr;
     }
 
     if (strThreadContext.Compare(GLOBAL_LOGNAME)) return false;
@@ -236,6 +265,21 @@ bool Log::Init(const String& strThreadContext, const int32_t& nLogLevel)
                 return false;
             };
 
+        if (pLogger->m_strLogFilePath.Exists()) {
+            pLogger->m_pWriter =
+                new LogWriter(pLogger->m_strLogFilePath.Get(), LOG_RING_SIZE);
+            pLogger->m_pWriter->SetRotation(s_lMaxLogFileSize,
+                                            s_nLogFileCount);
+
+            // Whatever is still queued when the process exits normally
+            // should make it into the file.
+            static bool bFlushAtExit = false;
+            if (!bFlushAtExit) {
+                std::atexit(FlushLogAtExit);
+                bFlushAtExit = true;
+            }
+        }
+
         pLogger->m_bInitialized = true;
 
         // Set the new log-assert function pointer.
@@ -261,6 +305,10 @@ bool Log::IsInitialized()
 bool Log::Cleanup()
 {
     if (nullptr != pLogger) {
+        if (nullptr != pLogger->m_pWriter) {
+            delete pLogger->m_pWriter; // Flushes it.
+            pLogger->m_pWriter = nullptr;
+        }
         delete pLogger;
         pLogger = nullptr;
         return true;
@@ -342,9 +390,19 @@ bool Log::SetLogLevel(const int32_t& nLogLevel)
 // command line utilities who might otherwise interpret it as their own input,
 // if I was actually writing to stdout.)
 //
+// Once Init has opened the log file, the line is only queued here; the
+// LogWriter thread echoes it to stderr and appends it to the file.
+//
 // static
 bool Log::LogToFile(const String& strOutput)
 {
+    if ((nullptr != pLogger) && (nullptr != pLogger->m_pWriter)) {
+        if (!strOutput.Exists()) return false;
+
+        pLogger->m_pWriter->Push(strOutput.Get());
+        return true;
+    }
+
     // We now do this either way.
     {
         std::cerr << strOutput;
@@ -379,6 +437,28 @@ bool Log::LogToFile(const String& strOutput)
     return bSuccess;
 }
 
+// static
+void Log::Flush()
+{
+    if ((nullptr != pLogger) && (nullptr != pLogger->m_pWriter))
+        pLogger->m_pWriter->Flush();
+    else
+        std::cerr.flush();
+}
+
+// static
+bool Log::SetLogRotation(const int64_t& lMaxFileSize,
+                         const int32_t& nFileCount)
+{
+    s_lMaxLogFileSize = lMaxFileSize;
+    s_nLogFileCount = nFileCount;
+
+    if ((nullptr != pLogger) && (nullptr != pLogger->m_pWriter))
+        pLogger->m_pWriter->SetRotation(lMaxFileSize, nFileCount);
+
+    return true;
+}
+
 String Log::GetMemlogAtIndex(int32_t nIndex)
 {
     // lets check if we are Initialized in this context
@@ -524,6 +604,10 @@ bool Log::SleepMilliseconds(int64_t lMilliseconds)
 size_t Log::logAssert(const char* szFilename, size_t nLinenumber,
                       const char* szMessage)
 {
+    // Anything still queued for the log file happened before this, so it
+    // should appear before it.
+    Log::Flush();
+
     if (nullptr != szMessage) {
 #ifndef ANDROID // if NOT android
         std::cerr << szMessage << "\n";
@@ -548,6 +632,7 @@ size_t Log::logAssert(const char* szFilename, size_t nLinenumber,
         strTemp.Format("\nOT_ASSERT in %s at line %" PRI_SIZE "\n", szFilename,
                        nLinenumber);
         LogToFile(strTemp.Get());
+        Log::Flush(); // We're about to terminate.
 
 #else // if Android
         String strAndroidAssertMsg;
@@ -583,7 +668,10 @@ void Log::Output(int32_t nVerbosity, const char* szOutput)
         return;
 
     // We store the last 1024 logs so programmers can access them via the API.
-    if (bHaveLogger) Log::PushMemlogFront(szOutput);
+    if (bHaveLogger) {
+        std::lock_guard<std::recursive_mutex> lock(s_logMutex);
+        Log::PushMemlogFront(szOutput);
+    }
 
 #ifndef ANDROID // if NOT android
 
@@ -699,7 +787,10 @@ void Log::Error(const char* szError)
     if ((nullptr == szError)) return;
 
     // We store the last 1024 logs so programmers can access them via the API.
-    if (bHaveLogger) Log::PushMemlogFront(szError);
+    if (bHaveLogger) {
+        std::lock_guard<std::recursive_mutex> lock(s_logMutex);
+        Log::PushMemlogFront(szError);
+    }
 
 #ifndef ANDROID // if NOT android
 
@@ -44,6 +44,7 @@
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Nym.hpp>
 #include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/crypto/OTBase64.hpp>
 #include <opentxs/core/util/Tag.hpp>
 
 #include <fstream>
@@ -51,6 +52,32 @@
 
 #include <irrxml/irrXML.hpp>
 
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable : 4244)
+#pragma warning(disable : 4267)
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+#ifndef __clang__
+// -Wuseless-cast does not exist in clang
+#pragma GCC diagnostic ignored "-Wuseless-cast"
+#endif
+#endif
+
+#include "Wire.pb.h"
+
+#ifdef _WIN32
+#pragma warning(pop)
+#else
+#pragma GCC diagnostic pop
+#endif
+
+// Base64 blocks shorter than this stay in the skeleton; cutting them out
+// wouldn't pay for their framing.
+#define WIRE_MIN_BLOCK_SIZE 128
+#define WIRE_BASE64_LINE 64
+
 // PROTOCOL DOCUMENT
 
 // --- This is the file that implements the entire message protocol.
@@ -63,8 +90,164 @@
 namespace opentxs
 {
 
+namespace
+{
+// Starts every SaveBinary message. Armored messages never start with NUL,
+// and servers that predate the binary form reply to it with an empty frame.
+const char s_binaryMagic[] = {'\0', 'O', 'T', 'B'};
+
+bool IsBase64Char(char c)
+{
+    return ((c >= 'A') && (c <= 'Z')) || ((c >= 'a') && (c <= 'z')) ||
+           ((c >= '0') && (c <= '9')) || ('+' == c) || ('/' == c) ||
+           ('=' == c);
+}
+
+// Length of the line starting at pos, if it is nothing but base64 characters
+// followed by a newline. Otherwise 0.
+size_t Base64LineLength(const std::string& text, size_t pos)
+{
+    size_t end = pos;
+    while ((end < text.size()) && IsBase64Char(text[end])) ++end;
+
+    if ((end == pos) || (end >= text.size()) || ('\n' != text[end])) return 0;
+
+    return end - pos;
+}
+
+// Decodes text[begin, end) into raw, but only if encoding raw again gives
+// back exactly the same text, so LoadBinary can restore it byte for byte.
+bool DecodeCanonicalBlock(const std::string& text, size_t begin, size_t end,
+                          std::string& raw)
+{
+    const size_t size = end - begin;
+
+    raw.resize(OTBase64::DecodedSizeMax(size));
+    size_t rawSize = raw.size();
+    if (!OTBase64::Decode(text.data() + begin, size,
+                          reinterpret_cast<uint8_t*>(&raw[0]), rawSize)) {
+        return false;
+    }
+    raw.resize(rawSize);
+
+    std::string encoded(OTBase64::EncodedSize(rawSize, true), '\0');
+    encoded.resize(OTBase64::Encode(reinterpret_cast<const uint8_t*>(
+                                        raw.data()),
+                                    rawSize, &encoded[0], true));
+
+    return 0 == text.compare(begin, size, encoded);
+}
+} // namespace
+
 OTMessageStrategyManager Message::messageStrategyManager;
 
+// static
+bool Message::IsBinary(const char* data, size_t size)
+{
+    return (size >= sizeof(s_binaryMagic)) &&
+           (0 == memcmp(data, s_binaryMagic, sizeof(s_binaryMagic)));
+}
+
+bool Message::SaveBinary(std::string& strOutput) const
+{
+    if (!m_strRawFile.Exists()) return false;
+
+    const std::string text(m_strRawFile.Get(), m_strRawFile.GetLength());
+    OTDB::WireMessage_InternalPB wire;
+    std::string* skeleton = wire.mutable_skeleton();
+    skeleton->reserve(text.size());
+
+    // Every base64 block in the signed text is a run of full lines followed
+    // by at most one short one, and starts at the beginning of a line.
+    size_t pos = 0;    // Start of the current line.
+    size_t copied = 0; // Everything before this is in the skeleton already.
+    std::string raw;
+
+    while (pos < text.size()) {
+        size_t end = pos;
+        size_t length = 0;
+
+        while (WIRE_BASE64_LINE == (length = Base64LineLength(text, end))) {
+            end += length + 1;
+        }
+        if (0 < length) end += length + 1;
+
+        if ((WIRE_MIN_BLOCK_SIZE <= end - pos) &&
+            DecodeCanonicalBlock(text, pos, end, raw)) {
+            skeleton->append(text, copied, pos - copied);
+
+            OTDB::WireBlock_InternalPB* block = wire.add_block();
+            block->set_offset(skeleton->size());
+            block->set_value(raw);
+
+            copied = pos = end;
+            continue;
+        }
+
+        const size_t newline = text.find('\n', pos);
+        if (std::string::npos == newline) break;
+        pos = newline + 1;
+    }
+
+    skeleton->append(text, copied, std::string::npos);
+
+    strOutput.assign(s_binaryMagic, sizeof(s_binaryMagic));
+    if (!wire.AppendToString(&strOutput)) return false;
+
+    otLog4 << "Message::SaveBinary: " << m_strCommand << ": "
+           << strOutput.size() << " bytes (signed text is " << text.size()
+           << " bytes.)\n";
+
+    return true;
+}
+
+bool Message::LoadBinary(const char* data, size_t size)
+{
+    OTDB::WireMessage_InternalPB wire;
+
+    if (!IsBinary(data, size) ||
+        !wire.ParseFromArray(data + sizeof(s_binaryMagic),
+                             static_cast<int>(size - sizeof(s_binaryMagic)))) {
+        otErr << __FUNCTION__ << ": Not a binary message.\n";
+        return false;
+    }
+
+    const std::string& skeleton = wire.skeleton();
+    size_t textSize = skeleton.size();
+    for (int i = 0; i < wire.block_size(); ++i) {
+        textSize += OTBase64::EncodedSize(wire.block(i).value().size(), true);
+    }
+
+    std::string text;
+    size_t copied = 0;
+
+    text.reserve(textSize);
+
+    for (int i = 0; i < wire.block_size(); ++i) {
+        const OTDB::WireBlock_InternalPB& block = wire.block(i);
+        const std::string& raw = block.value();
+
+        if ((block.offset() < copied) || (block.offset() > skeleton.size())) {
+            otErr << __FUNCTION__ << ": Block out of order.\n";
+            return false;
+        }
+
+        const size_t offset = static_cast<size_t>(block.offset());
+        text.append(skeleton, copied, offset - copied);
+        copied = offset;
+
+        const size_t start = text.size();
+        text.resize(start + OTBase64::EncodedSize(raw.size(), true));
+        text.resize(start + OTBase64::Encode(reinterpret_cast<const uint8_t*>(
+                                                 raw.data()),
+                                             raw.size(), &text[start], true));
+    }
+
+    text.append(skeleton, copied, std::string::npos);
+
+    return LoadContractFromString(String(text));
+}
+
 bool Message::HarvestTransactionNumbers(
     Nym& theNym,
     bool bHarvestingForRetry,          // false until positively asserted.
@@ -480,6 +663,11 @@ public:
         pTag->add_attribute("marketID", m.m_strNymID2.Get());
         pTag->add_attribute("depth", formatLong(m.m_lDepth));
 
+        // Optional: only the changes since this market version.
+        if (m.m_lTransactionNum > 0)
+            pTag->add_attribute("sinceVersion",
+                                formatLong(m.m_lTransactionNum));
+
         parent.add_tag(pTag);
     }
 
@@ -495,6 +683,11 @@ public:
 
         if (strDepth.GetLength() > 0) m.m_lDepth = strDepth.ToLong();
 
+        String strSinceVersion = xml->getAttributeValue("sinceVersion");
+
+        if (strSinceVersion.GetLength() > 0)
+            m.m_lTransactionNum = strSinceVersion.ToLong();
+
         otWarn << "\nCommand: " << m.m_strCommand
                << "\nNymID:    " << m.m_strNymID
                << "\nNotaryID: " << m.m_strNotaryID
@@ -521,6 +714,11 @@ public:
         pTag->add_attribute("notaryID", m.m_strNotaryID.Get());
         pTag->add_attribute("depth", formatLong(m.m_lDepth));
         pTag->add_attribute("marketID", m.m_strNymID2.Get());
+        pTag->add_attribute("marketVersion", formatLong(m.m_lTransactionNum));
+
+        // The payload holds only the offers that changed since the version
+        // the client asked about.
+        if (m.m_bBool) pTag->add_attribute("delta", formatBool(m.m_bBool));
 
         if (m.m_bSuccess && (m.m_ascPayload.GetLength() > 2) &&
             (m.m_lDepth > 0)) {
@@ -547,6 +745,13 @@ public:
 
         if (strDepth.GetLength() > 0) m.m_lDepth = strDepth.ToLong();
 
+        String strVersion = xml->getAttributeValue("marketVersion");
+
+        if (strVersion.GetLength() > 0)
+            m.m_lTransactionNum = strVersion.ToLong();
+
+        m.m_bBool = String(xml->getAttributeValue("delta")).Compare("true");
+
         const char* pElementExpected = nullptr;
         if (m.m_bSuccess && (m.m_lDepth > 0))
             pElementExpected = "messagePayload";
@@ -715,6 +920,129 @@ RegisterStrategy StrategyGetMarketRecentTradesResponse::reg(
     "getMarketRecentTradesResponse",
     new StrategyGetMarketRecentTradesResponse());
 
+class StrategyGetMarketCandles : public OTMessageStrategy
+{
+public:
+    virtual void writeXml(Message& m, Tag& parent)
+    {
+        TagPtr pTag(new Tag(m.m_strCommand.Get()));
+
+        pTag->add_attribute("requestNum", m.m_strRequestNum.Get());
+        pTag->add_attribute("nymID", m.m_strNymID.Get());
+        pTag->add_attribute("notaryID", m.m_strNotaryID.Get());
+        pTag->add_attribute("marketID", m.m_strNymID2.Get());
+        pTag->add_attribute("resolution", m.m_strType.Get());
+        pTag->add_attribute("depth", formatLong(m.m_lDepth));
+
+        parent.add_tag(pTag);
+    }
+
+    virtual int32_t processXml(Message& m, irr::io::IrrXMLReader*& xml)
+    {
+        m.m_strCommand = xml->getNodeName(); // Command
+        m.m_strNymID = xml->getAttributeValue("nymID");
+        m.m_strNotaryID = xml->getAttributeValue("notaryID");
+        m.m_strRequestNum = xml->getAttributeValue("requestNum");
+        m.m_strNymID2 = xml->getAttributeValue("marketID");
+        m.m_strType = xml->getAttributeValue("resolution");
+
+        String strDepth = xml->getAttributeValue("depth");
+
+        if (strDepth.GetLength() > 0) m.m_lDepth = strDepth.ToLong();
+
+        otWarn << "\nCommand: " << m.m_strCommand
+               << "\nNymID:    " << m.m_strNymID
+               << "\nNotaryID: " << m.m_strNotaryID
+               << "\n Market ID: " << m.m_strNymID2
+               << "\n Resolution: " << m.m_strType
+               << "\n Request #: " << m.m_strRequestNum << "\n";
+
+        return 1;
+    }
+    static RegisterStrategy reg;
+};
+RegisterStrategy StrategyGetMarketCandles::reg("getMarketCandles",
+                                               new StrategyGetMarketCandles());
+
+class StrategyGetMarketCandlesResponse : public OTMessageStrategy
+{
+public:
+    virtual void writeXml(Message& m, Tag& parent)
+    {
+        TagPtr pTag(new Tag(m.m_strCommand.Get()));
+
+        pTag->add_attribute("success", formatBool(m.m_bSuccess));
+        pTag->add_attribute("requestNum", m.m_strRequestNum.Get());
+        pTag->add_attribute("nymID", m.m_strNymID.Get());
+        pTag->add_attribute("notaryID", m.m_strNotaryID.Get());
+        pTag->add_attribute("depth", formatLong(m.m_lDepth));
+        pTag->add_attribute("marketID", m.m_strNymID2.Get());
+        pTag->add_attribute("resolution", m.m_strType.Get());
+
+        if (m.m_bSuccess && (m.m_ascPayload.GetLength() > 2) &&
+            (m.m_lDepth > 0)) {
+            pTag->add_tag("messagePayload", m.m_ascPayload.Get());
+        }
+        else if (!m.m_bSuccess && (m.m_ascInReferenceTo.GetLength() > 2)) {
+            pTag->add_tag("inReferenceTo", m.m_ascInReferenceTo.Get());
+        }
+
+        parent.add_tag(pTag);
+    }
+
+    virtual int32_t processXml(Message& m, irr::io::IrrXMLReader*& xml)
+    {
+        processXmlSuccess(m, xml);
+
+        m.m_strCommand = xml->getNodeName(); // Command
+        m.m_strRequestNum = xml->getAttributeValue("requestNum");
+        m.m_strNymID = xml->getAttributeValue("nymID");
+        m.m_strNotaryID = xml->getAttributeValue("notaryID");
+        m.m_strNymID2 = xml->getAttributeValue("marketID");
+        m.m_strType = xml->getAttributeValue("resolution");
+
+        String strDepth = xml->getAttributeValue("depth");
+
+        if (strDepth.GetLength() > 0) m.m_lDepth = strDepth.ToLong();
+
+        const char* pElementExpected = nullptr;
+        if (m.m_bSuccess && (m.m_lDepth > 0))
+            pElementExpected = "messagePayload";
+        else if (!m.m_bSuccess)
+            pElementExpected = "inReferenceTo";
+
+        if (nullptr != pElementExpected) {
+            OTASCIIArmor ascTextExpected;
+
+            if (!Contract::LoadEncodedTextFieldByName(xml, ascTextExpected,
+                                                      pElementExpected)) {
+                otErr << "Error in OTMessage::ProcessXMLNode: "
+                         "Expected " << pElementExpected
+                      << " element with text field, for " << m.m_strCommand
+                      << ".\n";
+                return (-1); // error condition
+            }
+
+            if (m.m_bSuccess)
+                m.m_ascPayload.Set(ascTextExpected);
+            else
+                m.m_ascInReferenceTo = ascTextExpected;
+        }
+
+        otWarn << "\nCommand: " << m.m_strCommand << "   "
+               << (m.m_bSuccess ? "SUCCESS" : "FAILED")
+               << "\nNymID:    " << m.m_strNymID
+               << "\n NotaryID: " << m.m_strNotaryID
+               << "\n MarketID: " << m.m_strNymID2
+               << "\n Resolution: " << m.m_strType << "\n\n";
+
+        return 1;
+    }
+    static RegisterStrategy reg;
+};
+RegisterStrategy StrategyGetMarketCandlesResponse::reg(
+    "getMarketCandlesResponse", new StrategyGetMarketCandlesResponse());
+
 class StrategyGetNymMarketOffers : public OTMessageStrategy
 {
 public:
@@ -1373,6 +1701,101 @@ public:
 RegisterStrategy StrategyUsageCreditsResponse::reg(
     "usageCreditsResponse", new StrategyUsageCreditsResponse());
 
+class StrategyGetServerStats : public OTMessageStrategy
+{
+public:
+    virtual void writeXml(Message& m, Tag& parent)
+    {
+        TagPtr pTag(new Tag(m.m_strCommand.Get()));
+
+        pTag->add_attribute("requestNum", m.m_strRequestNum.Get());
+        pTag->add_attribute("nymID", m.m_strNymID.Get());
+        pTag->add_attribute("notaryID", m.m_strNotaryID.Get());
+
+        parent.add_tag(pTag);
+    }
+
+    virtual int32_t processXml(Message& m, irr::io::IrrXMLReader*& xml)
+    {
+        m.m_strCommand = xml->getNodeName(); // Command
+        m.m_strNymID = xml->getAttributeValue("nymID");
+        m.m_strNotaryID = xml->getAttributeValue("notaryID");
+        m.m_strRequestNum = xml->getAttributeValue("requestNum");
+
+        otWarn << "\nCommand: " << m.m_strCommand
+               << "\nNymID:    " << m.m_strNymID
+               << "\nNotaryID: " << m.m_strNotaryID
+               << "\nRequest #: " << m.m_strRequestNum << "\n";
+
+        return 1;
+    }
+    static RegisterStrategy reg;
+};
+RegisterStrategy StrategyGetServerStats::reg("getServerStats",
+                                             new StrategyGetServerStats());
+
+// The payload is the XML from ServerStats::Snapshot.
+class StrategyGetServerStatsResponse : public OTMessageStrategy
+{
+public:
+    virtual void writeXml(Message& m, Tag& parent)
+    {
+        TagPtr pTag(new Tag(m.m_strCommand.Get()));
+
+        pTag->add_attribute("success", formatBool(m.m_bSuccess));
+        pTag->add_attribute("requestNum", m.m_strRequestNum.Get());
+        pTag->add_attribute("nymID", m.m_strNymID.Get());
+        pTag->add_attribute("notaryID", m.m_strNotaryID.Get());
+
+        if (m.m_bSuccess && (m.m_ascPayload.GetLength() > 2)) {
+            pTag->add_tag("messagePayload", m.m_ascPayload.Get());
+        }
+        else if (!m.m_bSuccess && (m.m_ascInReferenceTo.GetLength() > 2)) {
+            pTag->add_tag("inReferenceTo", m.m_ascInReferenceTo.Get());
+        }
+
+        parent.add_tag(pTag);
+    }
+
+    virtual int32_t processXml(Message& m, irr::io::IrrXMLReader*& xml)
+    {
+        processXmlSuccess(m, xml);
+
+        m.m_strCommand = xml->getNodeName(); // Command
+        m.m_strRequestNum = xml->getAttributeValue("requestNum");
+        m.m_strNymID = xml->getAttributeValue("nymID");
+        m.m_strNotaryID = xml->getAttributeValue("notaryID");
+
+        const char* pElementExpected =
+            m.m_bSuccess ? "messagePayload" : "inReferenceTo";
+        OTASCIIArmor ascTextExpected;
+
+        if (!Contract::LoadEncodedTextFieldByName(xml, ascTextExpected,
+                                                  pElementExpected)) {
+            otErr << "Error in OTMessage::ProcessXMLNode: "
+                     "Expected " << pElementExpected
+                  << " element with text field, for " << m.m_strCommand
+                  << ".\n";
+            return (-1); // error condition
+        }
+
+        if (m.m_bSuccess)
+            m.m_ascPayload.Set(ascTextExpected);
+        else
+            m.m_ascInReferenceTo.Set(ascTextExpected);
+
+        otWarn << "\nCommand: " << m.m_strCommand << "   "
+               << (m.m_bSuccess ? "SUCCESS" : "FAILED")
+               << "\nNymID:    " << m.m_strNymID
+               << "\nNotaryID: " << m.m_strNotaryID << "\n\n";
+
+        return 1;
+    }
+    static RegisterStrategy reg;
+};
+RegisterStrategy StrategyGetServerStatsResponse::reg(
+    "getServerStatsResponse", new StrategyGetServerStatsResponse());
+
 // This one isn't part of the message protocol, but is used for
 // outmail storage.
 // (Because outmail isn't encrypted like the inmail is, since the
@@ -2473,6 +2896,226 @@ public:
 RegisterStrategy StrategyGetBoxReceiptResponse::reg(
     "getBoxReceiptResponse", new StrategyGetBoxReceiptResponse());
 
+// Same as getBoxReceipt, for a list of receipts in the same box.
+class StrategyGetBoxReceipts : public OTMessageStrategy
+{
+public:
+    virtual void writeXml(Message& m, Tag& parent)
+    {
+        TagPtr pTag(new Tag(m.m_strCommand.Get()));
+
+        pTag->add_attribute("requestNum", m.m_strRequestNum.Get());
+        pTag->add_attribute("nymID", m.m_strNymID.Get());
+        pTag->add_attribute("notaryID", m.m_strNotaryID.Get());
+        // If retrieving box receipts for Nymbox, NymID
+        // will appear in this variable.
+        pTag->add_attribute("accountID", m.m_strAcctID.Get());
+        pTag->add_attribute("boxType", // outbox is 2.
+                            (m.m_lDepth == 0)
+                                ? "nymbox"
+                                : ((m.m_lDepth == 1) ? "inbox" : "outbox"));
+
+        String strNums;
+        if (m.m_TransactionNums.Output(strNums) && strNums.Exists()) {
+            const OTASCIIArmor ascTemp(strNums);
+            if (ascTemp.Exists()) {
+                pTag->add_tag("transactionNums", ascTemp.Get());
+            }
+        }
+
+        parent.add_tag(pTag);
+    }
+
+    int32_t processXml(Message& m, irr::io::IrrXMLReader*& xml)
+    {
+        m.m_strCommand = xml->getNodeName(); // Command
+        m.m_strNymID = xml->getAttributeValue("nymID");
+        m.m_strNotaryID = xml->getAttributeValue("notaryID");
+        m.m_strAcctID = xml->getAttributeValue("accountID");
+        m.m_strRequestNum = xml->getAttributeValue("requestNum");
+
+        const String strBoxType = xml->getAttributeValue("boxType");
+
+        if (strBoxType.Compare("nymbox"))
+            m.m_lDepth = 0;
+        else if (strBoxType.Compare("inbox"))
+            m.m_lDepth = 1;
+        else if (strBoxType.Compare("outbox"))
+            m.m_lDepth = 2;
+        else {
+            m.m_lDepth = 0;
+            otErr << "Error in OTMessage::ProcessXMLNode:\n"
+                     "Expected boxType to be inbox, outbox, or nymbox, in "
+                     "getBoxReceipts\n";
+            return (-1);
+        }
+
+        String strNums;
+        if (!Contract::LoadEncodedTextFieldByName(xml, strNums,
+                                                  "transactionNums")) {
+            otErr << "Error in OTMessage::ProcessXMLNode: Expected "
+                     "transactionNums element with text field, for "
+                  << m.m_strCommand << ".\n";
+            return (-1); // error condition
+        }
+
+        m.m_TransactionNums.Release();
+        m.m_TransactionNums.Add(strNums);
+
+        otWarn << "\n Command: " << m.m_strCommand
+               << " \n NymID:    " << m.m_strNymID
+               << "\n AccountID:    " << m.m_strAcctID
+               << "\n"
+                  " NotaryID: " << m.m_strNotaryID
+               << "\n Request#: " << m.m_strRequestNum
+               << "  Receipts: " << m.m_TransactionNums.Count()
+               << "   boxType: "
+               << ((m.m_lDepth == 0) ? "nymbox" : (m.m_lDepth == 1) ? "inbox"
+                                                                    : "outbox")
+               << "\n\n"; // outbox is 2.);
+
+        return 1;
+    }
+    static RegisterStrategy reg;
+};
+RegisterStrategy StrategyGetBoxReceipts::reg("getBoxReceipts",
+                                             new StrategyGetBoxReceipts());
+
+class StrategyGetBoxReceiptsResponse : public OTMessageStrategy
+{
+public:
+    virtual void writeXml(Message& m, Tag& parent)
+    {
+        TagPtr pTag(new Tag(m.m_strCommand.Get()));
+
+        pTag->add_attribute("success", formatBool(m.m_bSuccess));
+        pTag->add_attribute("requestNum", m.m_strRequestNum.Get());
+        pTag->add_attribute("nymID", m.m_strNymID.Get());
+        pTag->add_attribute("notaryID", m.m_strNotaryID.Get());
+        pTag->add_attribute("accountID", m.m_strAcctID.Get());
+        pTag->add_attribute("boxType", // outbox is 2.
+                            (m.m_lDepth == 0)
+                                ? "nymbox"
+                                : ((m.m_lDepth == 1) ? "inbox" : "outbox"));
+        pTag->add_attribute(
+            "receiptCount",
+            formatLong(m.m_bSuccess
+                           ? static_cast<int64_t>(m.m_mapBoxReceipts.size())
+                           : 0));
+
+        if (m.m_ascInReferenceTo.GetLength()) {
+            pTag->add_tag("inReferenceTo", m.m_ascInReferenceTo.Get());
+        }
+
+        if (m.m_bSuccess) {
+            for (auto& it : m.m_mapBoxReceipts) {
+                TagPtr pReceipt(new Tag("boxReceipt", it.second.Get()));
+                pReceipt->add_attribute("transactionNum",
+                                        formatLong(it.first));
+                pTag->add_tag(pReceipt);
+            }
+        }
+
+        parent.add_tag(pTag);
+    }
+
+    int32_t processXml(Message& m, irr::io::IrrXMLReader*& xml)
+    {
+        processXmlSuccess(m, xml);
+
+        m.m_strCommand = xml->getNodeName(); // Command
+        m.m_strRequestNum = xml->getAttributeValue("requestNum");
+        m.m_strNymID = xml->getAttributeValue("nymID");
+        m.m_strNotaryID = xml->getAttributeValue("notaryID");
+        m.m_strAcctID = xml->getAttributeValue("accountID");
+
+        const String strBoxType = xml->getAttributeValue("boxType");
+
+        if (strBoxType.Compare("nymbox"))
+            m.m_lDepth = 0;
+        else if (strBoxType.Compare("inbox"))
+            m.m_lDepth = 1;
+        else if (strBoxType.Compare("outbox"))
+            m.m_lDepth = 2;
+        else {
+            m.m_lDepth = 0;
+            otErr << "Error in OTMessage::ProcessXMLNode:\n"
+                     "Expected boxType to be inbox, outbox, or nymbox, in "
+                     "getBoxReceiptsResponse reply\n";
+            return (-1);
+        }
+
+        const String strCount = xml->getAttributeValue("receiptCount");
+        const int64_t lCount = strCount.Exists() ? strCount.ToLong() : 0;
+
+        // inReferenceTo contains the getBoxReceipts (original request)
+        {
+            const char* pElementExpected = "inReferenceTo";
+            OTASCIIArmor& ascTextExpected = m.m_ascInReferenceTo;
+
+            if (!Contract::LoadEncodedTextFieldByName(xml, ascTextExpected,
+                                                      pElementExpected)) {
+                otErr << "Error in OTMessage::ProcessXMLNode: "
+                         "Expected " << pElementExpected
+                      << " element with text field, for " << m.m_strCommand
+                      << ".\n";
+                return (-1); // error condition
+            }
+        }
+
+        m.m_mapBoxReceipts.clear();
+
+        for (int64_t i = 0; m.m_bSuccess && (i < lCount); ++i) {
+            const char* pElementExpected = "boxReceipt";
+            OTASCIIArmor ascReceipt;
+            String::Map mapAttributes;
+            mapAttributes.insert(std::make_pair("transactionNum", ""));
+
+            if (!Contract::LoadEncodedTextFieldByName(
+                    xml, ascReceipt, pElementExpected, &mapAttributes)) {
+                otErr << "Error in OTMessage::ProcessXMLNode: "
+                         "Expected " << pElementExpected
+                      << " element with text field, for " << m.m_strCommand
+                      << ".\n";
+                return (-1); // error condition
+            }
+
+            const String strTransactionNum(mapAttributes["transactionNum"]);
+            const int64_t lTransactionNum =
+                strTransactionNum.Exists() ? strTransactionNum.ToLong() : 0;
+
+            if ((lTransactionNum <= 0) || !ascReceipt.Exists()) {
+                otErr << "Error in OTMessage::ProcessXMLNode: Expected "
+                         "transactionNum and text on each boxReceipt, for "
+                      << m.m_strCommand << ".\n";
+                return (-1); // error condition
+            }
+
+            m.m_mapBoxReceipts[lTransactionNum] = ascReceipt;
+        }
+
+        if (!m.m_ascInReferenceTo.GetLength()) {
+            otErr << "Error in OTMessage::ProcessXMLNode:\n"
+                     "Expected inReferenceTo element with text field in "
+                     "getBoxReceiptsResponse reply\n";
+            return (-1); // error condition
+        }
+
+        otWarn << "\nCommand: " << m.m_strCommand << "   "
+               << (m.m_bSuccess ? "SUCCESS" : "FAILED")
+               << "\nNymID:    " << m.m_strNymID
+               << "\nAccountID: " << m.m_strAcctID
+               << "\nReceipts: " << m.m_mapBoxReceipts.size()
+               << "\n"
+                  "NotaryID: " << m.m_strNotaryID << "\n\n";
+
+        return 1;
+    }
+    static RegisterStrategy reg;
+};
+RegisterStrategy StrategyGetBoxReceiptsResponse::reg(
+    "getBoxReceiptsResponse", new StrategyGetBoxReceiptsResponse());
+
 class StrategyUnregisterAccount : public OTMessageStrategy
 {
 public:
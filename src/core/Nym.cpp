@@ -63,6 +63,8 @@
 namespace opentxs
 {
 
+std::function<void(const String&)> Nym::s_NymfileSaved;
+
 Nym* Nym::LoadPublicNym(const Identifier& NYM_ID, const String* pstrName,
                         const char* szFuncName)
 {
@@ -5447,16 +5449,51 @@ bool Nym::SaveSignedNymfile(Nym& SIGNER_NYM)
     String strNymID;
     GetIdentifier(strNymID);
 
+    // Checked out of the server's Nym cache? Then the cache keeps the
+    // serialized nymfile, and may write it out later on our behalf.
+    if (nullptr != m_pstrCachedNymfile) {
+        m_pstrCachedNymfile->Release();
+        SavePseudonym(*m_pstrCachedNymfile);
+
+        if (m_bDeferSave) {
+            m_bNymfileDirty = true;
+            return true;
+        }
+
+        const bool bSaved = WriteSignedNymfile(
+            strNymID, *m_pstrCachedNymfile, SIGNER_NYM, &m_strNymfile);
+        m_bNymfileDirty = !bSaved;
+
+        return bSaved;
+    }
+
+    // First we save this nym to a string...
+    String strPayload;
+    SavePseudonym(strPayload);
+
+    const bool bSaved =
+        WriteSignedNymfile(strNymID, strPayload, SIGNER_NYM, &m_strNymfile);
+
+    if (bSaved && s_NymfileSaved) s_NymfileSaved(strNymID);
+
+    return bSaved;
+}
+
+// static
+bool Nym::WriteSignedNymfile(const String& strNymID, const String& strPayload,
+                             const Nym& SIGNER_NYM, String* pstrFilename)
+{
     // Create an OTSignedFile object, giving it the filename (the ID) and the
     // local directory ("nyms")
     OTSignedFile theNymfile(OTFolders::Nym().Get(), strNymID);
-    theNymfile.GetFilename(m_strNymfile);
 
-    otInfo << "Saving nym to: " << m_strNymfile << "\n";
+    if (nullptr != pstrFilename) theNymfile.GetFilename(*pstrFilename);
 
-    // First we save this nym to a string...
-    // Specifically, the file payload string on the OTSignedFile object.
-    SavePseudonym(theNymfile.GetFilePayload());
+    otInfo << "Saving nym to: " << OTFolders::Nym() << "/" << strNymID << "\n";
+
+    // The file payload string on the OTSignedFile object gets the contents of
+    // the Nym itself.
+    theNymfile.SetFilePayload(strPayload);
 
     // Now the OTSignedFile contains the path, the filename, AND the
     // contents of the Nym itself, saved to a string inside the OTSignedFile
@@ -5486,6 +5523,18 @@ bool Nym::SaveSignedNymfile(Nym& SIGNER_NYM)
     return false;
 }
 
+void Nym::SetCachedNymfile(String* pstrNymfile, bool bDeferSave)
+{
+    m_pstrCachedNymfile = pstrNymfile;
+    m_bDeferSave = (nullptr != pstrNymfile) && bDeferSave;
+}
+
+// static
+void Nym::SetNymfileSavedCallback(std::function<void(const String&)> callback)
+{
+    s_NymfileSaved = callback;
+}
+
 /// See if two nyms have identical lists of issued transaction numbers (#s
 /// currently signed for.)
 bool Nym::VerifyIssuedNumbersOnNym(Nym& THE_NYM)
@@ -6073,6 +6122,9 @@ Nym::Nym()
     : m_bMarkForDeletion(false)
     , m_pkeypair(new OTKeypair)
     , m_lUsageCredits(0)
+    , m_pstrCachedNymfile(nullptr)
+    , m_bDeferSave(false)
+    , m_bNymfileDirty(false)
 {
     OT_ASSERT(nullptr != m_pkeypair);
 
@@ -6088,6 +6140,9 @@ Nym::Nym(const String& name, const String& filename, const String& nymID)
     : m_bMarkForDeletion(false)
     , m_pkeypair(new OTKeypair)
     , m_lUsageCredits(0)
+    , m_pstrCachedNymfile(nullptr)
+    , m_bDeferSave(false)
+    , m_bNymfileDirty(false)
 {
     OT_ASSERT(nullptr != m_pkeypair);
 
@@ -6103,6 +6158,9 @@ Nym::Nym(const Identifier& nymID)
     : m_bMarkForDeletion(false)
     , m_pkeypair(new OTKeypair)
     , m_lUsageCredits(0)
+    , m_pstrCachedNymfile(nullptr)
+    , m_bDeferSave(false)
+    , m_bNymfileDirty(false)
 {
     OT_ASSERT(nullptr != m_pkeypair);
 
@@ -6115,6 +6173,9 @@ Nym::Nym(const String& strNymID)
     : m_bMarkForDeletion(false)
     , m_pkeypair(new OTKeypair)
     , m_lUsageCredits(0)
+    , m_pstrCachedNymfile(nullptr)
+    , m_bDeferSave(false)
+    , m_bNymfileDirty(false)
 {
     OT_ASSERT(nullptr != m_pkeypair);
 
@@ -152,12 +152,33 @@ void OTData::Release()
         // For security reasons, we clear the memory to 0 when deleting the
         // object. (Seems smart.)
         OTPassword::zeroMemory(data_, size_);
-        delete[] static_cast<uint8_t*>(data_);
+        deallocate();
         // If data_ was already nullptr, no need to re-Initialize().
         Initialize();
     }
 }
 
+// Returns the inline buffer for small sizes, otherwise a new heap buffer.
+// Doesn't touch data_.
+void* OTData::allocate(uint32_t size)
+{
+    if (size <= INLINE_SIZE) {
+        return static_cast<void*>(inline_);
+    }
+
+    void* data = static_cast<void*>(new uint8_t[size]);
+    OT_ASSERT(data != nullptr);
+
+    return data;
+}
+
+void OTData::deallocate()
+{
+    if (data_ != nullptr && !isInline()) {
+        delete[] static_cast<uint8_t*>(data_);
+    }
+}
+
 OTData& OTData::operator=(OTData rhs)
 {
     swap(rhs);
@@ -166,9 +187,21 @@ OTData& OTData::operator=(OTData rhs)
 
 void OTData::swap(OTData& rhs)
 {
+    const bool lhsInline = isInline();
+    const bool rhsInline = rhs.isInline();
+
     std::swap(data_, rhs.data_);
     std::swap(position_, rhs.position_);
     std::swap(size_, rhs.size_);
+    std::swap(inline_, rhs.inline_);
+
+    // Inline buffers moved with the contents, so point at the new location.
+    if (lhsInline) {
+        rhs.data_ = rhs.inline_;
+    }
+    if (rhsInline) {
+        data_ = inline_;
+    }
 }
 
 void OTData::Assign(const OTData& source)
@@ -198,8 +231,7 @@ void OTData::Assign(const void* data, uint32_t size)
     Release();
 
     if (data != nullptr && size > 0) {
-        data_ = static_cast<void*>(new uint8_t[size]);
-        OT_ASSERT(data_ != nullptr);
+        data_ = allocate(size);
         OTPassword::safe_memcpy(data_, size, data, size);
         size_ = size;
     }
@@ -210,14 +242,13 @@ bool OTData::Randomize(uint32_t size)
 {
     Release(); // This releases all memory and zeros out all members.
     if (size > 0) {
-        data_ = static_cast<void*>(new uint8_t[size]);
-        OT_ASSERT(data_ != nullptr);
+        data_ = allocate(size);
 
         if (!OTPassword::randomizeMemory_uint8(static_cast<uint8_t*>(data_),
                                                size)) {
             // randomizeMemory already logs, so I'm not logging again twice
             // here.
-            delete[] static_cast<uint8_t*>(data_);
+            deallocate();
             data_ = nullptr;
             return false;
         }
@@ -243,14 +274,18 @@ void OTData::Concatenate(const void* data, uint32_t size)
         return;
     }
 
-    void* newData = nullptr;
     uint32_t newSize = GetSize() + size;
 
-    if (newSize > 0) {
-        newData = static_cast<void*>(new uint8_t[newSize]);
-        OT_ASSERT(newData != nullptr);
-        OTPassword::zeroMemory(newData, newSize);
+    // Still fits in the inline buffer, which is where the data already is.
+    if (newSize <= INLINE_SIZE) {
+        OTPassword::safe_memcpy(inline_ + size_, INLINE_SIZE - size_, data,
+                                size);
+        size_ = newSize;
+        return;
     }
+
+    void* newData = allocate(newSize);
+    OTPassword::zeroMemory(newData, newSize);
     // If there's a new memory buffer (for the combined..)
     if (newData != nullptr) {
         // if THIS object has data inside of it...
@@ -266,9 +301,7 @@ void OTData::Concatenate(const void* data, uint32_t size)
                                 newSize - GetSize(), data, size);
     }
 
-    if (data_ != nullptr) {
-        delete[] static_cast<uint8_t*>(data_);
-    }
+    deallocate();
 
     data_ = newData;
     size_ = newSize;
@@ -287,8 +320,7 @@ void OTData::SetSize(uint32_t size)
     Release();
 
     if (size > 0) {
-        data_ = static_cast<void*>(new uint8_t[size]);
-        OT_ASSERT(data_ != nullptr);
+        data_ = allocate(size);
         OTPassword::zeroMemory(data_, size);
         size_ = size;
     }
@@ -227,10 +227,10 @@ int32_t OTServerContract::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
         if (!transportKeyB64) return -1;
         std::string transportKeyB64Trimmed(transportKeyB64);
         String::trim(transportKeyB64Trimmed);
-        size_t outLen;
+        size_t outLen = 0;
         m_transportKey = OTCrypto::It()->Base64Decode(
             transportKeyB64Trimmed.c_str(), &outLen, false);
-        if (outLen != TRANSPORT_KEY_SIZE) {
+        if (!m_transportKey || outLen != TRANSPORT_KEY_SIZE) {
             return -1;
         }
         return 1;
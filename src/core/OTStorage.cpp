@@ -46,10 +46,31 @@
 #include <opentxs/core/OTData.hpp>
 #include <opentxs/core/OTStoragePB.hpp>
 
+#include <cstdio>
 #include <sstream>
 #include <fstream>
+#include <set>
 #include <typeinfo>
 
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Lists the files of a batch commit until they're all in place. (See
+// StorageFS::onCommitBatch.)
+#define OTDB_FS_JOURNAL "opentxs.batch"
+// Appended to the path of each file, while it's waiting to be renamed.
+#define OTDB_FS_BATCH_SUFFIX ".batch"
+
 /*
  // We want to store EXISTING OT OBJECTS (Usually signed contracts)
  // These have an EXISTING OT path, such as "inbox/acct_id".
@@ -515,6 +536,11 @@ bool Exists(std::string strFolder, std::string oneStr, std::string twoStr,
         return false;
     }
 
+    bool bExists = false;
+
+    if (pStorage->ExistsInBatch(bExists, strFolder, oneStr, twoStr, threeStr))
+        return bExists;
+
     return pStorage->Exists(strFolder, oneStr, twoStr, threeStr);
 }
 
@@ -763,6 +789,56 @@ bool EraseValueByKey(std::string strFolder, std::string oneStr,
     return pStorage->EraseValueByKey(strFolder, oneStr, twoStr, threeStr);
 }
 
+// Write batches on the default storage.
+
+void BeginBatch()
+{
+    Storage* pStorage = details::s_pStorage;
+
+    if (nullptr != pStorage) pStorage->BeginBatch();
+}
+
+bool CommitBatch()
+{
+    Storage* pStorage = details::s_pStorage;
+
+    if (nullptr == pStorage) {
+        otErr << "OTDB::CommitBatch: No Default Storage object allocated.\n";
+        return false;
+    }
+
+    return pStorage->CommitBatch();
+}
+
+void AbortBatch()
+{
+    Storage* pStorage = details::s_pStorage;
+
+    if (nullptr != pStorage) pStorage->AbortBatch();
+}
+
+ScopedBatch::ScopedBatch()
+    : m_bOpen(true)
+{
+    BeginBatch();
+}
+
+ScopedBatch::~ScopedBatch()
+{
+    if (m_bOpen && !Commit()) {
+        otErr << "OTDB::ScopedBatch: Failed committing a write batch.\n";
+    }
+}
+
+bool ScopedBatch::Commit()
+{
+    if (!m_bOpen) return true;
+
+    m_bOpen = false;
+
+    return CommitBatch();
+}
+
 // Used internally. Creates the right subclass for any stored object type,
 // based on which packer is needed.
 
@@ -2060,6 +2136,9 @@ Storage* Storage::Create(StorageType eStorageType, PackType ePackType)
         pStore = StorageFS::Instantiate();
         OT_ASSERT(nullptr != pStore);
         break;
+    case STORE_KEY_VALUE:
+        pStore = StorageKV::Instantiate();
+        break;
     //            case STORE_COUCH_DB:
     //                pStore = new StorageCouchDB; OT_ASSERT(nullptr != pStore);
     // break;
@@ -2100,6 +2179,8 @@ StorageType Storage::GetType() const
     // that this is a custom Storage type invented by the API user.
 
     if (typeid(*this) == typeid(StorageFS)) return STORE_FILESYSTEM;
+    else if (typeid(*this) == typeid(StorageKV))
+        return STORE_KEY_VALUE;
     //    else if (typeid(*this) == typeid(StorageCouchDB))
     //        return STORE_COUCH_DB;
     //  Etc.
@@ -2134,6 +2215,7 @@ bool Storage::StoreString(std::string strContents, std::string strFolder,
     if (nullptr == pBuffer) return false;
 
     bool bSuccess =
+        StageBuffer(*pBuffer, strFolder, oneStr, twoStr, threeStr) ||
         onStorePackedBuffer(*pBuffer, strFolder, oneStr, twoStr, threeStr);
 
     // Don't want any leaks here, do we?
@@ -2158,8 +2240,19 @@ std::string Storage::QueryString(std::string strFolder, std::string oneStr,
 
     // Below this point, responsible for pBuffer.
 
-    bool bSuccess =
-        onQueryPackedBuffer(*pBuffer, strFolder, oneStr, twoStr, threeStr);
+    bool bSuccess = false;
+    const BatchEntry* pStaged = nullptr;
+
+    if (FindStaged(pStaged, strFolder, oneStr, twoStr, threeStr)) {
+        bSuccess = !pStaged->erase;
+        if (bSuccess)
+            pBuffer->SetData(
+                reinterpret_cast<const uint8_t*>(pStaged->value.data()),
+                pStaged->value.size());
+    }
+    else
+        bSuccess =
+            onQueryPackedBuffer(*pBuffer, strFolder, oneStr, twoStr, threeStr);
 
     if (!bSuccess) {
         delete pBuffer;
@@ -2193,6 +2286,9 @@ bool Storage::StorePlainString(std::string strContents, std::string strFolder,
                                std::string oneStr, std::string twoStr,
                                std::string threeStr)
 {
+    if (Stage(strContents, false, false, strFolder, oneStr, twoStr, threeStr))
+        return true;
+
     return onStorePlainString(strContents, strFolder, oneStr, twoStr, threeStr);
 }
 
@@ -2200,8 +2296,13 @@ std::string Storage::QueryPlainString(std::string strFolder, std::string oneStr,
                                       std::string twoStr, std::string threeStr)
 {
     std::string theString("");
+    const BatchEntry* pStaged = nullptr;
 
-    if (!onQueryPlainString(theString, strFolder, oneStr, twoStr, threeStr))
+    if (FindStaged(pStaged, strFolder, oneStr, twoStr, threeStr)) {
+        if (!pStaged->erase) theString = pStaged->value;
+    }
+    else if (!onQueryPlainString(theString, strFolder, oneStr, twoStr,
+                                 threeStr))
         theString = "";
 
     return theString;
@@ -2226,6 +2327,7 @@ bool Storage::StoreObject(Storable& theContents, std::string strFolder,
     }
 
     bool bSuccess =
+        StageBuffer(*pBuffer, strFolder, oneStr, twoStr, threeStr) ||
         onStorePackedBuffer(*pBuffer, strFolder, oneStr, twoStr, threeStr);
 
     if (!bSuccess) {
@@ -2265,8 +2367,19 @@ Storable* Storage::QueryObject(StoredObjectType theObjectType,
 
     // Below this point, responsible for pBuffer AND pStorable.
 
-    bool bSuccess =
-        onQueryPackedBuffer(*pBuffer, strFolder, oneStr, twoStr, threeStr);
+    bool bSuccess = false;
+    const BatchEntry* pStaged = nullptr;
+
+    if (FindStaged(pStaged, strFolder, oneStr, twoStr, threeStr)) {
+        bSuccess = !pStaged->erase;
+        if (bSuccess)
+            pBuffer->SetData(
+                reinterpret_cast<const uint8_t*>(pStaged->value.data()),
+                pStaged->value.size());
+    }
+    else
+        bSuccess =
+            onQueryPackedBuffer(*pBuffer, strFolder, oneStr, twoStr, threeStr);
 
     if (!bSuccess) {
         delete pBuffer;
@@ -2396,6 +2509,9 @@ Storable* Storage::DecodeObject(StoredObjectType theObjectType,
 bool Storage::EraseValueByKey(std::string strFolder, std::string oneStr,
                               std::string twoStr, std::string threeStr)
 {
+    if (Stage("", false, true, strFolder, oneStr, twoStr, threeStr))
+        return true;
+
     bool bSuccess = onEraseValueByKey(strFolder, oneStr, twoStr, threeStr);
 
     if (!bSuccess)
@@ -2405,8 +2521,287 @@ bool Storage::EraseValueByKey(std::string strFolder, std::string oneStr,
     return bSuccess;
 }
 
+// WRITE BATCHES
+
+Storage::Batch* Storage::GetBatch()
+{
+    std::lock_guard<std::mutex> lock(m_batchLock);
+
+    auto it = m_mapBatches.find(std::this_thread::get_id());
+
+    if (m_mapBatches.end() == it) return nullptr;
+
+    // Only this thread touches its own batch, and map nodes don't move.
+    return &it->second;
+}
+
+static std::string BatchKey(const std::string& strFolder,
+                            const std::string& oneStr,
+                            const std::string& twoStr,
+                            const std::string& threeStr)
+{
+    std::string strKey(strFolder);
+    strKey += '\0';
+    strKey += oneStr;
+    strKey += '\0';
+    strKey += twoStr;
+    strKey += '\0';
+    strKey += threeStr;
+
+    return strKey;
+}
+
+bool Storage::Stage(const std::string& strValue, bool bPacked, bool bErase,
+                    const std::string& strFolder, const std::string& oneStr,
+                    const std::string& twoStr, const std::string& threeStr)
+{
+    Batch* pBatch = GetBatch();
+
+    if (nullptr == pBatch) return false;
+
+    const std::string strKey = BatchKey(strFolder, oneStr, twoStr, threeStr);
+    auto it = pBatch->index.find(strKey);
+
+    if (pBatch->index.end() == it) {
+        it = pBatch->index.insert(std::make_pair(strKey,
+                                                 pBatch->entries.size())).first;
+        pBatch->entries.push_back(BatchEntry());
+    }
+
+    // A later write to the same key replaces the earlier one.
+    BatchEntry& theEntry = pBatch->entries[it->second];
+    theEntry.strFolder = strFolder;
+    theEntry.oneStr = oneStr;
+    theEntry.twoStr = twoStr;
+    theEntry.threeStr = threeStr;
+    theEntry.value = strValue;
+    theEntry.packed = bPacked;
+    theEntry.erase = bErase;
+
+    return true;
+}
+
+bool Storage::StageBuffer(PackedBuffer& theBuffer,
+                          const std::string& strFolder,
+                          const std::string& oneStr, const std::string& twoStr,
+                          const std::string& threeStr)
+{
+    if (nullptr == GetBatch()) return false;
+
+    const std::string strPacked(
+        reinterpret_cast<const char*>(theBuffer.GetData()),
+        theBuffer.GetSize());
+
+    return Stage(strPacked, true, false, strFolder, oneStr, twoStr, threeStr);
+}
+
+bool Storage::FindStaged(const BatchEntry*& pEntry,
+                         const std::string& strFolder,
+                         const std::string& oneStr, const std::string& twoStr,
+                         const std::string& threeStr)
+{
+    Batch* pBatch = GetBatch();
+
+    if (nullptr == pBatch) return false;
+
+    auto it = pBatch->index.find(BatchKey(strFolder, oneStr, twoStr, threeStr));
+
+    if (pBatch->index.end() == it) return false;
+
+    pEntry = &pBatch->entries[it->second];
+
+    return true;
+}
+
+void Storage::BeginBatch()
+{
+    std::lock_guard<std::mutex> lock(m_batchLock);
+
+    ++m_mapBatches[std::this_thread::get_id()].depth;
+}
+
+bool Storage::CommitBatch()
+{
+    std::vector<BatchEntry> theEntries;
+
+    {
+        std::lock_guard<std::mutex> lock(m_batchLock);
+
+        auto it = m_mapBatches.find(std::this_thread::get_id());
+
+        if (m_mapBatches.end() == it) {
+            otErr << "Storage::" << __FUNCTION__ << ": No batch is open.\n";
+            return false;
+        }
+
+        if (0 < --it->second.depth) return true;
+
+        theEntries.swap(it->second.entries);
+        m_mapBatches.erase(it);
+    }
+
+    if (theEntries.empty()) return true;
+
+    return onCommitBatch(theEntries);
+}
+
+void Storage::AbortBatch()
+{
+    std::lock_guard<std::mutex> lock(m_batchLock);
+
+    m_mapBatches.erase(std::this_thread::get_id());
+}
+
+bool Storage::ExistsInBatch(bool& bExists, std::string strFolder,
+                            std::string oneStr, std::string twoStr,
+                            std::string threeStr)
+{
+    const BatchEntry* pStaged = nullptr;
+
+    if (!FindStaged(pStaged, strFolder, oneStr, twoStr, threeStr))
+        return false;
+
+    bExists = !pStaged->erase && !pStaged->value.empty();
+
+    return true;
+}
+
+bool Storage::onCommitBatch(std::vector<BatchEntry>& theEntries)
+{
+    bool bSuccess = true;
+
+    for (auto& it : theEntries) {
+        bool bWritten = false;
+
+        if (it.erase) {
+            bWritten = onEraseValueByKey(it.strFolder, it.oneStr, it.twoStr,
+                                         it.threeStr);
+        }
+        else if (it.packed) {
+            OTPacker* pPacker = GetPacker();
+            PackedBuffer* pBuffer =
+                (nullptr == pPacker) ? nullptr : pPacker->CreateBuffer();
+
+            if (nullptr != pBuffer) {
+                pBuffer->SetData(
+                    reinterpret_cast<const uint8_t*>(it.value.data()),
+                    it.value.size());
+                bWritten = onStorePackedBuffer(*pBuffer, it.strFolder,
+                                               it.oneStr, it.twoStr,
+                                               it.threeStr);
+                delete pBuffer;
+            }
+        }
+        else {
+            bWritten = onStorePlainString(it.value, it.strFolder, it.oneStr,
+                                          it.twoStr, it.threeStr);
+        }
+
+        if (!bWritten) {
+            otErr << "Storage::" << __FUNCTION__ << ": Failed writing "
+                  << it.strFolder << "/" << it.oneStr << "/" << it.twoStr
+                  << "/" << it.threeStr << "\n";
+            bSuccess = false;
+        }
+    }
+
+    return bSuccess;
+}
+
 // STORAGE FS  (OTDB::StorageFS is the filesystem version of OTDB::Storage.)
 
+namespace
+{
+
+// Writes strData to strPath and syncs it to disk.
+bool writeSynced(const std::string& strPath, const std::string& strData)
+{
+    std::FILE* pFile = std::fopen(strPath.c_str(), "wb");
+
+    if (nullptr == pFile) return false;
+
+    bool bSuccess =
+        strData.empty() ||
+        (1 == std::fwrite(strData.data(), strData.size(), 1, pFile));
+    bSuccess = (0 == std::fflush(pFile)) && bSuccess;
+#ifdef _WIN32
+    bSuccess = (0 == _commit(_fileno(pFile))) && bSuccess;
+#else
+    bSuccess = (0 == fsync(fileno(pFile))) && bSuccess;
+#endif
+
+    return (0 == std::fclose(pFile)) && bSuccess;
+}
+
+bool readFile(const std::string& strPath, std::string& strOutput)
+{
+    std::ifstream fin(strPath.c_str(), std::ios::in | std::ios::binary);
+
+    if (!fin.is_open()) return false;
+
+    std::stringstream buffer;
+    buffer << fin.rdbuf();
+    strOutput = buffer.str();
+
+    return !fin.bad();
+}
+
+bool fileExists(const std::string& strPath)
+{
+    struct ::stat st;
+
+    return 0 == ::stat(strPath.c_str(), &st);
+}
+
+std::string parentFolder(const std::string& strPath)
+{
+    const size_t nPos = strPath.find_last_of("/\\");
+
+    if (std::string::npos == nPos) return ".";
+
+    return strPath.substr(0, nPos);
+}
+
+// Makes the files created, renamed or removed in strFolder stay that way.
+bool syncFolder(const std::string& strFolder)
+{
+#ifdef _WIN32
+    // Windows can't sync a folder. replaceFile() writes through instead.
+    return true;
+#else
+    const int fd = open(strFolder.c_str(), O_RDONLY);
+
+    if (fd < 0) return false;
+
+    const bool bSuccess = (0 == fsync(fd));
+    close(fd);
+
+    return bSuccess;
+#endif
+}
+
+bool replaceFile(const std::string& strFrom, const std::string& strTo)
+{
+#ifdef _WIN32
+    return 0 != MoveFileExA(strFrom.c_str(), strTo.c_str(),
+                            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    return 0 == std::rename(strFrom.c_str(), strTo.c_str());
+#endif
+}
+
+// The journal has a line per entry ("S <path>" to store, "E <path>" to
+// erase), and ends with a "C" line once it's complete.
+bool isJournalComplete(const std::string& strJournal)
+{
+    if ("C\n" == strJournal) return true;
+
+    return (strJournal.size() > 3) &&
+           (0 == strJournal.compare(strJournal.size() - 3, 3, "\nC\n"));
+}
+
+} // namespace
+
 // ConfirmOrCreateFolder()
 // Used for making sure that certain necessary folders actually exist. (Creates
 // them otherwise.)
@@ -2826,6 +3221,164 @@ bool StorageFS::onEraseValueByKey(std::string strFolder, std::string oneStr,
     return bSuccess;
 }
 
+// Writes every value to a temporary file next to its target and syncs it.
+// Then it writes and syncs the journal listing them. From then on the commit
+// can't be lost: the files are renamed into place (and erased values
+// removed) here, or by RecoverBatch() on the next startup if the process
+// dies first.
+bool StorageFS::onCommitBatch(std::vector<BatchEntry>& theEntries)
+{
+    std::lock_guard<std::mutex> lock(m_commitLock);
+
+    std::string strJournal;
+    std::vector<std::string> theTemps;
+    std::set<std::string> setFolders;
+    bool bSuccess = true;
+
+    for (auto& it : theEntries) {
+        std::string strPath;
+
+        if (it.erase) {
+            bSuccess = (0 <= ConstructAndConfirmPath(strPath, it.strFolder,
+                                                     it.oneStr, it.twoStr,
+                                                     it.threeStr));
+            if (bSuccess) strJournal += "E " + strPath + "\n";
+        }
+        else {
+            bSuccess = (0 <= ConstructAndCreatePath(strPath, it.strFolder,
+                                                    it.oneStr, it.twoStr,
+                                                    it.threeStr)) &&
+                       !(it.packed && it.value.empty());
+
+            if (bSuccess) {
+                const std::string strTemp = strPath + OTDB_FS_BATCH_SUFFIX;
+                theTemps.push_back(strTemp);
+                bSuccess = writeSynced(strTemp, it.value);
+                strJournal += "S " + strPath + "\n";
+            }
+        }
+
+        if (!bSuccess) {
+            otErr << "StorageFS::" << __FUNCTION__ << ": Failed writing "
+                  << it.strFolder << "/" << it.oneStr << "/" << it.twoStr
+                  << "/" << it.threeStr << "\n";
+            break;
+        }
+
+        setFolders.insert(parentFolder(strPath));
+    }
+
+    strJournal += "C\n";
+
+    // The temporary files have to be there before the journal says so.
+    for (auto& it : setFolders) {
+        if (!bSuccess) break;
+        bSuccess = syncFolder(it);
+    }
+
+    bSuccess = bSuccess && writeSynced(m_strJournal, strJournal) &&
+               syncFolder(parentFolder(m_strJournal));
+
+    if (!bSuccess) {
+        otErr << "StorageFS::" << __FUNCTION__
+              << ": Failed writing the batch. (Nothing was changed.)\n";
+
+        for (auto& it : theTemps) std::remove(it.c_str());
+        std::remove(m_strJournal.c_str());
+
+        return false;
+    }
+
+    // If this fails, the journal stays, and it's tried again on startup.
+    if (!ReplayJournal(strJournal)) return false;
+
+    return RemoveJournal();
+}
+
+// Moves the files listed in a complete journal into place. Any of them may
+// already be there, if this is a replay.
+bool StorageFS::ReplayJournal(const std::string& strJournal)
+{
+    std::istringstream in(strJournal);
+    std::string strLine;
+    std::set<std::string> setFolders;
+    bool bSuccess = true;
+
+    while (std::getline(in, strLine)) {
+        if (strLine.size() < 3) continue; // The "C" line.
+
+        const std::string strPath = strLine.substr(2);
+        const std::string strTemp = strPath + OTDB_FS_BATCH_SUFFIX;
+        bool bDone = true;
+
+        if ('S' == strLine[0]) {
+            bDone = !fileExists(strTemp) || replaceFile(strTemp, strPath);
+        }
+        else if ('E' == strLine[0]) {
+            bDone = !fileExists(strPath) || (0 == std::remove(strPath.c_str()));
+        }
+
+        if (!bDone) {
+            otErr << "StorageFS::" << __FUNCTION__ << ": Failed updating "
+                  << strPath << "\n";
+            bSuccess = false;
+        }
+
+        setFolders.insert(parentFolder(strPath));
+    }
+
+    for (auto& it : setFolders) bSuccess = syncFolder(it) && bSuccess;
+
+    return bSuccess;
+}
+
+bool StorageFS::RemoveJournal()
+{
+    // Replaying a journal twice could erase a file that was written since.
+    if ((0 != std::remove(m_strJournal.c_str())) ||
+        !syncFolder(parentFolder(m_strJournal))) {
+        otErr << "StorageFS::" << __FUNCTION__ << ": Failed removing "
+              << m_strJournal << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+// Finishes a batch commit that was cut off after its journal was written,
+// or cleans up after one that was cut off before.
+void StorageFS::RecoverBatch()
+{
+    std::string strJournal;
+
+    if (!fileExists(m_strJournal) || !readFile(m_strJournal, strJournal))
+        return;
+
+    if (isJournalComplete(strJournal)) {
+        otOut << "StorageFS::" << __FUNCTION__
+              << ": Finishing an interrupted batch commit.\n";
+
+        if (!ReplayJournal(strJournal)) return;
+    }
+    else {
+        otOut << "StorageFS::" << __FUNCTION__
+              << ": Discarding an incomplete batch commit.\n";
+
+        std::istringstream in(strJournal);
+        std::string strLine;
+
+        while (std::getline(in, strLine)) {
+            if ((strLine.size() > 2) && ('S' == strLine[0])) {
+                const std::string strTemp =
+                    strLine.substr(2) + OTDB_FS_BATCH_SUFFIX;
+                std::remove(strTemp.c_str());
+            }
+        }
+    }
+
+    RemoveJournal();
+}
+
 // Constructor for Filesystem storage context.
 //
 StorageFS::StorageFS()
@@ -2834,6 +3387,12 @@ StorageFS::StorageFS()
     String strDataPath;
     OTDataFolder::Get(strDataPath);
     m_strDataPath = strDataPath.Get();
+
+    String strJournal;
+    OTPaths::AppendFile(strJournal, m_strDataPath.c_str(), OTDB_FS_JOURNAL);
+    m_strJournal = strJournal.Get();
+
+    RecoverBatch();
 }
 
 StorageFS::~StorageFS()
@@ -0,0 +1,899 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/util/OTPaths.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#define OTDB_KV_FILENAME "opentxs.kvdb"
+#define OTDB_KV_RECORD_MAGIC 0x564b544fu // "OTKV"
+#define OTDB_KV_HEADER_SIZE 20
+// Compacted files are written as records of roughly this size.
+#define OTDB_KV_COMPACT_RECORD_SIZE (4 * 1024 * 1024)
+// Files are only compacted once they hold this much garbage.
+#define OTDB_KV_COMPACT_MIN_GARBAGE (1024 * 1024)
+// Number of files migrated per commit.
+#define OTDB_KV_IMPORT_BATCH 1000
+// Holds the state of the migration. The import skips files whose names start
+// with OTDB_KV_FILENAME, so none of them can have this key.
+#define OTDB_KV_IMPORT_KEY OTDB_KV_FILENAME ".import"
+#define OTDB_KV_IMPORT_STARTED "started"
+#define OTDB_KV_IMPORT_DONE "done"
+
+namespace opentxs
+{
+
+namespace OTDB
+{
+
+// A record is a header followed by a payload of changes:
+//
+// header:  magic (4) | checksum of payload (4) | change count (4) |
+//          payload size (8)
+// change:  erase flag (1) | key size (4) | key | value size (4) | value
+//
+// All integers are little endian.
+
+namespace
+{
+
+void putInt(std::string& strOutput, uint64_t lValue, size_t nBytes)
+{
+    for (size_t i = 0; i < nBytes; ++i) {
+        strOutput += static_cast<char>((lValue >> (8 * i)) & 0xff);
+    }
+}
+
+uint64_t getInt(const char* pData, size_t nBytes)
+{
+    uint64_t lValue = 0;
+
+    for (size_t i = 0; i < nBytes; ++i) {
+        lValue |= static_cast<uint64_t>(static_cast<uint8_t>(pData[i]))
+                  << (8 * i);
+    }
+
+    return lValue;
+}
+
+// FNV-1a. Only needs to catch torn and partial writes.
+uint32_t checksum(const char* pData, size_t nSize)
+{
+    uint32_t nHash = 2166136261u;
+
+    for (size_t i = 0; i < nSize; ++i) {
+        nHash ^= static_cast<uint8_t>(pData[i]);
+        nHash *= 16777619u;
+    }
+
+    return nHash;
+}
+
+bool seekTo(std::FILE* pFile, int64_t lOffset)
+{
+#ifdef _WIN32
+    return 0 == _fseeki64(pFile, lOffset, SEEK_SET);
+#else
+    return 0 == fseeko(pFile, lOffset, SEEK_SET);
+#endif
+}
+
+int64_t fileLength(std::FILE* pFile)
+{
+#ifdef _WIN32
+    if (0 != _fseeki64(pFile, 0, SEEK_END)) return -1;
+    return _ftelli64(pFile);
+#else
+    if (0 != fseeko(pFile, 0, SEEK_END)) return -1;
+    return ftello(pFile);
+#endif
+}
+
+// Only touches the descriptor, so other threads may use the stream meanwhile.
+bool syncDescriptor(std::FILE* pFile)
+{
+#ifdef _WIN32
+    return 0 == _commit(_fileno(pFile));
+#else
+    return 0 == fsync(fileno(pFile));
+#endif
+}
+
+bool syncFile(std::FILE* pFile)
+{
+    return (0 == std::fflush(pFile)) && syncDescriptor(pFile);
+}
+
+bool readFile(const std::string& strPath, std::string& strOutput)
+{
+    std::ifstream fin(strPath.c_str(), std::ios::in | std::ios::binary);
+
+    if (!fin.is_open()) return false;
+
+    std::stringstream buffer;
+    buffer << fin.rdbuf();
+    strOutput = buffer.str();
+
+    return !fin.bad();
+}
+
+} // namespace
+
+StorageKV::StorageKV()
+    : StorageFS()
+    , m_pFile(nullptr)
+    , m_lFileSize(0)
+    , m_lLiveBytes(0)
+    , m_bCommitting(false)
+{
+    String strFilename;
+    OTPaths::AppendFile(strFilename, m_strDataPath.c_str(), OTDB_KV_FILENAME);
+    m_strFilename = strFilename.Get();
+}
+
+StorageKV::~StorageKV()
+{
+    Close();
+}
+
+StorageKV* StorageKV::Instantiate()
+{
+    StorageKV* pStorage = new StorageKV;
+
+    if (!pStorage->Open()) {
+        otErr << "StorageKV::" << __FUNCTION__ << ": Failed opening "
+              << pStorage->m_strFilename << "\n";
+        delete pStorage;
+        return nullptr;
+    }
+
+    return pStorage;
+}
+
+void StorageKV::SerializeRecord(const std::vector<Change>& theChanges,
+                                std::string& strRecord,
+                                std::vector<int64_t>& theOffsets)
+{
+    std::string strPayload;
+    theOffsets.clear();
+
+    for (auto& it : theChanges) {
+        putInt(strPayload, it.erase ? 1 : 0, 1);
+        putInt(strPayload, it.key.size(), 4);
+        strPayload += it.key;
+        putInt(strPayload, it.value.size(), 4);
+        theOffsets.push_back(OTDB_KV_HEADER_SIZE + strPayload.size());
+        strPayload += it.value;
+    }
+
+    strRecord.clear();
+    putInt(strRecord, OTDB_KV_RECORD_MAGIC, 4);
+    putInt(strRecord, checksum(strPayload.data(), strPayload.size()), 4);
+    putInt(strRecord, theChanges.size(), 4);
+    putInt(strRecord, strPayload.size(), 8);
+    strRecord += strPayload;
+}
+
+// Reads every record in the file into the index. Stops at the first record
+// that's incomplete or damaged (a crash during a commit), and compacts the
+// file (if bCompact) if that left garbage at the end, or if it holds too much
+// garbage.
+bool StorageKV::Open(bool bCompact)
+{
+    OT_ASSERT(nullptr == m_pFile);
+
+    m_pFile = std::fopen(m_strFilename.c_str(), "r+b");
+
+    if (nullptr == m_pFile) {
+        m_pFile = std::fopen(m_strFilename.c_str(), "w+b");
+    }
+
+    if (nullptr == m_pFile) return false;
+
+    m_mapIndex.clear();
+    m_lLiveBytes = 0;
+    m_lFileSize = 0;
+
+    const int64_t lLength = fileLength(m_pFile);
+    int64_t lOffset = 0;
+    bool bDamaged = false;
+    char header[OTDB_KV_HEADER_SIZE];
+    std::string strPayload;
+
+    while (seekTo(m_pFile, lOffset) &&
+           (1 == std::fread(header, sizeof(header), 1, m_pFile))) {
+        const uint32_t nMagic = static_cast<uint32_t>(getInt(header, 4));
+        const uint32_t nChecksum = static_cast<uint32_t>(getInt(header + 4, 4));
+        const uint64_t nCount = getInt(header + 8, 4);
+        const uint64_t nPayload = getInt(header + 12, 8);
+
+        if ((OTDB_KV_RECORD_MAGIC != nMagic) ||
+            (static_cast<int64_t>(nPayload) >
+             lLength - lOffset - OTDB_KV_HEADER_SIZE)) {
+            bDamaged = true;
+            break;
+        }
+
+        strPayload.resize(static_cast<size_t>(nPayload));
+
+        if ((nPayload > 0) &&
+            (1 != std::fread(&strPayload[0], strPayload.size(), 1, m_pFile))) {
+            bDamaged = true;
+            break;
+        }
+
+        if (checksum(strPayload.data(), strPayload.size()) != nChecksum) {
+            bDamaged = true;
+            break;
+        }
+
+        size_t nPos = 0;
+        const size_t nSize = strPayload.size();
+        const char* pData = strPayload.data();
+        std::vector<std::pair<std::string, Location>> theChanges;
+        std::vector<bool> theErasures;
+
+        for (uint64_t i = 0; i < nCount; ++i) {
+            if (nPos + 5 > nSize) break;
+            const bool bErase = (1 == getInt(pData + nPos, 1));
+            const size_t nKey = getInt(pData + nPos + 1, 4);
+            nPos += 5;
+            if (nPos + nKey + 4 > nSize) break;
+            std::string strKey(pData + nPos, nKey);
+            nPos += nKey;
+            const uint32_t nValue =
+                static_cast<uint32_t>(getInt(pData + nPos, 4));
+            nPos += 4;
+            if (nPos + nValue > nSize) break;
+
+            Location theLocation;
+            theLocation.offset = lOffset + OTDB_KV_HEADER_SIZE + nPos;
+            theLocation.size = nValue;
+            nPos += nValue;
+
+            theChanges.push_back(std::make_pair(strKey, theLocation));
+            theErasures.push_back(bErase);
+        }
+
+        if ((theChanges.size() != nCount) || (nPos != nSize)) {
+            bDamaged = true;
+            break;
+        }
+
+        // The whole record checked out, so apply it.
+        for (size_t i = 0; i < theChanges.size(); ++i) {
+            auto it = m_mapIndex.find(theChanges[i].first);
+
+            if (m_mapIndex.end() != it) {
+                m_lLiveBytes -= it->second.size;
+                m_mapIndex.erase(it);
+            }
+
+            if (!theErasures[i]) {
+                m_mapIndex.insert(theChanges[i]);
+                m_lLiveBytes += theChanges[i].second.size;
+            }
+        }
+
+        lOffset += OTDB_KV_HEADER_SIZE + static_cast<int64_t>(nPayload);
+    }
+
+    m_lFileSize = lOffset;
+
+    if (bDamaged) {
+        otErr << "StorageKV::" << __FUNCTION__ << ": " << m_strFilename
+              << " ends with an incomplete commit at offset " << lOffset
+              << ". (Discarding it.)\n";
+
+        // Commits overwrite the damaged tail anyway, so this can wait.
+        if (bCompact) return Compact();
+    }
+
+    if (bCompact && HasTooMuchGarbage()) return Compact();
+
+    return true;
+}
+
+bool StorageKV::HasTooMuchGarbage() const
+{
+    const int64_t lGarbage = m_lFileSize - m_lLiveBytes;
+
+    return (lGarbage > OTDB_KV_COMPACT_MIN_GARBAGE) &&
+           (lGarbage > m_lLiveBytes);
+}
+
+void StorageKV::Close()
+{
+    if (nullptr != m_pFile) {
+        std::fclose(m_pFile);
+        m_pFile = nullptr;
+    }
+}
+
+// Copies the latest value of every key into a new file, which then replaces
+// the old one. If that fails, the old file stays in use.
+bool StorageKV::Compact()
+{
+    const std::string strTemp = m_strFilename + ".tmp";
+    std::FILE* pTemp = std::fopen(strTemp.c_str(), "wb");
+
+    if (nullptr == pTemp) {
+        otErr << "StorageKV::" << __FUNCTION__ << ": Failed opening " << strTemp
+              << "\n";
+        return false;
+    }
+
+    bool bSuccess = true;
+    std::vector<Change> theChanges;
+    std::vector<int64_t> theOffsets;
+    std::string strRecord;
+    size_t nBatchSize = 0;
+    auto it = m_mapIndex.begin();
+
+    while (bSuccess && (m_mapIndex.end() != it || !theChanges.empty())) {
+        if (m_mapIndex.end() != it &&
+            nBatchSize < OTDB_KV_COMPACT_RECORD_SIZE) {
+            Change theChange;
+            theChange.key = it->first;
+            theChange.erase = false;
+            bSuccess = ReadValue(it->second, theChange.value);
+            nBatchSize += theChange.value.size();
+            theChanges.push_back(theChange);
+            ++it;
+            continue;
+        }
+
+        SerializeRecord(theChanges, strRecord, theOffsets);
+        bSuccess = (1 == std::fwrite(strRecord.data(), strRecord.size(), 1,
+                                     pTemp));
+        theChanges.clear();
+        nBatchSize = 0;
+    }
+
+    bSuccess = syncFile(pTemp) && bSuccess;
+    std::fclose(pTemp);
+
+    if (!bSuccess) {
+        otErr << "StorageKV::" << __FUNCTION__ << ": Failed writing " << strTemp
+              << "\n";
+        std::remove(strTemp.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    // Windows won't replace a file that's open.
+    Close();
+    const bool bReplaced =
+        (0 != MoveFileExA(strTemp.c_str(), m_strFilename.c_str(),
+                          MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH));
+#else
+    const bool bReplaced =
+        (0 == std::rename(strTemp.c_str(), m_strFilename.c_str()));
+#endif
+
+    if (!bReplaced) {
+        otErr << "StorageKV::" << __FUNCTION__ << ": Failed replacing "
+              << m_strFilename << "\n";
+        std::remove(strTemp.c_str());
+#ifdef _WIN32
+        Open(false);
+#endif
+        return false;
+    }
+
+    Close();
+
+    return Open(false);
+}
+
+bool StorageKV::Commit(std::unique_lock<std::mutex>& lock,
+                       const std::vector<Change>& theChanges)
+{
+    PendingCommit thePending(theChanges);
+    m_queue.push_back(&thePending);
+
+    while (m_bCommitting && !thePending.done) m_commitDone.wait(lock);
+
+    // Somebody else's group included us.
+    if (thePending.done) return thePending.success;
+
+    // Nobody is syncing, so write everything queued up to now.
+    std::vector<PendingCommit*> theGroup;
+    theGroup.swap(m_queue);
+    m_bCommitting = true;
+
+    std::string strRecords, strRecord;
+    std::vector<std::vector<int64_t>> theOffsets(theGroup.size());
+
+    for (size_t i = 0; i < theGroup.size(); ++i) {
+        const int64_t lStart = m_lFileSize + strRecords.size();
+        SerializeRecord(theGroup[i]->changes, strRecord, theOffsets[i]);
+
+        for (auto& lOffset : theOffsets[i]) lOffset += lStart;
+
+        strRecords += strRecord;
+    }
+
+    // Always write where the last good record ended, so a failed commit gets
+    // overwritten by the next one.
+    bool bSuccess =
+        (nullptr != m_pFile) && seekTo(m_pFile, m_lFileSize) &&
+        (1 == std::fwrite(strRecords.data(), strRecords.size(), 1, m_pFile)) &&
+        (0 == std::fflush(m_pFile));
+
+    // Let other threads read (and queue up more commits) during the sync.
+    // Nothing new is visible until the index is updated below.
+    if (bSuccess) {
+        lock.unlock();
+        bSuccess = syncDescriptor(m_pFile);
+        lock.lock();
+    }
+
+    if (bSuccess) {
+        for (size_t i = 0; i < theGroup.size(); ++i) {
+            const std::vector<Change>& theChanges = theGroup[i]->changes;
+
+            for (size_t j = 0; j < theChanges.size(); ++j) {
+                const Change& theChange = theChanges[j];
+                auto it = m_mapIndex.find(theChange.key);
+
+                if (m_mapIndex.end() != it) {
+                    m_lLiveBytes -= it->second.size;
+                    m_mapIndex.erase(it);
+                }
+
+                if (!theChange.erase) {
+                    Location theLocation;
+                    theLocation.offset = theOffsets[i][j];
+                    theLocation.size =
+                        static_cast<uint32_t>(theChange.value.size());
+                    m_mapIndex.insert(
+                        std::make_pair(theChange.key, theLocation));
+                    m_lLiveBytes += theLocation.size;
+                }
+            }
+        }
+
+        m_lFileSize += static_cast<int64_t>(strRecords.size());
+
+        // Nobody else can read or write until m_bCommitting is cleared. The
+        // commit is already safe, so a failure here only means the file
+        // stays as it is.
+        if (HasTooMuchGarbage()) Compact();
+    }
+    else {
+        otErr << "StorageKV::" << __FUNCTION__ << ": Failed writing to "
+              << m_strFilename << "\n";
+    }
+
+    for (auto& it : theGroup) {
+        it->done = true;
+        it->success = bSuccess;
+    }
+
+    m_bCommitting = false;
+    m_commitDone.notify_all();
+
+    return bSuccess;
+}
+
+bool StorageKV::ReadValue(const Location& theLocation, std::string& strOutput)
+{
+    strOutput.resize(theLocation.size);
+
+    if (0 == theLocation.size) return true;
+
+    return (nullptr != m_pFile) && seekTo(m_pFile, theLocation.offset) &&
+           (1 == std::fread(&strOutput[0], strOutput.size(), 1, m_pFile));
+}
+
+// The key is the path StorageFS would use, relative to the data folder.
+// (Same rules as StorageFS::ConstructAndConfirmPathImp.)
+bool StorageKV::FormKey(std::string& strOutput, std::string strFolder,
+                        std::string oneStr, std::string twoStr,
+                        std::string threeStr)
+{
+    if ((3 > strFolder.length()) && (0 != strFolder.compare("."))) {
+        otErr << "StorageKV::" << __FUNCTION__ << ": strFolder is too short "
+                                                  "(and not \".\"): \""
+              << strFolder << "\"\n";
+        return false;
+    }
+
+    if (3 > oneStr.length()) {
+        otErr << "StorageKV::" << __FUNCTION__ << ": oneStr is too short: \""
+              << oneStr << "\"\n";
+        return false;
+    }
+
+    if ((3 > twoStr.length()) && !threeStr.empty()) {
+        otErr << "StorageKV::" << __FUNCTION__ << ": threeStr passed in: "
+              << threeStr << " while twoStr is empty!\n";
+        return false;
+    }
+
+    strOutput.clear();
+
+    if (0 != strFolder.compare(".")) {
+        strOutput += strFolder;
+        strOutput += "/";
+    }
+
+    strOutput += oneStr;
+
+    if (3 <= twoStr.length()) {
+        strOutput += "/";
+        strOutput += twoStr;
+
+        if (!threeStr.empty()) {
+            strOutput += "/";
+            strOutput += threeStr;
+        }
+    }
+
+    return true;
+}
+
+bool StorageKV::StoreValue(const std::string& strValue, std::string strFolder,
+                           std::string oneStr, std::string twoStr,
+                           std::string threeStr)
+{
+    Change theChange;
+    theChange.value = strValue;
+    theChange.erase = false;
+
+    if (!FormKey(theChange.key, strFolder, oneStr, twoStr, threeStr)) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    return Commit(lock, std::vector<Change>(1, theChange));
+}
+
+bool StorageKV::QueryValue(std::string& strValue, std::string strFolder,
+                           std::string oneStr, std::string twoStr,
+                           std::string threeStr)
+{
+    std::string strKey;
+
+    if (!FormKey(strKey, strFolder, oneStr, twoStr, threeStr)) return false;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    auto it = m_mapIndex.find(strKey);
+
+    if (m_mapIndex.end() == it) {
+        otErr << "StorageKV::" << __FUNCTION__ << ": Failure reading " << strKey
+              << ": it does not exist.\n";
+        return false;
+    }
+
+    if (!ReadValue(it->second, strValue)) {
+        otErr << "StorageKV::" << __FUNCTION__ << ": Failure reading " << strKey
+              << " from " << m_strFilename << "\n";
+        strValue.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool StorageKV::onStorePackedBuffer(PackedBuffer& theBuffer,
+                                    std::string strFolder, std::string oneStr,
+                                    std::string twoStr, std::string threeStr)
+{
+    std::ostringstream ofs(std::ios::out | std::ios::binary);
+
+    if (!theBuffer.WriteToOStream(ofs)) return false;
+
+    return StoreValue(ofs.str(), strFolder, oneStr, twoStr, threeStr);
+}
+
+bool StorageKV::onQueryPackedBuffer(PackedBuffer& theBuffer,
+                                    std::string strFolder, std::string oneStr,
+                                    std::string twoStr, std::string threeStr)
+{
+    std::string strValue;
+
+    if (!QueryValue(strValue, strFolder, oneStr, twoStr, threeStr)) {
+        return false;
+    }
+
+    std::istringstream ifs(strValue, std::ios::in | std::ios::binary);
+
+    return theBuffer.ReadFromIStream(ifs,
+                                     static_cast<int64_t>(strValue.size()));
+}
+
+bool StorageKV::onStorePlainString(std::string& theBuffer,
+                                   std::string strFolder, std::string oneStr,
+                                   std::string twoStr, std::string threeStr)
+{
+    return StoreValue(theBuffer, strFolder, oneStr, twoStr, threeStr);
+}
+
+bool StorageKV::onQueryPlainString(std::string& theBuffer,
+                                   std::string strFolder, std::string oneStr,
+                                   std::string twoStr, std::string threeStr)
+{
+    if (!QueryValue(theBuffer, strFolder, oneStr, twoStr, threeStr)) {
+        theBuffer = "";
+        return false;
+    }
+
+    return (theBuffer.length() > 0);
+}
+
+bool StorageKV::onEraseValueByKey(std::string strFolder, std::string oneStr,
+                                  std::string twoStr, std::string threeStr)
+{
+    Change theChange;
+    theChange.erase = true;
+
+    if (!FormKey(theChange.key, strFolder, oneStr, twoStr, threeStr)) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    if (m_mapIndex.end() == m_mapIndex.find(theChange.key)) {
+        otErr << "** Failed trying to erase (it doesn't exist): "
+              << theChange.key << " \n";
+        return false;
+    }
+
+    return Commit(lock, std::vector<Change>(1, theChange));
+}
+
+// The whole batch goes into one record, so it's written completely or not
+// at all.
+bool StorageKV::onCommitBatch(std::vector<BatchEntry>& theEntries)
+{
+    std::vector<Change> theChanges(theEntries.size());
+
+    for (size_t i = 0; i < theEntries.size(); ++i) {
+        BatchEntry& theEntry = theEntries[i];
+        Change& theChange = theChanges[i];
+
+        if (!FormKey(theChange.key, theEntry.strFolder, theEntry.oneStr,
+                     theEntry.twoStr, theEntry.threeStr)) {
+            return false;
+        }
+
+        theChange.value.swap(theEntry.value);
+        theChange.erase = theEntry.erase;
+    }
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    return Commit(lock, theChanges);
+}
+
+bool StorageKV::Exists(std::string strFolder, std::string oneStr,
+                       std::string twoStr, std::string threeStr)
+{
+    std::string strKey;
+
+    if (!FormKey(strKey, strFolder, oneStr, twoStr, threeStr)) return false;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    auto it = m_mapIndex.find(strKey);
+
+    return (m_mapIndex.end() != it) && (0 < it->second.size);
+}
+
+int64_t StorageKV::FormPathString(std::string& strOutput,
+                                  std::string strFolder, std::string oneStr,
+                                  std::string twoStr, std::string threeStr)
+{
+    // Whoever asks for a path wants to use the file directly, and nothing
+    // else will have created its folder.
+    return ConstructAndCreatePath(strOutput, strFolder, oneStr, twoStr,
+                                  threeStr);
+}
+
+// The marker is written before the first batch and marked done after the
+// last one. An import that was interrupted in between starts over, which
+// just copies the same files again.
+bool StorageKV::ImportDataFolder()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    Change theMarker;
+    theMarker.key = OTDB_KV_IMPORT_KEY;
+    theMarker.erase = false;
+
+    auto it = m_mapIndex.find(theMarker.key);
+
+    if (m_mapIndex.end() != it) {
+        if (!ReadValue(it->second, theMarker.value)) {
+            otErr << "StorageKV::" << __FUNCTION__ << ": Failed reading "
+                  << theMarker.key << " from " << m_strFilename << "\n";
+            return false;
+        }
+
+        if (0 == theMarker.value.compare(OTDB_KV_IMPORT_DONE)) return true;
+
+        otOut << "StorageKV::" << __FUNCTION__ << ": The import of "
+              << m_strDataPath << " was interrupted. Starting it again.\n";
+    }
+    // Already in use without an import.
+    else if (!m_mapIndex.empty()) {
+        return true;
+    }
+    else {
+        theMarker.value = OTDB_KV_IMPORT_STARTED;
+
+        if (!Commit(lock, std::vector<Change>(1, theMarker))) return false;
+    }
+
+    int64_t lCount = 0;
+    bool bSuccess = ImportFolder(lock, m_strDataPath, "", lCount);
+
+    if (bSuccess) {
+        theMarker.value = OTDB_KV_IMPORT_DONE;
+        bSuccess = Commit(lock, std::vector<Change>(1, theMarker));
+    }
+
+    if (bSuccess) {
+        otOut << "StorageKV::" << __FUNCTION__ << ": Imported " << lCount
+              << " files from " << m_strDataPath << " into " << m_strFilename
+              << "\n";
+    }
+    else {
+        otErr << "StorageKV::" << __FUNCTION__ << ": Failed importing "
+              << m_strDataPath << " (after " << lCount << " files.)\n";
+    }
+
+    return bSuccess;
+}
+
+// lock holds m_lock. strKey is the key prefix for the contents of strPath.
+bool StorageKV::ImportFolder(std::unique_lock<std::mutex>& lock,
+                             const std::string& strPath,
+                             const std::string& strKey, int64_t& lCount)
+{
+    std::vector<std::string> theNames;
+
+#ifdef _WIN32
+    struct _finddata_t theEntry;
+    const std::string strPattern = strPath + "*";
+    intptr_t hFind = _findfirst(strPattern.c_str(), &theEntry);
+
+    if (-1 != hFind) {
+        do {
+            theNames.push_back(theEntry.name);
+        } while (0 == _findnext(hFind, &theEntry));
+        _findclose(hFind);
+    }
+#else
+    DIR* pDir = opendir(strPath.c_str());
+
+    if (nullptr == pDir) {
+        otErr << "StorageKV::" << __FUNCTION__ << ": Failed opening folder "
+              << strPath << "\n";
+        return false;
+    }
+
+    for (struct dirent* pEntry = readdir(pDir); nullptr != pEntry;
+         pEntry = readdir(pDir)) {
+        theNames.push_back(pEntry->d_name);
+    }
+
+    closedir(pDir);
+#endif
+
+    std::vector<Change> theChanges;
+
+    for (auto& strName : theNames) {
+        if ((0 == strName.compare(".")) || (0 == strName.compare(".."))) {
+            continue;
+        }
+
+        // Don't import ourselves.
+        if (strKey.empty() && (0 == strName.compare(0, strlen(OTDB_KV_FILENAME),
+                                                    OTDB_KV_FILENAME))) {
+            continue;
+        }
+
+        const std::string strChildPath = strPath + strName;
+        const std::string strChildKey = strKey + strName;
+        struct ::stat st;
+
+        if (0 != ::stat(strChildPath.c_str(), &st)) continue;
+
+        if (S_IFDIR == (st.st_mode & S_IFMT)) {
+            if (!ImportFolder(lock, strChildPath + "/", strChildKey + "/",
+                              lCount)) {
+                return false;
+            }
+            continue;
+        }
+
+        Change theChange;
+        theChange.key = strChildKey;
+        theChange.erase = false;
+
+        if (!readFile(strChildPath, theChange.value)) {
+            otErr << "StorageKV::" << __FUNCTION__ << ": Failed reading "
+                  << strChildPath << "\n";
+            return false;
+        }
+
+        theChanges.push_back(theChange);
+
+        if (OTDB_KV_IMPORT_BATCH <= theChanges.size()) {
+            if (!Commit(lock, theChanges)) return false;
+            lCount += theChanges.size();
+            theChanges.clear();
+        }
+    }
+
+    if (!theChanges.empty()) {
+        if (!Commit(lock, theChanges)) return false;
+        lCount += theChanges.size();
+    }
+
+    return true;
+}
+
+} // namespace OTDB
+
+} // namespace opentxs
@@ -44,7 +44,7 @@
 #include <opentxs/core/Cheque.hpp>
 #include <opentxs/core/util/OTFolders.hpp>
 #include <opentxs/core/Ledger.hpp>
-#include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/XMLWriter.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Message.hpp>
 #include <opentxs/core/Nym.hpp>
@@ -3003,7 +3003,7 @@ bool OTTransaction::SaveBoxReceipt(Ledger& theLedger)
     return SaveBoxReceipt(lLedgerType);
 }
 
-bool OTTransaction::VerifyBoxReceipt(OTTransaction& theFullVersion)
+bool OTTransaction::VerifyBoxReceipt(OTTransaction& theFullVersion) const
 {
     if (!m_bIsAbbreviated || theFullVersion.IsAbbreviated()) {
         otErr << "OTTransaction::" << __FUNCTION__
@@ -4256,10 +4256,15 @@ void OTTransaction::UpdateContents()
         strAcctID(GetPurportedAccountID()), strNotaryID(GetPurportedNotaryID()),
         strNymID(GetNymID());
 
+    // Reuse the previous size as a guess for the new one.
+    std::string str_result;
+    str_result.reserve(m_xmlUnsigned.GetLength());
+
     // I release this because I'm about to repopulate it.
     m_xmlUnsigned.Release();
 
-    Tag tag("transaction");
+    XMLWriter tag(str_result);
+    tag.open("transaction");
 
     tag.add_attribute("type", strType.Get());
     tag.add_attribute("dateSigned", getTimestamp());
@@ -4342,10 +4347,9 @@ void OTTransaction::UpdateContents()
     {
         if ((OTTransaction::finalReceipt == m_Type) ||
             (OTTransaction::basketReceipt == m_Type)) {
-            TagPtr tagClosingNo(new Tag("closingTransactionNumber"));
-            tagClosingNo->add_attribute("value",
-                                        formatLong(m_lClosingTransactionNo));
-            tag.add_tag(tagClosingNo);
+            tag.open("closingTransactionNumber");
+            tag.add_attribute("value", formatLong(m_lClosingTransactionNo));
+            tag.close();
         }
 
         // a transaction contains a list of items, but it is also in reference
@@ -4375,10 +4379,9 @@ void OTTransaction::UpdateContents()
         }
     } // not abbreviated (full details.)
 
-    std::string str_result;
-    tag.output(str_result);
+    tag.close();
 
-    m_xmlUnsigned.Concatenate("%s", str_result.c_str());
+    m_xmlUnsigned.Set(str_result.c_str());
 }
 
 /*
@@ -4448,7 +4451,7 @@ paymentInbox, you get one of these in YOUR paymentInbox.
     "instrumentRejection",    // When someone rejects your invoice from his
   paymentInbox, you get one of these in YOUR paymentInbox.
  */
-void OTTransaction::SaveAbbrevPaymentInboxRecord(Tag& parent)
+void OTTransaction::SaveAbbrevPaymentInboxRecord(XMLWriter& parent)
 {
     int64_t lDisplayValue = 0;
 
@@ -4504,21 +4507,21 @@ void OTTransaction::SaveAbbrevPaymentInboxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("paymentInboxRecord"));
+    parent.open("paymentInboxRecord");
 
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("displayValue", formatLong(lDisplayValue));
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
+    parent.add_attribute("type", strType.Get());
+    parent.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    parent.add_attribute("receiptHash", strHash.Get());
+    parent.add_attribute("displayValue", formatLong(lDisplayValue));
+    parent.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    parent.add_attribute("inRefDisplay",
                         formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    parent.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
-    parent.add_tag(pTag);
+    parent.close();
 }
 
-void OTTransaction::SaveAbbrevExpiredBoxRecord(Tag& parent)
+void OTTransaction::SaveAbbrevExpiredBoxRecord(XMLWriter& parent)
 {
     int64_t lDisplayValue = 0;
 
@@ -4586,18 +4589,18 @@ void OTTransaction::SaveAbbrevExpiredBoxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("expiredBoxRecord"));
+    parent.open("expiredBoxRecord");
 
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("displayValue", formatLong(lDisplayValue));
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
+    parent.add_attribute("type", strType.Get());
+    parent.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    parent.add_attribute("receiptHash", strHash.Get());
+    parent.add_attribute("displayValue", formatLong(lDisplayValue));
+    parent.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    parent.add_attribute("inRefDisplay",
                         formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    parent.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
-    parent.add_tag(pTag);
+    parent.close();
 }
 
 /*
@@ -4641,7 +4644,7 @@ payments inbox or outpayments box.)
  Except it's used for expired payments, instead of completed / canceled
 payments.
  */
-void OTTransaction::SaveAbbrevRecordBoxRecord(Tag& parent)
+void OTTransaction::SaveAbbrevRecordBoxRecord(XMLWriter& parent)
 {
     // Have some kind of check in here, whether the AcctID and NymID match.
     // Some recordBoxes DO, and some DON'T (the different kinds store different
@@ -4794,24 +4797,24 @@ void OTTransaction::SaveAbbrevRecordBoxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("recordBoxRecord"));
+    parent.open("recordBoxRecord");
 
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("adjustment", formatLong(lAdjustment));
-    pTag->add_attribute("displayValue", formatLong(lDisplayValue));
-    pTag->add_attribute("numberOfOrigin", formatLong(GetRawNumberOfOrigin()));
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
+    parent.add_attribute("type", strType.Get());
+    parent.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    parent.add_attribute("receiptHash", strHash.Get());
+    parent.add_attribute("adjustment", formatLong(lAdjustment));
+    parent.add_attribute("displayValue", formatLong(lDisplayValue));
+    parent.add_attribute("numberOfOrigin", formatLong(GetRawNumberOfOrigin()));
+    parent.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    parent.add_attribute("inRefDisplay",
                         formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    parent.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
     if ((OTTransaction::finalReceipt == m_Type) ||
         (OTTransaction::basketReceipt == m_Type))
-        pTag->add_attribute("closingNum", formatLong(GetClosingNum()));
+        parent.add_attribute("closingNum", formatLong(GetClosingNum()));
 
-    parent.add_tag(pTag);
+    parent.close();
 }
 
 // All of the actual receipts cannot fit inside the inbox file,
@@ -4821,7 +4824,7 @@ void OTTransaction::SaveAbbrevRecordBoxRecord(Tag& parent)
 // way, each message cannot be too large to download, such as
 // a giant inbox can be with 400000 receipts inside of it.
 //
-void OTTransaction::SaveAbbreviatedNymboxRecord(Tag& parent)
+void OTTransaction::SaveAbbreviatedNymboxRecord(XMLWriter& parent)
 {
     int64_t lDisplayValue = 0;
     bool bAddRequestNumber = false;
@@ -4919,42 +4922,42 @@ void OTTransaction::SaveAbbreviatedNymboxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("nymboxRecord"));
+    parent.open("nymboxRecord");
 
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
+    parent.add_attribute("type", strType.Get());
+    parent.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    parent.add_attribute("receiptHash", strHash.Get());
+    parent.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    parent.add_attribute("inRefDisplay",
                         formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    parent.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
     // I actually don't think you can put a basket receipt
     // notice in a nymbox, the way you can with a final
     // receipt notice. Probably can remove that line.
     if ((OTTransaction::finalReceipt == m_Type) ||
         (OTTransaction::basketReceipt == m_Type))
-        pTag->add_attribute("closingNum", formatLong(GetClosingNum()));
+        parent.add_attribute("closingNum", formatLong(GetClosingNum()));
     else {
         if (strListOfBlanks.Exists())
-            pTag->add_attribute("totalListOfNumbers", strListOfBlanks.Get());
+            parent.add_attribute("totalListOfNumbers", strListOfBlanks.Get());
         if (bAddRequestNumber) {
-            pTag->add_attribute("requestNumber", formatLong(m_lRequestNumber));
-            pTag->add_attribute("transSuccess",
+            parent.add_attribute("requestNumber", formatLong(m_lRequestNumber));
+            parent.add_attribute("transSuccess",
                                 formatBool(m_bReplyTransSuccess));
         }
         if (lDisplayValue > 0) {
             // IF this transaction is passing through on its
             // way to the paymentInbox, it will have a
             // displayValue.
-            pTag->add_attribute("displayValue", formatLong(lDisplayValue));
+            parent.add_attribute("displayValue", formatLong(lDisplayValue));
         }
     }
 
-    parent.add_tag(pTag);
+    parent.close();
 }
 
-void OTTransaction::SaveAbbreviatedOutboxRecord(Tag& parent)
+void OTTransaction::SaveAbbreviatedOutboxRecord(XMLWriter& parent)
 {
     int64_t lAdjustment = 0, lDisplayValue = 0;
 
@@ -5016,23 +5019,23 @@ void OTTransaction::SaveAbbreviatedOutboxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("outboxRecord"));
+    parent.open("outboxRecord");
 
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("adjustment", formatLong(lAdjustment));
-    pTag->add_attribute("displayValue", formatLong(lDisplayValue));
-    pTag->add_attribute("numberOfOrigin", formatLong(GetRawNumberOfOrigin()));
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
+    parent.add_attribute("type", strType.Get());
+    parent.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    parent.add_attribute("receiptHash", strHash.Get());
+    parent.add_attribute("adjustment", formatLong(lAdjustment));
+    parent.add_attribute("displayValue", formatLong(lDisplayValue));
+    parent.add_attribute("numberOfOrigin", formatLong(GetRawNumberOfOrigin()));
+    parent.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    parent.add_attribute("inRefDisplay",
                         formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    parent.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
-    parent.add_tag(pTag);
+    parent.close();
 }
 
-void OTTransaction::SaveAbbreviatedInboxRecord(Tag& parent)
+void OTTransaction::SaveAbbreviatedInboxRecord(XMLWriter& parent)
 {
     // This is the actual amount that your account is changed BY this receipt.
     // Versus the useful amount the user will want to see (lDisplayValue.) For
@@ -5168,24 +5171,24 @@ void OTTransaction::SaveAbbreviatedInboxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("inboxRecord"));
+    parent.open("inboxRecord");
 
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("adjustment", formatLong(lAdjustment));
-    pTag->add_attribute("displayValue", formatLong(lDisplayValue));
-    pTag->add_attribute("numberOfOrigin", formatLong(GetRawNumberOfOrigin()));
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
+    parent.add_attribute("type", strType.Get());
+    parent.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    parent.add_attribute("receiptHash", strHash.Get());
+    parent.add_attribute("adjustment", formatLong(lAdjustment));
+    parent.add_attribute("displayValue", formatLong(lDisplayValue));
+    parent.add_attribute("numberOfOrigin", formatLong(GetRawNumberOfOrigin()));
+    parent.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    parent.add_attribute("inRefDisplay",
                         formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    parent.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
     if ((OTTransaction::finalReceipt == m_Type) ||
         (OTTransaction::basketReceipt == m_Type))
-        pTag->add_attribute("closingNum", formatLong(GetClosingNum()));
+        parent.add_attribute("closingNum", formatLong(GetClosingNum()));
 
-    parent.add_tag(pTag);
+    parent.close();
 }
 
 // The ONE case where an Item has SUB-ITEMS is in the case of Balance Agreement.
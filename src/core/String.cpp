@@ -246,6 +246,31 @@ std::string& String::trim(std::string& str)
     return str;
 }
 
+void String::Trim()
+{
+    if (!Exists()) return;
+
+    auto isWhitespace = [](char c) {
+        return (' ' == c) || ('\t' == c) || ('\f' == c) || ('\v' == c) ||
+               ('\n' == c) || ('\r' == c);
+    };
+
+    uint32_t begin = 0;
+    uint32_t end = length_;
+
+    while ((begin < end) && isWhitespace(data_[begin])) ++begin;
+
+    // Like trim(), leave a string that is nothing but whitespace alone.
+    if (begin == end) return;
+
+    while (isWhitespace(data_[end - 1])) --end;
+
+    if ((0 == begin) && (length_ == end)) return;
+
+    String strTrimmed(data_ + begin, end - begin);
+    swap(strTrimmed);
+}
+
 std::string String::replace_chars(const std::string& str,
                                   const std::string& charsFrom,
                                   const char& charTo)
@@ -1057,10 +1082,11 @@ bool String::DecodeIfArmored(bool bEscapedIsAllowed)
         }
     }
     else {
-        std::string str_temp(Get(), GetLength());
-        str_Trim = String::trim(str_temp); // This is the std::string for the
-                                           // trim process. (Wasn't armored,
-                                           // so here we use it as passed in.)
+        // Wasn't armored, so here we use it as passed in. Trimmed in place,
+        // since a signed contract can be large and this is the common case.
+        Trim();
+
+        return Exists();
     }
 
     // At this point, str_Trim contains the actual contents, whether they
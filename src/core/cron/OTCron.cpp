@@ -40,13 +40,16 @@
 #include <opentxs/core/crypto/OTASCIIArmor.hpp>
 #include <opentxs/core/cron/OTCronItem.hpp>
 #include <opentxs/core/util/OTFolders.hpp>
-#include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/XMLWriter.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/trade/OTMarket.hpp>
 
 #include <irrxml/irrXML.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
 
 // Note: these are only code defaults -- the values are actually loaded from
 // ~/.ot/server.cfg.
@@ -65,8 +68,89 @@ int32_t OTCron::__cron_max_items_per_nym = 10; // The maximum number of cron
                                                // items any given Nym can have
                                                // active at the same time.
 
+int32_t OTCron::__cron_thread_count = 1; // Threads processing independent
+                                         // cron items at the same time.
+
 Timer OTCron::tCron(true);
 
+namespace
+{
+
+// What became of each due cron item during a round.
+const int32_t CRON_ITEM_SKIPPED = 0; // Out of transaction numbers.
+const int32_t CRON_ITEM_KEEP = 1;
+const int32_t CRON_ITEM_REMOVE = 2;
+
+// Sorts the due cron items into groups that share no account, Nym or market.
+// (Union-find over the items, joined by the keys they report.)
+class CronItemGroups
+{
+public:
+    explicit CronItemGroups(std::size_t nItems)
+        : parent_(nItems)
+    {
+        for (std::size_t i = 0; i < nItems; ++i) parent_[i] = i;
+    }
+
+    void Join(std::size_t nItem, const std::string& strKey)
+    {
+        auto it = keys_.find(strKey);
+
+        if (keys_.end() == it)
+            keys_[strKey] = nItem;
+        else
+            unite(nItem, it->second);
+    }
+
+    // Each group lists its items in order, and the groups are in order of
+    // their first item.
+    void GetGroups(const std::vector<std::size_t>& theItems,
+                   std::vector<std::vector<std::size_t>>& theGroups)
+    {
+        std::map<std::size_t, std::size_t> mapGroups; // root -> group
+
+        for (std::size_t nItem : theItems) {
+            const std::size_t nRoot = find(nItem);
+            auto it = mapGroups.find(nRoot);
+
+            if (mapGroups.end() == it) {
+                it = mapGroups.insert(std::make_pair(nRoot, theGroups.size()))
+                         .first;
+                theGroups.push_back(std::vector<std::size_t>());
+            }
+
+            theGroups[it->second].push_back(nItem);
+        }
+    }
+
+private:
+    std::size_t find(std::size_t nItem)
+    {
+        while (parent_[nItem] != nItem) {
+            parent_[nItem] = parent_[parent_[nItem]];
+            nItem = parent_[nItem];
+        }
+
+        return nItem;
+    }
+
+    void unite(std::size_t nFirst, std::size_t nSecond)
+    {
+        nFirst = find(nFirst);
+        nSecond = find(nSecond);
+
+        if (nFirst < nSecond)
+            parent_[nSecond] = nFirst;
+        else if (nSecond < nFirst)
+            parent_[nFirst] = nSecond;
+    }
+
+    std::vector<std::size_t> parent_;
+    std::map<std::string, std::size_t> keys_;
+};
+
+} // namespace
+
 // Make sure Server Nym is set on this cron object before loading or saving,
 // since it's
 // used for signing and verifying..
@@ -91,6 +175,8 @@ bool OTCron::SaveCron()
 
     OT_ASSERT(nullptr != GetServerNym());
 
+    std::lock_guard<std::mutex> lock(m_saveLock);
+
     ReleaseSignatures();
 
     // Sign it, save it internally to string, and then save that out to the
@@ -105,6 +191,14 @@ bool OTCron::SaveCron()
         return true;
 }
 
+void OTCron::SaveCronLater()
+{
+    if (m_bProcessing)
+        m_bNeedToSave = true;
+    else
+        SaveCron();
+}
+
 // Loops through ALL markets, and calls pMarket->GetNym_OfferList(NYM_ID,
 // *pOfferList) for each.
 // Returns a list of all the offers that a specific Nym has on all the markets.
@@ -186,7 +280,47 @@ bool OTCron::GetNym_OfferList(OTASCIIArmor& ascOutput, const Identifier& NYM_ID,
     return false;
 }
 
+// Markets only ever get added, and their versions only go up, so this
+// changes whenever anything in the market list does.
+int64_t OTCron::getMarketListVersion() const
+{
+    int64_t lVersion = static_cast<int64_t>(m_mapMarkets.size());
+
+    for (auto& it : m_mapMarkets) {
+        OTMarket* pMarket = it.second;
+        OT_ASSERT(nullptr != pMarket);
+
+        lVersion += pMarket->GetVersion();
+    }
+
+    return lVersion;
+}
+
+// The list is only encoded again once some market has changed.
 bool OTCron::GetMarketList(OTASCIIArmor& ascOutput, int32_t& nMarketCount)
+{
+    std::lock_guard<std::mutex> lock(m_marketListLock);
+
+    const int64_t lVersion = getMarketListVersion();
+
+    if (lVersion != m_lMarketListVersion) {
+        OTASCIIArmor ascMarkets;
+        int32_t nCount = 0;
+
+        if (!encodeMarketList(ascMarkets, nCount)) return false;
+
+        m_ascMarketList = ascMarkets;
+        m_nMarketListCount = nCount;
+        m_lMarketListVersion = lVersion;
+    }
+
+    ascOutput = m_ascMarketList;
+    nMarketCount = m_nMarketListCount;
+
+    return true;
+}
+
+bool OTCron::encodeMarketList(OTASCIIArmor& ascOutput, int32_t& nMarketCount)
 {
     nMarketCount = 0; // This parameter is set to zero here, and incremented in
                       // the loop below.
@@ -237,13 +371,13 @@ bool OTCron::GetMarketList(OTASCIIArmor& ascOutput, int32_t& nMarketCount)
 
         pMarketData->last_sale_date = pMarket->GetLastSaleDate();
 
-        const mapOfOffers::size_type theBidCount = pMarket->GetBidCount();
-        const mapOfOffers::size_type theAskCount = pMarket->GetAskCount();
+        const OTOrderBook::size_type theBidCount = pMarket->GetBidCount();
+        const OTOrderBook::size_type theAskCount = pMarket->GetAskCount();
 
         pMarketData->number_bids =
-            to_string<mapOfOffers::size_type>(theBidCount);
+            to_string<OTOrderBook::size_type>(theBidCount);
         pMarketData->number_asks =
-            to_string<mapOfOffers::size_type>(theAskCount);
+            to_string<OTOrderBook::size_type>(theAskCount);
 
         // In the past 24 hours.
         // (I'm not collecting this data yet, (maybe never), so these values
@@ -317,6 +451,8 @@ bool OTCron::GetMarketList(OTASCIIArmor& ascOutput, int32_t& nMarketCount)
 
 int32_t OTCron::GetTransactionCount() const
 {
+    std::lock_guard<std::mutex> lock(m_transactionLock);
+
     if (m_listTransactionNumbers.empty()) return 0;
 
     return static_cast<int32_t>(m_listTransactionNumbers.size());
@@ -324,6 +460,8 @@ int32_t OTCron::GetTransactionCount() const
 
 void OTCron::AddTransactionNumber(const int64_t& lTransactionNum)
 {
+    std::lock_guard<std::mutex> lock(m_transactionLock);
+
     m_listTransactionNumbers.push_back(lTransactionNum);
 }
 
@@ -331,6 +469,8 @@ void OTCron::AddTransactionNumber(const int64_t& lTransactionNum)
 // payment plans until the server object replenishes this list.
 int64_t OTCron::GetNextTransactionNumber()
 {
+    std::lock_guard<std::mutex> lock(m_transactionLock);
+
     if (m_listTransactionNumbers.empty()) return 0;
 
     int64_t lTransactionNum = m_listTransactionNumbers.front();
@@ -498,12 +638,17 @@ int32_t OTCron::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
 
 void OTCron::UpdateContents()
 {
+    // Reuse the previous size as a guess for the new one.
+    std::string str_result;
+    str_result.reserve(m_xmlUnsigned.GetLength());
+
     // I release this because I'm about to repopulate it.
     m_xmlUnsigned.Release();
 
     const String NOTARY_ID(m_NOTARY_ID);
 
-    Tag tag("cron");
+    XMLWriter tag(str_result);
+    tag.open("cron");
 
     tag.add_attribute("version", m_strVersion.Get());
     tag.add_attribute("notaryID", NOTARY_ID.Get());
@@ -521,14 +666,13 @@ void OTCron::UpdateContents()
             pMarket->GetInstrumentDefinitionID());
         String str_CURRENCY_ID(pMarket->GetCurrencyID());
 
-        TagPtr tagMarket(new Tag("market"));
-        tagMarket->add_attribute("marketID", str_MARKET_ID.Get());
-        tagMarket->add_attribute("instrumentDefinitionID",
-                                 str_INSTRUMENT_DEFINITION_ID.Get());
-        tagMarket->add_attribute("currencyID", str_CURRENCY_ID.Get());
-        tagMarket->add_attribute("marketScale",
-                                 formatLong(pMarket->GetScale()));
-        tag.add_tag(tagMarket);
+        tag.open("market");
+        tag.add_attribute("marketID", str_MARKET_ID.Get());
+        tag.add_attribute("instrumentDefinitionID",
+                          str_INSTRUMENT_DEFINITION_ID.Get());
+        tag.add_attribute("currencyID", str_CURRENCY_ID.Get());
+        tag.add_attribute("marketScale", formatLong(pMarket->GetScale()));
+        tag.close();
     }
 
     // Save the Cron Items
@@ -541,23 +685,23 @@ void OTCron::UpdateContents()
             *pItem); // Extract the cron item contract into string form.
         OTASCIIArmor ascItem(strItem); // Base64-encode that for storage.
 
-        TagPtr tagCronItem(new Tag("cronItem", ascItem.Get()));
-        tagCronItem->add_attribute("dateAdded", formatTimestamp(tDateAdded));
-        tag.add_tag(tagCronItem);
+        tag.open("cronItem");
+        tag.add_attribute("dateAdded", formatTimestamp(tDateAdded));
+        tag.set_text(ascItem.Get());
+        tag.close();
     }
 
     // Save the transaction numbers.
     //
     for (auto& lTransactionNumber : m_listTransactionNumbers) {
-        TagPtr tagNumber(new Tag("transactionNum"));
-        tagNumber->add_attribute("value", formatLong(lTransactionNumber));
-        tag.add_tag(tagNumber);
+        tag.open("transactionNum");
+        tag.add_attribute("value", formatLong(lTransactionNumber));
+        tag.close();
     } // for
 
-    std::string str_result;
-    tag.output(str_result);
+    tag.close();
 
-    m_xmlUnsigned.Concatenate("%s", str_result.c_str());
+    m_xmlUnsigned.Set(str_result.c_str());
 }
 
 int64_t OTCron::computeTimeout()
@@ -567,78 +711,266 @@ int64_t OTCron::computeTimeout()
 
 // Make sure to call this regularly so the CronItems get a chance to process and
 // expire.
-void OTCron::ProcessCronItems()
+bool OTCron::ProcessCronItems(int32_t nMaxItems)
 {
     if (!m_bIsActivated) {
         otErr << "OTCron::ProcessCronItems: Not activated yet. (Skipping.)\n";
-        return;
-    }
-
-    // check elapsed time since last items processing
-    if (computeTimeout() > 0) {
-        return;
+        return true;
     }
-    tCron.start();
 
-    const int32_t nTwentyPercent = OTCron::GetCronRefillAmount() / 5;
-    if (GetTransactionCount() <= nTwentyPercent) {
-        otErr << "WARNING: Cron has fewer than 20 percent of its normal "
-                 "transaction number count available since the previous round! "
-                 "\n"
-                 "That is, " << GetTransactionCount()
-              << " are currently available, with a max of "
-              << OTCron::GetCronRefillAmount() << ", meaning "
-              << OTCron::GetCronRefillAmount() - GetTransactionCount()
-              << " were used in the last round alone!!! \n"
-                 "SKIPPING THE CRON ITEMS THAT WERE SCHEDULED FOR THIS "
-                 "ROUND!!!\n\n";
-        return;
-    }
-    bool bNeedToSave = false;
+    if (!m_bInPass) {
+        // check elapsed time since last items processing
+        if (computeTimeout() > 0) {
+            return true;
+        }
+        tCron.start();
 
-    // loop through the cron items and tell each one to ProcessCron().
-    // If the item returns true, that means leave it on the list. Otherwise,
-    // if it returns false, that means "it's done: remove it."
-    for (auto it = m_multimapCronItems.begin();
-         it != m_multimapCronItems.end();) {
+        const int32_t nTwentyPercent = OTCron::GetCronRefillAmount() / 5;
         if (GetTransactionCount() <= nTwentyPercent) {
             otErr << "WARNING: Cron has fewer than 20 percent of its normal "
-                     "transaction "
-                     "number count available since the previous cron item "
-                     "alone! \n"
+                     "transaction number count available since the previous "
+                     "round! \n"
                      "That is, " << GetTransactionCount()
                   << " are currently available, with a max of "
                   << OTCron::GetCronRefillAmount() << ", meaning "
                   << OTCron::GetCronRefillAmount() - GetTransactionCount()
-                  << " were used in the current round alone!!! \n"
-                     "SKIPPING THE REMAINDER OF THE CRON ITEMS THAT WERE "
-                     "SCHEDULED FOR THIS ROUND!!!\n\n";
-            break;
+                  << " were used in the last round alone!!! \n"
+                     "SKIPPING THE CRON ITEMS THAT WERE SCHEDULED FOR THIS "
+                     "ROUND!!!\n\n";
+            return true;
         }
-        OTCronItem* pItem = it->second;
-        OT_ASSERT(nullptr != pItem);
-        otInfo << "OTCron::" << __FUNCTION__
-               << ": Processing item number: " << pItem->GetTransactionNum()
-               << " \n";
 
-        if (pItem->ProcessCron()) {
-            it++;
-            continue;
+        m_tPassTime = OTTimeGetCurrentTime();
+        m_bInPass = true;
+    }
+
+    bool bNeedToSave = false;
+    bool bOutOfNumbers = false;
+    bool bMoreDue = false;
+    const time64_t tNow = m_tPassTime;
+    std::size_t nProcessed = 0;
+
+    // Process the cron items that are due. If an item's ProcessCron() returns
+    // true, that means leave it on the list, and schedule it again. Otherwise,
+    // if it returns false, that means "it's done: remove it."
+    //
+    // Items flagged for removal along the way are scheduled right away, so
+    // keep going until nothing is due (or nMaxItems have been processed.)
+    while (!bOutOfNumbers) {
+        std::size_t nLeft = 0;
+
+        if (nMaxItems > 0) {
+            if (nProcessed >= static_cast<std::size_t>(nMaxItems)) {
+                bMoreDue = true;
+                break;
+            }
+            nLeft = static_cast<std::size_t>(nMaxItems) - nProcessed;
         }
-        pItem->HookRemovalFromCron(nullptr, GetNextTransactionNumber());
-        otOut << "OTCron::" << __FUNCTION__
-              << ": Removing cron item: " << pItem->GetTransactionNum() << "\n";
-        it = m_multimapCronItems.erase(it);
-        auto it_map = FindItemOnMap(pItem->GetTransactionNum());
-        OT_ASSERT(m_mapCronItems.end() != it_map);
-        m_mapCronItems.erase(it_map);
 
-        delete pItem;
-        pItem = nullptr;
+        std::vector<OTCronItem*> theItems;
+        TakeDueItems(tNow, theItems, nLeft);
+
+        if (theItems.empty()) break;
+
+        nProcessed += theItems.size();
+
+        std::vector<int32_t> theResults(theItems.size(), CRON_ITEM_SKIPPED);
+        m_bProcessing = true;
+        ProcessDueItems(theItems, theResults);
+        m_bProcessing = false;
+
+        if (m_bNeedToSave.exchange(false)) bNeedToSave = true;
+
+        // Items are rescheduled and removed here, in order, on this thread.
+        for (std::size_t i = 0; i < theItems.size(); ++i) {
+            OTCronItem* pItem = theItems[i];
+            const int64_t lTransactionNum = pItem->GetTransactionNum();
 
-        bNeedToSave = true;
+            if (CRON_ITEM_SKIPPED == theResults[i]) {
+                ScheduleCronItem(*pItem); // Still due, next round.
+                bOutOfNumbers = true;
+                continue;
+            }
+
+            if (CRON_ITEM_KEEP == theResults[i]) {
+                // Not again this round, even if it says it's still due.
+                ScheduleCronItem(*pItem, OTTimeAddTimeInterval(tNow, 1));
+                continue;
+            }
+
+            pItem->HookRemovalFromCron(nullptr, GetNextTransactionNumber());
+            otOut << "OTCron::" << __FUNCTION__
+                  << ": Removing cron item: " << lTransactionNum << "\n";
+            UnscheduleCronItem(lTransactionNum); // In case it was flagged.
+            auto it_multimap = FindItemOnMultimap(lTransactionNum);
+            OT_ASSERT(m_multimapCronItems.end() != it_multimap);
+            m_multimapCronItems.erase(it_multimap);
+            auto it_map = FindItemOnMap(lTransactionNum);
+            OT_ASSERT(m_mapCronItems.end() != it_map);
+            m_mapCronItems.erase(it_map);
+
+            delete pItem;
+            pItem = nullptr;
+
+            bNeedToSave = true;
+        }
     }
+
     if (bNeedToSave) SaveCron();
+
+    if (bMoreDue) return false;
+
+    m_bInPass = false;
+
+    if (bOutOfNumbers) {
+        otErr << "WARNING: Cron has fewer than 20 percent of its normal "
+                 "transaction "
+                 "number count available since the previous cron item "
+                 "alone! \n"
+                 "That is, " << GetTransactionCount()
+              << " are currently available, with a max of "
+              << OTCron::GetCronRefillAmount() << ", meaning "
+              << OTCron::GetCronRefillAmount() - GetTransactionCount()
+              << " were used in the current round alone!!! \n"
+                 "SKIPPING THE REMAINDER OF THE CRON ITEMS THAT WERE "
+                 "SCHEDULED FOR THIS ROUND!!!\n\n";
+    }
+
+    // The markets journal their changes as trades process. Here, between
+    // rounds, is where a market saves itself in full once its journal gets
+    // long.
+    for (auto& it : m_mapMarkets) {
+        OTMarket* pMarket = it.second;
+        OT_ASSERT(nullptr != pMarket);
+
+        pMarket->CompactJournal();
+    }
+
+    return true;
+}
+
+// Takes the items due by tNow off the schedule, in the order they're due, up
+// to nMaxItems of them (0 for all.)
+void OTCron::TakeDueItems(time64_t tNow, std::vector<OTCronItem*>& theItems,
+                          std::size_t nMaxItems)
+{
+    std::lock_guard<std::mutex> lock(m_scheduleLock);
+
+    while (!m_setDueDates.empty() && (m_setDueDates.begin()->first <= tNow) &&
+           ((0 == nMaxItems) || (theItems.size() < nMaxItems))) {
+        const int64_t lTransactionNum = m_setDueDates.begin()->second;
+        EraseDueDate(lTransactionNum);
+
+        auto it_map = m_mapCronItems.find(lTransactionNum);
+        OT_ASSERT(m_mapCronItems.end() != it_map);
+        theItems.push_back(it_map->second);
+    }
+}
+
+// Items that share no account, Nym or market are processed in parallel, in
+// groups. Within a group, and for the items that can't say what they touch
+// (which are processed afterwards, on this thread), the order is the order
+// they came due. So an item always sees the same results from the items it
+// shares anything with.
+void OTCron::ProcessDueItems(const std::vector<OTCronItem*>& theItems,
+                             std::vector<int32_t>& theResults)
+{
+    std::vector<std::size_t> theSerial;
+    std::vector<std::vector<std::size_t>> theGroups;
+
+    if (GetCronThreadCount() > 1) {
+        CronItemGroups theKeys(theItems.size());
+        std::vector<std::size_t> theParallel;
+        std::set<std::string> setMarkets; // Expanded already.
+
+        for (std::size_t i = 0; i < theItems.size(); ++i) {
+            std::set<std::string> keys;
+
+            if (!theItems[i]->GetCronKeys(keys)) {
+                theSerial.push_back(i);
+                continue;
+            }
+
+            // A market stands in for everybody trading on it.
+            std::set<std::string> traders;
+
+            for (const std::string& key : keys) {
+                auto it = m_mapMarkets.find(key);
+
+                if ((m_mapMarkets.end() != it) && setMarkets.insert(key).second)
+                    it->second->GetTraderKeys(traders);
+            }
+
+            for (const std::string& key : keys) theKeys.Join(i, key);
+            for (const std::string& key : traders) theKeys.Join(i, key);
+
+            theParallel.push_back(i);
+        }
+
+        theKeys.GetGroups(theParallel, theGroups);
+    }
+    else {
+        for (std::size_t i = 0; i < theItems.size(); ++i)
+            theSerial.push_back(i);
+    }
+
+    std::atomic<bool> bOutOfNumbers(false);
+
+    if (theGroups.size() > 1) {
+        std::atomic<std::size_t> nNextGroup(0);
+
+        auto processGroups = [&]() {
+            for (std::size_t nGroup = nNextGroup++; nGroup < theGroups.size();
+                 nGroup = nNextGroup++) {
+                for (std::size_t i : theGroups[nGroup]) {
+                    if (bOutOfNumbers ||
+                        !ProcessDueItem(*theItems[i], theResults[i])) {
+                        bOutOfNumbers = true;
+                        break;
+                    }
+                }
+            }
+        };
+
+        const std::size_t nThreads =
+            std::min(static_cast<std::size_t>(GetCronThreadCount()),
+                     theGroups.size());
+        std::vector<std::thread> theThreads;
+
+        for (std::size_t i = 0; i < nThreads; ++i)
+            theThreads.push_back(std::thread(processGroups));
+
+        for (auto& thread : theThreads) thread.join();
+    }
+    else if (1 == theGroups.size()) {
+        // Not worth a thread.
+        theSerial.insert(theSerial.end(), theGroups[0].begin(),
+                         theGroups[0].end());
+        std::sort(theSerial.begin(), theSerial.end());
+    }
+
+    for (std::size_t i : theSerial) {
+        if (bOutOfNumbers || !ProcessDueItem(*theItems[i], theResults[i])) {
+            bOutOfNumbers = true;
+            break;
+        }
+    }
+}
+
+// Returns false (without processing the item) if Cron is too low on
+// transaction numbers.
+bool OTCron::ProcessDueItem(OTCronItem& theItem, int32_t& nResult)
+{
+    if (GetTransactionCount() <= OTCron::GetCronRefillAmount() / 5)
+        return false;
+
+    otInfo << "OTCron::" << __FUNCTION__
+           << ": Processing item number: " << theItem.GetTransactionNum()
+           << " \n";
+
+    nResult = theItem.ProcessCron() ? CRON_ITEM_KEEP : CRON_ITEM_REMOVE;
+
+    return true;
 }
 
 // OTCron IS responsible for cleaning up theItem, and takes ownership.
@@ -695,6 +1027,8 @@ bool OTCron::AddCronItem(OTCronItem& theItem, Nym* pActivator,
         theItem.setServerNym(m_pServerNym);
         theItem.setNotaryID(&m_NOTARY_ID);
 
+        ScheduleCronItem(theItem);
+
         bool bSuccess = true;
 
         theItem.HookActivationOnCron(
@@ -780,6 +1114,7 @@ bool OTCron::RemoveCronItem(int64_t lTransactionNum,
 
         m_mapCronItems.erase(it_map);           // Remove from MAP.
         m_multimapCronItems.erase(it_multimap); // Remove from MULTIMAP.
+        UnscheduleCronItem(lTransactionNum);
 
         delete pItem;
 
@@ -790,6 +1125,42 @@ bool OTCron::RemoveCronItem(int64_t lTransactionNum,
     return false;
 }
 
+void OTCron::ScheduleCronItem(OTCronItem& theItem, time64_t tNotBefore)
+{
+    const int64_t lTransactionNum = theItem.GetTransactionNum();
+    auto it_map = m_mapCronItems.find(lTransactionNum);
+
+    // Only items that are actually on Cron get scheduled.
+    if ((m_mapCronItems.end() == it_map) || (&theItem != it_map->second))
+        return;
+
+    time64_t tDueDate = theItem.GetCronDueDate();
+    if (tDueDate < tNotBefore) tDueDate = tNotBefore;
+
+    std::lock_guard<std::mutex> lock(m_scheduleLock);
+
+    EraseDueDate(lTransactionNum);
+    m_setDueDates.insert(std::make_pair(tDueDate, lTransactionNum));
+    m_mapDueDates[lTransactionNum] = tDueDate;
+}
+
+void OTCron::UnscheduleCronItem(int64_t lTransactionNum)
+{
+    std::lock_guard<std::mutex> lock(m_scheduleLock);
+
+    EraseDueDate(lTransactionNum);
+}
+
+void OTCron::EraseDueDate(int64_t lTransactionNum)
+{
+    auto it = m_mapDueDates.find(lTransactionNum);
+
+    if (m_mapDueDates.end() == it) return;
+
+    m_setDueDates.erase(std::make_pair(it->second, lTransactionNum));
+    m_mapDueDates.erase(it);
+}
+
 // Look up a transaction by transaction number and see if it is in the map.
 // If it is, return an iterator to it, otherwise return m_mapCronItems.end()
 //
@@ -1056,6 +1427,12 @@ OTMarket* OTCron::GetMarket(const Identifier& MARKET_ID)
 
 OTCron::OTCron()
     : Contract()
+    , m_bProcessing(false)
+    , m_bNeedToSave(false)
+    , m_nMarketListCount(0)
+    , m_lMarketListVersion(-1)
+    , m_bInPass(false)
+    , m_tPassTime(OT_TIME_ZERO)
     , m_bIsActivated(false)
     , m_pServerNym(nullptr) // just here for convenience, not responsible to
                             // cleanup this pointer.
@@ -1066,6 +1443,12 @@ OTCron::OTCron()
 
 OTCron::OTCron(const Identifier& NOTARY_ID)
     : Contract()
+    , m_bProcessing(false)
+    , m_bNeedToSave(false)
+    , m_nMarketListCount(0)
+    , m_lMarketListVersion(-1)
+    , m_bInPass(false)
+    , m_tPassTime(OT_TIME_ZERO)
     , m_bIsActivated(false)
     , m_pServerNym(nullptr) // just here for convenience, not responsible to
                             // cleanup this pointer.
@@ -1077,6 +1460,12 @@ OTCron::OTCron(const Identifier& NOTARY_ID)
 
 OTCron::OTCron(const char* szFilename)
     : Contract()
+    , m_bProcessing(false)
+    , m_bNeedToSave(false)
+    , m_nMarketListCount(0)
+    , m_lMarketListVersion(-1)
+    , m_bInPass(false)
+    , m_tPassTime(OT_TIME_ZERO)
     , m_bIsActivated(false)
     , m_pServerNym(nullptr) // just here for convenience, not responsible to
                             // cleanup this pointer.
@@ -1120,6 +1509,9 @@ void OTCron::Release_Cron()
         // same pItems being deleted in the next block.
     }
 
+    m_setDueDates.clear();
+    m_mapDueDates.clear();
+
     while (!m_mapCronItems.empty()) {
         OTCronItem* pItem = m_mapCronItems.begin()->second;
         auto it = m_mapCronItems.begin();
@@ -1135,6 +1527,8 @@ void OTCron::Release_Cron()
         delete pMarket;
         pMarket = nullptr;
     }
+
+    m_lMarketListVersion = -1;
 }
 
 } // namespace opentxs
@@ -694,6 +694,31 @@ bool OTCronItem::ProcessCron()
     return true;
 }
 
+// Items that throttle themselves (see OTTrade::ProcessCron, etc) set the last
+// process date, and can't do anything until the process interval has passed
+// since then. Items that don't, are due every time Cron processes.
+//
+time64_t OTCronItem::GetCronDueDate() const
+{
+    if (IsFlaggedForRemoval() || (OT_TIME_ZERO >= m_LAST_PROCESS_DATE))
+        return OT_TIME_ZERO;
+
+    return OTTimeAddTimeInterval(m_LAST_PROCESS_DATE, m_PROCESS_INTERVAL + 1);
+}
+
+bool OTCronItem::GetCronKeys(std::set<std::string>&) const
+{
+    return false;
+}
+
+void OTCronItem::FlagForRemoval()
+{
+    m_bRemovalFlag = true;
+
+    // So the removal doesn't wait for the item to come due.
+    if (nullptr != m_pCron) m_pCron->ScheduleCronItem(*this);
+}
+
 // OTCron calls this when a cron item is added.
 // bForTheFirstTime=true means that this cron item is being
 // activated for the very first time. (Versus being re-added
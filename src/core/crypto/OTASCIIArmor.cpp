@@ -39,6 +39,7 @@
 #include <opentxs/core/stdafx.hpp>
 
 #include <opentxs/core/crypto/OTASCIIArmor.hpp>
+#include <opentxs/core/crypto/OTBase64.hpp>
 #include <opentxs/core/crypto/OTCrypto.hpp>
 #include <opentxs/core/crypto/OTEnvelope.hpp>
 #include <opentxs/core/Log.hpp>
@@ -183,8 +184,8 @@ OTASCIIArmor& OTASCIIArmor::operator=(const OTASCIIArmor& strValue)
 
 /** Compress a STL string using zlib with given compression level and return
  * the binary data. */
-std::string OTASCIIArmor::compress_string(
-    const std::string& str, int32_t compressionlevel = Z_BEST_COMPRESSION) const
+std::string OTASCIIArmor::compress_string(const char* data, size_t size,
+                                          int32_t compressionlevel)
 {
     z_stream zs; // z_stream is zlib's control structure
     memset(&zs, 0, sizeof(zs));
@@ -192,8 +193,8 @@ std::string OTASCIIArmor::compress_string(
     if (deflateInit(&zs, compressionlevel) != Z_OK)
         throw(std::runtime_error("deflateInit failed while compressing."));
 
-    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(str.data()));
-    zs.avail_in = static_cast<uInt>(str.size()); // set the z_stream's input
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zs.avail_in = static_cast<uInt>(size); // set the z_stream's input
 
     int32_t ret;
     char outbuffer[32768];
@@ -224,7 +225,7 @@ std::string OTASCIIArmor::compress_string(
 }
 
 /** Decompress an STL string using zlib and return the original data. */
-std::string OTASCIIArmor::decompress_string(const std::string& str) const
+std::string OTASCIIArmor::decompress_string(const char* data, size_t size)
 {
     z_stream zs; // z_stream is zlib's control structure
     memset(&zs, 0, sizeof(zs));
@@ -232,8 +233,8 @@ std::string OTASCIIArmor::decompress_string(const std::string& str) const
     if (inflateInit(&zs) != Z_OK)
         throw(std::runtime_error("inflateInit failed while decompressing."));
 
-    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(str.data()));
-    zs.avail_in = static_cast<uInt>(str.size());
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zs.avail_in = static_cast<uInt>(size);
 
     int32_t ret;
     char outbuffer[32768];
@@ -310,7 +311,7 @@ bool OTASCIIArmor::SetData(const OTData& theData, bool bLineBreaks)
 
 // Base64-decode an decompress
 bool OTASCIIArmor::GetString(String& strData,
-                             bool bLineBreaks) const // bLineBreaks=true
+                             bool) const // bLineBreaks=true
 {
     strData.Release();
 
@@ -318,24 +319,10 @@ bool OTASCIIArmor::GetString(String& strData,
         return true;
     }
 
-    size_t outSize = 0;
-    uint8_t* pData = OTCrypto::It()->Base64Decode(Get(), &outSize, bLineBreaks);
-
-    if (!pData) {
-        otErr << __FUNCTION__ << "Base64Decode fail\n";
-        return false;
-    }
-
-    std::string str_decoded(pData, pData + outSize);
-
-    delete[] pData;
-
     std::string str_uncompressed;
-    try {
-        str_uncompressed = decompress_string(str_decoded);
-    }
-    catch (const std::runtime_error&) {
-        otErr << __FUNCTION__ << "decompress fail\n";
+
+    if (!DecodeString(Get(), GetLength(), str_uncompressed)) {
+        otErr << __FUNCTION__ << "Base64Decode or decompress fail\n";
         return false;
     }
 
@@ -351,26 +338,70 @@ bool OTASCIIArmor::SetString(const String& strData, bool bLineBreaks) //=true
 
     if (strData.GetLength() < 1) return true;
 
-    std::string stdstring = std::string(strData.Get());
-    std::string str_compressed = compress_string(stdstring);
+    std::string str_encoded;
 
-    // "Success"
-    if (str_compressed.size() == 0) {
-        otErr << "OTASCIIArmor::" << __FUNCTION__ << ": compression fail 0.\n";
+    if (!EncodeString(strData.Get(), strData.GetLength(), str_encoded,
+                      bLineBreaks)) {
+        otErr << "OTASCIIArmor::" << __FUNCTION__ << ": compression fail.\n";
         return false;
     }
 
-    char* pString = OTCrypto::It()->Base64Encode(
-        reinterpret_cast<const uint8_t*>((str_compressed.data())),
-        static_cast<int32_t>(str_compressed.size()), bLineBreaks);
+    Set(str_encoded.c_str());
+    return true;
+}
 
-    if (!pString) {
-        otErr << "OTASCIIArmor::" << __FUNCTION__ << ": Base64Encode fail.\n";
+// Base64-decode and decompress.
+//
+// The base64 is decoded straight into the buffer that gets decompressed,
+// without copying the input first. (Line breaks are accepted either way.)
+//
+// static
+bool OTASCIIArmor::DecodeString(const char* szArmored, size_t size,
+                                std::string& strOutput)
+{
+    std::string str_decoded(OTBase64::DecodedSizeMax(size), '\0');
+    size_t outSize = str_decoded.size();
+
+    if (!OTBase64::Decode(szArmored, size,
+                          reinterpret_cast<uint8_t*>(&str_decoded[0]),
+                          outSize)) {
         return false;
     }
 
-    Set(pString);
-    delete[] pString;
+    try {
+        strOutput = decompress_string(str_decoded.data(), outSize);
+    }
+    catch (const std::runtime_error&) {
+        return false;
+    }
+
+    return true;
+}
+
+// Compress and Base64-encode. The compressed data is encoded straight into
+// strOutput.
+//
+// static
+bool OTASCIIArmor::EncodeString(const char* szData, size_t size,
+                                std::string& strOutput, bool bLineBreaks)
+{
+    std::string str_compressed;
+
+    try {
+        str_compressed = compress_string(szData, size, Z_BEST_COMPRESSION);
+    }
+    catch (const std::runtime_error&) {
+        return false;
+    }
+
+    // "Success"
+    if (str_compressed.size() == 0) return false;
+
+    strOutput.resize(OTBase64::EncodedSize(str_compressed.size(), bLineBreaks));
+    strOutput.resize(OTBase64::Encode(
+        reinterpret_cast<const uint8_t*>(str_compressed.data()),
+        str_compressed.size(), &strOutput[0], bLineBreaks));
+
     return true;
 }
 
@@ -41,6 +41,7 @@
 #include <opentxs/core/crypto/OTAsymmetricKey_OpenSSLPrivdp.hpp>
 
 #include <opentxs/core/crypto/OTASCIIArmor.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/crypto/OTPassword.hpp>
 #include <opentxs/core/crypto/OTPasswordData.hpp>
@@ -52,6 +53,11 @@
 
 #include <opentxs/core/util/stacktrace.h>
 
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 // BIO_get_mem_data() macro from OpenSSL uses old style cast
 #ifndef _WIN32
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -66,6 +72,110 @@ namespace opentxs
 
 #if defined(OT_CRYPTO_USING_OPENSSL)
 
+namespace
+{
+
+// Takes another reference to pkey, which EVP_PKEY_free will release.
+EVP_PKEY* AddKeyReference(EVP_PKEY* pkey)
+{
+#if OPENSSL_VERSION_NUMBER - 0 >= 0x10100000L
+    EVP_PKEY_up_ref(pkey);
+#else
+    CRYPTO_add(&pkey->references, 1, CRYPTO_LOCK_EVP_PKEY);
+#endif
+    return pkey;
+}
+
+// Bounded LRU cache of parsed public keys, keyed by their armored text.
+//
+// Every Nym load builds new key objects from the same armored public keys,
+// so this lets them share one parsed EVP_PKEY instead of running
+// PEM_read_bio_PUBKEY again. The cache and each key object hold their own
+// reference, so eviction never frees a key that's still in use.
+class PublicKeyCache
+{
+public:
+    static PublicKeyCache& It()
+    {
+        static PublicKeyCache s_theCache;
+
+        return s_theCache;
+    }
+
+    ~PublicKeyCache()
+    {
+        Release();
+    }
+
+    // Returns a new reference, or nullptr if the key isn't cached.
+    EVP_PKEY* Get(const std::string& strArmoredKey)
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+
+        auto it = entries_.find(strArmoredKey);
+
+        if (entries_.end() == it) return nullptr;
+
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+
+        return AddKeyReference(it->second.pkey);
+    }
+
+    void Add(const std::string& strArmoredKey, EVP_PKEY* pkey)
+    {
+        const size_t nCapacity = OTCryptoConfig::PublicKeyCacheSize();
+
+        if (0 == nCapacity) return;
+
+        std::lock_guard<std::mutex> lock(lock_);
+
+        if (entries_.end() != entries_.find(strArmoredKey)) return;
+
+        lru_.push_front(strArmoredKey);
+
+        Entry& theEntry = entries_[strArmoredKey];
+        theEntry.pkey = AddKeyReference(pkey);
+        theEntry.lru = lru_.begin();
+
+        while (entries_.size() > nCapacity) {
+            auto it = entries_.find(lru_.back());
+            EVP_PKEY_free(it->second.pkey);
+            entries_.erase(it);
+            lru_.pop_back();
+        }
+    }
+
+    void Release()
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+
+        for (auto& it : entries_) EVP_PKEY_free(it.second.pkey);
+
+        entries_.clear();
+        lru_.clear();
+    }
+
+private:
+    struct Entry
+    {
+        EVP_PKEY* pkey;
+        std::list<std::string>::iterator lru;
+    };
+
+    std::mutex lock_;
+    std::list<std::string> lru_; // Most recently used at the front.
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+} // namespace
+
+// static
+void OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::
+    ReleasePublicKeyCache()
+{
+    PublicKeyCache::It().Release();
+}
+
 void OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::SetX509(X509* x509)
 {
     if (m_pX509 == x509) return;
@@ -499,7 +609,17 @@ EVP_PKEY* OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::
 
     const char* szFunc = "OTAsymmetricKey_OpenSSL::InstantiatePublicKey";
 
-    EVP_PKEY* pReturnKey = nullptr;
+    const std::string strArmoredKey(backlink->m_p_ascKey->Get());
+
+    EVP_PKEY* pReturnKey = PublicKeyCache::It().Get(strArmoredKey);
+
+    if (nullptr != pReturnKey) {
+        backlink->ReleaseKeyLowLevel(); // Release whatever loaded key I might
+                                        // have already had.
+        m_pKey = pReturnKey;
+        return m_pKey;
+    }
+
     OTData theData;
 
     // This base64 decodes the string m_p_ascKey into the
@@ -538,6 +658,7 @@ EVP_PKEY* OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::
 
         if (nullptr != pReturnKey) {
             m_pKey = pReturnKey;
+            PublicKeyCache::It().Add(strArmoredKey, m_pKey);
             otLog4
                 << szFunc
                 << ": Success reading public key from ASCII-armored data:\n\n"
@@ -0,0 +1,243 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/crypto/OTBase64.hpp>
+
+// Input bytes per line of line-broken output (64 characters.)
+#define BASE64_LINE_INPUT 48
+
+namespace opentxs
+{
+
+namespace
+{
+const char s_alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Decode table values that aren't 6-bit digits.
+const uint8_t DECODE_SKIP = 0x40;    // Whitespace.
+const uint8_t DECODE_PAD = 0x41;     // '='
+const uint8_t DECODE_INVALID = 0xFF; // Anything else.
+
+struct DecodeTable
+{
+    uint8_t value[256];
+
+    DecodeTable()
+    {
+        for (int i = 0; i < 256; ++i) value[i] = DECODE_INVALID;
+        for (uint8_t i = 0; i < 64; ++i) {
+            value[static_cast<uint8_t>(s_alphabet[i])] = i;
+        }
+        value[static_cast<uint8_t>(' ')] = DECODE_SKIP;
+        value[static_cast<uint8_t>('\t')] = DECODE_SKIP;
+        value[static_cast<uint8_t>('\r')] = DECODE_SKIP;
+        value[static_cast<uint8_t>('\n')] = DECODE_SKIP;
+        value[static_cast<uint8_t>('=')] = DECODE_PAD;
+    }
+};
+
+const uint8_t* GetDecodeTable()
+{
+    static const DecodeTable s_table;
+
+    return s_table.value;
+}
+
+inline char* EncodeGroup(const uint8_t* in, char* out)
+{
+    const uint32_t group = (static_cast<uint32_t>(in[0]) << 16) |
+                           (static_cast<uint32_t>(in[1]) << 8) | in[2];
+
+    out[0] = s_alphabet[(group >> 18) & 0x3F];
+    out[1] = s_alphabet[(group >> 12) & 0x3F];
+    out[2] = s_alphabet[(group >> 6) & 0x3F];
+    out[3] = s_alphabet[group & 0x3F];
+
+    return out + 4;
+}
+
+// Encodes the last one or two bytes, with padding.
+char* EncodeTail(const uint8_t* in, size_t size, char* out)
+{
+    uint8_t padded[3] = {in[0], 0, 0};
+    if (2 == size) padded[1] = in[1];
+
+    EncodeGroup(padded, out);
+    out[3] = '=';
+    if (1 == size) out[2] = '=';
+
+    return out + 4;
+}
+} // namespace
+
+// static
+size_t OTBase64::EncodedSize(size_t inputSize, bool bLineBreaks)
+{
+    const size_t characters = ((inputSize + 2) / 3) * 4;
+
+    if (!bLineBreaks) return characters;
+
+    const size_t lines =
+        (inputSize + BASE64_LINE_INPUT - 1) / BASE64_LINE_INPUT;
+
+    return characters + lines;
+}
+
+// static
+size_t OTBase64::Encode(const uint8_t* input, size_t inputSize, char* output,
+                        bool bLineBreaks)
+{
+    char* out = output;
+    const uint8_t* in = input;
+    const uint8_t* end = input + inputSize;
+
+    if (bLineBreaks) {
+        while (end - in >= BASE64_LINE_INPUT) {
+            for (int i = 0; i < BASE64_LINE_INPUT; i += 3) {
+                out = EncodeGroup(in + i, out);
+            }
+            *out++ = '\n';
+            in += BASE64_LINE_INPUT;
+        }
+    }
+
+    while (end - in >= 3) {
+        out = EncodeGroup(in, out);
+        in += 3;
+    }
+
+    if (end != in) out = EncodeTail(in, end - in, out);
+
+    // OpenSSL ends a short last line with a newline too.
+    if (bLineBreaks && (0 != inputSize % BASE64_LINE_INPUT)) *out++ = '\n';
+
+    return out - output;
+}
+
+// static
+size_t OTBase64::DecodedSizeMax(size_t inputSize)
+{
+    return ((inputSize + 3) / 4) * 3;
+}
+
+// static
+bool OTBase64::Decode(const char* input, size_t inputSize, uint8_t* output,
+                      size_t& outputSize)
+{
+    if (outputSize < DecodedSizeMax(inputSize)) return false;
+
+    const uint8_t* table = GetDecodeTable();
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(input);
+    const uint8_t* end = in + inputSize;
+    uint8_t* out = output;
+
+    uint32_t group = 0;
+    int32_t nDigits = 0; // Digits collected in group so far.
+    int32_t nPadding = 0;
+
+    while (in != end) {
+        // Fast path: four digits in a row, the common case between newlines.
+        if ((0 == nDigits) && (end - in >= 4)) {
+            const uint8_t a = table[in[0]], b = table[in[1]],
+                          c = table[in[2]], d = table[in[3]];
+
+            if (0 == ((a | b | c | d) & 0xC0)) {
+                if (0 != nPadding) return false; // Data after the padding.
+
+                group = (static_cast<uint32_t>(a) << 18) |
+                        (static_cast<uint32_t>(b) << 12) |
+                        (static_cast<uint32_t>(c) << 6) | d;
+                out[0] = static_cast<uint8_t>(group >> 16);
+                out[1] = static_cast<uint8_t>(group >> 8);
+                out[2] = static_cast<uint8_t>(group);
+                out += 3;
+                in += 4;
+                continue;
+            }
+        }
+
+        const uint8_t value = table[*in++];
+
+        if (value < 64) {
+            if (0 != nPadding) return false;
+
+            group = (group << 6) | value;
+            if (4 == ++nDigits) {
+                out[0] = static_cast<uint8_t>(group >> 16);
+                out[1] = static_cast<uint8_t>(group >> 8);
+                out[2] = static_cast<uint8_t>(group);
+                out += 3;
+                group = 0;
+                nDigits = 0;
+            }
+        }
+        else if (DECODE_SKIP == value) {
+            continue;
+        }
+        else if (DECODE_PAD == value) {
+            // Padding only ever completes a group of two or three digits.
+            if ((nDigits < 2) || (nDigits + ++nPadding > 4)) return false;
+        }
+        else {
+            return false;
+        }
+    }
+
+    switch (nDigits) {
+    case 0:
+        break;
+    case 2:
+        *out++ = static_cast<uint8_t>(group >> 4);
+        break;
+    case 3:
+        *out++ = static_cast<uint8_t>(group >> 10);
+        *out++ = static_cast<uint8_t>(group >> 2);
+        break;
+    default:
+        return false; // A lone digit can't encode a byte.
+    }
+
+    outputSize = out - output;
+
+    return true;
+}
+
+} // namespace opentxs
@@ -90,6 +90,8 @@ typedef OTCrypto_OpenSSL OTCryptoImpl;
 #define OT_DEFAULT_SYMMETRIC_BUFFER_SIZE 4096 // in bytes
 #define OT_DEFAULT_PUBLIC_KEYSIZE 128         // in bytes == 4096 bits
 #define OT_DEFAULT_PUBLIC_KEYSIZE_MAX 512     // in bytes == 1024 bits
+#define OT_DEFAULT_SIGNATURE_CACHE_SIZE 16384 // in entries, 0 disables
+#define OT_DEFAULT_PUBLIC_KEY_CACHE_SIZE 4096 // in entries, 0 disables
 
 #define OT_KEY_ITERATION_COUNT "iteration_count"
 #define OT_KEY_SYMMETRIC_SALT_SIZE "symmetric_salt_size"
@@ -99,6 +101,8 @@ typedef OTCrypto_OpenSSL OTCryptoImpl;
 #define OT_KEY_SYMMETRIC_BUFFER_SIZE "symmetric_buffer_size"
 #define OT_KEY_PUBLIC_KEYSIZE "public_keysize"
 #define OT_KEY_PUBLIC_KEYSIZE_MAX "public_keysize_max"
+#define OT_KEY_SIGNATURE_CACHE_SIZE "signature_cache_size"
+#define OT_KEY_PUBLIC_KEY_CACHE_SIZE "public_key_cache_size"
 
 const int32_t* OTCryptoConfig::sp_nIterationCount = nullptr;
 const int32_t* OTCryptoConfig::sp_nSymmetricSaltSize = nullptr;
@@ -108,6 +112,8 @@ const int32_t* OTCryptoConfig::sp_nSymmetricIvSize = nullptr;
 const int32_t* OTCryptoConfig::sp_nSymmetricBufferSize = nullptr;
 const int32_t* OTCryptoConfig::sp_nPublicKeysize = nullptr;
 const int32_t* OTCryptoConfig::sp_nPublicKeysizeMax = nullptr;
+const int32_t* OTCryptoConfig::sp_nSignatureCacheSize = nullptr;
+const int32_t* OTCryptoConfig::sp_nPublicKeyCacheSize = nullptr;
 
 bool OTCryptoConfig::GetSetAll()
 {
@@ -142,6 +148,12 @@ bool OTCryptoConfig::GetSetAll()
     if (!GetSetValue(config, OT_KEY_PUBLIC_KEYSIZE_MAX,
                      OT_DEFAULT_PUBLIC_KEYSIZE_MAX, sp_nPublicKeysizeMax))
         return false;
+    if (!GetSetValue(config, OT_KEY_SIGNATURE_CACHE_SIZE,
+                     OT_DEFAULT_SIGNATURE_CACHE_SIZE, sp_nSignatureCacheSize))
+        return false;
+    if (!GetSetValue(config, OT_KEY_PUBLIC_KEY_CACHE_SIZE,
+                     OT_DEFAULT_PUBLIC_KEY_CACHE_SIZE, sp_nPublicKeyCacheSize))
+        return false;
 
     if (!config.Save()) return false;
 
@@ -219,6 +231,14 @@ uint32_t OTCryptoConfig::PublicKeysizeMax()
 {
     return GetValue(sp_nPublicKeysizeMax);
 }
+uint32_t OTCryptoConfig::SignatureCacheSize()
+{
+    return GetValue(sp_nSignatureCacheSize);
+}
+uint32_t OTCryptoConfig::PublicKeyCacheSize()
+{
+    return GetValue(sp_nPublicKeyCacheSize);
+}
 
 // static
 int32_t OTCrypto::s_nCount =
@@ -49,11 +49,13 @@
 #include <bitcoin-base58/hash.h> // for Hash()
 #include <opentxs/core/crypto/BitcoinCrypto.hpp>
 #include <opentxs/core/crypto/OTCryptoOpenSSL.hpp>
+#include <opentxs/core/crypto/OTBase64.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/crypto/OTPassword.hpp>
 #include <opentxs/core/crypto/OTPasswordData.hpp>
 #include <opentxs/core/Nym.hpp>
 #include <opentxs/core/crypto/OTSignature.hpp>
+#include <opentxs/core/crypto/OTSignatureCache.hpp>
 #include <opentxs/core/OTStorage.hpp>
 #include <opentxs/core/util/stacktrace.h>
 
@@ -136,6 +138,11 @@ public:
                          const OTPasswordData* pPWData = nullptr) const;
 
     static const EVP_MD* GetOpenSSLDigestByName(const String& theName);
+
+    // Key for OTSignatureCache.
+    static std::string GetSignatureCacheDigest(
+        const String& strContractToVerify, const OTASCIIArmor& ascPublicKey,
+        const OTSignature& theSignature, const String& strHashType);
 };
 
 #else // Apparently NO crypto engine is defined!
@@ -394,86 +401,45 @@ void ot_openssl_locking_callback(int32_t mode, int32_t type, const char*,
 } // extern "C"
 
 // Caller responsible to delete.
+//
+// The codec is OTBase64 rather than a BIO chain: same output, without
+// allocating and tearing down two BIOs (and copying out of them) per call.
 char* OTCrypto_OpenSSL::Base64Encode(const uint8_t* input, int32_t in_len,
                                      bool bLineBreaks) const
 {
-    char* buf = nullptr;
-    BUF_MEM* bptr = nullptr;
-
     OT_ASSERT_MSG(in_len >= 0,
                   "OT_base64_encode: Abort: in_len is a negative number!");
 
-    OpenSSL_BIO b64 = BIO_new(BIO_f_base64());
-
-    if (!b64) return buf;
-
-    if (!bLineBreaks) BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
-
-    OpenSSL_BIO bmem = BIO_new(BIO_s_mem());
+    const size_t size = static_cast<size_t>(in_len);
+    char* buf = new char[OTBase64::EncodedSize(size, bLineBreaks) + 1];
+    OT_ASSERT(nullptr != buf);
 
-    if (bmem) {
-        OpenSSL_BIO b64join = BIO_push(b64, bmem);
-        b64.release();
-        bmem.release();
-
-        if (BIO_write(b64join, input, in_len) == in_len) {
-            (void)BIO_flush(b64join);
-#ifndef _WIN32
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wold-style-cast"
-#endif
-            BIO_get_mem_ptr(b64join, &bptr);
-#ifndef _WIN32
-#pragma GCC diagnostic pop
-#endif
-            //    otLog5 << "DEBUG base64_encode size: %" PRId64 ",  in_len:
-            // %" PRId64 "\n", bptr->length+1, in_len);
-            buf = new char[bptr->length + 1];
-            OT_ASSERT(nullptr != buf);
-            memcpy(buf, bptr->data, bptr->length); // Safe.
-            buf[bptr->length] = '\0';              // Forcing null terminator.
-        }
-    }
-    else {
-        OT_FAIL_MSG("Failed creating new Bio in base64_encode.\n");
-    }
+    const size_t length = OTBase64::Encode(input, size, buf, bLineBreaks);
+    buf[length] = '\0'; // Forcing null terminator.
 
     return buf;
 }
 
-// Caller responsible to delete.
+// Caller responsible to delete. Returns nullptr if the input isn't base64.
+//
+// Line breaks are accepted either way, so bLineBreaks doesn't matter here.
 uint8_t* OTCrypto_OpenSSL::Base64Decode(const char* input, size_t* out_len,
-                                        bool bLineBreaks) const
+                                        bool) const
 {
-
     OT_ASSERT(nullptr != input);
+    OT_ASSERT(nullptr != out_len);
 
-    int32_t in_len =
-        static_cast<int32_t>(strlen(input)); // todo security (strlen)
-    int32_t out_max_len = (in_len * 6 + 7) / 8;
+    const size_t in_len = strlen(input); // todo security (strlen)
+    size_t out_max_len = OTBase64::DecodedSizeMax(in_len);
     uint8_t* buf = new uint8_t[out_max_len];
     OT_ASSERT(nullptr != buf);
-    memset(buf, 0, out_max_len); // todo security
-
-    OpenSSL_BIO b64 = BIO_new(BIO_f_base64());
-
-    if (b64) {
-        if (!bLineBreaks) BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
-
-        OpenSSL_BIO bmem = BIO_new_mem_buf(const_cast<char*>(input), in_len);
-        OT_ASSERT(nullptr != bmem);
-
-        OpenSSL_BIO b64join = BIO_push(b64, bmem);
-        b64.release();
-        bmem.release();
-        OT_ASSERT(nullptr != b64join);
-
-        *out_len = BIO_read(b64join, buf, out_max_len);
 
+    if (!OTBase64::Decode(input, in_len, buf, out_max_len)) {
+        delete[] buf;
+        return nullptr;
     }
-    else {
-        OT_FAIL_MSG("Failed creating new Bio in base64_decode.\n");
-    }
+
+    *out_len = out_max_len;
 
     return buf;
 }
@@ -673,6 +639,35 @@ const EVP_MD* OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::GetOpenSSLDigestByName(
     return nullptr;
 }
 
+// SHA256 over the hash type, public key, signature and contents, each one
+// prefixed with its length so that no two different inputs run together.
+//
+// static
+std::string OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::GetSignatureCacheDigest(
+    const String& strContractToVerify, const OTASCIIArmor& ascPublicKey,
+    const OTSignature& theSignature, const String& strHashType)
+{
+    const String* fields[] = {&strHashType, &ascPublicKey, &theSignature,
+                              &strContractToVerify};
+
+    SHA256_CTX context;
+    uint8_t md[SHA256_DIGEST_LENGTH];
+
+    SHA256_Init(&context);
+
+    for (const String* pField : fields) {
+        const uint32_t nLength = htonl(pField->GetLength());
+
+        SHA256_Update(&context, &nLength, sizeof(nLength));
+        if (pField->GetLength() > 0)
+            SHA256_Update(&context, pField->Get(), pField->GetLength());
+    }
+
+    SHA256_Final(md, &context);
+
+    return std::string(reinterpret_cast<const char*>(md), sizeof(md));
+}
+
 /*
  SHA256_CTX context;
  uint8_t md[SHA256_DIGEST_LENGTH];
@@ -1141,6 +1136,9 @@ void OTCrypto_OpenSSL::Cleanup_Override() const
 
     otLog4 << szFunc << ": Cleaning up OpenSSL...\n";
 
+    OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::
+        ReleasePublicKeyCache();
+
 // In the future if we start using ENGINEs, then do the cleanup here:
 //#ifndef OPENSSL_NO_ENGINE
 //  void ENGINE_cleanup(void);
@@ -3412,6 +3410,22 @@ bool OTCrypto_OpenSSL::VerifySignature(const String& strContractToVerify,
         dynamic_cast<OTAsymmetricKey_OpenSSL*>(&theTempKey);
     OT_ASSERT(nullptr != pTempOpenSSLKey);
 
+    // The server loads and verifies the same nymfiles, boxes and receipts
+    // over and over, so remember which signatures already verified.
+    OTSignatureCache& theCache = OTSignatureCache::It();
+    std::string strCacheDigest;
+
+    if ((theCache.GetCapacity() > 0) && theKey.IsPublic()) {
+        OTASCIIArmor ascPublicKey;
+
+        if (theKey.GetPublicKey(ascPublicKey)) {
+            strCacheDigest = OTCrypto_OpenSSLdp::GetSignatureCacheDigest(
+                strContractToVerify, ascPublicKey, theSignature, strHashType);
+
+            if (theCache.Check(strCacheDigest)) return true;
+        }
+    }
+
     const EVP_PKEY* pkey = pTempOpenSSLKey->dp->GetKey(pPWData);
     OT_ASSERT(nullptr != pkey);
 
@@ -3423,6 +3437,8 @@ bool OTCrypto_OpenSSL::VerifySignature(const String& strContractToVerify,
         return false;
     }
 
+    if (!strCacheDigest.empty()) theCache.Add(strCacheDigest);
+
     return true;
 }
 
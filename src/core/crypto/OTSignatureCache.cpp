@@ -0,0 +1,132 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/crypto/OTSignatureCache.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
+
+namespace opentxs
+{
+
+// static
+OTSignatureCache& OTSignatureCache::It()
+{
+    static OTSignatureCache s_theCache(OTCryptoConfig::SignatureCacheSize());
+
+    return s_theCache;
+}
+
+OTSignatureCache::OTSignatureCache(size_t capacity)
+    : capacity_(capacity)
+    , hits_(0)
+    , misses_(0)
+{
+}
+
+bool OTSignatureCache::Check(const std::string& digest)
+{
+    if (0 == capacity_) return false;
+
+    std::lock_guard<std::mutex> lock(lock_);
+
+    auto it = entries_.find(digest);
+
+    if (entries_.end() == it) {
+        ++misses_;
+        return false;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second);
+    ++hits_;
+
+    return true;
+}
+
+void OTSignatureCache::Add(const std::string& digest)
+{
+    if (0 == capacity_) return;
+
+    std::lock_guard<std::mutex> lock(lock_);
+
+    auto it = entries_.find(digest);
+
+    if (entries_.end() != it) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+
+    lru_.push_front(digest);
+    entries_[digest] = lru_.begin();
+
+    while (entries_.size() > capacity_) {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+void OTSignatureCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(lock_);
+
+    entries_.clear();
+    lru_.clear();
+}
+
+size_t OTSignatureCache::GetSize() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+
+    return entries_.size();
+}
+
+int64_t OTSignatureCache::GetHits() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+
+    return hits_;
+}
+
+int64_t OTSignatureCache::GetMisses() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+
+    return misses_;
+}
+
+} // namespace opentxs
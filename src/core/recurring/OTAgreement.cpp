@@ -945,6 +945,18 @@ bool OTAgreement::ProcessCron()
     return true;
 }
 
+// An agreement (or payment plan) only moves funds between the sender's and
+// the recipient's accounts, and drops receipts for their Nyms.
+bool OTAgreement::GetCronKeys(std::set<std::string>& keys) const
+{
+    keys.insert(String(GetSenderAcctID()).Get());
+    keys.insert(String(GetSenderNymID()).Get());
+    keys.insert(String(GetRecipientAcctID()).Get());
+    keys.insert(String(GetRecipientNymID()).Get());
+
+    return true;
+}
+
 /// See if theNym has rights to remove this item from Cron.
 ///
 bool OTAgreement::CanRemoveItemFromCron(Nym& theNym)
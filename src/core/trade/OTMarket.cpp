@@ -40,23 +40,71 @@
 
 #include <opentxs/core/trade/OTMarket.hpp>
 #include <opentxs/core/trade/OTOffer.hpp>
+#include <opentxs/core/trade/OTOrderBook.hpp>
 #include <opentxs/core/trade/OTTrade.hpp>
 #include <opentxs/core/Account.hpp>
 #include <opentxs/core/Ledger.hpp>
-#include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/XMLWriter.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTData.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
+#include <opentxs/core/crypto/OTPasswordData.hpp>
+#include <opentxs/core/crypto/OTSignature.hpp>
 #include <opentxs/core/util/OTFolders.hpp>
+#include <opentxs/core/util/OTPaths.hpp>
 
 #include <irrxml/irrXML.hpp>
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <sstream>
 
 // return -1 if error, 0 if nothing, and 1 if the node was processed.
 
 namespace opentxs
 {
 
+namespace
+{
+
+// The journal is saved into the market file once it has at least this many
+// entries, or more entries than there are offers, whichever is larger.
+const size_t MIN_JOURNAL_ENTRIES = 256;
+
+// How many recent changes a market keeps, to answer delta queries.
+const size_t MAX_MARKET_CHANGES = 1024;
+
+// How many depths a market keeps an encoded offer list for.
+const size_t MAX_CACHED_DEPTHS = 8;
+
+bool packList(OTDB::Storable& theList, OTASCIIArmor& ascOutput)
+{
+    OTDB::Storage* pStorage = OTDB::GetDefaultStorage();
+    OT_ASSERT(nullptr != pStorage);
+
+    std::unique_ptr<OTDB::PackedBuffer> pBuffer(
+        pStorage->GetPacker()->Pack(theList));
+
+    if ((nullptr == pBuffer) || (nullptr == pBuffer->GetData())) return false;
+
+    OTData theData(pBuffer->GetData(),
+                   static_cast<uint32_t>(pBuffer->GetSize()));
+    ascOutput.SetData(theData);
+
+    return true;
+}
+
+bool decodeOffer(const std::string& strArmored, String& strOffer)
+{
+    OTASCIIArmor ascOffer(strArmored.c_str());
+
+    return ascOffer.GetString(strOffer, false);
+}
+
+} // namespace
+
 int32_t OTMarket::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
 {
     int32_t nReturnVal = 0;
@@ -78,6 +126,9 @@ int32_t OTMarket::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
         m_lLastSalePrice =
             String::StringToLong(xml->getAttributeValue("lastSalePrice"));
         m_strLastSaleDate = xml->getAttributeValue("lastSaleDate");
+        // Markets saved before the journal have no sequence, and start at 0.
+        m_lJournalSequence = String::StringToLong(
+            xml->getAttributeValueSafe("journalSequence"));
 
         const String strNotaryID(xml->getAttributeValue("notaryID")),
             strInstrumentDefinitionID(
@@ -112,27 +163,8 @@ int32_t OTMarket::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
                   << ": offer field without value.\n";
             return (-1); // error condition
         }
-        else {
-            OTOffer* pOffer =
-                new OTOffer(m_NOTARY_ID, m_INSTRUMENT_DEFINITION_ID,
-                            m_CURRENCY_TYPE_ID, m_lScale);
-
-            OT_ASSERT(nullptr != pOffer);
-
-            if (pOffer->LoadContractFromString(strData) &&
-                AddOffer(nullptr, *pOffer, false, tDateAdded)) // bSaveMarket =
-            // false (Don't SAVE
-            // -- we're loading
-            // right now!)
-            {
-                otWarn << "Successfully loaded offer and added to market.\n";
-            }
-            else {
-                otErr << "Error adding offer to market while loading market.\n";
-                delete pOffer;
-                pOffer = nullptr;
-                return (-1);
-            }
+        else if (!loadOffer(strData, tDateAdded)) {
+            return (-1);
         }
 
         nReturnVal = 1;
@@ -143,6 +175,10 @@ int32_t OTMarket::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
 
 void OTMarket::UpdateContents()
 {
+    // Reuse the previous size as a guess for the new one.
+    std::string str_result;
+    str_result.reserve(m_xmlUnsigned.GetLength());
+
     // I release this because I'm about to repopulate it.
     m_xmlUnsigned.Release();
 
@@ -150,7 +186,8 @@ void OTMarket::UpdateContents()
         INSTRUMENT_DEFINITION_ID(m_INSTRUMENT_DEFINITION_ID),
         CURRENCY_TYPE_ID(m_CURRENCY_TYPE_ID);
 
-    Tag tag("market");
+    XMLWriter tag(str_result);
+    tag.open("market");
 
     tag.add_attribute("version", m_strVersion.Get());
     tag.add_attribute("notaryID", NOTARY_ID.Get());
@@ -159,55 +196,62 @@ void OTMarket::UpdateContents()
     tag.add_attribute("marketScale", formatLong(m_lScale));
     tag.add_attribute("lastSaleDate", m_strLastSaleDate);
     tag.add_attribute("lastSalePrice", formatLong(m_lLastSalePrice));
+    tag.add_attribute("journalSequence", formatLong(m_lJournalSequence));
 
     // Save the offers for sale.
-    for (auto& it : m_mapAsks) {
-        OTOffer* pOffer = it.second;
+    for (OTOffer* pOffer : m_bookAsks) {
         OT_ASSERT(nullptr != pOffer);
 
         String strOffer(
             *pOffer); // Extract the offer contract into string form.
         OTASCIIArmor ascOffer(strOffer); // Base64-encode that for storage.
 
-        TagPtr tagOffer(new Tag("offer", ascOffer.Get()));
-        tagOffer->add_attribute(
-            "dateAdded", formatTimestamp(pOffer->GetDateAddedToMarket()));
-        tag.add_tag(tagOffer);
+        tag.open("offer");
+        tag.add_attribute("dateAdded",
+                          formatTimestamp(pOffer->GetDateAddedToMarket()));
+        tag.set_text(ascOffer.Get());
+        tag.close();
     }
 
     // Save the bids.
-    for (auto& it : m_mapBids) {
-        OTOffer* pOffer = it.second;
+    for (OTOffer* pOffer : m_bookBids) {
         OT_ASSERT(nullptr != pOffer);
 
         String strOffer(
             *pOffer); // Extract the offer contract into string form.
         OTASCIIArmor ascOffer(strOffer); // Base64-encode that for storage.
 
-        TagPtr tagOffer(new Tag("offer", ascOffer.Get()));
-        tagOffer->add_attribute(
-            "dateAdded", formatTimestamp(pOffer->GetDateAddedToMarket()));
-        tag.add_tag(tagOffer);
+        tag.open("offer");
+        tag.add_attribute("dateAdded",
+                          formatTimestamp(pOffer->GetDateAddedToMarket()));
+        tag.set_text(ascOffer.Get());
+        tag.close();
     }
 
-    std::string str_result;
-    tag.output(str_result);
+    tag.close();
 
-    m_xmlUnsigned.Concatenate("%s", str_result.c_str());
+    m_xmlUnsigned.Set(str_result.c_str());
 }
 
 int64_t OTMarket::GetTotalAvailableAssets()
 {
-    int64_t lTotal = 0;
+    return m_bookAsks.GetTotalQuantity();
+}
 
-    for (auto& it : m_mapAsks) {
+void OTMarket::GetTraderKeys(std::set<std::string>& keys) const
+{
+    for (auto& it : m_mapOffers) {
         OTOffer* pOffer = it.second;
         OT_ASSERT(nullptr != pOffer);
 
-        lTotal += pOffer->GetAmountAvailable();
-    }
+        OTTrade* pTrade = pOffer->GetTrade();
 
-    return lTotal;
+        if (nullptr == pTrade) continue;
+
+        keys.insert(String(pTrade->GetSenderAcctID()).Get());
+        keys.insert(String(pTrade->GetCurrencyAcctID()).Get());
+        keys.insert(String(pTrade->GetSenderNymID()).Get());
+    }
 }
 
 // Get list of offers for a particular Nym, to send that Nym
@@ -311,7 +355,8 @@ bool OTMarket::GetNym_OfferList(const Identifier& NYM_ID,
     return true;
 }
 
-bool OTMarket::GetRecentTradeList(OTASCIIArmor& ascOutput, int32_t& nTradeCount)
+bool OTMarket::encodeRecentTradeList(OTASCIIArmor& ascOutput,
+                                     int32_t& nTradeCount)
 {
     nTradeCount = 0; // Output the count of trades in the list being returned.
                      // (If success..)
@@ -381,8 +426,8 @@ bool OTMarket::GetRecentTradeList(OTASCIIArmor& ascOutput, int32_t& nTradeCount)
 
 // OTDB::OfferListMarket
 //
-bool OTMarket::GetOfferList(OTASCIIArmor& ascOutput, int64_t lDepth,
-                            int32_t& nOfferCount)
+bool OTMarket::encodeOfferList(OTASCIIArmor& ascOutput, int64_t lDepth,
+                               int32_t& nOfferCount)
 {
     nOfferCount = 0; // Outputs the actual count of offers being returned.
 
@@ -395,17 +440,13 @@ bool OTMarket::GetOfferList(OTASCIIArmor& ascOutput, int64_t lDepth,
         dynamic_cast<OTDB::OfferListMarket*>(
             OTDB::CreateObject(OTDB::STORED_OBJ_OFFER_LIST_MARKET)));
 
-    //    mapOfOffers            m_mapBids;        // The buyers, ordered by
-    // price limit
-    //    mapOfOffers            m_mapAsks;        // The sellers, ordered by
-    // price limit
+    // Both books are ordered best price first.
 
     int32_t nTempDepth = 0;
 
-    for (auto& it : m_mapBids) {
+    for (OTOffer* pOffer : m_bookBids) {
         if (nTempDepth++ > lDepth) break;
 
-        OTOffer* pOffer = it.second;
         OT_ASSERT(nullptr != pOffer);
 
         const int64_t& lPriceLimit = pOffer->GetPriceLimit();
@@ -438,10 +479,9 @@ bool OTMarket::GetOfferList(OTASCIIArmor& ascOutput, int64_t lDepth,
 
     nTempDepth = 0;
 
-    for (auto& it : m_mapAsks) {
+    for (OTOffer* pOffer : m_bookAsks) {
         if (nTempDepth++ > lDepth) break;
 
-        OTOffer* pOffer = it.second;
         OT_ASSERT(nullptr != pOffer);
 
         // OfferDataMarket
@@ -514,17 +554,174 @@ bool OTMarket::GetOfferList(OTASCIIArmor& ascOutput, int64_t lDepth,
     return false;
 }
 
-// To insure that offers of a specific price are always inserted at the upper
-// bound,
-// use this:  my_mmap.insert(my_mmap.upper_bound(key), my_mmap::value_type(key,
-// val));
-// This way I can read them from the lower bound later, and always get them in
-// the
-// order received for that price.
-//
-// typedef std::multimap<int64_t, OTOffer *>    mapOfOffers;
-// mapOfOffers    m_mapBids; // The buyers, ordered
-// mapOfOffers    m_mapAsks; // The sellers, ordered
+// Polling clients mostly ask again before anything has changed, so the
+// encoded lists are kept until the market's version moves on.
+bool OTMarket::GetRecentTradeList(OTASCIIArmor& ascOutput,
+                                  int32_t& nTradeCount)
+{
+    std::lock_guard<std::mutex> lock(m_cacheLock);
+
+    checkCache();
+
+    if (!m_bRecentTradesCached) {
+        OTASCIIArmor ascTrades;
+        int32_t nCount = 0;
+
+        if (!encodeRecentTradeList(ascTrades, nCount)) return false;
+
+        m_ascRecentTrades = ascTrades;
+        m_nRecentTradeCount = nCount;
+        m_bRecentTradesCached = true;
+    }
+
+    ascOutput = m_ascRecentTrades;
+    nTradeCount = m_nRecentTradeCount;
+
+    return true;
+}
+
+bool OTMarket::GetOfferList(OTASCIIArmor& ascOutput, int64_t lDepth,
+                            int32_t& nOfferCount)
+{
+    std::lock_guard<std::mutex> lock(m_cacheLock);
+
+    checkCache();
+
+    auto it = m_mapOfferLists.find(lDepth);
+
+    if (it == m_mapOfferLists.end()) {
+        OfferListCache theList;
+        theList.nOfferCount = 0;
+
+        if (!encodeOfferList(theList.ascOffers, lDepth, theList.nOfferCount))
+            return false;
+
+        // Clients pick their own depths, so don't let these pile up.
+        if (m_mapOfferLists.size() >= MAX_CACHED_DEPTHS)
+            m_mapOfferLists.clear();
+
+        it = m_mapOfferLists.insert(std::make_pair(lDepth, theList)).first;
+    }
+
+    ascOutput = it->second.ascOffers;
+    nOfferCount = it->second.nOfferCount;
+
+    return true;
+}
+
+bool OTMarket::HasChangesSince(int64_t lVersion, int64_t lDepth) const
+{
+    return (0 == lDepth) && (lVersion >= m_lChangesSince) &&
+           (lVersion >= m_lWholeListSince) && (lVersion <= GetVersion());
+}
+
+// True if the full-depth offer list has every offer in the market.
+// (encodeOfferList counts market orders against the depth too.)
+bool OTMarket::isWholeList() const
+{
+    return (m_bookBids.size() <= MAX_MARKET_QUERY_DEPTH) &&
+           (m_bookAsks.size() <= MAX_MARKET_QUERY_DEPTH);
+}
+
+bool OTMarket::GetOfferChanges(OTASCIIArmor& ascOutput, int64_t lVersion,
+                               int32_t& nOfferCount)
+{
+    nOfferCount = 0;
+
+    if (!HasChangesSince(lVersion, 0)) {
+        otErr << "OTMarket::" << __FUNCTION__ << ": The changes since version "
+              << lVersion << " are no longer available.\n";
+        return false;
+    }
+
+    // The latest change for each offer, in transaction number order.
+    std::map<int64_t, const OfferChange*> mapChanged;
+
+    for (auto it = m_dequeChanges.rbegin();
+         (it != m_dequeChanges.rend()) && (it->lVersion > lVersion); ++it)
+        mapChanged.insert(std::make_pair(it->lTransactionNum, &(*it)));
+
+    if (mapChanged.empty()) return true; // Nothing changed.
+
+    std::unique_ptr<OTDB::OfferListMarket> pOfferList(
+        dynamic_cast<OTDB::OfferListMarket*>(
+            OTDB::CreateObject(OTDB::STORED_OBJ_OFFER_LIST_MARKET)));
+
+    for (auto& it : mapChanged) {
+        const OfferChange& theChange = *(it.second);
+        OTOffer* pOffer = GetOffer(theChange.lTransactionNum);
+
+        // Skipping any market orders, same as GetOfferList.
+        if (theChange.bBid && (0 == theChange.lPriceLimit)) continue;
+
+        std::unique_ptr<OTDB::OfferDataMarket> pOfferData(
+            dynamic_cast<OTDB::OfferDataMarket*>(OTDB::CreateObject(
+                theChange.bBid ? OTDB::STORED_OBJ_BID_DATA
+                               : OTDB::STORED_OBJ_ASK_DATA)));
+
+        pOfferData->transaction_id =
+            to_string<int64_t>(theChange.lTransactionNum);
+        pOfferData->price_per_scale =
+            to_string<int64_t>(theChange.lPriceLimit);
+
+        // A removed offer keeps the default of no assets available.
+        if (nullptr != pOffer) {
+            pOfferData->available_assets =
+                to_string<int64_t>(pOffer->GetAmountAvailable());
+            pOfferData->minimum_increment =
+                to_string<int64_t>(pOffer->GetMinimumIncrement());
+            pOfferData->date =
+                to_string<time64_t>(pOffer->GetDateAddedToMarket());
+        }
+
+        if (theChange.bBid)
+            pOfferList->AddBidData(
+                *dynamic_cast<OTDB::BidData*>(pOfferData.get()));
+        else
+            pOfferList->AddAskData(
+                *dynamic_cast<OTDB::AskData*>(pOfferData.get()));
+
+        nOfferCount++;
+    }
+
+    if ((nOfferCount > 0) && !packList(*pOfferList, ascOutput)) {
+        otErr << "OTMarket::" << __FUNCTION__
+              << ": Failed packing the offer list.\n";
+        return false;
+    }
+
+    return true;
+}
+
+// Called after a change has been journaled, so it has the market's new
+// version.
+void OTMarket::noteChange(const int64_t& lTransactionNum, bool bBid,
+                          const int64_t& lPriceLimit)
+{
+    OfferChange theChange;
+    theChange.lVersion = GetVersion();
+    theChange.lTransactionNum = lTransactionNum;
+    theChange.bBid = bBid;
+    theChange.lPriceLimit = lPriceLimit;
+
+    m_dequeChanges.push_back(theChange);
+
+    if (!isWholeList()) m_lWholeListSince = GetVersion() + 1;
+
+    while (m_dequeChanges.size() > MAX_MARKET_CHANGES) {
+        m_lChangesSince = m_dequeChanges.front().lVersion;
+        m_dequeChanges.pop_front();
+    }
+}
+
+void OTMarket::checkCache()
+{
+    if (m_lCacheVersion == GetVersion()) return;
+
+    m_mapOfferLists.clear();
+    m_bRecentTradesCached = false;
+    m_lCacheVersion = GetVersion();
+}
 
 OTOffer* OTMarket::GetOffer(const int64_t& lTransactionNum)
 {
@@ -554,6 +751,22 @@ OTOffer* OTMarket::GetOffer(const int64_t& lTransactionNum)
 
 bool OTMarket::RemoveOffer(const int64_t& lTransactionNum) // if false, offer
                                                            // wasn't found.
+{
+    OTOffer* pOffer = GetOffer(lTransactionNum);
+
+    const bool bBid = (nullptr != pOffer) && pOffer->IsBid();
+    const int64_t lPriceLimit =
+        (nullptr != pOffer) ? pOffer->GetPriceLimit() : 0;
+
+    if (!removeOffer(lTransactionNum)) return false;
+
+    const bool bSaved = appendJournal("remove " + formatLong(lTransactionNum));
+    noteChange(lTransactionNum, bBid, lPriceLimit);
+
+    return bSaved;
+}
+
+bool OTMarket::removeOffer(const int64_t& lTransactionNum)
 {
     bool bReturnValue = false;
 
@@ -578,34 +791,11 @@ bool OTMarket::RemoveOffer(const int64_t& lTransactionNum) // if false, offer
         m_mapOffers.erase(it);
 
         // The code operates the same whether ask or bid. Just use a pointer.
-        mapOfOffers* pMap = (pOffer->IsBid() ? &m_mapBids : &m_mapAsks);
-
-        // Future solution here: instead of looping through all the offers and
-        // finding it,
-        // I could just have each Offer store a copy of the iterator that's
-        // returned when
-        // it's first inserted. Later I just erase that iterator from the right
-        // list to remove. Todo.
-        OTOffer* pSameOffer = nullptr;
-
-        for (mapOfOffers::iterator iii = pMap->begin(); iii != pMap->end();
-             ++iii) {
-            pSameOffer = iii->second;
-
-            OT_ASSERT_MSG(nullptr != pSameOffer,
-                          "nullptr offer pointer in OTMarket::RemoveOffer.\n");
-
-            // found it!
-            if (lTransactionNum == pSameOffer->GetTransactionNum()) {
-                pMap->erase(iii);
-                break;
-            }
+        OTOrderBook* pBook = (pOffer->IsBid() ? &m_bookBids : &m_bookAsks);
 
-            // Later on, below this loop, this pointer will be nullptr or not,
-            // and
-            // I will know if it was removed.
-            pSameOffer = nullptr;
-        }
+        // The book indexes its offers by transaction number, so there's no
+        // need to search it.
+        OTOffer* pSameOffer = pBook->Remove(lTransactionNum);
 
         if (nullptr == pSameOffer) {
             otErr << "Removed Offer from offers list, but not found on bid/ask "
@@ -630,10 +820,7 @@ bool OTMarket::RemoveOffer(const int64_t& lTransactionNum) // if false, offer
         pSameOffer = nullptr;
     }
 
-    if (bReturnValue)
-        return SaveMarket(); // <====== SAVE since an offer was removed.
-    else
-        return false;
+    return bReturnValue;
 }
 
 // This method demands an Offer reference in order to verify that it really
@@ -646,8 +833,7 @@ bool OTMarket::RemoveOffer(const int64_t& lTransactionNum) // if false, offer
 bool OTMarket::AddOffer(OTTrade* pTrade, OTOffer& theOffer, bool bSaveFile,
                         time64_t tDateAddedToMarket)
 {
-    const int64_t lTransactionNum = theOffer.GetTransactionNum(),
-                  lPriceLimit = theOffer.GetPriceLimit();
+    const int64_t lTransactionNum = theOffer.GetTransactionNum();
 
     // Make sure the offer is even appropriate for this market...
     if (!ValidateOfferForMarket(theOffer)) {
@@ -682,26 +868,18 @@ bool OTMarket::AddOffer(OTTrade* pTrade, OTOffer& theOffer, bool bSaveFile,
         // know it validated as an offer, AND we know it wasn't already on the
         // market.
         //
-        // So next, let's add it to the lists that are indexed by price:
-
-        // Determine if it's a buy or sell, and add it to the right list.
+        // So next, let's add it to the book for its side of the market,
+        // where it goes last in line at its price. (Highest bidders and
+        // lowest sellers go first.)
+        //
+        // No bother checking if the offer is already on the book,
+        // since the code above basically already verifies that for us.
         if (theOffer.IsBid()) {
-            // No bother checking if the offer is already on this list,
-            // since the code above basically already verifies that for us.
-
-            m_mapBids.insert(
-                m_mapBids.lower_bound(lPriceLimit), // highest bidders go first,
-                                                    // so I am last in line at
-                                                    // lower bound.
-                std::pair<int64_t, OTOffer*>(lPriceLimit, &theOffer));
+            m_bookBids.Add(theOffer);
             otLog4 << "Offer added as a bid to the market.\n";
         }
         else {
-            m_mapAsks.insert(
-                m_mapAsks.upper_bound(lPriceLimit), // lowest price sells first,
-                                                    // so I am last in line at
-                                                    // upper bound.
-                std::pair<int64_t, OTOffer*>(lPriceLimit, &theOffer));
+            m_bookAsks.Add(theOffer);
             otLog4 << "Offer added as an ask to the market.\n";
         }
 
@@ -711,8 +889,19 @@ bool OTMarket::AddOffer(OTTrade* pTrade, OTOffer& theOffer, bool bSaveFile,
             //
             theOffer.SetDateAddedToMarket(OTTimeGetCurrentTime());
 
-            return SaveMarket(); // <====== SAVE since an offer was added to the
-                                 // Market.
+            // <====== SAVE since an offer was added to the Market.
+            OTASCIIArmor ascOffer;
+            ascOffer.SetString(String(theOffer), false); // One line.
+
+            const bool bSaved = appendJournal(
+                "add " +
+                formatLong(OTTimeGetSecondsFromTime(
+                    theOffer.GetDateAddedToMarket())) +
+                " " + ascOffer.Get());
+            noteChange(lTransactionNum, theOffer.IsBid(),
+                       theOffer.GetPriceLimit());
+
+            return bSaved;
         }
         else {
             // Set this to the date passed in, since this offer was
@@ -757,6 +946,28 @@ bool OTMarket::LoadMarket()
             szFilename)); // markets/recent/market_ID
     }
 
+    // Then apply whatever changed since the market file was saved.
+    //
+    if (bSuccess) {
+        std::vector<std::string> theEntries;
+
+        bSuccess = openJournal(theEntries);
+
+        // Whatever follows a forged entry is dropped, by saving the market
+        // as it was up to there.
+        if (bSuccess && !replayJournal(theEntries)) bSuccess = SaveMarket();
+
+        m_lChangesSince = m_lJournalSequence;
+        m_lWholeListSince =
+            isWholeList() ? m_lJournalSequence : (m_lJournalSequence + 1);
+
+        // The candles are only informational, so the market loads without
+        // them if need be.
+        if (!openCandles())
+            otErr << "OTMarket::" << __FUNCTION__
+                  << ": Failed opening the candles for this market.\n";
+    }
+
     return bSuccess;
 }
 
@@ -801,9 +1012,378 @@ bool OTMarket::SaveMarket()
                   << szFilename << "\n";
     }
 
+    // The market file now includes everything in the journal.
+    std::vector<std::string> theEntries;
+
+    if (m_journal.IsOpen() || openJournal(theEntries)) m_journal.Clear();
+
+    return true;
+}
+
+bool OTMarket::CompactJournal()
+{
+    const size_t nThreshold = std::max(MIN_JOURNAL_ENTRIES, m_mapOffers.size());
+
+    if (m_journal.GetCount() < nThreshold) return true;
+
+    return SaveMarket();
+}
+
+bool OTMarket::SaveOffer(const OTOffer& theOffer)
+{
+    OTASCIIArmor ascOffer;
+    ascOffer.SetString(String(theOffer), false); // One line.
+
+    const int64_t lTransactionNum = theOffer.GetTransactionNum();
+    const bool bSaved =
+        appendJournal("offer " + formatLong(lTransactionNum) + " " +
+                      ascOffer.Get());
+
+    OTOffer* pOffer = GetOffer(lTransactionNum);
+
+    if (nullptr != pOffer)
+        noteChange(lTransactionNum, pOffer->IsBid(), pOffer->GetPriceLimit());
+
+    return bSaved;
+}
+
+// Takes ownership of the offer if it succeeds.
+bool OTMarket::loadOffer(const String& strOffer, time64_t tDateAdded)
+{
+    OTOffer* pOffer = new OTOffer(m_NOTARY_ID, m_INSTRUMENT_DEFINITION_ID,
+                                  m_CURRENCY_TYPE_ID, m_lScale);
+
+    OT_ASSERT(nullptr != pOffer);
+
+    if (pOffer->LoadContractFromString(strOffer) &&
+        AddOffer(nullptr, *pOffer, false, tDateAdded)) // bSaveMarket =
+    // false (Don't SAVE
+    // -- we're loading
+    // right now!)
+    {
+        otWarn << "Successfully loaded offer and added to market.\n";
+        return true;
+    }
+
+    otErr << "Error adding offer to market while loading market.\n";
+    delete pOffer;
+    pOffer = nullptr;
+
+    return false;
+}
+
+// Replaces the contents of an offer that's already on the market, keeping its
+// place in line.
+bool OTMarket::updateOffer(const int64_t& lTransactionNum,
+                           const String& strOffer)
+{
+    OTOffer* pOffer = GetOffer(lTransactionNum);
+
+    if (nullptr == pOffer) {
+        otErr << "OTMarket::" << __FUNCTION__
+              << ": No offer on the market with transaction number "
+              << lTransactionNum << "\n";
+        return false;
+    }
+
+    // Check it first, so the offer on the market isn't left half loaded.
+    OTOffer theUpdate(m_NOTARY_ID, m_INSTRUMENT_DEFINITION_ID,
+                      m_CURRENCY_TYPE_ID, m_lScale);
+
+    if (!theUpdate.LoadContractFromString(strOffer) ||
+        (theUpdate.GetTransactionNum() != lTransactionNum) ||
+        (theUpdate.IsBid() != pOffer->IsBid()) ||
+        (theUpdate.GetPriceLimit() != pOffer->GetPriceLimit())) {
+        otErr << "OTMarket::" << __FUNCTION__
+              << ": Bad update for offer with transaction number "
+              << lTransactionNum << "\n";
+        return false;
+    }
+
+    const time64_t tDateAdded = pOffer->GetDateAddedToMarket();
+
+    pOffer->LoadContractFromString(strOffer);
+    pOffer->SetDateAddedToMarket(tDateAdded);
+
+    (pOffer->IsBid() ? m_bookBids : m_bookAsks).Update(*pOffer);
+
     return true;
 }
 
+// Here we save this trade in a list of the most recent 50 trades.
+void OTMarket::addRecentTrade(const int64_t& lTransactionNum, time64_t tDate,
+                              const int64_t& lPrice,
+                              const int64_t& lAmountSold)
+{
+    if (nullptr == m_pTradeList) {
+        m_pTradeList = dynamic_cast<OTDB::TradeListMarket*>(
+            OTDB::CreateObject(OTDB::STORED_OBJ_TRADE_LIST_MARKET));
+    }
+
+    std::unique_ptr<OTDB::TradeDataMarket> pTradeData(
+        dynamic_cast<OTDB::TradeDataMarket*>(
+            OTDB::CreateObject(OTDB::STORED_OBJ_TRADE_DATA_MARKET)));
+
+    pTradeData->transaction_id = to_string<int64_t>(lTransactionNum);
+    pTradeData->date = to_string<time64_t>(tDate);
+    pTradeData->price = to_string<int64_t>(lPrice);
+    pTradeData->amount_sold = to_string<int64_t>(lAmountSold);
+
+    m_strLastSaleDate = pTradeData->date;
+
+    // *pTradeData is CLONED at this time (I'm still responsible
+    // to delete.)
+    // That's also why I add it here, after all the above: So
+    // the data is set right BEFORE the cloning occurs.
+    //
+    m_pTradeList->AddTradeDataMarket(*pTradeData);
+
+    // Here we erase the oldest elements so the list never
+    // exceeds 50 elements total.
+    //
+    while (m_pTradeList->GetTradeDataMarketCount() > MAX_MARKET_QUERY_DEPTH)
+        m_pTradeList->RemoveTradeDataMarket(0);
+}
+
+// markets/<szSubFolder>/<market ID>
+bool OTMarket::getFilePath(const char* szSubFolder,
+                           std::string& strPath) const
+{
+    Identifier MARKET_ID;
+    GetIdentifier(MARKET_ID);
+    const String str_MARKET_ID(MARKET_ID);
+
+    if (0 > OTDB::FormPathString(strPath, OTFolders::Market().Get(),
+                                 szSubFolder, str_MARKET_ID.Get()))
+        return false;
+
+    bool bFolderCreated = false;
+
+    return OTPaths::BuildFilePath(String(strPath), bFolderCreated);
+}
+
+bool OTMarket::openJournal(std::vector<std::string>& theEntries)
+{
+    std::string strPath;
+
+    if (!getFilePath("journal", strPath)) {
+        otErr << "OTMarket::" << __FUNCTION__
+              << ": Failed forming the journal path.\n";
+        return false;
+    }
+
+    return m_journal.Open(strPath, theEntries);
+}
+
+bool OTMarket::openCandles()
+{
+    std::string strPath;
+
+    if (!getFilePath("candles", strPath)) {
+        otErr << "OTMarket::" << __FUNCTION__
+              << ": Failed forming the candles path.\n";
+        return false;
+    }
+
+    return m_candles.Open(strPath);
+}
+
+bool OTMarket::GetCandles(const std::string& strResolution, int64_t lDepth,
+                          OTASCIIArmor& ascOutput, int32_t& nCandleCount) const
+{
+    nCandleCount = 0;
+
+    std::vector<OTMarketCandles::Candle> theCandles;
+
+    if (!m_candles.GetCandles(strResolution, lDepth, theCandles)) {
+        otErr << "OTMarket::" << __FUNCTION__ << ": No candles are kept at "
+              << strResolution << "\n";
+        return false;
+    }
+
+    if (theCandles.empty()) return true;
+
+    std::ostringstream strCandles;
+
+    for (auto& theCandle : theCandles)
+        strCandles << OTTimeGetSecondsFromTime(theCandle.tStart) << " "
+                   << theCandle.lOpen << " " << theCandle.lHigh << " "
+                   << theCandle.lLow << " " << theCandle.lClose << " "
+                   << theCandle.lVolume << "\n";
+
+    nCandleCount = static_cast<int32_t>(theCandles.size());
+
+    return ascOutput.SetString(String(strCandles.str()));
+}
+
+// Each entry is "<sequence> <type> ... <signature>". If the journal can't be
+// written, the whole market is saved instead, like before there was a
+// journal.
+bool OTMarket::appendJournal(const std::string& strEntry)
+{
+    std::vector<std::string> theEntries;
+
+    ++m_lJournalSequence;
+
+    const std::string strSigned =
+        formatLong(m_lJournalSequence) + " " + strEntry;
+    std::string strSignature;
+
+    if (signJournalEntry(strSigned, strSignature) &&
+        (m_journal.IsOpen() || openJournal(theEntries)) &&
+        m_journal.Append(strSigned + " " + strSignature))
+        return true;
+
+    otErr << "OTMarket::" << __FUNCTION__
+          << ": Failed writing to the journal. Saving the whole market "
+             "instead.\n";
+
+    return SaveMarket();
+}
+
+// The server Nym signs each entry, as it signs the market file, so the
+// journal can't be edited to change the market. The signature is armored
+// on one line.
+bool OTMarket::signJournalEntry(const std::string& strEntry,
+                                std::string& strSignature)
+{
+    OT_ASSERT(nullptr != GetCron());
+    OT_ASSERT(nullptr != GetCron()->GetServerNym());
+
+    const Nym& theServerNym = *(GetCron()->GetServerNym());
+    OTSignature theSignature;
+    OTPasswordData thePWData("Signing a market journal entry.");
+    bool bSigned = false;
+
+    {
+        std::lock_guard<std::mutex> lock(theServerNym.GetSigningLock());
+
+        bSigned = OTCrypto::It()->SignContract(
+            String(strEntry), theServerNym.GetPrivateSignKey(), theSignature,
+            Identifier::DefaultHashAlgorithm, &thePWData);
+    }
+
+    OTData theData;
+    OTASCIIArmor ascSignature;
+
+    if (!bSigned || !theSignature.GetData(theData) ||
+        !ascSignature.SetData(theData, false)) {
+        otErr << "OTMarket::" << __FUNCTION__
+              << ": Failed signing journal entry: " << strEntry << "\n";
+        return false;
+    }
+
+    strSignature = ascSignature.Get();
+
+    return true;
+}
+
+bool OTMarket::verifyJournalEntry(const std::string& strEntry,
+                                  const std::string& strSignature)
+{
+    OT_ASSERT(nullptr != GetCron());
+    OT_ASSERT(nullptr != GetCron()->GetServerNym());
+
+    const OTASCIIArmor ascSignature(strSignature.c_str());
+    OTData theData;
+    OTSignature theSignature;
+
+    return ascSignature.GetData(theData, false) &&
+           theSignature.SetData(theData) &&
+           OTCrypto::It()->VerifySignature(
+               String(strEntry),
+               GetCron()->GetServerNym()->GetPublicSignKey(), theSignature,
+               Identifier::DefaultHashAlgorithm);
+}
+
+// Returns false if an entry isn't signed by the server Nym. The entries
+// after it aren't applied.
+bool OTMarket::replayJournal(const std::vector<std::string>& theEntries)
+{
+    for (auto& strLine : theEntries) {
+        const size_t nPos = strLine.rfind(' ');
+
+        if ((std::string::npos == nPos) ||
+            !verifyJournalEntry(strLine.substr(0, nPos),
+                                strLine.substr(nPos + 1))) {
+            otErr << "OTMarket::" << __FUNCTION__
+                  << ": Bad signature on journal entry: " << strLine
+                  << ". (Ignoring the rest of the journal.)\n";
+            return false;
+        }
+
+        const std::string strEntry = strLine.substr(0, nPos);
+
+        if (!replayEntry(strEntry))
+            otErr << "OTMarket::" << __FUNCTION__
+                  << ": Failed applying journal entry: " << strEntry << "\n";
+    }
+
+    return true;
+}
+
+bool OTMarket::replayEntry(const std::string& strEntry)
+{
+    std::istringstream theEntry(strEntry);
+
+    int64_t lSequence = 0;
+    std::string strType;
+
+    if (!(theEntry >> lSequence >> strType)) return false;
+
+    // Entries up to the one the market file was saved after are already in it.
+    if (lSequence <= m_lJournalSequence) return true;
+
+    m_lJournalSequence = lSequence;
+
+    if ("add" == strType) {
+        int64_t lDateAdded = 0;
+        std::string strArmored;
+        String strOffer;
+
+        return (theEntry >> lDateAdded >> strArmored) &&
+               decodeOffer(strArmored, strOffer) &&
+               loadOffer(strOffer, OTTimeGetTimeFromSeconds(lDateAdded));
+    }
+    else if ("offer" == strType) {
+        int64_t lTransactionNum = 0;
+        std::string strArmored;
+        String strOffer;
+
+        return (theEntry >> lTransactionNum >> strArmored) &&
+               decodeOffer(strArmored, strOffer) &&
+               updateOffer(lTransactionNum, strOffer);
+    }
+    else if ("remove" == strType) {
+        int64_t lTransactionNum = 0;
+
+        return (theEntry >> lTransactionNum) && removeOffer(lTransactionNum);
+    }
+    else if ("trade" == strType) {
+        int64_t lDate = 0, lPrice = 0, lAmountSold = 0;
+        int64_t lTransactionNum = 0, lOtherTransactionNum = 0;
+        std::string strArmored, strOtherArmored;
+        String strOffer, strOtherOffer;
+
+        if (!(theEntry >> lDate >> lPrice >> lAmountSold >> lTransactionNum >>
+              strArmored >> lOtherTransactionNum >> strOtherArmored) ||
+            !decodeOffer(strArmored, strOffer) ||
+            !decodeOffer(strOtherArmored, strOtherOffer))
+            return false;
+
+        const bool bUpdated = updateOffer(lTransactionNum, strOffer) &&
+                              updateOffer(lOtherTransactionNum, strOtherOffer);
+
+        m_lLastSalePrice = lPrice;
+        addRecentTrade(lTransactionNum, OTTimeGetTimeFromSeconds(lDate), lPrice,
+                       lAmountSold);
+
+        return bUpdated;
+    }
+
+    return false;
+}
+
 // A Market's ID is based on the instrument definition, the currency type, and
 // the scale.
 //
@@ -827,46 +1407,16 @@ void OTMarket::GetIdentifier(Identifier& theIdentifier) const
 // bid on the market.
 int64_t OTMarket::GetHighestBidPrice()
 {
-    int64_t lPrice = 0;
-
-    mapOfOffers::reverse_iterator rr = m_mapBids.rbegin();
-
-    if (rr != m_mapBids.rend()) {
-        lPrice = rr->first;
-    }
-
-    return lPrice;
+    return m_bookBids.GetBestPrice();
 }
 
 // returns 0 if there are no asks. Otherwise returns the value of the lowest ask
 // on the market.
 int64_t OTMarket::GetLowestAskPrice()
 {
-    int64_t lPrice = 0;
-
-    auto it = m_mapAsks.begin();
-
-    if (it != m_mapAsks.end()) {
-        lPrice = it->first;
-
-        // Market orders have a 0 price, so we need to skip any if they are
-        // here.
-        //
-        // Note that we don't have to do this with the highest bid price (above
-        // function) but in the case of asks, a "0 price" will undercut the
-        // other
-        // actual prices, so we need to skip any that have a 0 price.
-        //
-        while (0 == lPrice) {
-            ++it;
-
-            if (it == m_mapAsks.end()) break;
-
-            lPrice = it->first;
-        }
-    }
-
-    return lPrice;
+    // Market orders have a 0 price, so the book skips any if they are here.
+    // (In the case of asks, a "0 price" would undercut the actual prices.)
+    return m_bookAsks.GetBestPrice();
 }
 
 // This utility function is used directly below (only).
@@ -1764,6 +2314,11 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
                     lOtherOfferFinished); // I was storing these up in the loop
                                           // above.
 
+                // Keep the quantities on the books in step.
+                (theOffer.IsBid() ? m_bookBids : m_bookAsks).Update(theOffer);
+                (theOtherOffer.IsBid() ? m_bookBids : m_bookAsks)
+                    .Update(theOtherOffer);
+
                 // These have updated values, so let's save them.
                 theTrade.ReleaseSignatures();
                 theTrade.SignContract(*pServerNym);
@@ -1786,57 +2341,43 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
 
                 // Here we save this trade in a list of the most recent 50
                 // trades.
-                {
-                    if (nullptr == m_pTradeList) {
-                        m_pTradeList = dynamic_cast<OTDB::TradeListMarket*>(
-                            OTDB::CreateObject(
-                                OTDB::STORED_OBJ_TRADE_LIST_MARKET));
-                    }
+                const time64_t theDate = OTTimeGetCurrentTime();
 
-                    std::unique_ptr<OTDB::TradeDataMarket> pTradeData(
-                        dynamic_cast<OTDB::TradeDataMarket*>(OTDB::CreateObject(
-                            OTDB::STORED_OBJ_TRADE_DATA_MARKET)));
-
-                    const int64_t& lTransactionNum =
-                        theOffer.GetTransactionNum();
-                    const time64_t theDate = OTTimeGetCurrentTime();
-                    const int64_t& lPriceLimit =
-                        theOtherOffer.GetPriceLimit(); // Priced per scale.
-                    const int64_t& lAmountSold = lOfferFinished;
-
-                    pTradeData->transaction_id =
-                        to_string<int64_t>(lTransactionNum);
-                    pTradeData->date = to_string<time64_t>(theDate);
-                    pTradeData->price = to_string<int64_t>(lPriceLimit);
-                    pTradeData->amount_sold = to_string<int64_t>(lAmountSold);
-
-                    m_strLastSaleDate = pTradeData->date;
-
-                    // *pTradeData is CLONED at this time (I'm still responsible
-                    // to delete.)
-                    // That's also why I add it here, after all the above: So
-                    // the data is set right BEFORE the cloning occurs.
-                    //
-                    m_pTradeList->AddTradeDataMarket(*pTradeData);
-
-                    // Here we erase the oldest elements so the list never
-                    // exceeds 50 elements total.
-                    //
-                    while (m_pTradeList->GetTradeDataMarketCount() >
-                           MAX_MARKET_QUERY_DEPTH)
-                        m_pTradeList->RemoveTradeDataMarket(0);
-                }
+                addRecentTrade(theOffer.GetTransactionNum(), theDate,
+                               m_lLastSalePrice, lOfferFinished);
+
+                // The candles are saved as they change, so unlike the list
+                // above, they aren't rebuilt when the journal is replayed.
+                if (m_candles.IsOpen() || openCandles())
+                    m_candles.AddTrade(theDate, m_lLastSalePrice,
+                                       lOfferFinished);
 
                 // Account balances have changed based on these trades that we
                 // just processed.
-                // Make sure to save the Market since it contains those offers
-                // that have just updated.
-                SaveMarket();
+                // Make sure to journal the offers that have just updated, so
+                // the market can be restored without saving all of it here.
+                OTASCIIArmor ascOffer, ascOtherOffer;
+                ascOffer.SetString(String(theOffer), false);
+                ascOtherOffer.SetString(String(theOtherOffer), false);
+
+                appendJournal(
+                    "trade " + formatLong(OTTimeGetSecondsFromTime(theDate)) +
+                    " " + formatLong(m_lLastSalePrice) + " " +
+                    formatLong(lOfferFinished) + " " +
+                    formatLong(theOffer.GetTransactionNum()) + " " +
+                    ascOffer.Get() + " " +
+                    formatLong(theOtherOffer.GetTransactionNum()) + " " +
+                    ascOtherOffer.Get());
+                noteChange(theOffer.GetTransactionNum(), theOffer.IsBid(),
+                           theOffer.GetPriceLimit());
+                noteChange(theOtherOffer.GetTransactionNum(),
+                           theOtherOffer.IsBid(),
+                           theOtherOffer.GetPriceLimit());
 
                 // The Trade has changed, and it is stored as a CronItem. So I
                 // save Cron as well, for
                 // the same reason I saved the Market.
-                pCron->SaveCron();
+                pCron->SaveCronLater();
             }
 
             //
@@ -2395,18 +2936,18 @@ bool OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer)
 
     if (theOffer.IsAsk()) // If I'm selling,
     {
-        // rbegin puts us on the upper bound of the highest bidder (any new
-        // bidders at the same price would
-        // be added at the lower bound, where they are last in line.) The upper
-        // bound, on the other hand, is
-        // first in line.  So we start there, and loop backwards until there are
-        // no other bids within my price range.
-        for (mapOfOffers::reverse_iterator rr = m_mapBids.rbegin();
-             rr != m_mapBids.rend(); ++rr) {
+        // The bids are ordered from the highest bidder down, and first in
+        // line at each price comes first (any new bidders at the same price
+        // are added last in line.) So we start at the front, and loop until
+        // there are no other bids within my price range.
+        auto it = m_bookBids.begin();
+
+        while (it != m_bookBids.end()) {
             // then I want to start at the highest bidder and loop DOWN until
             // hitting my price limit.
-            OTOffer* pBid = rr->second;
+            OTOffer* pBid = *it;
             OT_ASSERT(nullptr != pBid);
+            ++it;
 
             // NOTE: Market orders only process once, and they are processed in
             // the order they were added to the market.
@@ -2483,18 +3024,19 @@ bool OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer)
     }
     // I'm buying
     else {
-        // Begin puts us on the lower bound of the lowest seller (any new
-        // sellers at the same price would
-        // be added at the upper bound for that price, where they are last in
-        // line.) The lower bound, on the other hand, is
-        // first in line.  So we start there, and loop forwards until there are
-        // no other asks within my price range.
+        // The asks are ordered from the lowest seller up, and first in line
+        // at each price comes first (any new sellers at the same price are
+        // added last in line.) So we start at the front, and loop until there
+        // are no other asks within my price range.
         //
-        for (auto& it : m_mapAsks) {
+        auto it = m_bookAsks.begin();
+
+        while (it != m_bookAsks.end()) {
             // then I want to start at the lowest seller and loop UP until
             // hitting my price limit.
-            OTOffer* pAsk = it.second;
+            OTOffer* pAsk = *it;
             OT_ASSERT(nullptr != pAsk);
+            ++it;
 
             // NOTE: Market orders only process once, and they are processed in
             // the order they were added to the market.
@@ -2649,8 +3191,16 @@ OTMarket::OTMarket(const char* szFilename)
     : Contract()
     , m_pCron(nullptr)
     , m_pTradeList(nullptr)
+    , m_bookBids(true)
+    , m_bookAsks(false)
     , m_lScale(1)
     , m_lLastSalePrice(0)
+    , m_lJournalSequence(0)
+    , m_lChangesSince(0)
+    , m_lWholeListSince(0)
+    , m_lCacheVersion(-1)
+    , m_bRecentTradesCached(false)
+    , m_nRecentTradeCount(0)
 {
     OT_ASSERT(nullptr != szFilename);
 
@@ -2665,8 +3215,16 @@ OTMarket::OTMarket()
     : Contract()
     , m_pCron(nullptr)
     , m_pTradeList(nullptr)
+    , m_bookBids(true)
+    , m_bookAsks(false)
     , m_lScale(1)
     , m_lLastSalePrice(0)
+    , m_lJournalSequence(0)
+    , m_lChangesSince(0)
+    , m_lWholeListSince(0)
+    , m_lCacheVersion(-1)
+    , m_bRecentTradesCached(false)
+    , m_nRecentTradeCount(0)
 {
     m_pCron = nullptr; // just for convenience, not responsible to delete.
     InitMarket();
@@ -2678,8 +3236,16 @@ OTMarket::OTMarket(const Identifier& NOTARY_ID,
     : Contract()
     , m_pCron(nullptr)
     , m_pTradeList(nullptr)
+    , m_bookBids(true)
+    , m_bookAsks(false)
     , m_lScale(1)
     , m_lLastSalePrice(0)
+    , m_lJournalSequence(0)
+    , m_lChangesSince(0)
+    , m_lWholeListSince(0)
+    , m_lCacheVersion(-1)
+    , m_bRecentTradesCached(false)
+    , m_nRecentTradeCount(0)
 {
     m_pCron = nullptr; // just for convenience, not responsible to delete.
     InitMarket();
@@ -2718,18 +3284,23 @@ void OTMarket::Release_Market()
     }
 
     // If there were any dynamically allocated objects, clean them up here.
-    while (!m_mapBids.empty()) {
-        OTOffer* pOffer = m_mapBids.begin()->second;
-        m_mapBids.erase(m_mapBids.begin());
-        delete pOffer;
-        pOffer = nullptr;
-    }
-    while (!m_mapAsks.empty()) {
-        OTOffer* pOffer = m_mapAsks.begin()->second;
-        m_mapAsks.erase(m_mapAsks.begin());
-        delete pOffer;
-        pOffer = nullptr;
-    }
+    for (OTOffer* pOffer : m_bookBids) delete pOffer;
+    for (OTOffer* pOffer : m_bookAsks) delete pOffer;
+
+    m_bookBids.Clear();
+    m_bookAsks.Clear();
+    m_mapOffers.clear();
+
+    m_journal.Close();
+    m_candles.Close();
+
+    m_dequeChanges.clear();
+    m_lChangesSince = 0;
+    m_lWholeListSince = 0;
+
+    m_lCacheVersion = -1;
+    m_mapOfferLists.clear();
+    m_bRecentTradesCached = false;
 }
 
 void OTMarket::Release()
@@ -0,0 +1,280 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/trade/OTMarketCandles.hpp>
+#include <opentxs/core/Log.hpp>
+
+#include <algorithm>
+
+namespace opentxs
+{
+
+namespace
+{
+
+struct Resolution
+{
+    const char* szName;
+    int64_t lSeconds;
+    size_t nCount; // How many candles are kept.
+};
+
+// A day of minutes, a month of hours and two years of days.
+const Resolution RESOLUTIONS[] = {
+    {"1m", 60, 1440}, {"1h", 3600, 720}, {"1d", 86400, 730}};
+
+const size_t RESOLUTION_COUNT = sizeof(RESOLUTIONS) / sizeof(RESOLUTIONS[0]);
+
+// Each candle is saved as its six fields, little endian.
+const size_t FIELD_COUNT = 6;
+const size_t RECORD_SIZE = FIELD_COUNT * 8;
+
+// Where the candles for resolution nResolution start, in file order.
+size_t ringStart(size_t nResolution)
+{
+    size_t nStart = 0;
+
+    for (size_t i = 0; i < nResolution; ++i) nStart += RESOLUTIONS[i].nCount;
+
+    return nStart;
+}
+
+void encodeCandle(const OTMarketCandles::Candle& theCandle, uint8_t* pRecord)
+{
+    const int64_t theFields[FIELD_COUNT] = {
+        OTTimeGetSecondsFromTime(theCandle.tStart), theCandle.lOpen,
+        theCandle.lHigh, theCandle.lLow, theCandle.lClose, theCandle.lVolume};
+
+    for (size_t i = 0; i < FIELD_COUNT; ++i) {
+        const uint64_t uField = static_cast<uint64_t>(theFields[i]);
+
+        for (size_t j = 0; j < 8; ++j)
+            *pRecord++ = static_cast<uint8_t>(uField >> (8 * j));
+    }
+}
+
+void decodeCandle(const uint8_t* pRecord, OTMarketCandles::Candle& theCandle)
+{
+    int64_t theFields[FIELD_COUNT];
+
+    for (size_t i = 0; i < FIELD_COUNT; ++i) {
+        uint64_t uField = 0;
+
+        for (size_t j = 0; j < 8; ++j)
+            uField |= static_cast<uint64_t>(*pRecord++) << (8 * j);
+
+        theFields[i] = static_cast<int64_t>(uField);
+    }
+
+    theCandle.tStart = OTTimeGetTimeFromSeconds(theFields[0]);
+    theCandle.lOpen = theFields[1];
+    theCandle.lHigh = theFields[2];
+    theCandle.lLow = theFields[3];
+    theCandle.lClose = theFields[4];
+    theCandle.lVolume = theFields[5];
+}
+
+} // namespace
+
+OTMarketCandles::OTMarketCandles()
+    : m_pFile(nullptr)
+{
+}
+
+OTMarketCandles::~OTMarketCandles()
+{
+    Close();
+}
+
+bool OTMarketCandles::Open(const std::string& strPath)
+{
+    Close();
+
+    const OTMarketCandles::Candle theEmpty = {OT_TIME_ZERO, 0, 0, 0, 0, 0};
+    m_vecCandles.assign(ringStart(RESOLUTION_COUNT), theEmpty);
+
+    m_pFile = std::fopen(strPath.c_str(), "r+b");
+
+    if (nullptr == m_pFile) m_pFile = std::fopen(strPath.c_str(), "w+b");
+
+    if (nullptr == m_pFile) {
+        otErr << "OTMarketCandles::" << __FUNCTION__ << ": Failed opening "
+              << strPath << "\n";
+        return false;
+    }
+
+    m_strPath = strPath;
+
+    // Records never written yet (past the end of the file, or in a gap)
+    // read back as empty candles, which are skipped.
+    uint8_t theRecord[RECORD_SIZE];
+
+    for (auto& theCandle : m_vecCandles) {
+        if (1 != std::fread(theRecord, RECORD_SIZE, 1, m_pFile)) break;
+
+        decodeCandle(theRecord, theCandle);
+    }
+
+    if (0 != std::ferror(m_pFile)) {
+        otErr << "OTMarketCandles::" << __FUNCTION__ << ": Failed reading "
+              << strPath << "\n";
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void OTMarketCandles::Close()
+{
+    if (nullptr != m_pFile) std::fclose(m_pFile);
+
+    m_pFile = nullptr;
+    m_vecCandles.clear();
+}
+
+bool OTMarketCandles::AddTrade(time64_t tDate, int64_t lPrice, int64_t lAmount)
+{
+    if (nullptr == m_pFile) return false;
+
+    const int64_t lDate = OTTimeGetSecondsFromTime(tDate);
+    bool bWritten = true;
+
+    for (size_t i = 0; i < RESOLUTION_COUNT; ++i) {
+        const Resolution& theResolution = RESOLUTIONS[i];
+        const int64_t lPeriod = lDate / theResolution.lSeconds;
+        const time64_t tStart =
+            OTTimeGetTimeFromSeconds(lPeriod * theResolution.lSeconds);
+        const size_t nIndex =
+            ringStart(i) + static_cast<size_t>(lPeriod) % theResolution.nCount;
+
+        Candle& theCandle = m_vecCandles[nIndex];
+
+        if (theCandle.tStart == tStart) {
+            theCandle.lHigh = std::max(theCandle.lHigh, lPrice);
+            theCandle.lLow = std::min(theCandle.lLow, lPrice);
+            theCandle.lClose = lPrice;
+            theCandle.lVolume += lAmount;
+        }
+        else if (theCandle.tStart < tStart) {
+            // Starts a new candle, in place of one that's too old to keep.
+            theCandle.tStart = tStart;
+            theCandle.lOpen = lPrice;
+            theCandle.lHigh = lPrice;
+            theCandle.lLow = lPrice;
+            theCandle.lClose = lPrice;
+            theCandle.lVolume = lAmount;
+        }
+        else
+            continue;
+
+        bWritten = writeCandle(nIndex) && bWritten;
+    }
+
+    if ((0 != std::fflush(m_pFile)) || !bWritten) {
+        otErr << "OTMarketCandles::" << __FUNCTION__ << ": Failed writing to "
+              << m_strPath << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+bool OTMarketCandles::GetCandles(const std::string& strResolution,
+                                 int64_t lDepth,
+                                 std::vector<Candle>& theCandles) const
+{
+    theCandles.clear();
+
+    size_t nResolution = 0;
+
+    while ((nResolution < RESOLUTION_COUNT) &&
+           (strResolution != RESOLUTIONS[nResolution].szName))
+        ++nResolution;
+
+    if (RESOLUTION_COUNT == nResolution) return false;
+
+    if (m_vecCandles.empty()) return true; // No trades yet.
+
+    const Resolution& theResolution = RESOLUTIONS[nResolution];
+    auto itBegin = m_vecCandles.begin() + ringStart(nResolution);
+    auto itEnd = itBegin + theResolution.nCount;
+
+    for (auto it = itBegin; it != itEnd; ++it)
+        if (OT_TIME_ZERO != it->tStart) theCandles.push_back(*it);
+
+    std::sort(theCandles.begin(), theCandles.end(),
+              [](const Candle& lhs, const Candle& rhs) {
+        return lhs.tStart < rhs.tStart;
+    });
+
+    if (theCandles.empty()) return true;
+
+    // A slot that hasn't been reused since may still hold a candle from
+    // before the window the ring covers.
+    const int64_t lOldest =
+        OTTimeGetSecondsFromTime(theCandles.back().tStart) -
+        static_cast<int64_t>(theResolution.nCount - 1) * theResolution.lSeconds;
+
+    auto itKeep = theCandles.begin();
+
+    while ((theCandles.end() != itKeep) &&
+           (OTTimeGetSecondsFromTime(itKeep->tStart) < lOldest))
+        ++itKeep;
+
+    if ((lDepth > 0) && (theCandles.end() - itKeep > lDepth))
+        itKeep = theCandles.end() - lDepth;
+
+    theCandles.erase(theCandles.begin(), itKeep);
+
+    return true;
+}
+
+bool OTMarketCandles::writeCandle(size_t nIndex)
+{
+    uint8_t theRecord[RECORD_SIZE];
+    encodeCandle(m_vecCandles[nIndex], theRecord);
+
+    return (0 == std::fseek(m_pFile, static_cast<long>(nIndex * RECORD_SIZE),
+                            SEEK_SET)) &&
+           (1 == std::fwrite(theRecord, RECORD_SIZE, 1, m_pFile));
+}
+
+} // namespace opentxs
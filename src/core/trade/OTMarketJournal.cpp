@@ -0,0 +1,283 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/trade/OTMarketJournal.hpp>
+#include <opentxs/core/Log.hpp>
+
+#include <cstdio>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace opentxs
+{
+
+namespace
+{
+
+int openFile(const std::string& strPath)
+{
+#ifdef _WIN32
+    return _open(strPath.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY,
+                 _S_IREAD | _S_IWRITE);
+#else
+    return open(strPath.c_str(), O_WRONLY | O_CREAT, 0644);
+#endif
+}
+
+void closeFile(int nFile)
+{
+#ifdef _WIN32
+    _close(nFile);
+#else
+    close(nFile);
+#endif
+}
+
+// Fails unless all of strData was written.
+bool writeAt(int nFile, int64_t lOffset, const std::string& strData)
+{
+#ifdef _WIN32
+    return (lOffset == _lseeki64(nFile, lOffset, SEEK_SET)) &&
+           (static_cast<int>(strData.size()) ==
+            _write(nFile, strData.data(),
+                   static_cast<unsigned int>(strData.size())));
+#else
+    return (lOffset == lseek(nFile, lOffset, SEEK_SET)) &&
+           (static_cast<ssize_t>(strData.size()) ==
+            write(nFile, strData.data(), strData.size()));
+#endif
+}
+
+bool truncateFile(int nFile, int64_t lSize)
+{
+#ifdef _WIN32
+    return 0 == _chsize_s(nFile, lSize);
+#else
+    return 0 == ftruncate(nFile, lSize);
+#endif
+}
+
+bool syncFile(int nFile)
+{
+#ifdef _WIN32
+    return 0 == _commit(nFile);
+#else
+    return 0 == fsync(nFile);
+#endif
+}
+
+bool readFile(const std::string& strPath, std::string& strContents)
+{
+    strContents.clear();
+
+    std::FILE* pFile = std::fopen(strPath.c_str(), "rb");
+    if (nullptr == pFile) return true; // Not created yet.
+
+    char buffer[4096];
+    size_t nRead = 0;
+
+    while (0 < (nRead = std::fread(buffer, 1, sizeof(buffer), pFile)))
+        strContents.append(buffer, nRead);
+
+    const bool bRead = (0 == std::ferror(pFile));
+    std::fclose(pFile);
+
+    return bRead;
+}
+
+// Replaces the file in one step, so it's never seen half written.
+bool replaceFile(const std::string& strPath, const std::string& strContents)
+{
+    const std::string strTemp = strPath + ".tmp";
+    const int nFile = openFile(strTemp);
+
+    if (nFile < 0) return false;
+
+    const bool bWritten = truncateFile(nFile, 0) &&
+                          writeAt(nFile, 0, strContents) && syncFile(nFile);
+    closeFile(nFile);
+
+    if (!bWritten) {
+        std::remove(strTemp.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    return 0 != MoveFileExA(strTemp.c_str(), strPath.c_str(),
+                            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    return 0 == std::rename(strTemp.c_str(), strPath.c_str());
+#endif
+}
+
+} // namespace
+
+OTMarketJournal::OTMarketJournal()
+    : m_nFile(-1)
+    , m_lSize(0)
+    , m_nCount(0)
+{
+}
+
+OTMarketJournal::~OTMarketJournal()
+{
+    Close();
+}
+
+bool OTMarketJournal::Open(const std::string& strPath,
+                           std::vector<std::string>& theEntries)
+{
+    Close();
+    theEntries.clear();
+
+    std::string strContents;
+
+    if (!readFile(strPath, strContents)) {
+        otErr << "OTMarketJournal::" << __FUNCTION__ << ": Failed reading "
+              << strPath << "\n";
+        return false;
+    }
+
+    size_t nStart = 0;
+
+    for (size_t nEnd = strContents.find('\n'); std::string::npos != nEnd;
+         nEnd = strContents.find('\n', nStart)) {
+        if (nEnd > nStart)
+            theEntries.push_back(strContents.substr(nStart, nEnd - nStart));
+        nStart = nEnd + 1;
+    }
+
+    // Whatever follows the last newline was cut off in the middle of a write.
+    if (nStart < strContents.size()) {
+        otErr << "OTMarketJournal::" << __FUNCTION__
+              << ": Dropping an incomplete entry at the end of " << strPath
+              << "\n";
+
+        strContents.resize(nStart);
+
+        if (!replaceFile(strPath, strContents)) {
+            otErr << "OTMarketJournal::" << __FUNCTION__
+                  << ": Failed repairing " << strPath << "\n";
+            return false;
+        }
+    }
+
+    m_nFile = openFile(strPath);
+
+    if (m_nFile < 0) {
+        otErr << "OTMarketJournal::" << __FUNCTION__ << ": Failed opening "
+              << strPath << "\n";
+        return false;
+    }
+
+    m_strPath = strPath;
+    m_lSize = static_cast<int64_t>(strContents.size());
+    m_nCount = theEntries.size();
+
+    return true;
+}
+
+void OTMarketJournal::Close()
+{
+    if (m_nFile >= 0) closeFile(m_nFile);
+
+    m_nFile = -1;
+    m_lSize = 0;
+    m_nCount = 0;
+}
+
+bool OTMarketJournal::Append(const std::string& strEntry)
+{
+    OT_ASSERT(std::string::npos == strEntry.find('\n'));
+
+    if (m_nFile < 0) return false;
+
+    const std::string strLine = strEntry + "\n";
+
+    if (!writeAt(m_nFile, m_lSize, strLine) || !syncFile(m_nFile)) {
+        otErr << "OTMarketJournal::" << __FUNCTION__ << ": Failed writing to "
+              << m_strPath << "\n";
+
+        // Whatever part of the line made it would run into the next entry.
+        if (!truncateFile(m_nFile, m_lSize)) {
+            otErr << "OTMarketJournal::" << __FUNCTION__
+                  << ": Failed cutting off the partial entry. Closing "
+                  << m_strPath << "\n";
+            Close();
+        }
+
+        return false;
+    }
+
+    m_lSize += static_cast<int64_t>(strLine.size());
+    ++m_nCount;
+
+    return true;
+}
+
+bool OTMarketJournal::Clear()
+{
+    if (m_nFile < 0) return false;
+
+    if (!truncateFile(m_nFile, 0) || !syncFile(m_nFile)) {
+        otErr << "OTMarketJournal::" << __FUNCTION__ << ": Failed clearing "
+              << m_strPath << "\n";
+        Close();
+        return false;
+    }
+
+    m_lSize = 0;
+    m_nCount = 0;
+
+    return true;
+}
+
+} // namespace opentxs
@@ -0,0 +1,231 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/trade/OTOrderBook.hpp>
+#include <opentxs/core/trade/OTOffer.hpp>
+#include <opentxs/core/Log.hpp>
+
+namespace opentxs
+{
+
+namespace
+{
+
+// Offer nodes are allocated this many at a time.
+const std::size_t POOL_CHUNK_SIZE = 256;
+
+} // namespace
+
+OTOrderBook::const_iterator& OTOrderBook::const_iterator::operator++()
+{
+    node_ = node_->next;
+
+    if (nullptr == node_) NextLevel();
+
+    return *this;
+}
+
+void OTOrderBook::const_iterator::NextLevel()
+{
+    ++level_;
+    node_ = (level_ == end_) ? nullptr : level_->second.head;
+}
+
+OTOrderBook::OTOrderBook(bool bBids)
+    : m_mapLevels(PriceOrder(bBids))
+    , m_lTotalQuantity(0)
+    , m_pFreeNodes(nullptr)
+{
+}
+
+OTOrderBook::~OTOrderBook()
+{
+}
+
+OTOrderBook::Node* OTOrderBook::allocateNode()
+{
+    if (nullptr == m_pFreeNodes) {
+        std::unique_ptr<Node[]> pChunk(new Node[POOL_CHUNK_SIZE]);
+
+        for (std::size_t i = 0; i < POOL_CHUNK_SIZE; ++i) {
+            pChunk[i].next = m_pFreeNodes;
+            m_pFreeNodes = &pChunk[i];
+        }
+
+        m_vecPool.push_back(std::move(pChunk));
+    }
+
+    Node* pNode = m_pFreeNodes;
+    m_pFreeNodes = pNode->next;
+
+    return pNode;
+}
+
+void OTOrderBook::releaseNode(Node* pNode)
+{
+    pNode->offer = nullptr;
+    pNode->level = nullptr;
+    pNode->prev = nullptr;
+    pNode->next = m_pFreeNodes;
+    m_pFreeNodes = pNode;
+}
+
+bool OTOrderBook::Add(OTOffer& theOffer)
+{
+    const int64_t lTransactionNum = theOffer.GetTransactionNum();
+
+    if (m_mapNodes.end() != m_mapNodes.find(lTransactionNum)) {
+        otErr << "OTOrderBook::Add: Offer with transaction number "
+              << lTransactionNum << " is already on the book.\n";
+        return false;
+    }
+
+    const int64_t lPrice = theOffer.GetPriceLimit();
+    Level& theLevel = m_mapLevels[lPrice];
+    Node* pNode = allocateNode();
+
+    theLevel.price = lPrice;
+
+    pNode->offer = &theOffer;
+    pNode->amount = theOffer.GetAmountAvailable();
+    pNode->level = &theLevel;
+    pNode->prev = theLevel.tail;
+    pNode->next = nullptr;
+
+    if (nullptr == theLevel.tail)
+        theLevel.head = pNode;
+    else
+        theLevel.tail->next = pNode;
+
+    theLevel.tail = pNode;
+    theLevel.quantity += pNode->amount;
+    ++theLevel.count;
+
+    m_lTotalQuantity += pNode->amount;
+    m_mapNodes[lTransactionNum] = pNode;
+
+    return true;
+}
+
+OTOffer* OTOrderBook::Remove(const int64_t& lTransactionNum)
+{
+    auto it = m_mapNodes.find(lTransactionNum);
+
+    if (m_mapNodes.end() == it) return nullptr;
+
+    Node* pNode = it->second;
+    Level* pLevel = pNode->level;
+    OTOffer* pOffer = pNode->offer;
+
+    OT_ASSERT(nullptr != pLevel);
+    OT_ASSERT(nullptr != pOffer);
+
+    m_mapNodes.erase(it);
+
+    if (nullptr == pNode->prev)
+        pLevel->head = pNode->next;
+    else
+        pNode->prev->next = pNode->next;
+
+    if (nullptr == pNode->next)
+        pLevel->tail = pNode->prev;
+    else
+        pNode->next->prev = pNode->prev;
+
+    pLevel->quantity -= pNode->amount;
+    m_lTotalQuantity -= pNode->amount;
+
+    if (0 == --pLevel->count) {
+        const int64_t lPrice = pLevel->price;
+        m_mapLevels.erase(lPrice);
+    }
+
+    releaseNode(pNode);
+
+    return pOffer;
+}
+
+void OTOrderBook::Update(const OTOffer& theOffer)
+{
+    auto it = m_mapNodes.find(theOffer.GetTransactionNum());
+
+    if (m_mapNodes.end() == it) return;
+
+    Node* pNode = it->second;
+
+    OT_ASSERT(&theOffer == pNode->offer);
+
+    const int64_t lAmount = theOffer.GetAmountAvailable();
+    const int64_t lChange = lAmount - pNode->amount;
+
+    pNode->amount = lAmount;
+    pNode->level->quantity += lChange;
+    m_lTotalQuantity += lChange;
+}
+
+void OTOrderBook::Clear()
+{
+    for (auto& it : m_mapNodes) releaseNode(it.second);
+
+    m_mapNodes.clear();
+    m_mapLevels.clear();
+    m_lTotalQuantity = 0;
+}
+
+int64_t OTOrderBook::GetBestPrice() const
+{
+    auto it = m_mapLevels.begin();
+
+    // Market orders have a 0 price. They sort first among the asks, where
+    // they would undercut the real prices, so skip them. (Among the bids
+    // they sort last.)
+    if ((m_mapLevels.end() != it) && (0 == it->first)) ++it;
+
+    return (m_mapLevels.end() == it) ? 0 : it->first;
+}
+
+int64_t OTOrderBook::GetQuantityAtPrice(const int64_t& lPrice) const
+{
+    auto it = m_mapLevels.find(lPrice);
+
+    return (m_mapLevels.end() == it) ? 0 : it->second.quantity;
+}
+
+} // namespace opentxs
@@ -513,7 +513,7 @@ OTOffer* OTTrade::GetOffer(Identifier* offerMarketId, OTMarket** market)
             offer_->SignContract(*(GetCron()->GetServerNym()));
             offer_->SaveContract();
 
-            pMarket->SaveMarket();
+            pMarket->SaveOffer(*offer_);
 
             // Now when the market loads next time, it can verify this offer
             // using the server's signature,
@@ -580,7 +580,7 @@ OTOffer* OTTrade::GetOffer(Identifier* offerMarketId, OTMarket** market)
                 offer_->SignContract(*(GetCron()->GetServerNym()));
                 offer_->SaveContract();
 
-                pMarket->SaveMarket();
+                pMarket->SaveOffer(*offer_);
 
                 // Now when the market loads next time, it can verify this offer
                 // using the server's signature,
@@ -1034,6 +1034,24 @@ void OTTrade::onFinalReceipt(OTCronItem& origCronItem,
     // in the first place.
 }
 
+// Matching can touch any trader on the market, so the market ID stands in
+// for all of them. (OTCron adds their accounts and Nyms.) Until the offer is
+// on a market (stop orders, or the first time around) the market may still
+// have to be created, so the trade is processed on its own.
+bool OTTrade::GetCronKeys(std::set<std::string>& keys) const
+{
+    if (nullptr == offer_) return false;
+
+    const Identifier MARKET_ID(*offer_);
+
+    keys.insert(String(MARKET_ID).Get());
+    keys.insert(String(GetSenderAcctID()).Get());
+    keys.insert(String(GetCurrencyAcctID()).Get());
+    keys.insert(String(GetSenderNymID()).Get());
+
+    return true;
+}
+
 // OTCron calls this regularly, which is my chance to expire, etc.
 // Return True if I should stay on the Cron list for more processing.
 // Return False if I should be removed and deleted.
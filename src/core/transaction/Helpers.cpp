@@ -310,6 +310,22 @@ OTTransaction* LoadBoxReceipt(OTTransaction& theAbbrev, int64_t lLedgerType)
     // Then, try to load the transaction from that string and see if successful.
     // If it verifies, then return it. Otherwise return nullptr.
 
+    String strRawFile;
+
+    if (!LoadBoxReceiptString(theAbbrev, lLedgerType, strRawFile))
+        return nullptr;
+
+    return LoadBoxReceiptFromString(theAbbrev, strRawFile);
+}
+
+// Reads the box receipt for theAbbrev out of local storage, without parsing
+// it. (Storage batches are per-thread, so this has to run on the thread that
+// would otherwise load the receipt.)
+bool LoadBoxReceiptString(OTTransaction& theAbbrev, int64_t lLedgerType,
+                          String& strRawFile)
+{
+    strRawFile.Release();
+
     // Can only load abbreviated transactions (so they'll become their full
     // form.)
     //
@@ -318,7 +334,7 @@ OTTransaction* LoadBoxReceipt(OTTransaction& theAbbrev, int64_t lLedgerType)
               << theAbbrev.GetTransactionNum()
               << ": "
                  "(Because argument 'theAbbrev' wasn't abbreviated.)\n";
-        return nullptr;
+        return false;
     }
 
     // Next, see if the appropriate file exists, and load it up from
@@ -330,7 +346,7 @@ OTTransaction* LoadBoxReceipt(OTTransaction& theAbbrev, int64_t lLedgerType)
             lLedgerType, theAbbrev,
             __FUNCTION__, // "OTTransaction::LoadBoxReceipt",
             strFolder1name, strFolder2name, strFolder3name, strFilename))
-        return nullptr; // This already logs -- no need to log twice, here.
+        return false; // This already logs -- no need to log twice, here.
 
     // See if the box receipt exists before trying to load it...
     //
@@ -340,7 +356,7 @@ OTTransaction* LoadBoxReceipt(OTTransaction& theAbbrev, int64_t lLedgerType)
                << ": Box receipt does not exist: " << strFolder1name
                << Log::PathSeparator() << strFolder2name << Log::PathSeparator()
                << strFolder3name << Log::PathSeparator() << strFilename << "\n";
-        return nullptr;
+        return false;
     }
 
     // Try to load the box receipt from local storage.
@@ -352,30 +368,35 @@ OTTransaction* LoadBoxReceipt(OTTransaction& theAbbrev, int64_t lLedgerType)
         otErr << __FUNCTION__ << ": Error reading file: " << strFolder1name
               << Log::PathSeparator() << strFolder2name << Log::PathSeparator()
               << strFolder3name << Log::PathSeparator() << strFilename << "\n";
-        return nullptr;
+        return false;
     }
 
-    String strRawFile(strFileContents.c_str());
+    strRawFile.Set(strFileContents.c_str());
 
     if (!strRawFile.Exists()) {
         otErr << __FUNCTION__ << ": Error reading file (resulting output "
                                  "string is empty): " << strFolder1name
               << Log::PathSeparator() << strFolder2name << Log::PathSeparator()
               << strFolder3name << Log::PathSeparator() << strFilename << "\n";
-        return nullptr;
+        return false;
     }
 
-    // Finally, try to load the transaction from that string and see if
-    // successful.
-    //
+    return true;
+}
+
+// Instantiates the full box receipt from strRawFile and verifies it against
+// theAbbrev, its abbreviated version. Only reads theAbbrev, so receipts of
+// the same ledger can be verified on different threads.
+OTTransaction* LoadBoxReceiptFromString(const OTTransaction& theAbbrev,
+                                        const String& strRawFile)
+{
     OTTransactionType* pTransType =
         OTTransactionType::TransactionFactory(strRawFile);
 
     if (nullptr == pTransType) {
         otErr << __FUNCTION__ << ": Error instantiating transaction "
-                                 "type based on strRawFile: " << strFolder1name
-              << Log::PathSeparator() << strFolder2name << Log::PathSeparator()
-              << strFolder3name << Log::PathSeparator() << strFilename << "\n";
+                                 "type for box receipt: "
+              << theAbbrev.GetTransactionNum() << "\n";
         return nullptr;
     }
 
@@ -384,9 +405,8 @@ OTTransaction* LoadBoxReceipt(OTTransaction& theAbbrev, int64_t lLedgerType)
     if (nullptr == pBoxReceipt) {
         otErr << __FUNCTION__
               << ": Error dynamic_cast from transaction "
-                 "type to transaction, based on strRawFile: " << strFolder1name
-              << Log::PathSeparator() << strFolder2name << Log::PathSeparator()
-              << strFolder3name << Log::PathSeparator() << strFilename << "\n";
+                 "type to transaction, for box receipt: "
+              << theAbbrev.GetTransactionNum() << "\n";
         delete pTransType;
         pTransType = nullptr; // cleanup!
         return nullptr;
@@ -401,20 +421,16 @@ OTTransaction* LoadBoxReceipt(OTTransaction& theAbbrev, int64_t lLedgerType)
     bool bSuccess = theAbbrev.VerifyBoxReceipt(*pBoxReceipt);
 
     if (!bSuccess) {
-        otErr << __FUNCTION__ << ": Failed verifying Box Receipt:\n"
-              << strFolder1name << Log::PathSeparator() << strFolder2name
-              << Log::PathSeparator() << strFolder3name << Log::PathSeparator()
-              << strFilename << "\n";
+        otErr << __FUNCTION__ << ": Failed verifying Box Receipt: "
+              << theAbbrev.GetTransactionNum() << "\n";
 
         delete pBoxReceipt;
         pBoxReceipt = nullptr;
         return nullptr;
     }
     else
-        otInfo << __FUNCTION__ << ": Successfully loaded Box Receipt in:\n"
-               << strFolder1name << Log::PathSeparator() << strFolder2name
-               << Log::PathSeparator() << strFolder3name << Log::PathSeparator()
-               << strFilename << "\n";
+        otInfo << __FUNCTION__ << ": Successfully loaded Box Receipt: "
+               << theAbbrev.GetTransactionNum() << "\n";
 
     // Todo: security analysis. By this point we've verified the hash of the
     // transaction against the stored
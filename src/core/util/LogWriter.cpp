@@ -0,0 +1,253 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/util/LogWriter.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+// Upper bound on a single batch, so one slow file write doesn't hold
+// m_drainLock (and any thread waiting in Flush) for too long.
+#define LOG_BATCH_BYTES 65536
+// How long the writer sleeps when the ring is empty, in case a wakeup is
+// missed.
+#define LOG_IDLE_WAIT_MS 50
+
+namespace opentxs
+{
+
+namespace
+{
+size_t RoundUpPowerOfTwo(size_t value)
+{
+    size_t result = 2;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+std::string RotatedName(const std::string& strPath, int32_t nIndex)
+{
+    return strPath + "." + std::to_string(nIndex);
+}
+} // namespace
+
+LogWriter::LogWriter(const std::string& strPath, size_t capacity)
+    : m_strPath(strPath)
+    , m_mask(RoundUpPowerOfTwo(capacity) - 1)
+    , m_slots(new Slot[m_mask + 1])
+    , m_enqueuePos(0)
+    , m_dequeuePos(0)
+    , m_lFileSize(0)
+    , m_lMaxFileSize(0)
+    , m_nFileCount(1)
+    , m_bStopping(false)
+{
+    for (size_t i = 0; i <= m_mask; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    {
+        std::ifstream existing(m_strPath, std::ios::ate | std::ios::binary);
+        if (existing.good()) m_lFileSize = existing.tellg();
+    }
+    m_file.open(m_strPath, std::ios::app);
+
+    m_thread = std::thread(&LogWriter::Run, this);
+}
+
+LogWriter::~LogWriter()
+{
+    m_bStopping.store(true);
+    m_wake.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+
+    Flush();
+    m_file.close();
+}
+
+void LogWriter::SetRotation(int64_t lMaxFileSize, int32_t nFileCount)
+{
+    m_lMaxFileSize.store(lMaxFileSize > 0 ? lMaxFileSize : 0);
+    m_nFileCount.store(nFileCount > 0 ? nFileCount : 1);
+}
+
+// Bounded multi-producer queue: each slot's sequence number tells producers
+// whether it is free for the position they claimed, and tells the consumer
+// whether the line in it has been published yet.
+void LogWriter::Push(std::string strLine)
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+    while (true) {
+        Slot& slot = m_slots[pos & m_mask];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const int64_t diff =
+            static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+
+        if (0 == diff) {
+            if (m_enqueuePos.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed)) {
+                slot.line.swap(strLine);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                m_wake.notify_one();
+                return;
+            }
+        }
+        else if (diff < 0) {
+            // The ring is full. Drain it here if the writer is busy elsewhere
+            // (or already stopped), otherwise give it a chance to catch up.
+            std::unique_lock<std::mutex> lock(m_drainLock, std::try_to_lock);
+            if (lock.owns_lock())
+                Drain();
+            else
+                std::this_thread::yield();
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+        else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool LogWriter::Pop(std::string& strLine)
+{
+    Slot& slot = m_slots[m_dequeuePos & m_mask];
+    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+    if (sequence != m_dequeuePos + 1) return false; // Empty (or unpublished.)
+
+    strLine.swap(slot.line);
+    slot.line.clear();
+    slot.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+    ++m_dequeuePos;
+
+    return true;
+}
+
+bool LogWriter::Drain()
+{
+    std::string strBatch, strLine;
+
+    while ((strBatch.size() < LOG_BATCH_BYTES) && Pop(strLine)) {
+        strBatch += strLine;
+    }
+
+    if (strBatch.empty()) return false;
+
+    Write(strBatch);
+
+    return true;
+}
+
+void LogWriter::Write(const std::string& strBatch)
+{
+    std::cerr.write(strBatch.data(), strBatch.size());
+
+    const int64_t lMaxFileSize = m_lMaxFileSize.load();
+    const int64_t lBatchSize = static_cast<int64_t>(strBatch.size());
+
+    if ((0 < lMaxFileSize) && (0 < m_lFileSize) &&
+        (lMaxFileSize < m_lFileSize + lBatchSize)) {
+        Rotate();
+    }
+
+    if (!m_file.is_open()) return;
+
+    m_file.write(strBatch.data(), strBatch.size());
+    m_lFileSize += lBatchSize;
+}
+
+void LogWriter::Rotate()
+{
+    const int32_t nFileCount = m_nFileCount.load();
+
+    m_file.close();
+
+    std::remove(RotatedName(m_strPath, nFileCount).c_str());
+    for (int32_t i = nFileCount - 1; i > 0; --i) {
+        std::rename(RotatedName(m_strPath, i).c_str(),
+                    RotatedName(m_strPath, i + 1).c_str());
+    }
+    std::rename(m_strPath.c_str(), RotatedName(m_strPath, 1).c_str());
+
+    m_file.clear();
+    m_file.open(m_strPath, std::ios::app);
+    m_lFileSize = 0;
+}
+
+void LogWriter::Flush()
+{
+    std::lock_guard<std::mutex> lock(m_drainLock);
+
+    while (Drain()) {
+    }
+
+    if (m_file.is_open()) m_file.flush();
+    std::cerr.flush();
+}
+
+void LogWriter::Run()
+{
+    bool bUnflushed = false;
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(m_drainLock);
+
+            if (Drain()) {
+                bUnflushed = true;
+                continue;
+            }
+
+            // Caught up: push what we have to the OS before sleeping, so the
+            // file doesn't lag behind a quiet server.
+            if (bUnflushed && m_file.is_open()) m_file.flush();
+            bUnflushed = false;
+        }
+
+        if (m_bStopping.load()) return;
+
+        std::unique_lock<std::mutex> lock(m_wakeLock);
+        m_wake.wait_for(lock, std::chrono::milliseconds(LOG_IDLE_WAIT_MS));
+    }
+}
+
+} // namespace opentxs
@@ -0,0 +1,176 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/util/XMLWriter.hpp>
+#include <opentxs/core/util/Assert.hpp>
+
+#include <algorithm>
+
+namespace opentxs
+{
+
+XMLWriter::XMLWriter(std::string& str_output)
+    : output_(str_output)
+    , pending_(false)
+{
+}
+
+void XMLWriter::open(const std::string& str_name)
+{
+    if (!elements_.empty()) {
+        OT_ASSERT_MSG(!elements_.back().has_text,
+                      "XMLWriter: element already has text.");
+
+        start_content();
+    }
+
+    Element element;
+    element.name = str_name;
+    element.has_text = false;
+    element.has_content = false;
+
+    elements_.push_back(element);
+    attributes_.clear();
+    pending_ = true;
+}
+
+void XMLWriter::add_attribute(const std::string& str_att_name,
+                              const std::string& str_att_value)
+{
+    OT_ASSERT_MSG(pending_, "XMLWriter: start tag was already written.");
+
+    attributes_.push_back(std::make_pair(str_att_name, str_att_value));
+}
+
+void XMLWriter::add_attribute(const std::string& str_att_name,
+                              const char* sz_att_value)
+{
+    add_attribute(str_att_name, std::string(sz_att_value));
+}
+
+void XMLWriter::set_text(const std::string& str_text)
+{
+    OT_ASSERT(!elements_.empty());
+
+    // Like Tag, empty text means no text.
+    if (str_text.empty()) return;
+
+    OT_ASSERT_MSG(!elements_.back().has_content,
+                  "XMLWriter: element already has content.");
+
+    start_content();
+    output_ += str_text;
+    elements_.back().has_text = true;
+}
+
+void XMLWriter::set_text(const char* sz_text)
+{
+    OT_ASSERT(nullptr != sz_text);
+
+    set_text(std::string(sz_text));
+}
+
+void XMLWriter::add_tag(const std::string& str_tag_name,
+                        const std::string& str_tag_value)
+{
+    open(str_tag_name);
+    set_text(str_tag_value);
+    close();
+}
+
+void XMLWriter::close()
+{
+    OT_ASSERT(!elements_.empty());
+
+    if (pending_) {
+        write_start_tag();
+        output_ += " />\n";
+    }
+    else {
+        output_ += "\n</";
+        output_ += elements_.back().name;
+        output_ += ">\n";
+    }
+
+    elements_.pop_back();
+}
+
+// Writes the innermost start tag, if it's still pending, and marks the
+// element as having content.
+void XMLWriter::start_content()
+{
+    if (pending_) {
+        write_start_tag();
+        output_ += ">\n";
+    }
+
+    elements_.back().has_content = true;
+}
+
+void XMLWriter::write_start_tag()
+{
+    // Tag keeps its attributes in a std::map, so they come out sorted by
+    // name, and the first value added for a name wins.
+    std::stable_sort(attributes_.begin(), attributes_.end(),
+                     [](const std::pair<std::string, std::string>& lhs,
+                        const std::pair<std::string, std::string>& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    output_ += "<";
+    output_ += elements_.back().name;
+
+    const std::string* pLastName = nullptr;
+
+    for (auto& kv : attributes_) {
+        if ((nullptr != pLastName) && (*pLastName == kv.first)) continue;
+
+        output_ += "\n ";
+        output_ += kv.first;
+        output_ += "=\"";
+        output_ += kv.second;
+        output_ += "\"";
+
+        pLastName = &kv.first;
+    }
+
+    attributes_.clear();
+    pending_ = false;
+}
+
+} // namespace opentxs
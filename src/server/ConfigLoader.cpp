@@ -38,10 +38,14 @@
 
 #include <opentxs/server/ConfigLoader.hpp>
 #include <opentxs/server/ServerSettings.hpp>
+#include <opentxs/server/NymCache.hpp>
+#include <opentxs/cash/Mint.hpp>
+#include <opentxs/core/OTStorage.hpp>
 #include <opentxs/core/String.hpp>
 #include <opentxs/core/util/OTDataFolder.hpp>
 #include <opentxs/core/OTSettings.hpp>
 #include <opentxs/core/cron/OTCron.hpp>
+#include <opentxs/core/Ledger.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/crypto/OTCachedKey.hpp>
 #include <opentxs/core/crypto/OTKeyring.hpp>
@@ -99,6 +103,22 @@ bool ConfigLoader::load(String& walletFilename)
         Log::SetLogLevel(static_cast<int32_t>(lValue));
     }
 
+    // LOG ROTATION
+    {
+        const char* szComment = "; log_rotate_size is the size in bytes at "
+                                "which the log file is rotated.\n"
+                                "; 0 means never. log_rotate_count old files "
+                                "are kept.\n";
+
+        bool bIsNewKey;
+        int64_t lSize, lCount;
+        p_Config->CheckSet_long("logging", "log_rotate_size", 0, lSize,
+                                bIsNewKey, szComment);
+        p_Config->CheckSet_long("logging", "log_rotate_count", 5, lCount,
+                                bIsNewKey);
+        Log::SetLogRotation(lSize, static_cast<int32_t>(lCount));
+    }
+
     // WALLET
 
     // WALLET FILENAME
@@ -164,6 +184,20 @@ bool ConfigLoader::load(String& walletFilename)
         OTCron::SetCronMaxItemsPerNym(static_cast<int32_t>(lValue));
     }
 
+    {
+        const char* szComment = "; thread_count is the number of threads "
+                                "processing cron items at the same time.\n"
+                                "; Only items that share no account, Nym or "
+                                "market run in parallel. 1 means one at a "
+                                "time.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("cron", "thread_count", 1, lValue, bIsNewKey,
+                                szComment);
+        OTCron::SetCronThreadCount(static_cast<int32_t>(lValue));
+    }
+
     // HEARTBEAT
 
     {
@@ -197,6 +231,174 @@ bool ConfigLoader::load(String& walletFilename)
             static_cast<int32_t>(lValue));
     }
 
+    // WORKERS
+
+    {
+        const char* szComment = ";; WORKERS\n";
+
+        bool bSectionExist;
+        p_Config->CheckSetSection("workers", szComment, bSectionExist);
+    }
+
+    {
+        const char* szComment = "; thread_count is the number of threads "
+                                "processing client requests.\n"
+                                "; Requests from the same Nym are always "
+                                "processed in order. 0 means one per core.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("workers", "thread_count", 0, lValue,
+                                bIsNewKey, szComment);
+        ServerSettings::SetWorkerThreads(static_cast<int32_t>(lValue));
+    }
+
+    {
+        const char* szComment = "; box_receipt_threads is the number of "
+                                "threads verifying the box receipts of one "
+                                "inbox, outbox or nymbox.\n"
+                                "; 1 means one at a time.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("workers", "box_receipt_threads", 1, lValue,
+                                bIsNewKey, szComment);
+        Ledger::SetBoxReceiptThreadCount(static_cast<int32_t>(lValue));
+    }
+
+    {
+        const char* szComment = "; token_threads is the number of threads "
+                                "signing or verifying the cash tokens of one "
+                                "withdrawal or deposit.\n"
+                                "; 1 means one at a time.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("workers", "token_threads", 1, lValue,
+                                bIsNewKey, szComment);
+        Mint::SetTokenThreadCount(static_cast<int32_t>(lValue));
+    }
+
+    // NYM CACHE
+
+    {
+        const char* szComment = ";; NYM CACHE  (verified Nyms kept in memory "
+                                "between requests)\n";
+
+        bool bSectionExist;
+        p_Config->CheckSetSection("nym_cache", szComment, bSectionExist);
+    }
+
+    {
+        const char* szComment = "; size is the maximum number of Nyms in the "
+                                "cache. 0 disables it.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("nym_cache", "size",
+                                ServerSettings::GetNymCacheSize(), lValue,
+                                bIsNewKey, szComment);
+        ServerSettings::SetNymCacheSize(static_cast<int32_t>(lValue));
+    }
+
+    {
+        const char* szComment =
+            "; flush_policy decides when deferred nymfile saves are written:\n"
+            "; sync     : when the request finishes.\n"
+            "; group    : once group_size nymfiles are waiting.\n"
+            "; periodic : every flush_ms milliseconds.\n"
+            "; (Always before cron, and before any command that isn't "
+            "Nym-local.)\n";
+
+        bool bIsNewKey;
+        String strValue;
+        p_Config->CheckSet_str("nym_cache", "flush_policy", "sync", strValue,
+                               bIsNewKey, szComment);
+
+        if (strValue.Compare("group"))
+            ServerSettings::SetNymCacheFlushPolicy(NymCache::FLUSH_GROUP);
+        else if (strValue.Compare("periodic"))
+            ServerSettings::SetNymCacheFlushPolicy(NymCache::FLUSH_PERIODIC);
+        else
+            ServerSettings::SetNymCacheFlushPolicy(NymCache::FLUSH_SYNC);
+    }
+
+    {
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("nym_cache", "group_size",
+                                ServerSettings::GetNymCacheGroupSize(), lValue,
+                                bIsNewKey);
+        ServerSettings::SetNymCacheGroupSize(static_cast<int32_t>(lValue));
+    }
+
+    {
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("nym_cache", "flush_ms",
+                                ServerSettings::GetNymCacheFlushMs(), lValue,
+                                bIsNewKey);
+        ServerSettings::SetNymCacheFlushMs(static_cast<int32_t>(lValue));
+    }
+
+    // STATS
+
+    {
+        const char* szComment =
+            ";; STATS  (request counts and latencies per command)\n"
+            "; snapshot_seconds is how often they are written to stats.xml "
+            "in the data folder. 0 disables the file.\n";
+
+        bool bSectionExist;
+        p_Config->CheckSetSection("stats", szComment, bSectionExist);
+    }
+
+    {
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("stats", "snapshot_seconds",
+                                ServerSettings::GetStatsSnapshotSeconds(),
+                                lValue, bIsNewKey);
+        ServerSettings::SetStatsSnapshotSeconds(static_cast<int32_t>(lValue));
+    }
+
+    // STORAGE
+
+    {
+        const char* szComment =
+            ";; STORAGE\n"
+            "; type is where the server keeps its data:\n"
+            "; filesystem : one file per object in the data folder.\n"
+            "; keyvalue   : a single transactional file in the data folder.\n"
+            "; If import is true, an empty key/value file is filled from the\n"
+            "; data folder at startup. (Migrating from filesystem storage.)\n"
+            "; An import that was interrupted is started again.\n";
+
+        bool bSectionExist;
+        p_Config->CheckSetSection("storage", szComment, bSectionExist);
+    }
+
+    {
+        bool bIsNewKey;
+        String strValue;
+        p_Config->CheckSet_str("storage", "type", "filesystem", strValue,
+                               bIsNewKey);
+
+        if (strValue.Compare("keyvalue"))
+            ServerSettings::SetStorageType(OTDB::STORE_KEY_VALUE);
+        else
+            ServerSettings::SetStorageType(OTDB::STORE_FILESYSTEM);
+    }
+
+    {
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("storage", "import",
+                                ServerSettings::GetStorageImport(), bValue,
+                                bIsNewKey);
+        ServerSettings::SetStorageImport(bValue);
+    }
+
     // PERMISSIONS
 
     {
@@ -365,6 +567,8 @@ bool ConfigLoader::load(String& walletFilename)
                              ServerSettings::__cmd_get_market_offers);
     p_Config->SetOption_bool("permissions", "cmd_get_market_recent_trades",
                              ServerSettings::__cmd_get_market_recent_trades);
+    p_Config->SetOption_bool("permissions", "cmd_get_market_candles",
+                             ServerSettings::__cmd_get_market_candles);
     p_Config->SetOption_bool("permissions", "cmd_get_nym_market_offers",
                              ServerSettings::__cmd_get_nym_market_offers);
     p_Config->SetOption_bool("permissions", "transact_market_offer",
@@ -377,6 +581,8 @@ bool ConfigLoader::load(String& walletFilename)
                              ServerSettings::__transact_smart_contract);
     p_Config->SetOption_bool("permissions", "cmd_trigger_clause",
                              ServerSettings::__cmd_trigger_clause);
+    p_Config->SetOption_bool("permissions", "cmd_get_server_stats",
+                             ServerSettings::__cmd_get_server_stats);
 
     // Done Loading... Lets save any changes...
     if (!p_Config->Save()) {
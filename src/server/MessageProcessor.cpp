@@ -40,6 +40,7 @@
 #include <opentxs/server/ServerLoader.hpp>
 #include <opentxs/server/MessageProcessor.hpp>
 #include <opentxs/server/OTServer.hpp>
+#include <opentxs/server/ServerStats.hpp>
 #include <opentxs/server/ClientConnection.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Message.hpp>
@@ -51,23 +52,42 @@
 
 #include <czmq.h>
 
+#include <chrono>
+
 namespace opentxs
 {
 
+namespace
+{
+
+// Workers push finished replies here; the polling thread forwards them to
+// the ROUTER socket.
+const char* REPLY_ENDPOINT = "inproc://opentxs-notary-replies";
+
+// Cron items processed per turn on the exclusive side of the notary lock.
+const int32_t CRON_ITEMS_PER_SLICE = 100;
+
+} // namespace
+
 MessageProcessor::MessageProcessor(ServerLoader& loader)
     : server_(loader.getServer())
-    , zmqSocket_(zsock_new_rep(NULL))
+    , zmqSocket_(zsock_new_router(NULL))
+    , replySocket_(zsock_new_pull(NULL))
     , zmqAuth_(zactor_new(zauth, NULL))
-    , zmqPoller_(zpoller_new(zmqSocket_, NULL))
+    , zmqPoller_(zpoller_new(zmqSocket_, replySocket_, NULL))
+    , shutdown_(false)
 {
     init(loader.getPort(), loader.getTransportKey());
 }
 
 MessageProcessor::~MessageProcessor()
 {
+    stopThreads();
+    zpoller_remove(zmqPoller_, replySocket_);
     zpoller_remove(zmqPoller_, zmqSocket_);
     zpoller_destroy(&zmqPoller_);
     zactor_destroy(&zmqAuth_);
+    zsock_destroy(&replySocket_);
     zsock_destroy(&zmqSocket_);
 }
 
@@ -86,24 +106,63 @@ void MessageProcessor::init(int port, zcert_t* transportKey)
     zsock_set_curve_server(zmqSocket_, 1);
     zcert_apply(transportKey, zmqSocket_);
     zsock_bind(zmqSocket_, "tcp://*:%d", port);
+    // inproc needs the bind to happen before the workers connect.
+    zsock_bind(replySocket_, "%s", REPLY_ENDPOINT);
+}
+
+void MessageProcessor::startThreads()
+{
+    int32_t count = ServerSettings::GetWorkerThreads();
+    if (count <= 0)
+        count = static_cast<int32_t>(std::thread::hardware_concurrency());
+    if (count <= 0) count = 1;
+
+    Log::vOutput(0, "MessageProcessor: Starting %d worker threads.\n", count);
+
+    for (int32_t i = 0; i < count; ++i) {
+        workers_.push_back(std::thread(&MessageProcessor::workerLoop, this));
+    }
+    cronThread_ = std::thread(&MessageProcessor::cronLoop, this);
+}
+
+void MessageProcessor::stopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        shutdown_ = true;
+    }
+    queueCondition_.notify_all();
+    cronCondition_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+    workers_.clear();
+    if (cronThread_.joinable()) cronThread_.join();
+
+    // Nobody is left to answer these.
+    for (auto& request : queue_) {
+        zframe_destroy(&request.body);
+        zmsg_destroy(&request.envelope);
+    }
+    queue_.clear();
 }
 
 void MessageProcessor::run()
 {
+    startThreads();
+
     for (;;) {
-        // timeout is the time left until the next cron should execute.
-        int64_t timeout = server_->computeTimeout();
-        if (timeout <= 0) {
-            server_->ProcessCron();
-            continue;
-        }
+        void* socket = zpoller_wait(zmqPoller_, -1);
 
-        // wait for incoming message or up to timeout,
-        // i.e. stop polling in time for the next cron execution.
-        if (zpoller_wait(zmqPoller_, timeout)) {
+        if (zmqSocket_ == socket) {
             processSocket();
             continue;
         }
+        if (replySocket_ == socket) {
+            processReply();
+            continue;
+        }
         if (zpoller_terminated(zmqPoller_)) {
             otErr << __FUNCTION__
                   << ": zpoller_terminated - process interrupted or"
@@ -117,59 +176,187 @@ void MessageProcessor::run()
             Log::SleepMilliseconds(100);
         }
     }
+
+    stopThreads();
 }
 
 void MessageProcessor::processSocket()
 {
-    char* msg = zstr_recv(zmqSocket_);
+    zmsg_t* msg = zmsg_recv(zmqSocket_);
     if (msg == nullptr) {
         Log::Error("zeromq recv() failed\n");
         return;
     }
-    std::string requestString(msg);
-    zstr_free(&msg);
 
-    std::string responseString;
+    // The last frame is the request itself. Whatever precedes it is the
+    // routing envelope, which goes back out unchanged with the reply.
+    zframe_t* body = zmsg_last(msg);
+    if (body == nullptr) {
+        zmsg_destroy(&msg);
+        return;
+    }
+
+    Request request;
+    zmsg_remove(msg, body);
+    request.body = body;
+    request.envelope = msg;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        // Taken with the queue locked, so tickets follow the queue order.
+        request.ticket = nymLocks_.takeTicket();
+        queue_.push_back(request);
+    }
+    queueCondition_.notify_one();
+}
+
+void MessageProcessor::processReply()
+{
+    zmsg_t* msg = zmsg_recv(replySocket_);
+    if (msg == nullptr) {
+        Log::Error("MessageProcessor: failed to receive reply from worker\n");
+        return;
+    }
+
+    if (zmsg_send(&msg, zmqSocket_) != 0) {
+        Log::Error("MessageProcessor: failed to send response\n");
+        zmsg_destroy(&msg);
+    }
+}
+
+void MessageProcessor::workerLoop()
+{
+    zsock_t* replySocket = zsock_new_push(NULL);
+    zsock_connect(replySocket, "%s", REPLY_ENDPOINT);
+
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueCondition_.wait(
+                lock, [this]() { return shutdown_ || !queue_.empty(); });
+            if (shutdown_) break;
+            request = queue_.front();
+            queue_.pop_front();
+        }
+
+        std::string responseString;
+
+        bool error = processMessage(
+            reinterpret_cast<const char*>(zframe_data(request.body)),
+            zframe_size(request.body), request.ticket, responseString);
 
-    bool error = processMessage(requestString, responseString);
+        if (error) {
+            responseString = "";
+        }
+
+        zmsg_addmem(request.envelope, responseString.data(),
+                    responseString.size());
+
+        if (zmsg_send(&request.envelope, replySocket) != 0) {
+            Log::vError("MessageProcessor: failed to queue response\n"
+                        "request:\n%.*s\n\n"
+                        "response:\n%s\n\n",
+                        static_cast<int>(zframe_size(request.body)),
+                        zframe_data(request.body), responseString.c_str());
+            zmsg_destroy(&request.envelope);
+        }
 
-    if (error) {
-        responseString = "";
+        zframe_destroy(&request.body);
     }
 
-    int rc = zstr_send(zmqSocket_, responseString.c_str());
+    zsock_destroy(&replySocket);
+}
+
+void MessageProcessor::cronLoop()
+{
+    std::unique_lock<std::mutex> lock(queueMutex_);
+
+    while (!shutdown_) {
+        lock.unlock();
+
+        // timeout is the time left until the next cron should execute.
+        int64_t timeout = 0;
+        {
+            SharedNotaryLock notary(notaryLock_);
+            timeout = server_->computeTimeout();
+            server_->nymCache_.FlushIfDue();
+        }
+        server_->stats_.SaveIfDue();
+        // The pass is split into slices, and clients get their turn in
+        // between. (See NotaryLock.)
+        for (bool bDone = (timeout > 0); !bDone;) {
+            ExclusiveNotaryLock notary(notaryLock_, true);
+            server_->nymCache_.Flush();
+            bDone = server_->ProcessCron(CRON_ITEMS_PER_SLICE);
+        }
+
+        // Wake up in time for the next periodic nymfile flush.
+        if ((NymCache::FLUSH_PERIODIC ==
+             ServerSettings::GetNymCacheFlushPolicy()) &&
+            (timeout > ServerSettings::GetNymCacheFlushMs())) {
+            timeout = ServerSettings::GetNymCacheFlushMs();
+        }
 
-    if (rc != 0) {
-        Log::vError("MessageProcessor: failed to send response\n"
-                    "request:\n%s\n\n"
-                    "response:\n%s\n\n",
-                    requestString.c_str(), responseString.c_str());
+        lock.lock();
+        if (timeout > 0) {
+            cronCondition_.wait_for(lock, std::chrono::milliseconds(timeout),
+                                    [this]() { return shutdown_; });
+        }
     }
 }
 
-bool MessageProcessor::processMessage(const std::string& messageString,
-                                      std::string& reply)
+// data and size are the request frame. It is decoded (or, in the binary
+// form, parsed) straight from there, and the loaded message takes over the
+// decoded text rather than copying it.
+bool MessageProcessor::processMessage(const char* data, size_t size,
+                                      uint64_t ticket, std::string& reply)
 {
-    if (messageString.size() < 1) return false;
+    if (size < 1) {
+        nymLocks_.skip(ticket);
+        return false;
+    }
 
-    // First we grab the client's message
-    OTASCIIArmor ascMessage;
-    ascMessage.MemSet(messageString.data(), messageString.size());
+    ServerStats::Request stats(server_->stats_);
 
-    String messageContents;
-    ascMessage.GetString(messageContents);
-    // All decrypted--now let's load the results into an OTMessage.
-    // No need to call message.ParseRawFile() after, since
-    // LoadContractFromString handles it.
+    // Clients that speak the binary form get their reply in it too.
+    const bool bBinary = Message::IsBinary(data, size);
     Message message;
-    if (!messageContents.Exists() ||
-        !message.LoadContractFromString(messageContents)) {
-        Log::vError("Error loading message from message "
-                    "contents:\n\n%s\n\n",
-                    messageContents.Get());
-        return true;
+
+    {
+        ServerStats::Timer timer(ServerStats::PHASE_PARSE);
+
+        if (bBinary) {
+            if (!message.LoadBinary(data, size)) {
+                Log::vError("Error loading message from %" PRI_SIZE
+                            " bytes of binary message contents.\n",
+                            size);
+                stats.SetFailed();
+                nymLocks_.skip(ticket);
+                return true;
+            }
+        }
+        else {
+            // First we grab the client's message
+            std::string messageContents;
+            OTASCIIArmor::DecodeString(data, size, messageContents);
+            // All decrypted--now let's load the results into an OTMessage.
+            // No need to call message.ParseRawFile() after, since
+            // LoadContractFromString handles it.
+            if (messageContents.empty() ||
+                !message.LoadContractFromString(String(messageContents))) {
+                Log::vError("Error loading message from message "
+                            "contents:\n\n%s\n\n",
+                            messageContents.c_str());
+                stats.SetFailed();
+                nymLocks_.skip(ticket);
+                return true;
+            }
+        }
     }
 
+    stats.SetCommand(message.m_strCommand);
+
     Message replyMessage;
     replyMessage.m_strCommand.Format("%sResponse", message.m_strCommand.Get());
     // NymID
@@ -179,16 +366,12 @@ bool MessageProcessor::processMessage(const std::string& messageString,
     // The default reply. In fact this is probably superfluous
     replyMessage.m_bSuccess = false;
 
-    ClientConnection client;
-    Nym nym(message.m_strNymID);
+    bool processedUserCmd = processCommand(message, replyMessage, ticket);
 
-    bool processedUserCmd = server_->userCommandProcessor_.ProcessUserCommand(
-        message, replyMessage, &client, &nym);
+    if (!processedUserCmd || !replyMessage.m_bSuccess) stats.SetFailed();
+
+    ServerStats::Timer timer(ServerStats::PHASE_SIGN);
 
-    // By optionally passing in &client, the client Nym's public
-    // key will be set on it whenever verification is complete. (So
-    // for the reply, I'll  have the key and thus I'll be able to
-    // encrypt reply to the recipient.)
     if (!processedUserCmd) {
         String s1(message);
 
@@ -230,6 +413,8 @@ bool MessageProcessor::processMessage(const std::string& messageString,
                      message.m_strCommand.Get());
     }
 
+    if (bBinary && replyMessage.SaveBinary(reply)) return false;
+
     String replyString(replyMessage);
 
     if (!replyString.Exists()) {
@@ -239,18 +424,53 @@ bool MessageProcessor::processMessage(const std::string& messageString,
         return true;
     }
 
-    OTASCIIArmor ascReply(replyString);
-
-    if (!ascReply.Exists()) {
-        Log::vOutput(0, "Unable to WriteArmoredString from "
-                        "OTASCIIArmor object into OTString object. (No reply "
+    // Armored straight into the reply.
+    if (!OTASCIIArmor::EncodeString(replyString.Get(), replyString.GetLength(),
+                                    reply)) {
+        Log::vOutput(0, "Unable to armor the reply. (No reply "
                         "message will be sent.)\n");
         return true;
     }
 
-    reply.assign(ascReply.Get(), ascReply.GetLength());
-
     return false;
 }
 
+bool MessageProcessor::processCommand(Message& message, Message& reply,
+                                      uint64_t ticket)
+{
+    ClientConnection client;
+    Nym nym(message.m_strNymID);
+    const std::string nymID = message.m_strNymID.Get();
+
+    // The server Nym is shared by every request (it signs all the replies),
+    // so anything it sends as a client runs exclusively.
+    const bool exclusive =
+        !UserCommandProcessor::IsNymLocalCommand(message.m_strCommand) ||
+        server_->m_strServerNymID.Compare(message.m_strNymID);
+
+    // The Nym's turn comes first. Taking the notary lock first could
+    // deadlock: a later request holding the shared side would wait for this
+    // Nym, while this one waited for the exclusive side.
+    NymGuard guard(nymLocks_, ticket, nymID);
+
+    // By optionally passing in &client, the client Nym's public
+    // key will be set on it whenever verification is complete. (So
+    // for the reply, I'll  have the key and thus I'll be able to
+    // encrypt reply to the recipient.)
+    if (exclusive) {
+        ExclusiveNotaryLock notary(notaryLock_);
+
+        // Exclusive commands may load any Nym straight from storage.
+        server_->nymCache_.Flush();
+
+        return server_->userCommandProcessor_.ProcessUserCommand(
+            message, reply, &client, &nym);
+    }
+
+    SharedNotaryLock notary(notaryLock_);
+
+    return server_->userCommandProcessor_.ProcessUserCommand(message, reply,
+                                                             &client, &nym);
+}
+
 } // namespace opentxs
@@ -65,6 +65,8 @@
 #include <deque>
 #include <memory>
 #include <list>
+#include <map>
+#include <vector>
 
 namespace opentxs
 {
@@ -1071,6 +1073,11 @@ void Notary::NotarizeWithdrawal(Nym& theNym, Account& theAccount,
 
                 // Pull the token(s) out of the purse that was received from the
                 // client.
+                std::vector<Token*> theTokens;
+                std::vector<Account*> theReserveAccts;
+                std::map<Mint*, std::vector<size_t>> theTokensByMint;
+                bool bVerified = true;
+
                 while ((pToken = thePurse.Pop(server_->m_nymServer)) !=
                        nullptr) {
                     // We are responsible to cleanup pToken
@@ -1085,7 +1092,7 @@ void Notary::NotarizeWithdrawal(Nym& theNym, Account& theAccount,
                                     "find Mint (series %d): %s\n",
                                     pToken->GetSeries(),
                                     strInstrumentDefinitionID.Get());
-                        bSuccess = false;
+                        bVerified = false;
                         break; // Once there's a failure, we ditch the loop.
                     }
                     else if (nullptr ==
@@ -1096,7 +1103,7 @@ void Notary::NotarizeWithdrawal(Nym& theNym, Account& theAccount,
                             "reserve account for Mint (series %d): %s\n",
                             pToken->GetSeries(),
                             strInstrumentDefinitionID.Get());
-                        bSuccess = false;
+                        bVerified = false;
                         break; // Once there's a failure, we ditch the loop.
                     }
                     // Mints expire halfway into their token expiration period.
@@ -1114,124 +1121,143 @@ void Notary::NotarizeWithdrawal(Nym& theNym, Account& theAccount,
                             "withdrawal with an expired mint (series %d): %s\n",
                             pToken->GetSeries(),
                             strInstrumentDefinitionID.Get());
-                        bSuccess = false;
+                        bVerified = false;
                         break; // Once there's a failure, we ditch the loop.
                     }
-                    else {
-                        String theStringReturnVal;
+                    else if (pToken->GetInstrumentDefinitionID() !=
+                             INSTRUMENT_DEFINITION_ID) {
+                        const String str1(pToken->GetInstrumentDefinitionID()),
+                            str2(INSTRUMENT_DEFINITION_ID);
+                        Log::vError("%s: ERROR while signing token: "
+                                    "Expected instrument definition id "
+                                    "%s but found %s "
+                                    "instead. (Failure.)\n",
+                                    __FUNCTION__, str2.Get(), str1.Get());
+                        bVerified = false;
+                        break;
+                    }
+
+                    theTokensByMint[pMint].push_back(theTokens.size());
+                    theTokens.push_back(pToken);
+                    theReserveAccts.push_back(pMintCashReserveAcct);
+                } // While success popping token out of the purse...
+
+                // Each mint signs all of its tokens in one call, so it only
+                // opens each denomination's private key once, and can spread
+                // the tokens over several threads.
+                //
+                // TokenIndex is for cash systems that send multiple
+                // proto-tokens, so the Mint
+                // knows which proto-token has been chosen for signing.
+                // But Lucre only uses a single proto-token, so the
+                // token index is always 0.
+                //
+                std::vector<String> theSignatures(theTokens.size());
+
+                for (auto& it : theTokensByMint) {
+                    if (!bVerified) break;
+
+                    std::vector<Token*> theMintTokens;
+                    std::vector<String> theMintSignatures;
+
+                    for (size_t i : it.second)
+                        theMintTokens.push_back(theTokens[i]);
+
+                    if (!(it.first->SignTokens(server_->m_nymServer,
+                                               theMintTokens, theMintSignatures,
+                                               0))) // nTokenIndex = 0
+                    {
+                        Log::vError("%s: Failure in call: "
+                                    "pMint->SignTokens(server_->m_nymServer, "
+                                    "theMintTokens, theMintSignatures, 0). "
+                                    "(Returning.)\n",
+                                    __FUNCTION__);
+                        bVerified = false;
+                        break;
+                    }
+
+                    for (size_t i = 0; i < it.second.size(); ++i)
+                        theSignatures[it.second[i]] = theMintSignatures[i];
+                }
+
+                for (size_t i = 0; bVerified && (i < theTokens.size()); ++i) {
+                    pToken = theTokens[i];
+                    pMintCashReserveAcct = theReserveAccts[i];
+
+                    OTASCIIArmor theArmorReturnVal(theSignatures[i]);
+
+                    pToken->ReleaseSignatures(); // this releases the
+                                                 // normal signatures,
+                                                 // not the Lucre signed
+                                                 // token from the Mint,
+                                                 // above.
+
+                    pToken->SetSignature(theArmorReturnVal,
+                                         0); // nTokenIndex = 0
+
+                    // Sign and Save the token
+                    pToken->SignContract(server_->m_nymServer);
+                    pToken->SaveContract();
+
+                    // Now the token is in signedToken mode, and the
+                    // other prototokens have been released.
+
+                    // Deduct the amount from the account...
+                    if (theAccount.Debit(
+                            pToken->GetDenomination())) { // todo need
+                                                          // to be able
+                                                          // to "roll
+                                                          // back" if
+                                                          // anything
+                                                          // inside this
+                                                          // block
+                                                          // fails.
+                        bSuccess = true;
+
+                        // Credit the server's cash account for this
+                        // instrument definition in the same
+                        // amount that was debited. When the token is
+                        // deposited again, Debit that same
+                        // server cash account and deposit in the
+                        // depositor's acct.
+                        // Why, you might ask? Because if the token
+                        // expires, the money will stay in
+                        // the bank's cash account instead of being lost
+                        // (and screwing up the overall
+                        // issuer balance, with the issued money
+                        // disappearing forever.) The bank knows
+                        // that once the series expires, whatever funds
+                        // are left in that cash account are
+                        // for the bank to keep. They can be transferred
+                        // to another account and kept, instead
+                        // of being lost.
+                        if (!pMintCashReserveAcct->Credit(
+                                pToken->GetDenomination())) {
+                            Log::Error("Error crediting mint cash "
+                                       "reserve account...\n");
+
+                            // Reverse the account debit (even though
+                            // we're not going to save it anyway.)
+                            if (false ==
+                                theAccount.Credit(pToken->GetDenomination()))
+                                Log::vError("%s: Failed crediting "
+                                            "user account back.\n",
+                                            __FUNCTION__);
 
-                        if (pToken->GetInstrumentDefinitionID() !=
-                            INSTRUMENT_DEFINITION_ID) {
-                            const String str1(
-                                pToken->GetInstrumentDefinitionID()),
-                                str2(INSTRUMENT_DEFINITION_ID);
-                            bSuccess = false;
-                            Log::vError("%s: ERROR while signing token: "
-                                        "Expected instrument definition id "
-                                        "%s but found %s "
-                                        "instead. (Failure.)\n",
-                                        __FUNCTION__, str2.Get(), str1.Get());
-                            break;
-                        }
-                        // TokenIndex is for cash systems that send multiple
-                        // proto-tokens, so the Mint
-                        // knows which proto-token has been chosen for signing.
-                        // But Lucre only uses a single proto-token, so the
-                        // token index is always 0.
-                        //
-                        else if (!(pMint->SignToken(server_->m_nymServer,
-                                                    *pToken, theStringReturnVal,
-                                                    0))) // nTokenIndex = 0 //
-                        // ******************************************
-                        {
                             bSuccess = false;
-                            Log::vError(
-                                "%s: Failure in call: "
-                                "pMint->SignToken(server_->m_nymServer, "
-                                "*pToken, theStringReturnVal, 0). "
-                                "(Returning.)\n",
-                                __FUNCTION__);
                             break;
                         }
-                        else {
-                            OTASCIIArmor theArmorReturnVal(theStringReturnVal);
-
-                            pToken->ReleaseSignatures(); // this releases the
-                                                         // normal signatures,
-                                                         // not the Lucre signed
-                                                         // token from the Mint,
-                                                         // above.
-
-                            pToken->SetSignature(theArmorReturnVal,
-                                                 0); // nTokenIndex = 0
-
-                            // Sign and Save the token
-                            pToken->SignContract(server_->m_nymServer);
-                            pToken->SaveContract();
-
-                            // Now the token is in signedToken mode, and the
-                            // other prototokens have been released.
-
-                            // Deduct the amount from the account...
-                            if (theAccount.Debit(
-                                    pToken->GetDenomination())) { // todo need
-                                                                  // to be able
-                                                                  // to "roll
-                                                                  // back" if
-                                                                  // anything
-                                                                  // inside this
-                                                                  // block
-                                                                  // fails.
-                                bSuccess = true;
-
-                                // Credit the server's cash account for this
-                                // instrument definition in the same
-                                // amount that was debited. When the token is
-                                // deposited again, Debit that same
-                                // server cash account and deposit in the
-                                // depositor's acct.
-                                // Why, you might ask? Because if the token
-                                // expires, the money will stay in
-                                // the bank's cash account instead of being lost
-                                // (and screwing up the overall
-                                // issuer balance, with the issued money
-                                // disappearing forever.) The bank knows
-                                // that once the series expires, whatever funds
-                                // are left in that cash account are
-                                // for the bank to keep. They can be transferred
-                                // to another account and kept, instead
-                                // of being lost.
-                                if (!pMintCashReserveAcct->Credit(
-                                        pToken->GetDenomination())) {
-                                    Log::Error("Error crediting mint cash "
-                                               "reserve account...\n");
-
-                                    // Reverse the account debit (even though
-                                    // we're not going to save it anyway.)
-                                    if (false ==
-                                        theAccount.Credit(
-                                            pToken->GetDenomination()))
-                                        Log::vError("%s: Failed crediting "
-                                                    "user account back.\n",
-                                                    __FUNCTION__);
-
-                                    bSuccess = false;
-                                    break;
-                                }
-                            }
-                            else {
-                                bSuccess = false;
-                                Log::vOutput(0, "%s: Unable to debit account "
-                                                "%s in the amount of: %" PRId64
-                                                "\n",
-                                             __FUNCTION__, strAccountID.Get(),
-                                             pToken->GetDenomination());
-                                break; // Once there's a failure, we ditch the
-                                       // loop.
-                            }
-                        }
                     }
-                } // While success popping token out of the purse...
+                    else {
+                        bSuccess = false;
+                        Log::vOutput(0, "%s: Unable to debit account "
+                                        "%s in the amount of: %" PRId64 "\n",
+                                     __FUNCTION__, strAccountID.Get(),
+                                     pToken->GetDenomination());
+                        break; // Once there's a failure, we ditch the
+                               // loop.
+                    }
+                }
 
                 if (bSuccess) {
                     while (!theDeque.empty()) {
@@ -1281,10 +1307,19 @@ void Notary::NotarizeWithdrawal(Nym& theNym, Account& theAccount,
                     // cash expires, then after the expiry period, if it remains
                     // in the account,
                     // it is now the property of the transaction server.)
-                    pMintCashReserveAcct->ReleaseSignatures();
-                    pMintCashReserveAcct->SignContract(server_->m_nymServer);
-                    pMintCashReserveAcct->SaveContract();
-                    pMintCashReserveAcct->SaveAccount();
+                    // (The purse may hold tokens from more than one series,
+                    // each with its own reserve account.)
+                    listOfAccounts theReserves(theReserveAccts.begin(),
+                                               theReserveAccts.end());
+                    theReserves.sort();
+                    theReserves.unique();
+
+                    for (auto& pReserveAcct : theReserves) {
+                        pReserveAcct->ReleaseSignatures();
+                        pReserveAcct->SignContract(server_->m_nymServer);
+                        pReserveAcct->SaveContract();
+                        pReserveAcct->SaveAccount();
+                    }
 
                     // Notice if there is any failure in the above loop, then we
                     // will never enter this block.
@@ -3718,9 +3753,19 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
                                             // successful.
 
                 bool bSuccess = false;
+                bool bVerified = true;
 
                 // Pull the token(s) out of the purse that was received from the
-                // client.
+                // client, and verify all of them before anything is credited.
+                // That way the spent token database is only checked, and
+                // written, once for the whole purse.
+                std::vector<std::unique_ptr<Token>> theTokens;
+                std::vector<Token*> theTokenPtrs;
+                std::vector<const Mint*> theTokenMints;
+                std::vector<String> theSpendableTokens;
+                std::vector<Account*> theReserveAccts;
+                std::map<Mint*, std::vector<size_t>> theTokensByMint;
+
                 while (true) {
                     std::unique_ptr<Token> pToken(
                         thePurse.Pop(server_->m_nymServer));
@@ -3734,175 +3779,199 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
                     if (nullptr == pMint) {
                         Log::Error("Notary::NotarizeDeposit: Unable to get "
                                    "or load Mint.\n");
+                        bVerified = false;
                         break;
                     }
                     else if ((pMintCashReserveAcct =
-                                    pMint->GetCashReserveAccount()) !=
+                                    pMint->GetCashReserveAccount()) ==
                                nullptr) {
-                        String strSpendableToken;
-                        bool bToken = pToken->GetSpendableString(
-                            server_->m_nymServer, strSpendableToken);
+                        Log::Error("Notary::NotarizeDeposit: Unable to get "
+                                   "cash reserve account for Mint.\n");
+                        bVerified = false;
+                        break;
+                    }
 
-                        if (!bToken) // if failure getting the spendable token
-                                     // data from the token object
-                        {
-                            bSuccess = false;
-                            Log::vOutput(0, "Notary::NotarizeDeposit: "
-                                            "ERROR verifying token: Failure "
-                                            "retrieving token data. \n");
-                            break;
-                        }
-                        else if (!(pToken->GetInstrumentDefinitionID() ==
-                                     INSTRUMENT_DEFINITION_ID)) // or if failure
-                                                                // verifying
-                        // instrument definition
-                        {
-                            bSuccess = false;
-                            Log::vOutput(0, "Notary::NotarizeDeposit: "
-                                            "ERROR verifying token: Wrong "
-                                            "instrument definition. \n");
-                            break;
-                        }
-                        else if (!(pToken->GetNotaryID() ==
-                                     NOTARY_ID)) // or if failure verifying
-                                                 // server ID
-                        {
-                            bSuccess = false;
-                            Log::vOutput(0, "Notary::NotarizeDeposit: "
-                                            "ERROR verifying token: Wrong "
-                                            "server ID. \n");
-                            break;
-                        }
-                        // This call to VerifyToken verifies the token's Series
-                        // and From/To dates against the
-                        // mint's, and also verifies that the CURRENT date is
-                        // inside that valid date range.
-                        //
-                        // It also verifies the Lucre coin data itself against
-                        // the key for that series and
-                        // denomination. (The signed and unblinded Lucre coin is
-                        // finally verified in Lucre
-                        // using the appropriate Mint private key.)
-                        //
-                        else if (!(pMint->VerifyToken(
-                                     server_->m_nymServer, strSpendableToken,
-                                     pToken->GetDenomination()))) {
-                            bSuccess = false;
-                            Log::vOutput(0, "Notary::NotarizeDeposit: "
-                                            "ERROR verifying token: Token "
-                                            "verification failed. \n");
-                            break;
-                        }
-                        // Lookup the token in the SPENT TOKEN DATABASE, and
-                        // make sure
-                        // that it hasn't already been spent...
-                        else if (pToken->IsTokenAlreadySpent(
-                                     strSpendableToken)) {
-                            // TODO!!!! Need to store the spent token database
-                            // in multiple places, on multiple media!
-                            //          Furthermore need to CHECK those multiple
-                            // places inside IsTokenAlreadySpent.
-                            //          In fact, that should all be configurable
-                            // in the server config file!
-                            //          Related: make sure IsTokenAlreadySpent
-                            // differentiates between ACTUALLY not finding
-                            //          a token as spent (successfully), versus
-                            // some error state with the storage.
-                            bSuccess = false;
-                            Log::vOutput(0, "Notary::NotarizeDeposit: "
-                                            "ERROR verifying token: Token "
-                                            "was already spent. \n");
-                            break;
-                        }
-                        else {
-                            Log::Output(3, "Notary::NotarizeDeposit: "
-                                           "SUCCESS verifying token...    "
-                                           "\n");
-
-                            // need to be able to "roll back" if anything inside
-                            // this block fails.
-                            // so unless bSuccess is true, I don't save the
-                            // account below.
-                            //
+                    String strSpendableToken;
+                    bool bToken = pToken->GetSpendableString(
+                        server_->m_nymServer, strSpendableToken);
 
-                            // two defense mechanisms here:  mint cash reserve
-                            // acct, and spent token database
-                            //
-                            if (false ==
-                                pMintCashReserveAcct->Debit(
-                                    pToken->GetDenomination())) {
-                                Log::Error("Notary::NotarizeDeposit: Error "
-                                           "debiting the mint cash reserve "
-                                           "account. "
-                                           "SHOULD NEVER HAPPEN...\n");
-                                bSuccess = false;
-                                break;
-                            }
-                            // CREDIT the amount to the account...
-                            else if (false ==
-                                     theAccount.Credit(
-                                         pToken->GetDenomination())) {
-                                Log::Error("Notary::NotarizeDeposit: Error "
-                                           "crediting the user's asset "
-                                           "account...\n");
+                    if (!bToken) // if failure getting the spendable token
+                                 // data from the token object
+                    {
+                        Log::vOutput(0, "Notary::NotarizeDeposit: "
+                                        "ERROR verifying token: Failure "
+                                        "retrieving token data. \n");
+                        bVerified = false;
+                        break;
+                    }
+                    else if (!(pToken->GetInstrumentDefinitionID() ==
+                                 INSTRUMENT_DEFINITION_ID)) // or if failure
+                                                            // verifying
+                    // instrument definition
+                    {
+                        Log::vOutput(0, "Notary::NotarizeDeposit: "
+                                        "ERROR verifying token: Wrong "
+                                        "instrument definition. \n");
+                        bVerified = false;
+                        break;
+                    }
+                    else if (!(pToken->GetNotaryID() ==
+                                 NOTARY_ID)) // or if failure verifying
+                                             // server ID
+                    {
+                        Log::vOutput(0, "Notary::NotarizeDeposit: "
+                                        "ERROR verifying token: Wrong "
+                                        "server ID. \n");
+                        bVerified = false;
+                        break;
+                    }
+                    // The token's series and dates must match the mint's,
+                    // and the series must not have expired. The spent token
+                    // database forgets a series once it expires.
+                    else if (!pToken->VerifySeries(*pMint)) {
+                        Log::vOutput(0, "Notary::NotarizeDeposit: "
+                                        "ERROR verifying token: Bad "
+                                        "series or expired. \n");
+                        bVerified = false;
+                        break;
+                    }
 
-                                if (false ==
-                                    pMintCashReserveAcct->Credit(
-                                        pToken->GetDenomination()))
-                                    Log::Error("Notary::NotarizeDeposit: "
-                                               "Failure crediting-back "
-                                               "mint's cash reserve account "
-                                               "while depositing cash.\n");
-                                bSuccess = false;
-                                break;
-                            }
-                            // Spent token database. This is where the call is
-                            // made to add
-                            // the token to the spent token database.
-                            else if (false ==
-                                     pToken->RecordTokenAsSpent(
-                                         strSpendableToken)) {
-                                Log::Error("Notary::NotarizeDeposit: "
-                                           "Failed recording token as "
-                                           "spent...\n");
+                    theTokensByMint[pMint].push_back(theTokens.size());
+                    theTokenPtrs.push_back(pToken.get());
+                    theTokenMints.push_back(pMint);
+                    theTokens.push_back(std::move(pToken));
+                    theSpendableTokens.push_back(strSpendableToken);
+                    theReserveAccts.push_back(pMintCashReserveAcct);
+                } // while success popping token from purse
 
-                                if (false ==
-                                    pMintCashReserveAcct->Credit(
-                                        pToken->GetDenomination()))
-                                    Log::Error("Notary::NotarizeDeposit: "
-                                               "Failure crediting-back "
-                                               "mint's cash reserve account "
-                                               "while depositing cash.\n");
+                // This call to VerifyTokens verifies the Lucre coin data
+                // itself against the key for that series and denomination.
+                // (The signed and unblinded Lucre coin is finally verified in
+                // Lucre using the appropriate Mint private key.) Each mint
+                // verifies all of its tokens in one call.
+                //
+                for (auto& it : theTokensByMint) {
+                    if (!bVerified) break;
 
-                                if (false ==
-                                    theAccount.Debit(pToken->GetDenomination()))
-                                    Log::Error("Notary::NotarizeDeposit: "
-                                               "Failure debiting-back user's "
-                                               "asset account while "
-                                               "depositing cash.\n");
+                    std::vector<String> theMintTokens;
+                    std::vector<int64_t> theDenominations;
 
-                                bSuccess = false;
-                                break;
-                            }
-                            else // SUCCESS!!! (this iteration)
-                            {
-                                Log::vOutput(2, "Notary::NotarizeDeposit: "
-                                                "SUCCESS crediting account "
-                                                "with cash token...\n");
-                                bSuccess = true;
+                    for (size_t i : it.second) {
+                        theMintTokens.push_back(theSpendableTokens[i]);
+                        theDenominations.push_back(
+                            theTokens[i]->GetDenomination());
+                    }
 
-                                // No break here -- we allow the loop to carry
-                                // on through.
-                            }
+                    if (!(it.first->VerifyTokens(server_->m_nymServer,
+                                                 theMintTokens,
+                                                 theDenominations))) {
+                        Log::vOutput(0, "Notary::NotarizeDeposit: "
+                                        "ERROR verifying token: Token "
+                                        "verification failed. \n");
+                        bVerified = false;
+                    }
+                }
+
+                // Lookup the tokens in the SPENT TOKEN DATABASE, and make sure
+                // that none of them has already been spent (or appears twice
+                // in this purse.)
+                if (!bVerified || theTokens.empty()) {
+                    bSuccess = false;
+                }
+                else if (Token::AreTokensAlreadySpent(
+                             theTokenPtrs, theTokenMints, theSpendableTokens)) {
+                    // TODO!!!! Need to store the spent token database
+                    // in multiple places, on multiple media!
+                    //          Furthermore need to CHECK those multiple
+                    // places inside AreTokensAlreadySpent.
+                    //          In fact, that should all be configurable
+                    // in the server config file!
+                    Log::vOutput(0, "Notary::NotarizeDeposit: "
+                                    "ERROR verifying token: Token "
+                                    "was already spent. \n");
+                }
+                else {
+                    Log::Output(3, "Notary::NotarizeDeposit: "
+                                   "SUCCESS verifying tokens...    "
+                                   "\n");
+
+                    // need to be able to "roll back" if anything below
+                    // fails. so unless bSuccess is true, I don't save the
+                    // accounts below.
+                    //
+                    // two defense mechanisms here:  mint cash reserve
+                    // acct, and spent token database
+                    //
+                    size_t nCredited = 0;
+
+                    for (; nCredited < theTokens.size(); ++nCredited) {
+                        const int64_t lAmount =
+                            theTokens[nCredited]->GetDenomination();
+                        Account* pReserveAcct = theReserveAccts[nCredited];
+
+                        if (false == pReserveAcct->Debit(lAmount)) {
+                            Log::Error("Notary::NotarizeDeposit: Error "
+                                       "debiting the mint cash reserve "
+                                       "account. "
+                                       "SHOULD NEVER HAPPEN...\n");
+                            break;
+                        }
+                        // CREDIT the amount to the account...
+                        else if (false == theAccount.Credit(lAmount)) {
+                            Log::Error("Notary::NotarizeDeposit: Error "
+                                       "crediting the user's asset "
+                                       "account...\n");
+
+                            if (false == pReserveAcct->Credit(lAmount))
+                                Log::Error("Notary::NotarizeDeposit: "
+                                           "Failure crediting-back "
+                                           "mint's cash reserve account "
+                                           "while depositing cash.\n");
+                            break;
                         }
                     }
-                    else {
-                        Log::Error("Notary::NotarizeDeposit: Unable to get "
-                                   "cash reserve account for Mint.\n");
+
+                    bSuccess = (theTokens.size() == nCredited);
+
+                    // Spent token database. This is where the call is
+                    // made to add the tokens to the spent token database.
+                    if (bSuccess &&
+                        (false == Token::RecordTokensAsSpent(
+                                      theTokenPtrs, theTokenMints,
+                                      theSpendableTokens))) {
+                        Log::Error("Notary::NotarizeDeposit: "
+                                   "Failed recording tokens as "
+                                   "spent...\n");
                         bSuccess = false;
-                        break;
                     }
-                } // while success popping token from purse
+
+                    if (bSuccess) {
+                        Log::vOutput(2, "Notary::NotarizeDeposit: "
+                                        "SUCCESS crediting account "
+                                        "with cash tokens...\n");
+                    }
+                    else {
+                        // Roll back whatever was credited above.
+                        while (nCredited > 0) {
+                            --nCredited;
+                            const int64_t lAmount =
+                                theTokens[nCredited]->GetDenomination();
+
+                            if (false ==
+                                theReserveAccts[nCredited]->Credit(lAmount))
+                                Log::Error("Notary::NotarizeDeposit: "
+                                           "Failure crediting-back "
+                                           "mint's cash reserve account "
+                                           "while depositing cash.\n");
+
+                            if (false == theAccount.Debit(lAmount))
+                                Log::Error("Notary::NotarizeDeposit: "
+                                           "Failure debiting-back user's "
+                                           "asset account while "
+                                           "depositing cash.\n");
+                        }
+                    }
+                }
 
                 if (bSuccess) {
                     // Release any signatures that were there before (They won't
@@ -3926,10 +3995,19 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
                     // cash expires, then after the expiry period, if it remains
                     // in the account,
                     // it is now the property of the transaction server.)
-                    pMintCashReserveAcct->ReleaseSignatures();
-                    pMintCashReserveAcct->SignContract(server_->m_nymServer);
-                    pMintCashReserveAcct->SaveContract();
-                    pMintCashReserveAcct->SaveAccount();
+                    // (The purse may hold tokens from more than one series,
+                    // each with its own reserve account.)
+                    listOfAccounts theReserves(theReserveAccts.begin(),
+                                               theReserveAccts.end());
+                    theReserves.sort();
+                    theReserves.unique();
+
+                    for (auto& pReserveAcct : theReserves) {
+                        pReserveAcct->ReleaseSignatures();
+                        pReserveAcct->SignContract(server_->m_nymServer);
+                        pReserveAcct->SaveContract();
+                        pReserveAcct->SaveAccount();
+                    }
 
                     pResponseItem->SetStatus(Item::acknowledgement);
 
@@ -0,0 +1,410 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/server/NymCache.hpp>
+#include <opentxs/server/OTServer.hpp>
+#include <opentxs/server/ServerSettings.hpp>
+#include <opentxs/server/ServerStats.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/Nym.hpp>
+
+#include <algorithm>
+
+namespace opentxs
+{
+
+NymCache::Lease::Lease(NymCache& cache, const String& nymID, bool bDeferSave)
+    : cache_(cache)
+    , nymID_(nymID.Get())
+    , nym_(nullptr)
+    , nymfile_(nullptr)
+    , verified_(false)
+{
+    if ((ServerSettings::GetNymCacheSize() <= 0) || nymID_.empty()) return;
+
+    nym_ = cache_.checkout(nymID_, bDeferSave, nymfile_, verified_);
+}
+
+NymCache::Lease::~Lease()
+{
+    if (nullptr != nym_) cache_.checkin(nymID_, verified_);
+}
+
+void NymCache::Lease::SetVerified()
+{
+    if (nullptr == nym_) return;
+
+    // The Nym was just loaded from disk, so this is its last saved state.
+    if (!nym_->IsNymfileDirty()) {
+        nymfile_->Release();
+        nym_->SavePseudonym(*nymfile_);
+    }
+    verified_ = true;
+}
+
+NymCache::NymCache(OTServer* server)
+    : server_(server)
+    , dirtyCount_(0)
+    , lastFlush_(std::chrono::steady_clock::now())
+    , hits_(0)
+    , misses_(0)
+{
+    Nym::SetNymfileSavedCallback(
+        [this](const String& nymID) { onNymfileSaved(nymID); });
+}
+
+NymCache::~NymCache()
+{
+    Nym::SetNymfileSavedCallback(nullptr);
+
+    Flush();
+}
+
+Nym* NymCache::checkout(const std::string& nymID, bool bDeferSave,
+                        String*& nymfile, bool& bVerified)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto it = entries_.find(nymID);
+
+    if (entries_.end() == it) {
+        ++misses_;
+        Entry& entry = entries_[nymID];
+        entry.nym.reset(new Nym(String(nymID)));
+        lru_.push_front(nymID);
+        entry.lru = lru_.begin();
+        it = entries_.find(nymID);
+    }
+    else {
+        ++hits_;
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+    }
+
+    Entry& entry = it->second;
+
+    // Requests from the same Nym are serialized by MessageProcessor.
+    OT_ASSERT(!entry.leased);
+
+    entry.leased = true;
+    entry.stale = false;
+    bVerified = entry.verified;
+    nymfile = &entry.nymfile;
+
+    // Nobody else touches a leased entry, so the rest happens unlocked.
+    lock.unlock();
+
+    // Start from the last saved state of the nymfile, dropping anything the
+    // previous request changed in memory without saving.
+    if (bVerified && !entry.nym->LoadFromString(entry.nymfile)) {
+        otErr << __FUNCTION__ << ": Failed reloading cached nymfile for Nym "
+              << nymID << ". Loading it from storage instead.\n";
+        entry.nym.reset(new Nym(String(nymID)));
+        bVerified = false;
+    }
+
+    entry.nym->SetCachedNymfile(&entry.nymfile, bDeferSave);
+
+    return entry.nym.get();
+}
+
+void NymCache::checkin(const std::string& nymID, bool bVerified)
+{
+    std::vector<std::string> nymIDs; // To write once mutex_ is released.
+    String strDropped; // Unsaved nymfile of an entry that's being dropped.
+    bool bDropped = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = entries_.find(nymID);
+        OT_ASSERT(entries_.end() != it);
+
+        Entry& entry = it->second;
+        entry.leased = false;
+        entry.nym->SetCachedNymfile(nullptr, false);
+
+        if (entry.nym->IsNymfileDirty()) {
+            entry.nym->ClearNymfileDirty();
+            ++entry.version;
+
+            if (!entry.dirty) {
+                entry.dirty = true;
+                ++dirtyCount_;
+            }
+        }
+
+        if (entry.stale) {
+            // Deferred saves only happen for Nym-local commands, which never
+            // load the same Nym through another object. So this is
+            // unexpected.
+            if (entry.dirty) {
+                otErr << __FUNCTION__ << ": Nymfile for " << nymID
+                      << " was written elsewhere while it had unsaved changes "
+                         "in the cache. Keeping the version in storage.\n";
+                entry.dirty = false;
+                --dirtyCount_;
+            }
+            bVerified = false;
+        }
+
+        if (!bVerified) {
+            if (entry.dirty) {
+                strDropped = entry.nymfile;
+                bDropped = true;
+                --dirtyCount_;
+            }
+            lru_.erase(entry.lru);
+            entries_.erase(it);
+        }
+        else {
+            entry.verified = true;
+
+            switch (ServerSettings::GetNymCacheFlushPolicy()) {
+            case FLUSH_GROUP:
+                if (dirtyCount_ >= ServerSettings::GetNymCacheGroupSize()) {
+                    getDirty(nymIDs);
+                    lastFlush_ = std::chrono::steady_clock::now();
+                }
+                break;
+            case FLUSH_PERIODIC:
+                if (std::chrono::steady_clock::now() - lastFlush_ >=
+                    std::chrono::milliseconds(
+                        ServerSettings::GetNymCacheFlushMs())) {
+                    getDirty(nymIDs);
+                    lastFlush_ = std::chrono::steady_clock::now();
+                }
+                break;
+            case FLUSH_SYNC:
+            default:
+                if (entry.dirty) nymIDs.push_back(nymID);
+                break;
+            }
+
+            evict(nymIDs);
+        }
+    }
+
+    if (bDropped) {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        write(nymID, strDropped);
+    }
+
+    if (!nymIDs.empty()) {
+        write(nymIDs);
+
+        // Whatever evict() had to write first can go now.
+        std::vector<std::string> unwritten;
+        std::lock_guard<std::mutex> lock(mutex_);
+        evict(unwritten);
+    }
+}
+
+void NymCache::Flush()
+{
+    std::vector<std::string> nymIDs;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        getDirty(nymIDs);
+        lastFlush_ = std::chrono::steady_clock::now();
+    }
+
+    write(nymIDs);
+}
+
+void NymCache::FlushIfDue()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (FLUSH_PERIODIC != ServerSettings::GetNymCacheFlushPolicy())
+            return;
+
+        if (std::chrono::steady_clock::now() - lastFlush_ <
+            std::chrono::milliseconds(ServerSettings::GetNymCacheFlushMs()))
+            return;
+    }
+
+    Flush();
+}
+
+void NymCache::Invalidate(const String& nymID)
+{
+    onNymfileSaved(nymID);
+}
+
+int64_t NymCache::GetHits() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+int64_t NymCache::GetMisses() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+// Some other Nym object wrote this nymfile, so our copy is out of date.
+void NymCache::onNymfileSaved(const String& nymID)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = entries_.find(nymID.Get());
+    if (entries_.end() == it) return;
+
+    Entry& entry = it->second;
+
+    if (entry.leased) {
+        entry.stale = true;
+        return;
+    }
+
+    if (entry.dirty) {
+        otErr << __FUNCTION__ << ": Nymfile for " << nymID
+              << " was written elsewhere while it had unsaved changes in the "
+                 "cache. Keeping the version in storage.\n";
+        --dirtyCount_;
+    }
+
+    lru_.erase(entry.lru);
+    entries_.erase(it);
+}
+
+// Caller holds writeMutex_.
+bool NymCache::write(const std::string& nymID, const String& nymfile)
+{
+    ServerStats::Timer timer(ServerStats::PHASE_SAVE);
+
+    if (!Nym::WriteSignedNymfile(String(nymID), nymfile,
+                                 server_->GetServerNym())) {
+        otErr << __FUNCTION__ << ": Failed writing cached nymfile for Nym "
+              << nymID << ". (Will retry.)\n";
+        return false;
+    }
+
+    return true;
+}
+
+// Writes whichever of these entries are dirty and not checked out. An entry
+// that changed again meanwhile stays dirty.
+void NymCache::write(const std::vector<std::string>& nymIDs)
+{
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
+
+    std::vector<std::pair<std::string, String>> theCopies;
+    std::vector<int64_t> theVersions;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (auto& nymID : nymIDs) {
+            auto it = entries_.find(nymID);
+            if (entries_.end() == it) continue;
+
+            const Entry& entry = it->second;
+            if (!entry.dirty || entry.leased) continue;
+
+            theCopies.push_back(std::make_pair(nymID, entry.nymfile));
+            theVersions.push_back(entry.version);
+        }
+    }
+
+    std::vector<bool> theWritten;
+
+    for (auto& it : theCopies) theWritten.push_back(write(it.first, it.second));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (size_t i = 0; i < theCopies.size(); ++i) {
+        if (!theWritten[i]) continue;
+
+        auto it = entries_.find(theCopies[i].first);
+        if (entries_.end() == it) continue;
+
+        Entry& entry = it->second;
+
+        if (entry.dirty && (entry.version == theVersions[i])) {
+            entry.dirty = false;
+            --dirtyCount_;
+        }
+    }
+}
+
+// Caller holds mutex_.
+void NymCache::getDirty(std::vector<std::string>& nymIDs) const
+{
+    if (dirtyCount_ <= 0) return;
+
+    for (auto& it : entries_) {
+        const Entry& entry = it.second;
+        if (entry.dirty && !entry.leased) nymIDs.push_back(it.first);
+    }
+}
+
+// Caller holds mutex_. Drops the least recently used entries until the cache
+// is back to its size. Entries that still have to be written are added to
+// nymIDs instead.
+void NymCache::evict(std::vector<std::string>& nymIDs)
+{
+    const size_t capacity =
+        static_cast<size_t>(ServerSettings::GetNymCacheSize());
+
+    size_t nUnwritten = 0;
+    auto it = lru_.end();
+
+    while ((entries_.size() - nUnwritten > capacity) && (lru_.begin() != it)) {
+        --it;
+        auto entry = entries_.find(*it);
+        OT_ASSERT(entries_.end() != entry);
+
+        if (entry->second.leased) continue;
+
+        if (entry->second.dirty) {
+            if (nymIDs.end() == std::find(nymIDs.begin(), nymIDs.end(), *it))
+                nymIDs.push_back(*it);
+            ++nUnwritten;
+            continue;
+        }
+
+        it = lru_.erase(it);
+        entries_.erase(entry);
+    }
+}
+
+} // namespace opentxs
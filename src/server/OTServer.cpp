@@ -46,6 +46,7 @@
 #include <opentxs/ext/Helpers.hpp>
 #include <opentxs/ext/OTPayment.hpp>
 #include <opentxs/cash/Purse.hpp>
+#include <opentxs/cash/SpentTokenIndex.hpp>
 #include <opentxs/cash/Token.hpp>
 #include <opentxs/basket/Basket.hpp>
 #include <opentxs/core/crypto/OTAsymmetricKey.hpp>
@@ -69,6 +70,7 @@
 #include <opentxs/core/util/OTPaths.hpp>
 #include <opentxs/core/recurring/OTPaymentPlan.hpp>
 #include <opentxs/core/OTServerContract.hpp>
+#include <opentxs/core/OTStorage.hpp>
 #include <opentxs/core/script/OTSmartContract.hpp>
 #include <opentxs/core/trade/OTTrade.hpp>
 
@@ -210,9 +212,9 @@ void OTServer::ActivateCron()
 /// It sleeps in between. (See testserver.cpp for the call
 /// and OTLog::Sleep() for the sleep code.)
 ///
-void OTServer::ProcessCron()
+bool OTServer::ProcessCron(int32_t nMaxItems)
 {
-    if (!m_Cron.IsActivated()) return;
+    if (!m_Cron.IsActivated()) return true;
 
     bool bAddedNumbers = false;
 
@@ -235,12 +237,19 @@ void OTServer::ProcessCron()
         m_Cron.SaveCron();
     }
 
-    m_Cron.ProcessCronItems(); // This needs to be called regularly for trades,
-                               // markets, payment plans, etc to process.
+    // This needs to be called regularly for trades, markets, payment plans,
+    // etc to process.
+    if (!m_Cron.ProcessCronItems(nMaxItems)) return false;
+
+    // Tokens from an expired mint series can't be deposited anymore, so
+    // there's no need to remember which of them were spent.
+    SpentTokenIndex::DropExpired();
 
     // NOTE:  TODO:  OTHER RE-OCCURRING SERVER FUNCTIONS CAN GO HERE AS WELL!!
     //
     // Such as sweeping server accounts after expiration dates, etc.
+
+    return true;
 }
 
 const Nym& OTServer::GetServerNym() const
@@ -261,6 +270,7 @@ OTServer::OTServer()
     , m_bReadOnly(false)
     , m_bShutdownFlag(false)
     , m_pServerContract()
+    , nymCache_(this)
 {
 }
 
@@ -384,7 +394,21 @@ void OTServer::Init(bool readOnly)
             }
         }
     }
-    OTDB::InitDefaultStorage(OTDB_DEFAULT_STORAGE, OTDB_DEFAULT_PACKER);
+    if (!OTDB::InitDefaultStorage(
+            static_cast<OTDB::StorageType>(ServerSettings::GetStorageType()),
+            OTDB_DEFAULT_PACKER)) {
+        Log::Error("Failed initializing storage.\n");
+        OT_FAIL;
+    }
+
+    // One-shot migration from the filesystem layout into a new key/value
+    // file. Finishes an earlier import that was interrupted.
+    OTDB::StorageKV* pStorageKV =
+        dynamic_cast<OTDB::StorageKV*>(OTDB::GetDefaultStorage());
+
+    if ((nullptr != pStorageKV) && ServerSettings::GetStorageImport()) {
+        if (!pStorageKV->ImportDataFolder()) OT_FAIL;
+    }
 
     // Load up the transaction number and other OTServer data members.
     bool mainFileExists = m_strWalletFilename.Exists()
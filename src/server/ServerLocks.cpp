@@ -0,0 +1,175 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/server/ServerLocks.hpp>
+#include <opentxs/core/util/Assert.hpp>
+
+namespace opentxs
+{
+
+NotaryLock::NotaryLock()
+    : readers_(0)
+    , readersWaiting_(0)
+    , writersWaiting_(0)
+    , priorityWaiting_(0)
+    , writer_(false)
+    , priority_(false)
+    , yielding_(false)
+{
+}
+
+void NotaryLock::lockShared()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++readersWaiting_;
+    condition_.wait(lock,
+                    [this]() { return !writer_ && (0 == writersWaiting_); });
+    --readersWaiting_;
+    ++readers_;
+
+    if (yielding_) {
+        yielding_ = false;
+        condition_.notify_all();
+    }
+}
+
+void NotaryLock::unlockShared()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    OT_ASSERT(readers_ > 0);
+    if (0 == --readers_) condition_.notify_all();
+}
+
+void NotaryLock::lockExclusive(bool bPriority)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (bPriority) {
+        // Not counted as waiting yet, so the others can get in.
+        condition_.wait(lock, [this]() { return !yielding_; });
+        ++priorityWaiting_;
+    }
+
+    ++writersWaiting_;
+    condition_.wait(lock, [this, bPriority]() {
+        return !writer_ && (0 == readers_) &&
+               (bPriority || (0 == priorityWaiting_));
+    });
+    --writersWaiting_;
+
+    if (bPriority) --priorityWaiting_;
+
+    writer_ = true;
+    priority_ = bPriority;
+
+    if (yielding_) {
+        yielding_ = false;
+        condition_.notify_all();
+    }
+}
+
+void NotaryLock::unlockExclusive()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    OT_ASSERT(writer_);
+    writer_ = false;
+
+    if (priority_ && ((readersWaiting_ > 0) || (writersWaiting_ > 0)))
+        yielding_ = true;
+
+    priority_ = false;
+    condition_.notify_all();
+}
+
+NymLockTable::NymLockTable()
+    : nextTicket_(0)
+    , nextToJoin_(0)
+{
+}
+
+uint64_t NymLockTable::takeTicket()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nextTicket_++;
+}
+
+void NymLockTable::waitToJoin(std::unique_lock<std::mutex>& lock,
+                              uint64_t ticket)
+{
+    condition_.wait(lock, [this, ticket]() { return nextToJoin_ == ticket; });
+}
+
+void NymLockTable::lock(uint64_t ticket, const std::string& nymID)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitToJoin(lock, ticket);
+
+    std::deque<uint64_t>& line = lines_[nymID];
+    line.push_back(ticket);
+    ++nextToJoin_;
+    condition_.notify_all();
+
+    // std::map never moves its elements, and the line can't be erased while
+    // this ticket is in it, so the reference stays valid here.
+    condition_.wait(lock,
+                    [&line, ticket]() { return line.front() == ticket; });
+}
+
+void NymLockTable::unlock(const std::string& nymID)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = lines_.find(nymID);
+    OT_ASSERT((lines_.end() != it) && !it->second.empty());
+
+    it->second.pop_front();
+
+    if (it->second.empty()) lines_.erase(it);
+
+    condition_.notify_all();
+}
+
+void NymLockTable::skip(uint64_t ticket)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitToJoin(lock, ticket);
+
+    ++nextToJoin_;
+    condition_.notify_all();
+}
+
+} // namespace opentxs
@@ -49,6 +49,19 @@ int64_t ServerSettings::__min_market_scale = 1;
 int32_t ServerSettings::__heartbeat_no_requests = 10;
 // number of ms between each heartbeat.
 int32_t ServerSettings::__heartbeat_ms_between_beats = 100;
+// The number of threads processing client requests. 0 means one per core.
+int32_t ServerSettings::__worker_threads = 0;
+// Verified Nyms kept in memory by the server. 0 disables the cache.
+int32_t ServerSettings::__nym_cache_size = 1000;
+// 0: write nymfiles when each request finishes. 1: in groups. 2: periodically.
+int32_t ServerSettings::__nym_cache_flush_policy = 0;
+int32_t ServerSettings::__nym_cache_group_size = 16;
+int32_t ServerSettings::__nym_cache_flush_ms = 1000;
+// Seconds between writes of the stats snapshot file. 0 disables it.
+int32_t ServerSettings::__stats_snapshot_seconds = 60;
+// 0: one file per object in the data folder. 1: single key/value file.
+int32_t ServerSettings::__storage_type = 0;
+bool ServerSettings::__storage_import = true;
 // The Nym who's allowed to do certain
 // commands even if they are turned off.
 std::string ServerSettings::__override_nym_id;
@@ -95,12 +108,14 @@ bool ServerSettings::__transact_deposit_cash = true;
 bool ServerSettings::__cmd_get_market_list = true;
 bool ServerSettings::__cmd_get_market_offers = true;
 bool ServerSettings::__cmd_get_market_recent_trades = true;
+bool ServerSettings::__cmd_get_market_candles = true;
 bool ServerSettings::__cmd_get_nym_market_offers = true;
 bool ServerSettings::__transact_market_offer = true;
 bool ServerSettings::__transact_payment_plan = true;
 bool ServerSettings::__transact_cancel_cron_item = true;
 bool ServerSettings::__transact_smart_contract = true;
 bool ServerSettings::__cmd_trigger_clause = true;
+bool ServerSettings::__cmd_get_server_stats = false;
 
 // Todo: Might set ALL of these to false (so you're FORCED to set them true
 // in the server.cfg file.) This way you're also assured that the right data
@@ -0,0 +1,266 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/server/ServerStats.hpp>
+#include <opentxs/server/ServerSettings.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/util/Tag.hpp>
+
+namespace opentxs
+{
+
+namespace
+{
+
+// Command names come from the client, so only this many are kept apart.
+// Anything past that is counted under "other".
+const size_t MAX_COMMANDS = 128;
+
+thread_local ServerStats::Request* currentRequest = nullptr;
+
+int64_t toMicroseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+        .count();
+}
+
+TagPtr histogramTag(const char* szName, const ServerStats::Histogram& hist)
+{
+    TagPtr pTag(new Tag("latency"));
+    pTag->add_attribute("phase", szName);
+    pTag->add_attribute("count", formatLong(hist.count_));
+    pTag->add_attribute("totalUs", formatLong(hist.total_));
+    pTag->add_attribute("maxUs", formatLong(hist.max_));
+
+    // Trailing empty buckets are left out.
+    int32_t nUsed = ServerStats::Histogram::BUCKETS;
+    while ((nUsed > 0) && (0 == hist.buckets_[nUsed - 1])) --nUsed;
+
+    std::string strBuckets;
+    for (int32_t i = 0; i < nUsed; ++i) {
+        if (i > 0) strBuckets += ",";
+        strBuckets += formatLong(hist.buckets_[i]);
+    }
+    pTag->add_attribute("buckets", strBuckets);
+
+    return pTag;
+}
+
+} // namespace
+
+ServerStats::Histogram::Histogram()
+    : count_(0)
+    , total_(0)
+    , max_(0)
+{
+    for (int32_t i = 0; i < BUCKETS; ++i) buckets_[i] = 0;
+}
+
+void ServerStats::Histogram::Add(int64_t lMicroseconds)
+{
+    if (lMicroseconds < 0) lMicroseconds = 0;
+
+    int32_t nBucket = 0;
+    for (int64_t lValue = lMicroseconds >> 1;
+         (lValue > 0) && (nBucket < BUCKETS - 1); lValue >>= 1)
+        ++nBucket;
+
+    ++count_;
+    total_ += lMicroseconds;
+    if (lMicroseconds > max_) max_ = lMicroseconds;
+    ++buckets_[nBucket];
+}
+
+ServerStats::Request::Request(ServerStats& stats)
+    : stats_(stats)
+    , previous_(currentRequest)
+    , failed_(false)
+    , phase_(PHASE_PROCESS)
+    , start_(std::chrono::steady_clock::now())
+    , mark_(start_)
+{
+    for (int32_t i = 0; i < PHASE_COUNT; ++i)
+        phases_[i] = std::chrono::steady_clock::duration::zero();
+
+    currentRequest = this;
+}
+
+ServerStats::Request::~Request()
+{
+    switchTo(phase_);
+    currentRequest = previous_;
+    stats_.record(*this);
+}
+
+void ServerStats::Request::SetCommand(const String& strCommand)
+{
+    command_ = strCommand.Get();
+}
+
+void ServerStats::Request::SetFailed()
+{
+    failed_ = true;
+}
+
+void ServerStats::Request::switchTo(Phase phase)
+{
+    const auto now = std::chrono::steady_clock::now();
+    phases_[phase_] += now - mark_;
+    mark_ = now;
+    phase_ = phase;
+}
+
+ServerStats::Timer::Timer(Phase phase)
+    : request_(currentRequest)
+    , previous_(PHASE_PROCESS)
+{
+    if (nullptr == request_) return;
+
+    previous_ = request_->phase_;
+    request_->switchTo(phase);
+}
+
+ServerStats::Timer::~Timer()
+{
+    if (nullptr != request_) request_->switchTo(previous_);
+}
+
+ServerStats::ServerStats()
+    : started_(OTTimeGetCurrentTime())
+    , lastSave_(std::chrono::steady_clock::now())
+{
+}
+
+const char* ServerStats::PhaseName(Phase phase)
+{
+    switch (phase) {
+    case PHASE_PARSE:
+        return "parse";
+    case PHASE_NYM_LOAD:
+        return "nymLoad";
+    case PHASE_VERIFY:
+        return "verify";
+    case PHASE_PROCESS:
+        return "process";
+    case PHASE_SAVE:
+        return "save";
+    case PHASE_SIGN:
+        return "sign";
+    default:
+        return "error";
+    }
+}
+
+void ServerStats::record(const Request& request)
+{
+    std::string strCommand =
+        request.command_.empty() ? "unknown" : request.command_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = commands_.find(strCommand);
+    if (commands_.end() == it) {
+        if (commands_.size() >= MAX_COMMANDS) strCommand = "other";
+        it = commands_.insert(std::make_pair(strCommand, Command())).first;
+    }
+
+    Command& command = it->second;
+    ++command.requests;
+    if (request.failed_) ++command.errors;
+
+    command.total.Add(toMicroseconds(request.mark_ - request.start_));
+    for (int32_t i = 0; i < PHASE_COUNT; ++i)
+        command.phases[i].Add(toMicroseconds(request.phases_[i]));
+}
+
+void ServerStats::Snapshot(String& strOutput) const
+{
+    Tag tag("serverStats");
+    tag.add_attribute("version", "1.0");
+    tag.add_attribute("since", formatTimestamp(started_));
+    tag.add_attribute("time", formatTimestamp(OTTimeGetCurrentTime()));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (const auto& it : commands_) {
+            const Command& command = it.second;
+
+            TagPtr pTag(new Tag("command"));
+            pTag->add_attribute("name", it.first);
+            pTag->add_attribute("requests", formatLong(command.requests));
+            pTag->add_attribute("errors", formatLong(command.errors));
+
+            TagPtr pTotal(histogramTag("total", command.total));
+            pTag->add_tag(pTotal);
+
+            for (int32_t i = 0; i < PHASE_COUNT; ++i) {
+                TagPtr pPhase(histogramTag(PhaseName(static_cast<Phase>(i)),
+                                           command.phases[i]));
+                pTag->add_tag(pPhase);
+            }
+
+            tag.add_tag(pTag);
+        }
+    }
+
+    std::string str_result;
+    tag.output(str_result);
+
+    strOutput.Concatenate("%s", str_result.c_str());
+}
+
+void ServerStats::SaveIfDue()
+{
+    const int32_t nSeconds = ServerSettings::GetStatsSnapshotSeconds();
+    if (nSeconds <= 0) return;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastSave_ < std::chrono::seconds(nSeconds)) return;
+    lastSave_ = now;
+
+    String strSnapshot;
+    Snapshot(strSnapshot);
+
+    if (!OTDB::StorePlainString(strSnapshot.Get(), ".", "stats.xml")) {
+        otErr << __FUNCTION__ << ": Failed writing stats.xml\n";
+    }
+}
+
+} // namespace opentxs
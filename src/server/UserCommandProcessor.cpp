@@ -38,9 +38,11 @@
 
 #include <opentxs/server/UserCommandProcessor.hpp>
 #include <opentxs/server/OTServer.hpp>
+#include <opentxs/server/NymCache.hpp>
 #include <opentxs/server/ClientConnection.hpp>
 #include <opentxs/server/Macros.hpp>
 #include <opentxs/server/ServerSettings.hpp>
+#include <opentxs/server/ServerStats.hpp>
 #include <opentxs/basket/BasketContract.hpp>
 #include <opentxs/basket/Basket.hpp>
 #include <opentxs/core/script/OTParty.hpp>
@@ -58,14 +60,42 @@
 #include <opentxs/cash/Mint.hpp>
 #include <opentxs/core/trade/OTMarket.hpp>
 
+#include <set>
+
 namespace opentxs
 {
 
+namespace
+{
+
+// How much armored box receipt text a getBoxReceiptsResponse may carry. The
+// whole reply has to fit in a String, along with a copy of the request.
+const uint32_t BOX_RECEIPTS_REPLY_SIZE = MAX_STRING_LENGTH / 2;
+
+} // namespace
+
 UserCommandProcessor::UserCommandProcessor(OTServer* server)
     : server_(server)
 {
 }
 
+// Commands that read the notary's shared state, but write nothing except the
+// sending Nym's own nymfile and nymbox. MessageProcessor runs these
+// concurrently for different Nyms; everything else runs exclusively.
+bool UserCommandProcessor::IsNymLocalCommand(const String& command)
+{
+    static const std::set<std::string> commands = {
+        "pingNotary",              "getRequestNumber",
+        "checkNym",                "getNymbox",
+        "getBoxReceipt",           "getBoxReceipts",
+        "getAccountData",          "getInstrumentDefinition",
+        "queryInstrumentDefinitions", "getMarketList",
+        "getMarketOffers",         "getMarketRecentTrades",
+        "getMarketCandles",        "getNymMarketOffers"};
+
+    return commands.end() != commands.find(command.Get());
+}
+
 // this function will create the Nym if it's not passed in. We pass it in so the
 // caller has the option to query things about the Nym (like if it actually
 // exists.)
@@ -538,6 +568,21 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
             } // Success loading and verifying the Nym based on his credentials.
         }     // Has Credentials.
     }
+    // NYM CACHE
+    //
+    // If this Nym passed verification on an earlier request, the cache hands
+    // back the already-loaded Nym (reset to its last saved nymfile) and we
+    // skip loading its credentials and nymfile from storage. The message
+    // signature is still verified every time. (The server Nym isn't cached,
+    // since it's already loaded.)
+    //
+    NymCache::Lease theLease(
+        server_->nymCache_, bNymIsServerNym ? String() : theMessage.m_strNymID,
+        IsNymLocalCommand(theMessage.m_strCommand));
+    const bool bNymIsCached = theLease.IsVerified();
+
+    if (nullptr != theLease.GetNym()) pNym = theLease.GetNym();
+
     // Look up the NymID and see if it's a valid user account.
     //
     // If we didn't receive a public key (above)
@@ -547,38 +592,47 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
     // If it is, then we read the public key from that Pseudonym and use it to
     // verify any
     // requests bearing that NymID.
-    if (!bNymIsServerNym &&
-        (false == pNym->LoadPublicKey()) // && // Old style. (Deprecated, but
-                                         // fine for now since it calls
-                                         // LoadCredentials.)
-        ) {
-        Log::vError("Failure loading public credentials for Nym: %s\n",
-                    theMessage.m_strNymID.Get());
-        return false;
-    }
-    if (!bNymIsServerNym && pNym->IsMarkedForDeletion()) {
-        Log::vOutput(0, "(Failed) attempt by client to use a deleted Nym: %s\n",
-                     theMessage.m_strNymID.Get());
-        return false;
-    }
-    // Okay, the file was read into memory and Public Key was successfully
-    // extracted!
-    // Next, let's use that public key to verify (1) the NymID and (2) the
-    // signature
-    // on the message that we're processing.
-
-    if (!pNym->VerifyPseudonym()) {
-        Log::Output(
-            0, "Pseudonym failed to verify. Hash of public key doesn't match "
-               "Nym ID that was sent.\n");
-        return false;
+    {
+        ServerStats::Timer timer(ServerStats::PHASE_NYM_LOAD);
+
+        if (!bNymIsServerNym && !bNymIsCached &&
+            (false == pNym->LoadPublicKey()) // && // Old style. (Deprecated,
+                                             // but fine for now since it
+                                             // calls LoadCredentials.)
+            ) {
+            Log::vError("Failure loading public credentials for Nym: %s\n",
+                        theMessage.m_strNymID.Get());
+            return false;
+        }
+        if (!bNymIsServerNym && pNym->IsMarkedForDeletion()) {
+            Log::vOutput(0,
+                         "(Failed) attempt by client to use a deleted Nym: "
+                         "%s\n",
+                         theMessage.m_strNymID.Get());
+            return false;
+        }
+        // Okay, the file was read into memory and Public Key was successfully
+        // extracted!
+        // Next, let's use that public key to verify (1) the NymID and (2) the
+        // signature
+        // on the message that we're processing.
+
+        if (!bNymIsCached && !pNym->VerifyPseudonym()) {
+            Log::Output(0, "Pseudonym failed to verify. Hash of public key "
+                           "doesn't match Nym ID that was sent.\n");
+            return false;
+        }
     }
     Log::Output(3, "Pseudonym verified!\n");
 
     // So far so good. Now let's see if the signature matches...
-    if (!theMessage.VerifySignature(*pNym)) {
-        Log::Output(0, "Signature verification failed!\n");
-        return false;
+    {
+        ServerStats::Timer timer(ServerStats::PHASE_VERIFY);
+
+        if (!theMessage.VerifySignature(*pNym)) {
+            Log::Output(0, "Signature verification failed!\n");
+            return false;
+        }
     }
     Log::Output(3, "Signature verified! The message WAS signed by "
                    "the Nym\'s private key.\n");
@@ -595,10 +649,17 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
     // Now we might as well load up the rest of the Nym.
     // Notice I use the && to only load the nymfile if it's NOT the
     // server Nym.
-    if (!bNymIsServerNym && !pNym->LoadSignedNymfile(server_->m_nymServer)) {
-        Log::vError("Error loading Nymfile: %s\n", theMessage.m_strNymID.Get());
-        return false;
+    {
+        ServerStats::Timer timer(ServerStats::PHASE_NYM_LOAD);
+
+        if (!bNymIsServerNym && !bNymIsCached &&
+            !pNym->LoadSignedNymfile(server_->m_nymServer)) {
+            Log::vError("Error loading Nymfile: %s\n",
+                        theMessage.m_strNymID.Get());
+            return false;
+        }
     }
+    theLease.SetVerified();
     Log::Output(2, "Successfully loaded Nymfile into memory.\n");
 
     // ENTERING THE INNER SANCTUM OF SECURITY. If the user got all
@@ -1138,6 +1199,25 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
 
         return true;
     }
+    else if (theMessage.m_strCommand.Compare("getBoxReceipts")) {
+        Log::vOutput(0,
+                     "\n==> Received a getBoxReceipts message. Nym: %s ...\n",
+                     strMsgNymID.Get());
+
+        bool bRunIt = true;
+        if (0 == theMessage.m_lDepth)
+            OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_nymbox)
+        else if (1 == theMessage.m_lDepth)
+            OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_inbox)
+        else if (2 == theMessage.m_lDepth)
+            OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_outbox)
+        else
+            bRunIt = false;
+
+        if (bRunIt) UserCmdGetBoxReceipts(theMessage, msgOut);
+
+        return true;
+    }
     else if (theMessage.m_strCommand.Compare("getAccountData")) {
         Log::vOutput(0, "\n==> Received a getAccountData message.  Acct: %s "
                         "Nym: %s  ...\n",
@@ -1238,6 +1318,17 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
 
         return true;
     }
+    else if (theMessage.m_strCommand.Compare("getMarketCandles")) {
+        Log::vOutput(
+            0, "\n==> Received a getMarketCandles message. Nym: %s ...\n",
+            strMsgNymID.Get());
+
+        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_market_candles);
+
+        UserCmdGetMarketCandles(*pNym, theMessage, msgOut);
+
+        return true;
+    }
     else if (theMessage.m_strCommand.Compare("getNymMarketOffers")) {
         Log::vOutput(
             0, "\n==> Received a getNymMarketOffers message. Nym: %s ...\n",
@@ -1269,6 +1360,17 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
 
         return true;
     }
+    else if (theMessage.m_strCommand.Compare("getServerStats")) {
+        Log::vOutput(0,
+                     "\n==> Received a getServerStats message. Nym: %s ...\n",
+                     strMsgNymID.Get());
+
+        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_server_stats);
+
+        UserCmdGetServerStats(theMessage, msgOut);
+
+        return true;
+    }
     else {
         Log::vError("Unknown command type in the XML, or missing payload, in "
                     "ProcessMessage.\n");
@@ -1327,6 +1429,7 @@ void UserCommandProcessor::UserCmdGetMarketList(Nym&, Message& MsgIn,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -1362,8 +1465,21 @@ void UserCommandProcessor::UserCmdGetMarketOffers(Nym&, Message& MsgIn,
         OTASCIIArmor ascOutput;
         int32_t nOfferCount = 0;
 
-        msgOut.m_bSuccess =
-            pMarket->GetOfferList(ascOutput, lDepth, nOfferCount);
+        // A client that already has the full-depth offers as of some version
+        // can ask for just the changes since then. If those can't be given
+        // (see HasChangesSince) it gets the list instead.
+        const int64_t lSinceVersion = MsgIn.m_lTransactionNum;
+
+        msgOut.m_lTransactionNum = pMarket->GetVersion();
+        msgOut.m_bBool = (lSinceVersion > 0) &&
+                         pMarket->HasChangesSince(lSinceVersion, lDepth);
+
+        if (msgOut.m_bBool)
+            msgOut.m_bSuccess =
+                pMarket->GetOfferChanges(ascOutput, lSinceVersion, nOfferCount);
+        else
+            msgOut.m_bSuccess =
+                pMarket->GetOfferList(ascOutput, lDepth, nOfferCount);
 
         if ((true == msgOut.m_bSuccess) && (nOfferCount > 0)) {
             msgOut.m_ascPayload = ascOutput;
@@ -1379,6 +1495,7 @@ void UserCommandProcessor::UserCmdGetMarketOffers(Nym&, Message& MsgIn,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -1429,6 +1546,7 @@ void UserCommandProcessor::UserCmdGetMarketRecentTrades(Nym&, Message& MsgIn,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -1441,6 +1559,57 @@ void UserCommandProcessor::UserCmdGetMarketRecentTrades(Nym&, Message& MsgIn,
     msgOut.SaveContract();
 }
 
+// Get price candles for a specific market, at one resolution.
+void UserCommandProcessor::UserCmdGetMarketCandles(Nym&, Message& MsgIn,
+                                                   Message& msgOut)
+{
+    // (1) set up member variables
+    msgOut.m_strCommand = "getMarketCandlesResponse"; // reply to
+                                                      // getMarketCandles
+    msgOut.m_strNymID = MsgIn.m_strNymID;             // NymID
+    msgOut.m_strNymID2 = MsgIn.m_strNymID2;           // Market ID.
+    msgOut.m_strType = MsgIn.m_strType;               // Resolution.
+
+    int64_t lDepth = MsgIn.m_lDepth;
+    if (lDepth < 0) lDepth = 0;
+
+    const Identifier MARKET_ID(MsgIn.m_strNymID2);
+
+    OTMarket* pMarket = server_->m_Cron.GetMarket(MARKET_ID);
+
+    // If success,
+    if ((msgOut.m_bSuccess =
+             ((pMarket != nullptr) ? true : false))) // if assigned true
+    {
+        OTASCIIArmor ascOutput;
+        int32_t nCandleCount = 0;
+
+        msgOut.m_bSuccess = pMarket->GetCandles(MsgIn.m_strType.Get(), lDepth,
+                                                ascOutput, nCandleCount);
+
+        if (true == msgOut.m_bSuccess) {
+            msgOut.m_lDepth = nCandleCount;
+
+            if (nCandleCount > 0) msgOut.m_ascPayload = ascOutput;
+        }
+    }
+
+    // if Failed, we send the user's message back to him, ascii-armored as part
+    // of response.
+    if (!msgOut.m_bSuccess) {
+        String tempInMessage(MsgIn);
+        msgOut.m_ascInReferenceTo.SetString(tempInMessage);
+    }
+
+    // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
+    msgOut.SignContract(server_->m_nymServer);
+
+    // (3) Save the Message (with signatures and all, back to its internal
+    // member m_strRawFile.)
+    msgOut.SaveContract();
+}
+
 // Get the offers that a specific Nym has placed on a specific market.
 //
 void UserCommandProcessor::UserCmdGetNymMarketOffers(Nym& theNym,
@@ -1473,6 +1642,7 @@ void UserCommandProcessor::UserCmdGetNymMarketOffers(Nym& theNym,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -1498,6 +1668,7 @@ void UserCommandProcessor::UserCmdPingNotary(Nym&, Message& MsgIn,
         msgOut.m_bSuccess = false;
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -1708,6 +1879,7 @@ void UserCommandProcessor::UserCmdGetTransactionNumbers(Nym& theNym,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -1768,6 +1940,7 @@ void UserCommandProcessor::UserCmdGetRequestNumber(Nym& theNym, Message& MsgIn,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -1806,6 +1979,7 @@ void UserCommandProcessor::UserCmdSendNymMessage(Nym& theNym, Message& MsgIn,
         msgOut.m_bSuccess = true;
     }
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -1845,6 +2019,7 @@ void UserCommandProcessor::UserCmdSendNymInstrument(Nym& theNym, Message& MsgIn,
         msgOut.m_bSuccess = true;
     }
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -1926,6 +2101,7 @@ void UserCommandProcessor::UserCmdCheckNym(Nym&, Message& MsgIn,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -2143,6 +2319,7 @@ void UserCommandProcessor::UserCmdUsageCredits(Nym& theNym, Message& MsgIn,
                                   // to usage credits.
     }
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -2155,6 +2332,30 @@ void UserCommandProcessor::UserCmdUsageCredits(Nym& theNym, Message& MsgIn,
     msgOut.SaveContract();
 }
 
+// Sends the per-command request counts and latencies (see ServerStats) back
+// in the payload, as XML.
+void UserCommandProcessor::UserCmdGetServerStats(Message& msgIn,
+                                                 Message& msgOut)
+{
+    // (1) set up member variables
+    msgOut.m_strCommand = "getServerStatsResponse"; // reply to getServerStats
+    msgOut.m_strNymID = msgIn.m_strNymID;           // NymID
+
+    String strStats;
+    server_->stats_.Snapshot(strStats);
+
+    msgOut.m_ascPayload.SetString(strStats);
+    msgOut.m_bSuccess = msgOut.m_ascPayload.Exists();
+
+    // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
+    msgOut.SignContract(server_->m_nymServer);
+
+    // (3) Save the Message (with signatures and all, back to its internal
+    // member m_strRawFile.)
+    msgOut.SaveContract();
+}
+
 /// An existing user is issuing a new currency.
 void UserCommandProcessor::UserCmdRegisterInstrumentDefinition(Nym& theNym,
                                                                Message& MsgIn,
@@ -2453,6 +2654,7 @@ void UserCommandProcessor::UserCmdRegisterInstrumentDefinition(Nym& theNym,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -2778,6 +2980,7 @@ void UserCommandProcessor::UserCmdIssueBasket(Nym& theNym, Message& MsgIn,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -2925,6 +3128,7 @@ void UserCommandProcessor::UserCmdRegisterAccount(Nym& theNym, Message& MsgIn,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -3139,6 +3343,7 @@ void UserCommandProcessor::UserCmdGetAccountData(Nym&, Message& MsgIn,
         msgOut.m_bSuccess = true;
     }
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(static_cast<const Nym&>(server_->m_nymServer));
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -3233,6 +3438,7 @@ void UserCommandProcessor::UserCmdQueryInstrumentDefinitions(Nym&,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(static_cast<const Nym&>(server_->m_nymServer));
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -3285,6 +3491,7 @@ void UserCommandProcessor::UserCmdGetInstrumentDefinition(Message& MsgIn,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(static_cast<const Nym&>(server_->m_nymServer));
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -3437,6 +3644,7 @@ void UserCommandProcessor::UserCmdTriggerClause(Nym& theNym, Message& MsgIn,
                                   // server side
         theSrvrNymboxHash.GetString(msgOut.m_strNymboxHash);
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(static_cast<const Nym&>(server_->m_nymServer));
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -3500,6 +3708,7 @@ void UserCommandProcessor::UserCmdGetMint(Nym&, Message& MsgIn, Message& msgOut)
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(static_cast<const Nym&>(server_->m_nymServer));
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -3620,6 +3829,7 @@ void UserCommandProcessor::UserCmdDeleteUser(Nym& theNym, Message& MsgIn,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(static_cast<const Nym&>(server_->m_nymServer));
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -3657,89 +3867,86 @@ void UserCommandProcessor::UserCmdDeleteUser(Nym& theNym, Message& MsgIn,
     }
 }
 
-// the "accountID" on this message will contain the NymID if retrieving a
-// boxreceipt for
-// the Nymbox. Otherwise it will contain an AcctID if retrieving a boxreceipt
-// for an Asset Acct.
+// Loads the nymbox, inbox or outbox (msgIn.m_lDepth 0, 1 or 2) that a
+// getBoxReceipt or getBoxReceipts message asks for, without loading its box
+// receipts. The "accountID" holds the NymID for the Nymbox, and an AcctID
+// otherwise.
 //
-void UserCommandProcessor::UserCmdGetBoxReceipt(Message& MsgIn, Message& msgOut)
+bool UserCommandProcessor::LoadBoxForReceipts(const Message& MsgIn,
+                                              Ledger& theBox)
 {
-    // (1) set up member variables
-    msgOut.m_strCommand = "getBoxReceiptResponse"; // reply to getBoxReceipt
-    msgOut.m_strNymID = MsgIn.m_strNymID;          // NymID
-    msgOut.m_strAcctID = MsgIn.m_strAcctID;        // the asset account ID
-                                                   // (inbox/outbox), or Nym ID
-                                                   // (nymbox)
-    msgOut.m_lTransactionNum =
-        MsgIn.m_lTransactionNum; // TransactionNumber for the receipt in the box
-                                 // (unique to the box.)
-    msgOut.m_lDepth = MsgIn.m_lDepth;
-    msgOut.m_bSuccess = false;
-
-    const Identifier NYM_ID(MsgIn.m_strNymID), NOTARY_ID(MsgIn.m_strNotaryID),
-        ACCOUNT_ID(MsgIn.m_strAcctID);
-
-    std::unique_ptr<Ledger> pLedger(new Ledger(NYM_ID, ACCOUNT_ID, NOTARY_ID));
-
-    bool bErrorCondition = false;
-    bool bSuccessLoading = false;
+    const Identifier NYM_ID(MsgIn.m_strNymID), ACCOUNT_ID(MsgIn.m_strAcctID);
 
     switch (MsgIn.m_lDepth) {
     case 0: // Nymbox
         if (NYM_ID == ACCOUNT_ID) {
-            // It's verified using VerifyAccount() below this switch block.
-            bSuccessLoading = pLedger->LoadNymbox();
-        }
-        else // Inbox / Outbox.
-        {
-            Log::vError(
-                "UserCommandProcessor::UserCmdGetBoxReceipt: User requested "
-                "Nymbox, but "
-                "failed to provide the "
-                "NymID (%s) in the AccountID (%s) field as expected.\n",
-                MsgIn.m_strNymID.Get(), MsgIn.m_strAcctID.Get());
-            bErrorCondition = true;
+            // It's verified by the caller, after this.
+            return theBox.LoadNymbox();
         }
-        break;
+        Log::vError("UserCommandProcessor::LoadBoxForReceipts: User requested "
+                    "Nymbox, but "
+                    "failed to provide the "
+                    "NymID (%s) in the AccountID (%s) field as expected.\n",
+                    MsgIn.m_strNymID.Get(), MsgIn.m_strAcctID.Get());
+        return false;
     case 1: // Inbox
         if (NYM_ID == ACCOUNT_ID) {
             Log::vError(
-                "UserCommandProcessor::UserCmdGetBoxReceipt: User requested "
+                "UserCommandProcessor::LoadBoxForReceipts: User requested "
                 "Inbox, but erroneously provided the "
                 "NymID (%s) in the AccountID (%s) field.\n",
                 MsgIn.m_strNymID.Get(), MsgIn.m_strAcctID.Get());
-            bErrorCondition = true;
-        }
-        else {
-            // It's verified using VerifyAccount() below this switch block.
-            bSuccessLoading = pLedger->LoadInbox();
+            return false;
         }
-        break;
+        // It's verified by the caller, after this.
+        return theBox.LoadInbox();
     case 2: // Outbox
         if (NYM_ID == ACCOUNT_ID) {
             Log::vError(
-                "UserCommandProcessor::UserCmdGetBoxReceipt: User requested "
+                "UserCommandProcessor::LoadBoxForReceipts: User requested "
                 "Outbox, but erroneously provided the "
                 "NymID (%s) in the AccountID (%s) field.\n",
                 MsgIn.m_strNymID.Get(), MsgIn.m_strAcctID.Get());
-            bErrorCondition = true;
-        }
-        else {
-            // It's verified using VerifyAccount() below this switch block.
-            bSuccessLoading = pLedger->LoadOutbox();
+            return false;
         }
-        break;
+        // It's verified by the caller, after this.
+        return theBox.LoadOutbox();
     default:
-        Log::vError("UserCommandProcessor::UserCmdGetBoxReceipt: Unknown box "
+        Log::vError("UserCommandProcessor::LoadBoxForReceipts: Unknown box "
                     "type: %" PRId64 "\n",
                     MsgIn.m_lDepth);
-        bErrorCondition = true;
-        break;
+        return false;
     }
+}
+
+// the "accountID" on this message will contain the NymID if retrieving a
+// boxreceipt for
+// the Nymbox. Otherwise it will contain an AcctID if retrieving a boxreceipt
+// for an Asset Acct.
+//
+void UserCommandProcessor::UserCmdGetBoxReceipt(Message& MsgIn, Message& msgOut)
+{
+    // (1) set up member variables
+    msgOut.m_strCommand = "getBoxReceiptResponse"; // reply to getBoxReceipt
+    msgOut.m_strNymID = MsgIn.m_strNymID;          // NymID
+    msgOut.m_strAcctID = MsgIn.m_strAcctID;        // the asset account ID
+                                                   // (inbox/outbox), or Nym ID
+                                                   // (nymbox)
+    msgOut.m_lTransactionNum =
+        MsgIn.m_lTransactionNum; // TransactionNumber for the receipt in the box
+                                 // (unique to the box.)
+    msgOut.m_lDepth = MsgIn.m_lDepth;
+    msgOut.m_bSuccess = false;
+
+    const Identifier NYM_ID(MsgIn.m_strNymID), NOTARY_ID(MsgIn.m_strNotaryID),
+        ACCOUNT_ID(MsgIn.m_strAcctID);
+
+    std::unique_ptr<Ledger> pLedger(new Ledger(NYM_ID, ACCOUNT_ID, NOTARY_ID));
+
     // At this point, we have the box loaded. Now let's use it to
     // load the appropriate box receipt...
 
-    if (bSuccessLoading && !bErrorCondition &&
+    if (LoadBoxForReceipts(MsgIn, *pLedger) &&
         // This call
         // causes all the Box Receipts to be loaded up and we don't need them
         // here, except
@@ -3848,6 +4055,7 @@ void UserCommandProcessor::UserCmdGetBoxReceipt(Message& MsgIn, Message& msgOut)
     msgOut.m_ascInReferenceTo.SetString(tempInMessage);
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(static_cast<const Nym&>(server_->m_nymServer));
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -3860,6 +4068,129 @@ void UserCommandProcessor::UserCmdGetBoxReceipt(Message& MsgIn, Message& msgOut)
     msgOut.SaveContract();
 }
 
+// Same as getBoxReceipt, for several receipts in the same box. The box is
+// loaded and verified once, and the receipts go back in a single reply.
+//
+// A reply holds as many of the receipts, in ascending transaction number, as
+// fit in BOX_RECEIPTS_REPLY_SIZE. The client asks again for any that are
+// missing from the reply. Receipts that aren't in the box, or that fail to
+// load, are left out (and logged); the reply still succeeds if the box
+// itself loaded.
+//
+void UserCommandProcessor::UserCmdGetBoxReceipts(Message& MsgIn,
+                                                 Message& msgOut)
+{
+    // (1) set up member variables
+    msgOut.m_strCommand = "getBoxReceiptsResponse"; // reply to getBoxReceipts
+    msgOut.m_strNymID = MsgIn.m_strNymID;           // NymID
+    msgOut.m_strAcctID = MsgIn.m_strAcctID; // the asset account ID
+                                            // (inbox/outbox), or Nym ID
+                                            // (nymbox)
+    msgOut.m_lDepth = MsgIn.m_lDepth;
+    msgOut.m_bSuccess = false;
+
+    const char* szBoxType =
+        (MsgIn.m_lDepth == 0) ? "nymbox"
+                              : ((MsgIn.m_lDepth == 1) ? "inbox" : "outbox");
+
+    const Identifier NYM_ID(MsgIn.m_strNymID), NOTARY_ID(MsgIn.m_strNotaryID),
+        ACCOUNT_ID(MsgIn.m_strAcctID);
+
+    std::unique_ptr<Ledger> pLedger(new Ledger(NYM_ID, ACCOUNT_ID, NOTARY_ID));
+
+    std::set<int64_t> setNums;
+    MsgIn.m_TransactionNums.Output(setNums);
+
+    if (setNums.empty()) {
+        Log::vError("UserCommandProcessor::UserCmdGetBoxReceipts: No "
+                    "transaction numbers requested. NymID (%s) and "
+                    "AccountID (%s) FYI.\n",
+                    MsgIn.m_strNymID.Get(), MsgIn.m_strAcctID.Get());
+    }
+    else if (LoadBoxForReceipts(MsgIn, *pLedger) &&
+             pLedger->VerifyContractID() &&
+             pLedger->VerifySignature(server_->m_nymServer)) {
+        uint32_t lReplySize = 0;
+
+        for (const int64_t& lTransactionNum : setNums) {
+            if (nullptr == pLedger->GetTransaction(lTransactionNum)) {
+                Log::vError("UserCommandProcessor::UserCmdGetBoxReceipts: "
+                            "User requested a transaction number (%" PRId64
+                            ") that's not in the %s. NymID (%s) and "
+                            "AccountID (%s) FYI.\n",
+                            lTransactionNum, szBoxType, MsgIn.m_strNymID.Get(),
+                            MsgIn.m_strAcctID.Get());
+                continue;
+            }
+
+            // Replaces the abbreviated transaction inside pLedger with the
+            // full version, so it has to be looked up again afterwards. (See
+            // UserCmdGetBoxReceipt.)
+            pLedger->LoadBoxReceipt(lTransactionNum);
+
+            OTTransaction* pTransaction =
+                pLedger->GetTransaction(lTransactionNum);
+
+            if ((nullptr == pTransaction) || pTransaction->IsAbbreviated() ||
+                !pTransaction->VerifyContractID() ||
+                !pTransaction->VerifySignature(server_->m_nymServer)) {
+                Log::vError("UserCommandProcessor::UserCmdGetBoxReceipts: "
+                            "Failed retrieving transaction number (%" PRId64
+                            ") from the %s. NymID (%s) and AccountID (%s) "
+                            "FYI.\n",
+                            lTransactionNum, szBoxType, MsgIn.m_strNymID.Get(),
+                            MsgIn.m_strAcctID.Get());
+                continue;
+            }
+
+            const String strBoxReceipt(*pTransaction);
+            OT_ASSERT(strBoxReceipt.Exists());
+
+            OTASCIIArmor ascReceipt(strBoxReceipt);
+
+            // The rest wait for the next request. (There is always room for
+            // at least one.)
+            if ((lReplySize > 0) &&
+                (lReplySize + ascReceipt.GetLength() >
+                 BOX_RECEIPTS_REPLY_SIZE)) {
+                break;
+            }
+
+            lReplySize += ascReceipt.GetLength();
+            msgOut.m_mapBoxReceipts[lTransactionNum] = ascReceipt;
+        }
+
+        msgOut.m_bSuccess = true;
+
+        Log::vOutput(3, "UserCommandProcessor::UserCmdGetBoxReceipts: "
+                        "Success: User is retrieving %" PRI_SIZE
+                        " of %" PRI_SIZE " requested box receipts in the %s "
+                        "for NymID (%s) AccountID (%s).\n",
+                     msgOut.m_mapBoxReceipts.size(), setNums.size(), szBoxType,
+                     MsgIn.m_strNymID.Get(), MsgIn.m_strAcctID.Get());
+    }
+    else {
+        Log::vError("UserCommandProcessor::UserCmdGetBoxReceipts: Failed "
+                    "loading or verifying %s. NymID (%s) and AccountID (%s) "
+                    "FYI.\n",
+                    szBoxType, MsgIn.m_strNymID.Get(),
+                    MsgIn.m_strAcctID.Get());
+    }
+
+    // Grab the incoming message in plaintext form
+    const String tempInMessage(MsgIn);
+    // Set it into the base64-encoded object on the outgoing message
+    msgOut.m_ascInReferenceTo.SetString(tempInMessage);
+
+    // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
+    msgOut.SignContract(static_cast<const Nym&>(server_->m_nymServer));
+
+    // (3) Save the Message (with signatures and all, back to its internal
+    // member m_strRawFile.)
+    msgOut.SaveContract();
+}
+
 // If the client wants to delete an asset account, the server will allow it...
 // ...IF: the Inbox and Outbox are both EMPTY. AND the Balance must be empty as
 // well!
@@ -3977,6 +4308,7 @@ void UserCommandProcessor::UserCmdDeleteAssetAcct(Nym& theNym, Message& MsgIn,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(static_cast<const Nym&>(server_->m_nymServer));
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -4117,6 +4449,7 @@ void UserCommandProcessor::UserCmdGetNymbox(Nym& theNym, Message& MsgIn,
     }
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(static_cast<const Nym&>(server_->m_nymServer));
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -4152,6 +4485,9 @@ void UserCommandProcessor::UserCmdProcessNymbox(Nym& theNym, Message& MsgIn,
 
     bool bTransSuccess = false;
 
+    // (See UserCmdNotarizeTransaction.)
+    OTDB::ScopedBatch theBatch;
+
     const Identifier theMsgNymboxHash(
         MsgIn.m_strNymboxHash); // theMsgNymboxHash is the hash sent by the
                                 // client side
@@ -4284,6 +4620,11 @@ void UserCommandProcessor::UserCmdProcessNymbox(Nym& theNym, Message& MsgIn,
 
 send_message:
 
+    if (!theBatch.Commit()) {
+        RejectTransactionReplies(*pResponseLedger);
+        bTransSuccess = false;
+    }
+
     // sign the ledger
     pResponseLedger->SignContract(server_->m_nymServer);
     pResponseLedger->SaveContract();
@@ -4321,6 +4662,7 @@ send_message:
         theSrvrNymboxHash.GetString(msgOut.m_strNymboxHash);
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -4389,6 +4731,11 @@ void UserCommandProcessor::UserCmdProcessInbox(Nym& theNym, Message& MsgIn,
     String strLedger(MsgIn.m_ascPayload);
 
     bool bTransSuccess = false;
+
+    // Includes the transaction numbers removed from theNym below.
+    // (See UserCmdNotarizeTransaction.)
+    OTDB::ScopedBatch theBatch;
+
     const Identifier theMsgNymboxHash(
         MsgIn.m_strNymboxHash); // theMsgNymboxHash is the hash sent by the
                                 // client side
@@ -4604,6 +4951,11 @@ send_message:
         pResponseLedger->AddTransaction(*pTranResponse);
     }
 
+    if (!theBatch.Commit()) {
+        RejectTransactionReplies(*pResponseLedger);
+        bTransSuccess = false;
+    }
+
     // sign the outoing transaction
     OT_ASSERT_MSG(nullptr != pTranResponse, "UserCommandProcessor::"
                                             "UserCmdProcessInbox 3: nullptr != "
@@ -4651,6 +5003,7 @@ send_message:
         theSrvrNymboxHash.GetString(msgOut.m_strNymboxHash);
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -4687,6 +5040,30 @@ send_message:
     }
 }
 
+// Called when the writes of the transactions in theLedger could not be
+// committed. Every reply item becomes a rejection, and is signed again.
+void UserCommandProcessor::RejectTransactionReplies(Ledger& theLedger)
+{
+    Log::vError("%s: Failed committing the transactions. Rejecting them.\n",
+                __FUNCTION__);
+
+    for (auto& it : theLedger.GetTransactionMap()) {
+        OTTransaction* pTransaction = it.second;
+        OT_ASSERT(nullptr != pTransaction);
+
+        for (auto& pItem : pTransaction->GetItemList()) {
+            pItem->SetStatus(Item::rejection);
+            pItem->ReleaseSignatures();
+            pItem->SignContract(server_->m_nymServer);
+            pItem->SaveContract();
+        }
+
+        pTransaction->ReleaseSignatures();
+        pTransaction->SignContract(server_->m_nymServer);
+        pTransaction->SaveContract();
+    }
+}
+
 /// There will be more code here to handle all that. In the meantime, I just
 /// send
 /// a test response back to make sure the communication works.
@@ -4717,6 +5094,10 @@ void UserCommandProcessor::UserCmdNotarizeTransaction(Nym& theNym,
     bool bCancelled = false;    // for "failed" transactions that were actually
                                 // successful cancellations.
 
+    // Everything the transactions write (accounts, boxes, box receipts,
+    // nymfiles...) is committed together, before the reply is built.
+    OTDB::ScopedBatch theBatch;
+
     int64_t lTransactionNumber = 0, lResponseNumber = 0;
     // Since the one going back (above) is a new ledger, we have to call
     // GenerateLedger.
@@ -4868,6 +5249,12 @@ void UserCommandProcessor::UserCmdNotarizeTransaction(Nym& theNym,
                                      // response, and will handle deleting it.
         }
 
+        if (!theBatch.Commit()) {
+            RejectTransactionReplies(*pResponseLedger);
+            bTransSuccess = false;
+            bCancelled = false;
+        }
+
         // TODO: should consider saving a copy of the response ledger here on
         // the server.
         // Until the user signs off of the responses, maybe the user didn't
@@ -4923,6 +5310,7 @@ send_message:
         theSrvrNymboxHash.GetString(msgOut.m_strNymboxHash);
 
     // (2) Sign the Message
+    ServerStats::Timer signTimer(ServerStats::PHASE_SIGN);
     msgOut.SignContract(server_->m_nymServer);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/Identifier.hpp>
+
+#include <unordered_set>
+
+using namespace opentxs;
+
+namespace
+{
+
+Identifier makeID(const char* bytes)
+{
+    Identifier id;
+    id.Assign(bytes, 20);
+    return id;
+}
+
+} // namespace
+
+TEST(Identifier, compare_equal)
+{
+    Identifier one = makeID("aaaaaaaaaaaaaaaaaaaa");
+    Identifier other = makeID("aaaaaaaaaaaaaaaaaaaa");
+    ASSERT_TRUE(one == other);
+    ASSERT_FALSE(one != other);
+    ASSERT_TRUE(one <= other);
+    ASSERT_TRUE(one >= other);
+}
+
+TEST(Identifier, compare_ordering)
+{
+    Identifier one = makeID("aaaaaaaaaaaaaaaaaaab");
+    Identifier other = makeID("aaaaaaaaaaaaaaaaaaac");
+    ASSERT_TRUE(one < other);
+    ASSERT_TRUE(other > one);
+    ASSERT_FALSE(one == other);
+}
+
+TEST(Identifier, compare_empty)
+{
+    Identifier empty;
+    Identifier one = makeID("aaaaaaaaaaaaaaaaaaaa");
+    ASSERT_TRUE(empty == Identifier());
+    ASSERT_TRUE(empty < one);
+}
+
+TEST(Identifier, hash_in_unordered_set)
+{
+    std::unordered_set<Identifier> ids;
+    ids.insert(makeID("aaaaaaaaaaaaaaaaaaaa"));
+    ids.insert(makeID("bbbbbbbbbbbbbbbbbbbb"));
+    ids.insert(makeID("aaaaaaaaaaaaaaaaaaaa"));
+    ASSERT_EQ(2u, ids.size());
+    ASSERT_EQ(1u, ids.count(makeID("bbbbbbbbbbbbbbbbbbbb")));
+}
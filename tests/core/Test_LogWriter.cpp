@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/util/LogWriter.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+std::string ReadFile(const std::string& path)
+{
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+class LogWriterTest : public ::testing::Test
+{
+protected:
+    LogWriterTest()
+        : path_("Test_LogWriter.log")
+    {
+        Remove();
+    }
+    ~LogWriterTest()
+    {
+        Remove();
+    }
+
+    void Remove()
+    {
+        std::remove(path_.c_str());
+        std::remove((path_ + ".1").c_str());
+        std::remove((path_ + ".2").c_str());
+    }
+
+    const std::string path_;
+};
+} // namespace
+
+TEST_F(LogWriterTest, flush_writes_lines_in_order)
+{
+    LogWriter writer(path_, 4);
+
+    for (int i = 0; i < 10; ++i) writer.Push(std::to_string(i) + "\n");
+    writer.Flush();
+
+    ASSERT_EQ("0\n1\n2\n3\n4\n5\n6\n7\n8\n9\n", ReadFile(path_));
+}
+
+TEST_F(LogWriterTest, keeps_every_line_from_several_threads)
+{
+    {
+        LogWriter writer(path_, 16);
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&writer]() {
+                for (int i = 0; i < 250; ++i) writer.Push("line\n");
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+
+    const std::string contents = ReadFile(path_);
+    ASSERT_EQ(1000 * std::string("line\n").size(), contents.size());
+}
+
+TEST_F(LogWriterTest, rotates_by_size)
+{
+    LogWriter writer(path_, 4);
+    writer.SetRotation(8, 2);
+
+    writer.Push("first\n");
+    writer.Flush();
+    writer.Push("second\n");
+    writer.Flush();
+    writer.Push("third\n");
+    writer.Flush();
+
+    ASSERT_EQ("third\n", ReadFile(path_));
+    ASSERT_EQ("second\n", ReadFile(path_ + ".1"));
+    ASSERT_EQ("first\n", ReadFile(path_ + ".2"));
+}
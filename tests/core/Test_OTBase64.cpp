@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/crypto/OTBase64.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+std::string Encode(const std::string& input, bool bLineBreaks)
+{
+    std::string output(OTBase64::EncodedSize(input.size(), bLineBreaks), '?');
+    output.resize(OTBase64::Encode(
+        reinterpret_cast<const uint8_t*>(input.data()), input.size(),
+        &output[0], bLineBreaks));
+    return output;
+}
+
+bool Decode(const std::string& input, std::string& output)
+{
+    std::vector<uint8_t> buffer(OTBase64::DecodedSizeMax(input.size()));
+    size_t size = buffer.size();
+
+    if (!OTBase64::Decode(input.data(), input.size(), buffer.data(), size))
+        return false;
+
+    output.assign(buffer.begin(), buffer.begin() + size);
+    return true;
+}
+} // namespace
+
+TEST(OTBase64, encodes_rfc4648_vectors)
+{
+    ASSERT_EQ("", Encode("", false));
+    ASSERT_EQ("Zg==", Encode("f", false));
+    ASSERT_EQ("Zm8=", Encode("fo", false));
+    ASSERT_EQ("Zm9v", Encode("foo", false));
+    ASSERT_EQ("Zm9vYmE=", Encode("fooba", false));
+    ASSERT_EQ("Zm9vYmFy\n", Encode("foobar", true));
+}
+
+TEST(OTBase64, breaks_lines_like_openssl)
+{
+    const std::string full(48, 'a');
+    const std::string encoded = Encode(full + full + "a", true);
+
+    ASSERT_EQ(64u * 2 + 4 + 3, encoded.size());
+    ASSERT_EQ('\n', encoded[64]);
+    ASSERT_EQ('\n', encoded[129]);
+    ASSERT_EQ("YQ==\n", encoded.substr(130));
+    ASSERT_EQ('\n', Encode(full, true).back());
+    ASSERT_EQ(65u, Encode(full, true).size());
+}
+
+TEST(OTBase64, round_trips_every_length)
+{
+    for (size_t size = 0; size < 200; ++size) {
+        std::string input;
+        for (size_t i = 0; i < size; ++i) input += static_cast<char>(i * 7);
+
+        for (bool bLineBreaks : {false, true}) {
+            std::string output;
+            ASSERT_TRUE(Decode(Encode(input, bLineBreaks), output));
+            ASSERT_EQ(input, output);
+        }
+    }
+}
+
+TEST(OTBase64, decodes_whitespace_and_missing_padding)
+{
+    std::string output;
+
+    ASSERT_TRUE(Decode("Zm9v\r\nYmFy\r\n", output));
+    ASSERT_EQ("foobar", output);
+    ASSERT_TRUE(Decode("Zm8", output));
+    ASSERT_EQ("fo", output);
+}
+
+TEST(OTBase64, rejects_invalid_input)
+{
+    std::string output;
+
+    ASSERT_FALSE(Decode("Zm9v*mFy", output));
+    ASSERT_FALSE(Decode("Zg==Zg==", output));
+    ASSERT_FALSE(Decode("Z", output));
+    ASSERT_FALSE(Decode("Z===", output));
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include <opentxs/core/OTData.hpp>
 
+#include <cstring>
+#include <string>
+
 using namespace opentxs;
 
 namespace
@@ -58,3 +61,29 @@ TEST(OTData, compare_not_equal_to_other_different)
     OTData other("zzzz", 4);
     ASSERT_TRUE(one != other);
 }
+
+TEST(OTData, swap_inline_with_heap)
+{
+    const std::string large(100, 'x');
+    OTData small("abcd", 4);
+    OTData big(large.data(), large.size());
+
+    small.swap(big);
+
+    ASSERT_EQ(large.size(), small.GetSize());
+    ASSERT_EQ(0, memcmp(small.GetPointer(), large.data(), large.size()));
+    ASSERT_EQ(4u, big.GetSize());
+    ASSERT_EQ(0, memcmp(big.GetPointer(), "abcd", 4));
+}
+
+TEST(OTData, concatenate_past_inline_size)
+{
+    const std::string large(100, 'x');
+    OTData one("abcd", 4);
+    OTData other(large.data(), large.size());
+    OTData expected((std::string("abcd") + large).data(), 4 + large.size());
+
+    one += other;
+
+    ASSERT_TRUE(one == expected);
+}
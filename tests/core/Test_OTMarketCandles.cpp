@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/trade/OTMarketCandles.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+class OTMarketCandlesTest : public ::testing::Test
+{
+protected:
+    OTMarketCandlesTest()
+        : path_("Test_OTMarketCandles.candles")
+    {
+        std::remove(path_.c_str());
+    }
+    ~OTMarketCandlesTest()
+    {
+        std::remove(path_.c_str());
+    }
+
+    const std::string path_;
+};
+
+// 2015-01-01 00:00:00 UTC
+const time64_t DAY = 1420070400;
+} // namespace
+
+TEST_F(OTMarketCandlesTest, aggregates_trades_in_the_same_minute)
+{
+    OTMarketCandles candles;
+    ASSERT_TRUE(candles.Open(path_));
+
+    ASSERT_TRUE(candles.AddTrade(DAY + 5, 100, 1));
+    ASSERT_TRUE(candles.AddTrade(DAY + 20, 120, 2));
+    ASSERT_TRUE(candles.AddTrade(DAY + 40, 90, 3));
+    ASSERT_TRUE(candles.AddTrade(DAY + 59, 110, 4));
+
+    std::vector<OTMarketCandles::Candle> result;
+    ASSERT_TRUE(candles.GetCandles("1m", 0, result));
+    ASSERT_EQ(1u, result.size());
+    ASSERT_EQ(DAY, result[0].tStart);
+    ASSERT_EQ(100, result[0].lOpen);
+    ASSERT_EQ(120, result[0].lHigh);
+    ASSERT_EQ(90, result[0].lLow);
+    ASSERT_EQ(110, result[0].lClose);
+    ASSERT_EQ(10, result[0].lVolume);
+}
+
+TEST_F(OTMarketCandlesTest, candles_survive_reopening)
+{
+    {
+        OTMarketCandles candles;
+        ASSERT_TRUE(candles.Open(path_));
+        ASSERT_TRUE(candles.AddTrade(DAY, 100, 1));
+        ASSERT_TRUE(candles.AddTrade(DAY + 60, 105, 2));
+        ASSERT_TRUE(candles.AddTrade(DAY + 3600, 95, 3));
+    }
+
+    OTMarketCandles candles;
+    ASSERT_TRUE(candles.Open(path_));
+
+    std::vector<OTMarketCandles::Candle> result;
+    ASSERT_TRUE(candles.GetCandles("1m", 0, result));
+    ASSERT_EQ(3u, result.size());
+    ASSERT_EQ(DAY + 60, result[1].tStart);
+
+    ASSERT_TRUE(candles.GetCandles("1h", 0, result));
+    ASSERT_EQ(2u, result.size());
+    ASSERT_EQ(105, result[0].lClose);
+    ASSERT_EQ(3, result[0].lVolume);
+
+    ASSERT_TRUE(candles.GetCandles("1d", 0, result));
+    ASSERT_EQ(1u, result.size());
+    ASSERT_EQ(105, result[0].lHigh);
+    ASSERT_EQ(95, result[0].lLow);
+    ASSERT_EQ(6, result[0].lVolume);
+}
+
+TEST_F(OTMarketCandlesTest, keeps_only_the_latest_day_of_minutes)
+{
+    OTMarketCandles candles;
+    ASSERT_TRUE(candles.Open(path_));
+
+    ASSERT_TRUE(candles.AddTrade(DAY, 100, 1));
+    ASSERT_TRUE(candles.AddTrade(DAY + 120, 101, 1));
+    ASSERT_TRUE(candles.AddTrade(DAY + 86400 + 60, 102, 1));
+
+    std::vector<OTMarketCandles::Candle> result;
+    ASSERT_TRUE(candles.GetCandles("1m", 0, result));
+    ASSERT_EQ(2u, result.size());
+    ASSERT_EQ(DAY + 120, result[0].tStart);
+    ASSERT_EQ(102, result[1].lOpen);
+
+    ASSERT_TRUE(candles.GetCandles("1h", 1, result));
+    ASSERT_EQ(1u, result.size());
+    ASSERT_EQ(DAY + 86400, result[0].tStart);
+
+    ASSERT_FALSE(candles.GetCandles("5m", 0, result));
+}
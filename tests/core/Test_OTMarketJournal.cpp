@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/trade/OTMarketJournal.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+class OTMarketJournalTest : public ::testing::Test
+{
+protected:
+    OTMarketJournalTest()
+        : path_("Test_OTMarketJournal.journal")
+    {
+        std::remove(path_.c_str());
+    }
+    ~OTMarketJournalTest()
+    {
+        std::remove(path_.c_str());
+    }
+
+    const std::string path_;
+};
+} // namespace
+
+TEST_F(OTMarketJournalTest, entries_survive_reopening)
+{
+    std::vector<std::string> entries;
+    {
+        OTMarketJournal journal;
+        ASSERT_TRUE(journal.Open(path_, entries));
+        ASSERT_TRUE(entries.empty());
+        ASSERT_TRUE(journal.Append("1 remove 5"));
+        ASSERT_TRUE(journal.Append("2 remove 6"));
+        ASSERT_EQ(2u, journal.GetCount());
+    }
+
+    OTMarketJournal journal;
+    ASSERT_TRUE(journal.Open(path_, entries));
+    ASSERT_EQ(std::vector<std::string>({"1 remove 5", "2 remove 6"}), entries);
+    ASSERT_EQ(2u, journal.GetCount());
+}
+
+TEST_F(OTMarketJournalTest, drops_a_partly_written_entry)
+{
+    {
+        std::ofstream file(path_);
+        file << "1 remove 5\n2 rem";
+    }
+
+    std::vector<std::string> entries;
+    {
+        OTMarketJournal journal;
+        ASSERT_TRUE(journal.Open(path_, entries));
+        ASSERT_EQ(std::vector<std::string>({"1 remove 5"}), entries);
+        ASSERT_TRUE(journal.Append("2 remove 6"));
+    }
+
+    OTMarketJournal journal;
+    ASSERT_TRUE(journal.Open(path_, entries));
+    ASSERT_EQ(std::vector<std::string>({"1 remove 5", "2 remove 6"}), entries);
+}
+
+TEST_F(OTMarketJournalTest, clear_empties_the_journal)
+{
+    std::vector<std::string> entries;
+    {
+        OTMarketJournal journal;
+        ASSERT_TRUE(journal.Open(path_, entries));
+        ASSERT_TRUE(journal.Append("1 remove 5"));
+        ASSERT_TRUE(journal.Clear());
+        ASSERT_EQ(0u, journal.GetCount());
+        ASSERT_TRUE(journal.Append("2 remove 6"));
+    }
+
+    OTMarketJournal journal;
+    ASSERT_TRUE(journal.Open(path_, entries));
+    ASSERT_EQ(std::vector<std::string>({"2 remove 6"}), entries);
+}
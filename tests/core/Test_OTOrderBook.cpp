@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/trade/OTOffer.hpp>
+#include <opentxs/core/trade/OTOrderBook.hpp>
+
+#include <memory>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+class OrderBookTest : public ::testing::Test
+{
+protected:
+    OTOffer& makeOffer(bool bSelling, int64_t lPrice, int64_t lAmount,
+                       int64_t lTransactionNum)
+    {
+        offers_.emplace_back(new OTOffer);
+        offers_.back()->MakeOffer(bSelling, lPrice, lAmount, 1,
+                                  lTransactionNum);
+        return *offers_.back();
+    }
+
+    std::vector<int64_t> order(const OTOrderBook& book)
+    {
+        std::vector<int64_t> result;
+        for (OTOffer* pOffer : book)
+            result.push_back(pOffer->GetTransactionNum());
+        return result;
+    }
+
+    std::vector<std::unique_ptr<OTOffer>> offers_;
+};
+
+} // namespace
+
+TEST_F(OrderBookTest, bids_highest_price_first_then_arrival)
+{
+    OTOrderBook bids(true);
+    bids.Add(makeOffer(false, 10, 5, 1));
+    bids.Add(makeOffer(false, 12, 5, 2));
+    bids.Add(makeOffer(false, 10, 5, 3));
+    bids.Add(makeOffer(false, 0, 5, 4));
+
+    ASSERT_EQ(std::vector<int64_t>({2, 1, 3, 4}), order(bids));
+    ASSERT_EQ(12, bids.GetBestPrice());
+    ASSERT_EQ(3u, bids.GetLevelCount());
+}
+
+TEST_F(OrderBookTest, asks_skip_market_orders_for_best_price)
+{
+    OTOrderBook asks(false);
+    asks.Add(makeOffer(true, 0, 5, 1));
+    asks.Add(makeOffer(true, 11, 5, 2));
+    asks.Add(makeOffer(true, 9, 5, 3));
+
+    ASSERT_EQ(std::vector<int64_t>({1, 3, 2}), order(asks));
+    ASSERT_EQ(9, asks.GetBestPrice());
+}
+
+TEST_F(OrderBookTest, level_quantities_follow_changes)
+{
+    OTOrderBook asks(false);
+    OTOffer& first = makeOffer(true, 9, 5, 1);
+    asks.Add(first);
+    asks.Add(makeOffer(true, 9, 7, 2));
+    asks.Add(makeOffer(true, 11, 3, 3));
+
+    ASSERT_EQ(12, asks.GetQuantityAtPrice(9));
+    ASSERT_EQ(15, asks.GetTotalQuantity());
+
+    first.IncrementFinishedSoFar(2);
+    asks.Update(first);
+    ASSERT_EQ(10, asks.GetQuantityAtPrice(9));
+    ASSERT_EQ(13, asks.GetTotalQuantity());
+
+    ASSERT_EQ(&first, asks.Remove(1));
+    ASSERT_EQ(nullptr, asks.Remove(1));
+    ASSERT_EQ(7, asks.GetQuantityAtPrice(9));
+    ASSERT_EQ(10, asks.GetTotalQuantity());
+}
+
+TEST_F(OrderBookTest, remove_last_offer_drops_level)
+{
+    OTOrderBook bids(true);
+    bids.Add(makeOffer(false, 12, 5, 1));
+    bids.Add(makeOffer(false, 10, 5, 2));
+
+    ASSERT_NE(nullptr, bids.Remove(1));
+    ASSERT_EQ(1u, bids.GetLevelCount());
+    ASSERT_EQ(10, bids.GetBestPrice());
+    ASSERT_EQ(std::vector<int64_t>({2}), order(bids));
+}
+
+TEST_F(OrderBookTest, duplicate_transaction_number_rejected)
+{
+    OTOrderBook bids(true);
+    ASSERT_TRUE(bids.Add(makeOffer(false, 12, 5, 1)));
+    ASSERT_FALSE(bids.Add(makeOffer(false, 10, 5, 1)));
+    ASSERT_EQ(1u, bids.size());
+}
+
+TEST_F(OrderBookTest, next_level_skips_rest_of_price)
+{
+    OTOrderBook asks(false);
+    asks.Add(makeOffer(true, 9, 5, 1));
+    asks.Add(makeOffer(true, 9, 5, 2));
+    asks.Add(makeOffer(true, 11, 5, 3));
+
+    OTOrderBook::const_iterator it = asks.begin();
+    ASSERT_EQ(9, it.GetLevelPrice());
+    ASSERT_EQ(10, it.GetLevelQuantity());
+    it.NextLevel();
+    ASSERT_EQ(3, (*it)->GetTransactionNum());
+    ++it;
+    ASSERT_TRUE(it == asks.end());
+}
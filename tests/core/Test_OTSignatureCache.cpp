@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/crypto/OTSignatureCache.hpp>
+
+using namespace opentxs;
+
+TEST(OTSignatureCache, counts_hits_and_misses)
+{
+    OTSignatureCache cache(2);
+
+    ASSERT_FALSE(cache.Check("a"));
+    cache.Add("a");
+    ASSERT_TRUE(cache.Check("a"));
+
+    ASSERT_EQ(1, cache.GetHits());
+    ASSERT_EQ(1, cache.GetMisses());
+    ASSERT_EQ(1u, cache.GetSize());
+}
+
+TEST(OTSignatureCache, evicts_least_recently_used)
+{
+    OTSignatureCache cache(2);
+
+    cache.Add("a");
+    cache.Add("b");
+    ASSERT_TRUE(cache.Check("a"));
+    cache.Add("c");
+
+    ASSERT_EQ(2u, cache.GetSize());
+    ASSERT_TRUE(cache.Check("a"));
+    ASSERT_FALSE(cache.Check("b"));
+    ASSERT_TRUE(cache.Check("c"));
+}
+
+TEST(OTSignatureCache, zero_capacity_disables)
+{
+    OTSignatureCache cache(0);
+
+    cache.Add("a");
+
+    ASSERT_FALSE(cache.Check("a"));
+    ASSERT_EQ(0u, cache.GetSize());
+    ASSERT_EQ(0, cache.GetMisses());
+}
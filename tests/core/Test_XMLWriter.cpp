@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/XMLWriter.hpp>
+
+#include <string>
+
+using namespace opentxs;
+
+TEST(XMLWriter, empty_element_matches_tag)
+{
+    Tag tag("cron");
+    tag.add_attribute("version", "1.0");
+    tag.add_attribute("notaryID", "abc");
+
+    std::string expected;
+    tag.output(expected);
+
+    std::string actual;
+    XMLWriter writer(actual);
+    writer.open("cron");
+    writer.add_attribute("version", "1.0");
+    writer.add_attribute("notaryID", "abc");
+    writer.close();
+
+    ASSERT_EQ(expected, actual);
+    ASSERT_EQ(0u, writer.depth());
+}
+
+TEST(XMLWriter, nested_elements_match_tag)
+{
+    Tag tag("market");
+    tag.add_attribute("version", "1.0");
+    tag.add_attribute("marketScale", "1");
+
+    TagPtr offer(new Tag("offer", "b2ZmZXI="));
+    offer->add_attribute("dateAdded", "42");
+    tag.add_tag(offer);
+
+    TagPtr number(new Tag("transactionNum"));
+    number->add_attribute("value", "7");
+    number->add_attribute("value", "8");
+    tag.add_tag(number);
+
+    tag.add_tag("inReferenceTo", "");
+    tag.add_tag("item", "aXRlbQ==");
+
+    std::string expected;
+    tag.output(expected);
+
+    std::string actual;
+    XMLWriter writer(actual);
+    writer.open("market");
+    writer.add_attribute("version", "1.0");
+    writer.add_attribute("marketScale", "1");
+    writer.open("offer");
+    writer.add_attribute("dateAdded", "42");
+    writer.set_text("b2ZmZXI=");
+    writer.close();
+    writer.open("transactionNum");
+    writer.add_attribute("value", "7");
+    writer.add_attribute("value", "8");
+    writer.close();
+    writer.add_tag("inReferenceTo", "");
+    writer.add_tag("item", "aXRlbQ==");
+    writer.close();
+
+    ASSERT_EQ(expected, actual);
+}
+
+TEST(XMLWriter, appends_to_existing_buffer)
+{
+    std::string actual("prefix\n");
+    XMLWriter writer(actual);
+    writer.add_tag("transaction", "dGV4dA==");
+
+    ASSERT_EQ("prefix\n<transaction>\ndGV4dA==\n</transaction>\n", actual);
+}